@@ -0,0 +1,803 @@
+/** CooTransformationBenchmark
+* ==========================
+*
+* Measures per-call latency and batch throughput of the exported CooTransformation functions.
+* The benchmark runs offline: a synthetic leapseconds kernel (LSK), planetary constants kernel
+* (PCK) and ephemeris (SPK, written with the CSPICE writer routines) are generated in a work
+* directory first.
+*
+* Startup is measured separately: a meta-kernel that also loads a large synthetic frames kernel
+* (FK) is loaded from an empty kernel pool with AddSpiceKernel() and with AddSpiceKernelCached()
+* (cache miss and cache hit).
+*
+* Every result is written as one JSON object per line, so results of different builds can be
+* compared with standard tools.
+*
+* With --validate, the native geodetic backends (see SetGeodeticBackend()) are compared against
+* the SPICE backend on a sweep over the whole sphere instead, and the float vertex output is checked
+* against GetVertexF32ErrorBound() for several tile sizes; the exit code is 1 if any backend exceeds
+* the documented tolerance or any vertex error exceeds its bound.
+*
+* Usage: CooTransformationBenchmark [--work-dir <dir>] [--output <file>] [--quick] [--validate]
+**/
+
+#include <CooTransformation/CooTransformation.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <SpiceUsr.h>
+
+
+static const double s_dPi = 3.14159265358979323846;
+
+// Synthetic ephemeris window.
+static const char* s_pcStartUtc = "2026-01-01T00:00:00";
+static const char* s_pcEndUtc = "2027-01-01T00:00:00";
+
+
+
+static bool SpiceHasFailed()
+{
+    // return_c() instead of failed_c(), see CooTransformation.cpp
+    return (return_c() == SPICETRUE);
+}
+
+
+
+struct SConfig
+{
+    std::string m_sWorkDir = ".";
+    std::string m_sOutput;
+    bool m_bQuick = false;
+    bool m_bValidate = false;
+};
+
+struct SLogConfig
+{
+    const char* m_pcName;
+    int m_nFileLogLevel; /* -1: no log file */
+    unsigned int m_nAsyncLogQueueSize;
+};
+
+static const SLogConfig s_aoLogConfigs[] =
+{
+    { "off", -1, 0 },
+    { "warning", 1, 0 },
+    { "trace", 4, 0 },
+    { "trace-async", 4, 65536 },
+};
+
+struct SGeodeticBackend
+{
+    const char* m_pcName;
+    int m_nBackend;
+};
+
+// native backends, see SetGeodeticBackend()
+static const SGeodeticBackend s_aoNativeBackends[] =
+{
+    { "scalar", 2 },
+    { "avx2", 3 },
+    { "avx512", 4 },
+};
+
+// documented tolerance of the native backends against SPICE
+static const double s_dMaxAngleErrorDeg = 1.0e-10;
+static const double s_dMaxDistanceErrorM = 1.0e-6;
+
+
+
+static void WriteTextKernel(const std::string& rsPath, const std::string& rsType, const std::string& rsData)
+{
+    std::ofstream oFile(rsPath, std::ios::out | std::ios::trunc);
+    oFile << "KPL/" << rsType << "\n\n"
+          << "Synthetic kernel generated by CooTransformationBenchmark. Not for scientific use.\n\n"
+          << "\\begindata\n\n" << rsData << "\n\\begintext\n";
+}
+
+
+static void WriteLeapsecondsKernel(const std::string& rsPath)
+{
+    WriteTextKernel(rsPath, "LSK",
+        "DELTET/DELTA_T_A = 32.184\n"
+        "DELTET/K = 1.657D-3\n"
+        "DELTET/EB = 1.671D-2\n"
+        "DELTET/M = ( 6.239996D0 1.99096871D-7 )\n"
+        "DELTET/DELTA_AT = ( 10, @1972-JAN-1\n"
+        "                    11, @1972-JUL-1\n"
+        "                    12, @1973-JAN-1\n"
+        "                    13, @1974-JAN-1\n"
+        "                    14, @1975-JAN-1\n"
+        "                    15, @1976-JAN-1\n"
+        "                    16, @1977-JAN-1\n"
+        "                    17, @1978-JAN-1\n"
+        "                    18, @1979-JAN-1\n"
+        "                    19, @1980-JAN-1\n"
+        "                    20, @1981-JUL-1\n"
+        "                    21, @1982-JUL-1\n"
+        "                    22, @1983-JUL-1\n"
+        "                    23, @1985-JUL-1\n"
+        "                    24, @1988-JAN-1\n"
+        "                    25, @1990-JAN-1\n"
+        "                    26, @1991-JAN-1\n"
+        "                    27, @1992-JUL-1\n"
+        "                    28, @1993-JUL-1\n"
+        "                    29, @1994-JUL-1\n"
+        "                    30, @1996-JAN-1\n"
+        "                    31, @1997-JUL-1\n"
+        "                    32, @1999-JAN-1\n"
+        "                    33, @2006-JAN-1\n"
+        "                    34, @2009-JAN-1\n"
+        "                    35, @2012-JUL-1\n"
+        "                    36, @2015-JUL-1\n"
+        "                    37, @2017-JAN-1 )\n");
+}
+
+
+static void WritePlanetaryConstantsKernel(const std::string& rsPath)
+{
+    WriteTextKernel(rsPath, "PCK",
+        "BODY10_RADII = ( 696000.0 696000.0 696000.0 )\n"
+        "BODY399_RADII = ( 6378.1366 6378.1366 6356.7519 )\n"
+        "BODY399_POLE_RA = ( 0.0 -0.641 0.0 )\n"
+        "BODY399_POLE_DEC = ( 90.0 -0.557 0.0 )\n"
+        "BODY399_PM = ( 190.147 360.9856235 0.0 )\n"
+        "BODY499_RADII = ( 3396.19 3396.19 3376.20 )\n"
+        "BODY499_POLE_RA = ( 317.68143 -0.1061 0.0 )\n"
+        "BODY499_POLE_DEC = ( 52.88650 -0.0609 0.0 )\n"
+        "BODY499_PM = ( 176.630 350.89198226 0.0 )\n");
+}
+
+
+static void WriteFramesKernel(const std::string& rsPath, int nFrames)
+{
+    std::string sData;
+    for (int i = 0; i < nFrames; ++i)
+    {
+        const std::string sId = std::to_string(-1000000 - i);
+        const std::string sName = "SYNTHETIC_FRAME_" + std::to_string(i);
+        sData += "FRAME_" + sName + " = " + sId + "\n"
+            "FRAME_" + sId + "_NAME = '" + sName + "'\n"
+            "FRAME_" + sId + "_CLASS = 4\n"
+            "FRAME_" + sId + "_CLASS_ID = " + sId + "\n"
+            "FRAME_" + sId + "_CENTER = 499\n"
+            "TKFRAME_" + sId + "_RELATIVE = 'J2000'\n"
+            "TKFRAME_" + sId + "_SPEC = 'ANGLES'\n"
+            "TKFRAME_" + sId + "_UNITS = 'DEGREES'\n"
+            "TKFRAME_" + sId + "_AXES = ( 3, 1, 3 )\n"
+            "TKFRAME_" + sId + "_ANGLES = ( " + std::to_string(0.01 * i) + ", " + std::to_string(0.02 * i) + ", " + std::to_string(0.03 * i) + " )\n\n";
+    }
+    WriteTextKernel(rsPath, "FK", sData);
+}
+
+
+static void WriteMetaKernel(const std::string& rsPath, const std::vector<std::string>& rvecKernels)
+{
+    std::string sData = "KERNELS_TO_LOAD = (\n";
+    for (const std::string& rsKernel : rvecKernels)
+    {
+        sData += "    '" + rsKernel + "'\n";
+    }
+    sData += ")\n";
+    WriteTextKernel(rsPath, "MK", sData);
+}
+
+
+struct SCircularOrbit
+{
+    int m_nBody;
+    int m_nCenter;
+    double m_dRadius;   /* [km] */
+    double m_dPeriod;   /* [s] */
+    double m_dStep;     /* [s] between SPK states */
+};
+
+
+static bool WriteEphemerisKernel(const std::string& rsPath, double dStartEt, double dEndEt)
+{
+    static const SCircularOrbit s_aoOrbits[] =
+    {
+        { 399, 10, 1.495978707e8, 365.25636 * 86400.0, 86400.0 },
+        { 499, 10, 2.279392e8, 686.98 * 86400.0, 86400.0 },
+        { 401, 499, 9376.0, 0.31891023 * 86400.0, 300.0 },
+    };
+
+    std::remove(rsPath.c_str());
+    SpiceInt nHandle = 0;
+    spkopn_c(rsPath.c_str(), "SYNTHETIC", 0, &nHandle);
+    if (SpiceHasFailed())
+    {
+        return false;
+    }
+
+    for (const SCircularOrbit& roOrbit : s_aoOrbits)
+    {
+        const SpiceInt nStates = static_cast<SpiceInt>(std::ceil((dEndEt - dStartEt) / roOrbit.m_dStep)) + 1;
+        std::vector<std::array<double, 6>> vecStates(static_cast<size_t>(nStates));
+        const double dOmega = 2.0 * s_dPi / roOrbit.m_dPeriod;
+        for (SpiceInt i = 0; i < nStates; ++i)
+        {
+            double dPhase = dOmega * (dStartEt + static_cast<double>(i) * roOrbit.m_dStep);
+            double dInclination = 0.03 * static_cast<double>(roOrbit.m_nBody % 7);
+            auto& rState = vecStates[static_cast<size_t>(i)];
+            rState[0] = roOrbit.m_dRadius * std::cos(dPhase);
+            rState[1] = roOrbit.m_dRadius * std::sin(dPhase) * std::cos(dInclination);
+            rState[2] = roOrbit.m_dRadius * std::sin(dPhase) * std::sin(dInclination);
+            rState[3] = -roOrbit.m_dRadius * dOmega * std::sin(dPhase);
+            rState[4] = roOrbit.m_dRadius * dOmega * std::cos(dPhase) * std::cos(dInclination);
+            rState[5] = roOrbit.m_dRadius * dOmega * std::cos(dPhase) * std::sin(dInclination);
+        }
+
+        std::string sSegmentId = "SYNTHETIC " + std::to_string(roOrbit.m_nBody);
+        spkw08_c(nHandle, roOrbit.m_nBody, roOrbit.m_nCenter, "J2000", dStartEt, dEndEt, sSegmentId.c_str(),
+            7, nStates, reinterpret_cast<const double(*)[6]>(vecStates.data()), dStartEt, roOrbit.m_dStep);
+        if (SpiceHasFailed())
+        {
+            return false;
+        }
+    }
+
+    spkcls_c(nHandle);
+    return !SpiceHasFailed();
+}
+
+
+
+class CResultWriter
+{
+public:
+    explicit CResultWriter(const std::string& rsOutput)
+    {
+        if (!rsOutput.empty())
+        {
+            m_oFile.open(rsOutput, std::ios::out | std::ios::trunc);
+        }
+    }
+
+    void Write(const std::string& rsBenchmark, const std::string& rsMode, const std::string& rsLog,
+        size_t nOps, double dNsPerOp)
+    {
+        char acLine[512];
+        std::snprintf(acLine, sizeof(acLine),
+            "{\"api_version\": %u, \"benchmark\": \"%s\", \"mode\": \"%s\", \"log\": \"%s\", "
+            "\"ops\": %zu, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f}",
+            GetAPIVersion(), rsBenchmark.c_str(), rsMode.c_str(), rsLog.c_str(),
+            nOps, dNsPerOp, dNsPerOp > 0.0 ? 1.0e9 / dNsPerOp : 0.0);
+        WriteLine(acLine);
+    }
+
+    void WriteLine(const char* pcLine)
+    {
+        std::cout << pcLine << std::endl;
+        if (m_oFile.is_open())
+        {
+            m_oFile << pcLine << std::endl;
+        }
+    }
+
+private:
+    std::ofstream m_oFile;
+};
+
+
+/** Median over repetitions of the time per operation of fnRun(), which performs nOps operations. **/
+static double MeasureNsPerOp(size_t nOps, const std::function<void()>& fnRun)
+{
+    fnRun(); // warm up caches
+    std::vector<double> vecNsPerOp;
+    for (int nRepetition = 0; nRepetition < 5; ++nRepetition)
+    {
+        auto oStart = std::chrono::steady_clock::now();
+        fnRun();
+        auto oEnd = std::chrono::steady_clock::now();
+        vecNsPerOp.push_back(std::chrono::duration<double, std::nano>(oEnd - oStart).count() / static_cast<double>(nOps));
+    }
+    std::sort(vecNsPerOp.begin(), vecNsPerOp.end());
+    return vecNsPerOp[vecNsPerOp.size() / 2];
+}
+
+
+
+static void RunBenchmarks(const SConfig& roConfig, const SLogConfig& roLog, double dStartEt, CResultWriter& roWriter)
+{
+    const size_t nSingle = roConfig.m_bQuick ? 2000 : 100000;
+    const size_t nState = roConfig.m_bQuick ? 200 : 10000;
+    const size_t nBatch = roConfig.m_bQuick ? 20000 : 1000000;
+    const std::string sLog = roLog.m_pcName;
+
+    // interleaved point cloud on the surface of Mars
+    std::vector<double> vecLatLonAlt(3 * nBatch);
+    std::vector<double> vecXyz(3 * nBatch);
+    std::vector<double> vecOut(3 * nBatch);
+    std::vector<int> vecStatus(nBatch);
+    for (size_t i = 0; i < nBatch; ++i)
+    {
+        vecLatLonAlt[3 * i + 0] = -89.0 + 178.0 * static_cast<double>(i % 997) / 996.0;
+        vecLatLonAlt[3 * i + 1] = 360.0 * static_cast<double>(i % 1009) / 1009.0;
+        vecLatLonAlt[3 * i + 2] = static_cast<double>(i % 5000) - 2500.0;
+    }
+    const double* pdLla = vecLatLonAlt.data();
+    LatLonAlt2XyzBatch("MARS", static_cast<unsigned int>(nBatch), pdLla, pdLla + 1, pdLla + 2, 3,
+        vecXyz.data(), vecXyz.data() + 1, vecXyz.data() + 2, 3, nullptr);
+    const double* pdXyz = vecXyz.data();
+    double* pdOut = vecOut.data();
+
+    double dA = 0.0, dB = 0.0, dC = 0.0;
+    roWriter.Write("Xyz2LatLonRad", "single", sLog, nSingle, MeasureNsPerOp(nSingle, [&]
+    {
+        for (size_t i = 0; i < nSingle; ++i)
+        {
+            Xyz2LatLonRad(pdXyz[3 * i], pdXyz[3 * i + 1], pdXyz[3 * i + 2], &dA, &dB, &dC);
+        }
+    }));
+    roWriter.Write("Xyz2LatLonAlt", "single", sLog, nSingle, MeasureNsPerOp(nSingle, [&]
+    {
+        for (size_t i = 0; i < nSingle; ++i)
+        {
+            Xyz2LatLonAlt("MARS", pdXyz[3 * i], pdXyz[3 * i + 1], pdXyz[3 * i + 2], &dA, &dB, &dC);
+        }
+    }));
+    roWriter.Write("LatLonAlt2Xyz", "single", sLog, nSingle, MeasureNsPerOp(nSingle, [&]
+    {
+        for (size_t i = 0; i < nSingle; ++i)
+        {
+            LatLonAlt2Xyz("MARS", pdLla[3 * i], pdLla[3 * i + 1], pdLla[3 * i + 2], &dA, &dB, &dC);
+        }
+    }));
+
+    const unsigned int nBatchCount = static_cast<unsigned int>(nBatch);
+    roWriter.Write("Xyz2LatLonRadBatch", "batch", sLog, nBatch, MeasureNsPerOp(nBatch, [&]
+    {
+        Xyz2LatLonRadBatch(nBatchCount, pdXyz, pdXyz + 1, pdXyz + 2, 3, pdOut, pdOut + 1, pdOut + 2, 3, vecStatus.data());
+    }));
+    roWriter.Write("Xyz2LatLonAltBatch", "batch", sLog, nBatch, MeasureNsPerOp(nBatch, [&]
+    {
+        Xyz2LatLonAltBatch("MARS", nBatchCount, pdXyz, pdXyz + 1, pdXyz + 2, 3, pdOut, pdOut + 1, pdOut + 2, 3, vecStatus.data());
+    }));
+    roWriter.Write("LatLonAlt2XyzBatch", "batch", sLog, nBatch, MeasureNsPerOp(nBatch, [&]
+    {
+        LatLonAlt2XyzBatch("MARS", nBatchCount, pdLla, pdLla + 1, pdLla + 2, 3, pdOut, pdOut + 1, pdOut + 2, 3, vecStatus.data());
+    }));
+
+    // DEM raster of the same size, 1000 columns; the altitudes of the point cloud serve as heights
+    const SLatLonGrid oGrid = { 10.0, -0.01, 120.0, 0.01, static_cast<unsigned int>(nBatch / 1000), 1000 };
+    std::vector<double> vecHeights(nBatch);
+    for (size_t i = 0; i < nBatch; ++i)
+    {
+        vecHeights[i] = pdLla[3 * i + 2];
+    }
+    roWriter.Write("LatLonGrid2Xyz", "batch", sLog, nBatch, MeasureNsPerOp(nBatch, [&]
+    {
+        LatLonGrid2Xyz("MARS", &oGrid, vecHeights.data(), 0, pdOut, 1);
+    }));
+
+    // the same conversions into an interleaved float vertex buffer (position, normal, texture coordinates)
+    std::vector<float> vecVertices(8 * nBatch);
+    const SVertexOutputF32 oVertexOutput = { { pdXyz[0], pdXyz[1], pdXyz[2] }, vecVertices.data(), 8 * sizeof(float), 0 };
+    roWriter.Write("LatLonAlt2XyzBatchF32", "batch", sLog, nBatch, MeasureNsPerOp(nBatch, [&]
+    {
+        LatLonAlt2XyzBatchF32("MARS", nBatchCount, pdLla, pdLla + 1, pdLla + 2, 3, &oVertexOutput, nullptr, vecStatus.data());
+    }));
+    roWriter.Write("LatLonGrid2XyzF32", "batch", sLog, nBatch, MeasureNsPerOp(nBatch, [&]
+    {
+        LatLonGrid2XyzF32("MARS", &oGrid, vecHeights.data(), 0, &oVertexOutput, nullptr, 1);
+    }));
+
+    for (const SGeodeticBackend& roBackend : s_aoNativeBackends)
+    {
+        if (SetGeodeticBackend(roBackend.m_nBackend) != 0)
+        {
+            continue;
+        }
+        const std::string sSuffix = std::string("/") + roBackend.m_pcName;
+        roWriter.Write("Xyz2LatLonAlt" + sSuffix, "single", sLog, nSingle, MeasureNsPerOp(nSingle, [&]
+        {
+            for (size_t i = 0; i < nSingle; ++i)
+            {
+                Xyz2LatLonAlt("MARS", pdXyz[3 * i], pdXyz[3 * i + 1], pdXyz[3 * i + 2], &dA, &dB, &dC);
+            }
+        }));
+        roWriter.Write("Xyz2LatLonAltBatch" + sSuffix, "batch", sLog, nBatch, MeasureNsPerOp(nBatch, [&]
+        {
+            Xyz2LatLonAltBatch("MARS", nBatchCount, pdXyz, pdXyz + 1, pdXyz + 2, 3, pdOut, pdOut + 1, pdOut + 2, 3, vecStatus.data());
+        }));
+        roWriter.Write("LatLonAlt2XyzBatch" + sSuffix, "batch", sLog, nBatch, MeasureNsPerOp(nBatch, [&]
+        {
+            LatLonAlt2XyzBatch("MARS", nBatchCount, pdLla, pdLla + 1, pdLla + 2, 3, pdOut, pdOut + 1, pdOut + 2, 3, vecStatus.data());
+        }));
+    }
+    SetGeodeticBackend(0);
+
+    double dEt = 0.0;
+    roWriter.Write("Datetime2Et", "single", sLog, nState, MeasureNsPerOp(nState, [&]
+    {
+        for (size_t i = 0; i < nState; ++i)
+        {
+            Datetime2Et("2026-06-01T12:00:00", &dEt);
+        }
+    }));
+
+    double adPos[3];
+    double adRot[9];
+    roWriter.Write("GetRelState", "single", sLog, nState, MeasureNsPerOp(nState, [&]
+    {
+        for (size_t i = 0; i < nState; ++i)
+        {
+            GetRelState("PHOBOS", "SUN", "EARTH", "2026-06-01T12:00:00", "J2000", adPos, adRot);
+        }
+    }));
+
+    // one call per epoch for several targets, ops are target poses as above
+    const char* const apcTargets[] = { "PHOBOS", "MARS", "PHOBOS", "MARS" };
+    const size_t nTargets = sizeof(apcTargets) / sizeof(apcTargets[0]);
+    double adPosMulti[3 * nTargets];
+    double adRotMulti[9 * nTargets];
+    roWriter.Write("GetRelStateMulti", "batch", sLog, nState, MeasureNsPerOp(nState, [&]
+    {
+        for (size_t i = 0; i < nState; i += nTargets)
+        {
+            GetRelStateMulti(apcTargets, static_cast<unsigned int>(nTargets), "SUN", "EARTH", "2026-06-01T12:00:00", "J2000", adPosMulti, adRotMulti, nullptr);
+        }
+    }));
+
+    std::vector<double> vecPos(3 * nState);
+    std::vector<double> vecRot(9 * nState);
+    roWriter.Write("GetRelStateSeries", "batch", sLog, nState, MeasureNsPerOp(nState, [&]
+    {
+        GetRelStateSeries("PHOBOS", "SUN", "EARTH", "J2000", dStartEt + 86400.0, 60.0, nullptr,
+            static_cast<unsigned int>(nState), vecPos.data(), vecRot.data(), nullptr);
+    }));
+
+    // the point cloud seen from the earth at 10 epochs, radial normals
+    const size_t nIllumPoints = nBatch / 10;
+    roWriter.Write("GetIlluminationAngles", "batch", sLog, 10 * nIllumPoints, MeasureNsPerOp(10 * nIllumPoints, [&]
+    {
+        GetIlluminationAngles("MARS", "IAU_MARS", "EARTH", dStartEt + 86400.0, 3600.0, nullptr, 10,
+            static_cast<unsigned int>(nIllumPoints), pdXyz, pdXyz + 1, pdXyz + 2, nullptr, nullptr, nullptr, 3,
+            pdOut, pdOut + 10 * nIllumPoints, pdOut + 20 * nIllumPoints, nullptr, 1);
+    }));
+
+    roWriter.Write("GetPositionTransformationMatrix", "single", sLog, nState, MeasureNsPerOp(nState, [&]
+    {
+        for (size_t i = 0; i < nState; ++i)
+        {
+            GetPositionTransformationMatrix("IAU_MARS", "J2000", "2026-06-01T12:00:00", adRot);
+        }
+    }));
+
+    std::vector<double> vecEts(nState);
+    std::vector<double> vecQuats(4 * nState);
+    for (size_t i = 0; i < nState; ++i)
+    {
+        vecEts[i] = dStartEt + 86400.0 + 60.0 * static_cast<double>(i);
+    }
+    roWriter.Write("GetPositionTransformationMatrixSeries", "batch", sLog, nState, MeasureNsPerOp(nState, [&]
+    {
+        GetPositionTransformationMatrixSeries("IAU_MARS", "J2000", vecEts.data(), static_cast<unsigned int>(nState),
+            nullptr, vecQuats.data(), nullptr);
+    }));
+}
+
+
+
+/** Compare every available native geodetic backend with SPICE on a grid over the whole sphere.
+  * Returns false if a backend exceeds the documented tolerance.
+  **/
+static bool ValidateGeodeticBackends(const SConfig& roConfig, CResultWriter& roWriter)
+{
+    const double dStep = roConfig.m_bQuick ? 1.0 : 0.125;
+    const double adAltitudes[] = { -8000.0, 0.0, 1234.5, 2.0e7, 9.0e8 };
+
+    // contiguous lat/lon/alt grid including the poles and the 0/360 deg seam
+    std::vector<double> vecLat;
+    std::vector<double> vecLon;
+    std::vector<double> vecAlt;
+    for (double dAlt : adAltitudes)
+    {
+        for (double dLat = -90.0; dLat <= 90.0; dLat += dStep)
+        {
+            for (double dLon = -180.0; dLon <= 360.0; dLon += dStep)
+            {
+                vecLat.push_back(dLat);
+                vecLon.push_back(dLon);
+                vecAlt.push_back(dAlt);
+            }
+        }
+    }
+    const size_t nCount = vecLat.size();
+    const unsigned int nCount32 = static_cast<unsigned int>(nCount);
+
+    bool bPassed = true;
+    // MARS uses positive west planetographic longitudes, EARTH positive east.
+    for (const char* pcBody : { "MARS", "EARTH" })
+    {
+        std::vector<double> vecRefX(nCount), vecRefY(nCount), vecRefZ(nCount);
+        std::vector<double> vecRefLat(nCount), vecRefLon(nCount), vecRefAlt(nCount);
+        SetGeodeticBackend(0);
+        if (LatLonAlt2XyzBatch(pcBody, nCount32, vecLat.data(), vecLon.data(), vecAlt.data(), 1,
+                vecRefX.data(), vecRefY.data(), vecRefZ.data(), 1, nullptr) != 0 ||
+            Xyz2LatLonAltBatch(pcBody, nCount32, vecRefX.data(), vecRefY.data(), vecRefZ.data(), 1,
+                vecRefLat.data(), vecRefLon.data(), vecRefAlt.data(), 1, nullptr) != 0)
+        {
+            std::cerr << "SPICE reference conversion failed for " << pcBody << "." << std::endl;
+            return false;
+        }
+
+        for (const SGeodeticBackend& roBackend : s_aoNativeBackends)
+        {
+            if (SetGeodeticBackend(roBackend.m_nBackend) != 0)
+            {
+                continue;
+            }
+
+            std::vector<double> vecX(nCount), vecY(nCount), vecZ(nCount);
+            std::vector<double> vecOutLat(nCount), vecOutLon(nCount), vecOutAlt(nCount);
+            LatLonAlt2XyzBatch(pcBody, nCount32, vecLat.data(), vecLon.data(), vecAlt.data(), 1,
+                vecX.data(), vecY.data(), vecZ.data(), 1, nullptr);
+            Xyz2LatLonAltBatch(pcBody, nCount32, vecRefX.data(), vecRefY.data(), vecRefZ.data(), 1,
+                vecOutLat.data(), vecOutLon.data(), vecOutAlt.data(), 1, nullptr);
+
+            double dMaxXyz = 0.0;
+            double dMaxLat = 0.0;
+            double dMaxLon = 0.0;
+            double dMaxAlt = 0.0;
+            for (size_t i = 0; i < nCount; ++i)
+            {
+                dMaxXyz = std::max({ dMaxXyz, std::fabs(vecX[i] - vecRefX[i]), std::fabs(vecY[i] - vecRefY[i]), std::fabs(vecZ[i] - vecRefZ[i]) });
+                dMaxLat = std::max(dMaxLat, std::fabs(vecOutLat[i] - vecRefLat[i]));
+                double dLonDiff = std::fabs(vecOutLon[i] - vecRefLon[i]);
+                dMaxLon = std::max(dMaxLon, std::min(dLonDiff, 360.0 - dLonDiff));
+                dMaxAlt = std::max(dMaxAlt, std::fabs(vecOutAlt[i] - vecRefAlt[i]));
+            }
+
+            // the single-point path must agree with the batch path
+            double dMaxSingle = 0.0;
+            for (size_t i = 0; i < nCount; i += 997)
+            {
+                double dLat = 0.0, dLon = 0.0, dAlt = 0.0;
+                Xyz2LatLonAlt(pcBody, vecRefX[i], vecRefY[i], vecRefZ[i], &dLat, &dLon, &dAlt);
+                dMaxSingle = std::max({ dMaxSingle, std::fabs(dLat - vecOutLat[i]), std::fabs(dLon - vecOutLon[i]), std::fabs(dAlt - vecOutAlt[i]) });
+            }
+
+            const bool bBackendPassed = dMaxXyz <= s_dMaxDistanceErrorM && dMaxAlt <= s_dMaxDistanceErrorM &&
+                dMaxLat <= s_dMaxAngleErrorDeg && dMaxLon <= s_dMaxAngleErrorDeg && dMaxSingle == 0.0;
+            bPassed = bPassed && bBackendPassed;
+
+            char acLine[512];
+            std::snprintf(acLine, sizeof(acLine),
+                "{\"api_version\": %u, \"validate\": \"%s\", \"body\": \"%s\", \"points\": %zu, "
+                "\"max_xyz_m\": %.3e, \"max_lat_deg\": %.3e, \"max_lon_deg\": %.3e, \"max_alt_m\": %.3e, "
+                "\"single_vs_batch\": %.3e, \"passed\": %s}",
+                GetAPIVersion(), roBackend.m_pcName, pcBody, nCount,
+                dMaxXyz, dMaxLat, dMaxLon, dMaxAlt, dMaxSingle, bBackendPassed ? "true" : "false");
+            roWriter.WriteLine(acLine);
+        }
+    }
+    SetGeodeticBackend(0);
+    return bPassed;
+}
+
+
+
+/** Convert DEM tiles of increasing size to float vertices relative to the tile center and compare
+  * the measured error with GetVertexF32ErrorBound() for the largest coordinate of the tile.
+  * Returns false if a tile exceeds its bound.
+  **/
+static bool ValidateVertexF32(const SConfig& roConfig, CResultWriter& roWriter)
+{
+    const unsigned int nSize = roConfig.m_bQuick ? 64 : 512;
+    const double dRadius = 3396190.0;
+    const double dDegPerM = 180.0 / (3.14159265358979323846 * dRadius);
+    std::vector<double> vecHeights(static_cast<size_t>(nSize) * nSize);
+    for (size_t i = 0; i < vecHeights.size(); ++i)
+    {
+        vecHeights[i] = -4000.0 + 37.0 * static_cast<double>(i % 97);
+    }
+    std::vector<double> vecXyz(3 * vecHeights.size());
+    std::vector<float> vecVertices(8 * vecHeights.size()); // position at float 3 of 8 (normal, texture coordinates around it)
+
+    bool bPassed = true;
+    for (double dTileSize : { 1000.0, 8000.0, 30000.0, 120000.0 })
+    {
+        const double dStep = dTileSize / (nSize - 1) * dDegPerM;
+        const SLatLonGrid oGrid = { 18.4 + dStep * (nSize - 1), -dStep, 77.5, dStep, nSize, nSize };
+        if (LatLonGrid2Xyz("MARS", &oGrid, vecHeights.data(), 0, vecXyz.data(), 1) != 0)
+        {
+            std::cerr << "LatLonGrid2Xyz() failed." << std::endl;
+            return false;
+        }
+        SVertexOutputF32 oOutput = { { 0.0, 0.0, 0.0 }, vecVertices.data(), 8 * sizeof(float), 3 * sizeof(float) };
+        const size_t nCenter = 3 * ((nSize / 2) * nSize + nSize / 2);
+        double dTileRadius = 0.0;
+        for (int k = 0; k < 3; ++k)
+        {
+            oOutput.m_adCenter[k] = vecXyz[nCenter + k];
+        }
+        for (size_t i = 0; i < vecXyz.size(); ++i)
+        {
+            dTileRadius = std::max(dTileRadius, std::fabs(vecXyz[i] - oOutput.m_adCenter[i % 3]));
+        }
+
+        double dMaxError = 0.0;
+        double dBound = 0.0;
+        bool bTilePassed = LatLonGrid2XyzF32("MARS", &oGrid, vecHeights.data(), 0, &oOutput, &dMaxError, 1) == 0 &&
+            GetVertexF32ErrorBound(dTileRadius, &dBound) == 0;
+        // the reported error must match the buffer contents
+        double dBufferError = 0.0;
+        for (size_t i = 0; i < vecHeights.size(); ++i)
+        {
+            double dError2 = 0.0;
+            for (int k = 0; k < 3; ++k)
+            {
+                const double dError = static_cast<double>(vecVertices[8 * i + 3 + k]) - (vecXyz[3 * i + k] - oOutput.m_adCenter[k]);
+                dError2 += dError * dError;
+            }
+            dBufferError = std::max(dBufferError, std::sqrt(dError2));
+        }
+        bTilePassed = bTilePassed && dMaxError <= dBound && std::fabs(dBufferError - dMaxError) <= 1.0e-9;
+        bPassed = bPassed && bTilePassed;
+
+        char acLine[512];
+        std::snprintf(acLine, sizeof(acLine),
+            "{\"api_version\": %u, \"validate\": \"vertex_f32\", \"tile_m\": %.0f, \"tile_radius_m\": %.1f, "
+            "\"max_error_mm\": %.4f, \"bound_mm\": %.4f, \"within_1mm\": %s, \"passed\": %s}",
+            GetAPIVersion(), dTileSize, dTileRadius, dMaxError * 1000.0, dBound * 1000.0,
+            dBound <= 1.0e-3 ? "true" : "false", bTilePassed ? "true" : "false");
+        roWriter.WriteLine(acLine);
+    }
+    return bPassed;
+}
+
+
+
+/** Loads the meta-kernel into an empty kernel pool without cache, with a cache miss and with a cache hit. **/
+static bool RunStartupBenchmark(const SConfig& roConfig, const std::string& rsMetaKernel, CResultWriter& roWriter)
+{
+    const std::filesystem::path oCacheDir = std::filesystem::path(roConfig.m_sWorkDir) / "pool-cache";
+    const std::string sCacheDir = oCacheDir.string();
+    bool bPassed = true;
+    auto fnLoad = [&](bool bCached, bool bClearCache, int nExpectedStatus)
+    {
+        if (bClearCache)
+        {
+            std::filesystem::remove_all(oCacheDir);
+            std::filesystem::create_directories(oCacheDir);
+        }
+        ClearSpiceKernels();
+        auto oStart = std::chrono::steady_clock::now();
+        int nStatus = 2;
+        int nResult = bCached ? AddSpiceKernelCached(rsMetaKernel.c_str(), sCacheDir.c_str(), &nStatus) : AddSpiceKernel(rsMetaKernel.c_str());
+        auto oEnd = std::chrono::steady_clock::now();
+        bPassed = bPassed && nResult == 0 && (!bCached || nStatus == nExpectedStatus);
+        return std::chrono::duration<double, std::nano>(oEnd - oStart).count();
+    };
+    auto fnMedian = [](const std::function<double()>& fnRun)
+    {
+        std::vector<double> vecNs;
+        for (int nRepetition = 0; nRepetition < 5; ++nRepetition)
+        {
+            vecNs.push_back(fnRun());
+        }
+        std::sort(vecNs.begin(), vecNs.end());
+        return vecNs[vecNs.size() / 2];
+    };
+
+    roWriter.Write("AddSpiceKernel", "startup", "off", 1, fnMedian([&] { return fnLoad(false, false, 0); }));
+    roWriter.Write("AddSpiceKernelCached", "startup-cache-miss", "off", 1, fnMedian([&] { return fnLoad(true, true, 1); }));
+    roWriter.Write("AddSpiceKernelCached", "startup-cache-hit", "off", 1, fnMedian([&] { return fnLoad(true, false, 0); }));
+    ClearSpiceKernels();
+    return bPassed;
+}
+
+
+
+int main(int argc, char** argv)
+{
+    SConfig oConfig;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string sArg = argv[i];
+        if (sArg == "--work-dir" && i + 1 < argc)
+        {
+            oConfig.m_sWorkDir = argv[++i];
+        }
+        else if (sArg == "--output" && i + 1 < argc)
+        {
+            oConfig.m_sOutput = argv[++i];
+        }
+        else if (sArg == "--quick")
+        {
+            oConfig.m_bQuick = true;
+        }
+        else if (sArg == "--validate")
+        {
+            oConfig.m_bValidate = true;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--work-dir <dir>] [--output <file>] [--quick] [--validate]" << std::endl;
+            return 1;
+        }
+    }
+
+    const std::string sLsk = oConfig.m_sWorkDir + "/synthetic.tls";
+    const std::string sPck = oConfig.m_sWorkDir + "/synthetic.tpc";
+    const std::string sSpk = oConfig.m_sWorkDir + "/synthetic.bsp";
+    const std::string sFk = oConfig.m_sWorkDir + "/synthetic.tf";
+    const std::string sMetaKernel = oConfig.m_sWorkDir + "/synthetic.tm";
+    const std::string sLog = oConfig.m_sWorkDir + "/benchmark.log";
+
+    // The SPK is written with this executable's own copy of CSPICE.
+    WriteLeapsecondsKernel(sLsk);
+    WritePlanetaryConstantsKernel(sPck);
+    WriteFramesKernel(sFk, oConfig.m_bQuick ? 200 : 5000);
+    WriteMetaKernel(sMetaKernel, { sLsk, sPck, sFk, sSpk });
+    SpiceChar szErrorAction[SPICE_ERROR_LMSGLN] = "RETURN";
+    erract_c("SET", SPICE_ERROR_LMSGLN, szErrorAction);
+    furnsh_c(sLsk.c_str());
+    double dStartEt = 0.0;
+    double dEndEt = 0.0;
+    str2et_c(s_pcStartUtc, &dStartEt);
+    str2et_c(s_pcEndUtc, &dEndEt);
+    if (SpiceHasFailed() || !WriteEphemerisKernel(sSpk, dStartEt, dEndEt))
+    {
+        char acMsg[SPICE_ERROR_LMSGLN];
+        getmsg_c("LONG", SPICE_ERROR_LMSGLN, acMsg);
+        std::cerr << "Failed to generate synthetic kernels: " << acMsg << std::endl;
+        return 1;
+    }
+
+    CResultWriter oWriter(oConfig.m_sOutput);
+    if (oConfig.m_bValidate)
+    {
+        Init(false, nullptr, -1, -1);
+        bool bPassed = AddSpiceKernel(sPck.c_str()) == 0 && ValidateGeodeticBackends(oConfig, oWriter);
+        bPassed = ValidateVertexF32(oConfig, oWriter) && bPassed;
+        DeInit();
+        return bPassed ? 0 : 1;
+    }
+
+    for (const SLogConfig& roLog : s_aoLogConfigs)
+    {
+        std::remove(sLog.c_str());
+        InitEx(false, roLog.m_nFileLogLevel >= 0 ? sLog.c_str() : nullptr, -1, roLog.m_nFileLogLevel,
+            roLog.m_nAsyncLogQueueSize, 0);
+
+        // kernel loading is measured once per log configuration
+        auto oStart = std::chrono::steady_clock::now();
+        bool bLoaded = AddSpiceKernel(sLsk.c_str()) == 0 && AddSpiceKernel(sPck.c_str()) == 0 && AddSpiceKernel(sSpk.c_str()) == 0;
+        auto oEnd = std::chrono::steady_clock::now();
+        if (!bLoaded)
+        {
+            std::cerr << "Failed to load synthetic kernels." << std::endl;
+            DeInit();
+            return 1;
+        }
+        oWriter.Write("AddSpiceKernel", "single", roLog.m_pcName, 3,
+            std::chrono::duration<double, std::nano>(oEnd - oStart).count() / 3.0);
+
+        RunBenchmarks(oConfig, roLog, dStartEt, oWriter);
+        DeInit();
+    }
+
+    Init(false, nullptr, -1, -1);
+    bool bStartupPassed = RunStartupBenchmark(oConfig, sMetaKernel, oWriter);
+    DeInit();
+    if (!bStartupPassed)
+    {
+        std::cerr << "Failed to load the synthetic meta-kernel." << std::endl;
+        return 1;
+    }
+    return 0;
+}
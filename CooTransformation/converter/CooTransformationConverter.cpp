@@ -0,0 +1,987 @@
+/** CooTransformationConverter
+* ==========================
+*
+* Converts point files between planet-centered cartesian coordinates (x, y, z in meters) and
+* planetographic coordinates (latitude, longitude in degrees, altitude in meters) with the batch
+* functions Xyz2LatLonAltBatch() and LatLonAlt2XyzBatch().
+*
+* Formats are selected by file extension:
+*     .xyz, .txt  one point per line, values separated by blanks, tabs, commas or semicolons
+*     .csv        like .xyz; the output gets a header line
+*     .ply        binary PLY (little or big endian); vertex properties x/y/z or lat/lon/alt,
+*                 float or double. Output is written as double in native byte order.
+* Columns after the first three values of a line are ignored, as are empty lines, lines starting
+* with '#' and a header line at the start of a text file. Points that cannot be converted are
+* written as NaN.
+*
+* The input is memory-mapped and cut into chunks. Worker threads parse, convert and format the
+* chunks; the main thread writes them in input order. At most two chunks per worker are in flight
+* and written chunks are released from the mapping, so memory use does not depend on the file
+* size. Throughput is reported on stdout when the conversion is finished.
+*
+* Points are converted with the native geodetic backend (--backend 1, see SetGeodeticBackend())
+* unless another one is selected. The SPICE backend (0) holds the SPICE lock for every batch, so
+* the workers then convert one chunk at a time.
+*
+* Usage: CooTransformationConverter --kernel <file> [--kernel <file> ...] --planet <name>
+*            --input <file> --output <file> [--direction xyz2lla|lla2xyz] [--threads <n>]
+*            [--chunk-size <MiB>] [--decimals <n>] [--backend <id>]
+**/
+
+#include <CooTransformation/CooTransformation.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+struct SConfig
+{
+    std::vector<std::string> m_vecKernels;
+    std::string m_sPlanet;
+    std::string m_sInput;
+    std::string m_sOutput;
+    bool m_bToXyz = false;
+    unsigned int m_nThreads = 0;
+    size_t m_nChunkBytes = 16u << 20;
+    int m_nDecimals = -1;               // -1: shortest representation that reads back exactly
+    int m_nBackend = 1;                 // native, fastest backend supported by the CPU
+};
+
+
+enum class EFormat
+{
+    TEXT,
+    CSV,
+    PLY
+};
+
+
+static bool FormatFromPath(const std::string& rsPath, EFormat& reFormat)
+{
+    const size_t nDot = rsPath.find_last_of('.');
+    std::string sExtension = nDot == std::string::npos ? std::string() : rsPath.substr(nDot + 1);
+    std::transform(sExtension.begin(), sExtension.end(), sExtension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (sExtension == "xyz" || sExtension == "txt")
+    {
+        reFormat = EFormat::TEXT;
+    }
+    else if (sExtension == "csv")
+    {
+        reFormat = EFormat::CSV;
+    }
+    else if (sExtension == "ply")
+    {
+        reFormat = EFormat::PLY;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+
+
+/** Read-only mapping of the input file. **/
+class CMappedInput
+{
+public:
+    CMappedInput() = default;
+    CMappedInput(const CMappedInput&) = delete;
+    CMappedInput& operator=(const CMappedInput&) = delete;
+
+    ~CMappedInput()
+    {
+#ifdef _WIN32
+        if (m_pcData)
+        {
+            UnmapViewOfFile(m_pcData);
+        }
+        if (m_hMapping)
+        {
+            CloseHandle(m_hMapping);
+        }
+        if (m_hFile)
+        {
+            CloseHandle(m_hFile);
+        }
+#else
+        if (m_pcData)
+        {
+            munmap(const_cast<char*>(m_pcData), m_nSize);
+        }
+#endif
+    }
+
+    bool Open(const std::string& rsPath)
+    {
+#ifdef _WIN32
+        HANDLE hFile = CreateFileA(rsPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        m_hFile = hFile;
+        LARGE_INTEGER oSize;
+        if (!GetFileSizeEx(hFile, &oSize))
+        {
+            return false;
+        }
+        m_nSize = static_cast<size_t>(oSize.QuadPart);
+        if (m_nSize > 0)
+        {
+            m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            m_pcData = m_hMapping ? static_cast<const char*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        }
+#else
+        const int nFile = open(rsPath.c_str(), O_RDONLY);
+        if (nFile < 0)
+        {
+            return false;
+        }
+        struct stat oStat;
+        if (fstat(nFile, &oStat) == 0)
+        {
+            m_nSize = static_cast<size_t>(oStat.st_size);
+            if (m_nSize > 0)
+            {
+                void* pData = mmap(nullptr, m_nSize, PROT_READ, MAP_PRIVATE, nFile, 0);
+                m_pcData = pData == MAP_FAILED ? nullptr : static_cast<const char*>(pData);
+            }
+        }
+        close(nFile);
+        if (m_pcData)
+        {
+            madvise(const_cast<char*>(m_pcData), m_nSize, MADV_SEQUENTIAL);
+        }
+#endif
+        return m_nSize == 0 || m_pcData;
+    }
+
+    const char* Data() const { return m_pcData; }
+    size_t Size() const { return m_nSize; }
+
+    /** Drop the pages of [0, nEnd) from the process, they are read again from the file if touched. **/
+    void Release(size_t nEnd)
+    {
+#ifndef _WIN32
+        static const size_t s_nPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t nPageEnd = nEnd / s_nPageSize * s_nPageSize;
+        if (m_pcData && nPageEnd > m_nReleased)
+        {
+            madvise(const_cast<char*>(m_pcData) + m_nReleased, nPageEnd - m_nReleased, MADV_DONTNEED);
+            m_nReleased = nPageEnd;
+        }
+#else
+        // Unmodified pages of a read-only view are trimmed from the working set by the system.
+        (void)nEnd;
+#endif
+    }
+
+private:
+    const char* m_pcData = nullptr;
+    size_t m_nSize = 0;
+    size_t m_nReleased = 0;
+#ifdef _WIN32
+    HANDLE m_hFile = nullptr;
+    HANDLE m_hMapping = nullptr;
+#endif
+};
+
+
+
+/** Position of the three coordinates in the vertex records of a binary PLY file. **/
+struct SPlyLayout
+{
+    size_t m_nDataOffset = 0;           // first vertex
+    uint64_t m_nVertices = 0;
+    size_t m_nVertexSize = 0;
+    size_t m_anOffset[3] = {};
+    bool m_abDouble[3] = {};
+    bool m_bSwapBytes = false;
+};
+
+
+static size_t PlyTypeSize(const std::string& rsType)
+{
+    if (rsType == "char" || rsType == "uchar" || rsType == "int8" || rsType == "uint8") return 1;
+    if (rsType == "short" || rsType == "ushort" || rsType == "int16" || rsType == "uint16") return 2;
+    if (rsType == "int" || rsType == "uint" || rsType == "int32" || rsType == "uint32" || rsType == "float" || rsType == "float32") return 4;
+    if (rsType == "double" || rsType == "float64") return 8;
+    return 0;
+}
+
+
+static bool ParsePlyHeader(const char* pcData, size_t nSize, bool bLatLonAlt, SPlyLayout& roLayout, std::string& rsError)
+{
+    const std::string_view sData(pcData, std::min<size_t>(nSize, 64 * 1024));
+    // header lines may end with "\r\n"
+    const size_t nLfEnd = sData.find("end_header\n");
+    const size_t nCrLfEnd = sData.find("end_header\r\n");
+    const bool bCrLf = nCrLfEnd < nLfEnd;
+    const size_t nHeaderEnd = bCrLf ? nCrLfEnd : nLfEnd;
+    if (sData.substr(0, 4) != "ply\n" && sData.substr(0, 5) != "ply\r\n")
+    {
+        rsError = "not a PLY file";
+        return false;
+    }
+    if (nHeaderEnd == std::string_view::npos)
+    {
+        rsError = "PLY header not terminated";
+        return false;
+    }
+    roLayout.m_nDataOffset = nHeaderEnd + std::strlen(bCrLf ? "end_header\r\n" : "end_header\n");
+
+    const char* apcNames[2][3] = { { "x", "y", "z" }, { "lat", "lon", "alt" } };
+    std::istringstream oHeader{ std::string(sData.substr(0, nHeaderEnd)) };
+    std::string sLine;
+    std::string sElement;
+    uint64_t nElementCount = 0;
+    size_t nElementSize = 0;
+    bool bVariableSize = false;
+    bool bVertexDone = false;
+    int anFound[2][3] = { { -1, -1, -1 }, { -1, -1, -1 } };
+    size_t anOffset[2][3] = {};
+    bool abDouble[2][3] = {};
+
+    auto fnFinishElement = [&]() -> bool
+    {
+        if (sElement == "vertex")
+        {
+            if (bVariableSize)
+            {
+                rsError = "PLY vertices with list properties are not supported";
+                return false;
+            }
+            roLayout.m_nVertices = nElementCount;
+            roLayout.m_nVertexSize = nElementSize;
+            bVertexDone = true;
+        }
+        else if (!sElement.empty() && !bVertexDone)
+        {
+            if (bVariableSize)
+            {
+                rsError = "PLY element \"" + sElement + "\" with list properties before the vertices";
+                return false;
+            }
+            roLayout.m_nDataOffset += nElementCount * nElementSize;
+        }
+        return true;
+    };
+
+    while (std::getline(oHeader, sLine))
+    {
+        if (!sLine.empty() && sLine.back() == '\r')
+        {
+            sLine.pop_back();
+        }
+        std::istringstream oLine(sLine);
+        std::string sKeyword;
+        oLine >> sKeyword;
+        if (sKeyword == "format")
+        {
+            std::string sFormat;
+            oLine >> sFormat;
+            const bool bBigEndian = sFormat == "binary_big_endian";
+            if (!bBigEndian && sFormat != "binary_little_endian")
+            {
+                rsError = "PLY format \"" + sFormat + "\" is not supported, only binary PLY";
+                return false;
+            }
+            roLayout.m_bSwapBytes = bBigEndian != (std::endian::native == std::endian::big);
+        }
+        else if (sKeyword == "element")
+        {
+            if (!fnFinishElement())
+            {
+                return false;
+            }
+            oLine >> sElement >> nElementCount;
+            nElementSize = 0;
+            bVariableSize = false;
+        }
+        else if (sKeyword == "property")
+        {
+            std::string sType;
+            std::string sName;
+            oLine >> sType >> sName;
+            if (sType == "list")
+            {
+                bVariableSize = true;
+                continue;
+            }
+            const size_t nTypeSize = PlyTypeSize(sType);
+            if (nTypeSize == 0)
+            {
+                rsError = "unknown PLY property type \"" + sType + "\"";
+                return false;
+            }
+            if (sElement == "vertex")
+            {
+                for (int nSet = 0; nSet < 2; ++nSet)
+                {
+                    for (int j = 0; j < 3; ++j)
+                    {
+                        if (sName == apcNames[nSet][j] && (nTypeSize == 4 || nTypeSize == 8) && sType.find("int") == std::string::npos)
+                        {
+                            anFound[nSet][j] = 1;
+                            anOffset[nSet][j] = nElementSize;
+                            abDouble[nSet][j] = nTypeSize == 8;
+                        }
+                    }
+                }
+            }
+            nElementSize += nTypeSize;
+        }
+    }
+    if (!fnFinishElement())
+    {
+        return false;
+    }
+    if (!bVertexDone)
+    {
+        rsError = "PLY file has no vertex element";
+        return false;
+    }
+
+    // lat/lon/alt input may also be stored as x/y/z
+    const int nPreferred = bLatLonAlt ? 1 : 0;
+    for (int nSet : { nPreferred, 0 })
+    {
+        if (anFound[nSet][0] > 0 && anFound[nSet][1] > 0 && anFound[nSet][2] > 0)
+        {
+            std::copy(anOffset[nSet], anOffset[nSet] + 3, roLayout.m_anOffset);
+            std::copy(abDouble[nSet], abDouble[nSet] + 3, roLayout.m_abDouble);
+            if (roLayout.m_nDataOffset > nSize || roLayout.m_nVertices > (nSize - roLayout.m_nDataOffset) / roLayout.m_nVertexSize)
+            {
+                rsError = "PLY file is truncated";
+                return false;
+            }
+            return true;
+        }
+    }
+    rsError = std::string("PLY vertices have no float or double properties ") + apcNames[nPreferred][0] + "/"
+        + apcNames[nPreferred][1] + "/" + apcNames[nPreferred][2];
+    return false;
+}
+
+
+template <typename T>
+static T ReadValue(const char* pcData, bool bSwapBytes)
+{
+    char acBytes[sizeof(T)];
+    std::memcpy(acBytes, pcData, sizeof(T));
+    if (bSwapBytes)
+    {
+        std::reverse(acBytes, acBytes + sizeof(T));
+    }
+    return std::bit_cast<T>(acBytes);
+}
+
+
+
+/** Input to the pipeline: chunk boundaries and parsing. **/
+class CPointReader
+{
+public:
+    CPointReader(const CMappedInput& roInput, EFormat eFormat, const SPlyLayout& roLayout, size_t nChunkBytes)
+        : m_roInput(roInput), m_eFormat(eFormat), m_oLayout(roLayout)
+    {
+        if (m_eFormat == EFormat::PLY)
+        {
+            m_nChunkPoints = std::max<size_t>(1, nChunkBytes / std::max<size_t>(1, m_oLayout.m_nVertexSize));
+            m_nChunks = static_cast<size_t>((m_oLayout.m_nVertices + m_nChunkPoints - 1) / m_nChunkPoints);
+        }
+        else
+        {
+            m_nChunkBytes = nChunkBytes;
+            m_nChunks = (m_roInput.Size() + m_nChunkBytes - 1) / m_nChunkBytes;
+        }
+    }
+
+    size_t ChunkCount() const { return m_nChunks; }
+
+    /** Byte offset in the input after chunk nChunk. **/
+    size_t ChunkEnd(size_t nChunk) const
+    {
+        if (m_eFormat == EFormat::PLY)
+        {
+            const uint64_t nEnd = std::min<uint64_t>((nChunk + 1) * m_nChunkPoints, m_oLayout.m_nVertices);
+            return m_oLayout.m_nDataOffset + static_cast<size_t>(nEnd) * m_oLayout.m_nVertexSize;
+        }
+        return LineStart((nChunk + 1) * m_nChunkBytes);
+    }
+
+    /** Appends the points of chunk nChunk to rvecPoints (3 values per point). **/
+    bool Read(size_t nChunk, std::vector<double>& rvecPoints, std::string& rsError) const
+    {
+        rvecPoints.clear();
+        if (m_eFormat == EFormat::PLY)
+        {
+            const uint64_t nBegin = nChunk * m_nChunkPoints;
+            const uint64_t nEnd = std::min<uint64_t>(nBegin + m_nChunkPoints, m_oLayout.m_nVertices);
+            rvecPoints.resize(static_cast<size_t>(nEnd - nBegin) * 3);
+            const char* pcVertex = m_roInput.Data() + m_oLayout.m_nDataOffset + nBegin * m_oLayout.m_nVertexSize;
+            for (size_t i = 0; i < nEnd - nBegin; ++i, pcVertex += m_oLayout.m_nVertexSize)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    const char* pcValue = pcVertex + m_oLayout.m_anOffset[j];
+                    rvecPoints[3 * i + j] = m_oLayout.m_abDouble[j] ? ReadValue<double>(pcValue, m_oLayout.m_bSwapBytes)
+                        : static_cast<double>(ReadValue<float>(pcValue, m_oLayout.m_bSwapBytes));
+                }
+            }
+            return true;
+        }
+
+        const char* pcData = m_roInput.Data();
+        size_t nPos = LineStart(nChunk * m_nChunkBytes);
+        const size_t nEnd = LineStart((nChunk + 1) * m_nChunkBytes);
+        bool bFirstLine = nPos == 0;
+        while (nPos < nEnd)
+        {
+            const char* pcNewline = static_cast<const char*>(std::memchr(pcData + nPos, '\n', nEnd - nPos));
+            const size_t nLineEnd = pcNewline ? static_cast<size_t>(pcNewline - pcData) : nEnd;
+            double adValues[3];
+            switch (ParseLine(pcData + nPos, pcData + nLineEnd, adValues))
+            {
+            case LINE_POINT:
+                rvecPoints.insert(rvecPoints.end(), adValues, adValues + 3);
+                break;
+            case LINE_EMPTY:
+                nPos = nLineEnd + 1;
+                continue;
+            case LINE_INVALID:
+                // a header line is only accepted before the first point
+                if (!bFirstLine)
+                {
+                    rsError = "invalid line at byte offset " + std::to_string(nPos);
+                    return false;
+                }
+                break;
+            }
+            bFirstLine = false;
+            nPos = nLineEnd + 1;
+        }
+        return true;
+    }
+
+private:
+    enum ELine
+    {
+        LINE_POINT,
+        LINE_EMPTY,
+        LINE_INVALID
+    };
+
+    /** First line start at or after nPos; a chunk owns the lines that start inside it. **/
+    size_t LineStart(size_t nPos) const
+    {
+        const size_t nSize = m_roInput.Size();
+        if (nPos == 0 || nPos >= nSize)
+        {
+            return std::min(nPos, nSize);
+        }
+        const void* pNewline = std::memchr(m_roInput.Data() + nPos - 1, '\n', nSize - nPos + 1);
+        return pNewline ? static_cast<size_t>(static_cast<const char*>(pNewline) - m_roInput.Data()) + 1 : nSize;
+    }
+
+    static bool IsSeparator(char c)
+    {
+        return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+    }
+
+    static ELine ParseLine(const char* pcBegin, const char* pcEnd, double* pdValues)
+    {
+        while (pcBegin < pcEnd && (*pcBegin == ' ' || *pcBegin == '\t' || *pcBegin == '\r'))
+        {
+            ++pcBegin;
+        }
+        if (pcBegin == pcEnd || *pcBegin == '#')
+        {
+            return LINE_EMPTY;
+        }
+        for (int j = 0; j < 3; ++j)
+        {
+            while (pcBegin < pcEnd && IsSeparator(*pcBegin))
+            {
+                ++pcBegin;
+            }
+            if (pcBegin < pcEnd && *pcBegin == '+')
+            {
+                ++pcBegin;
+            }
+            const std::from_chars_result oResult = std::from_chars(pcBegin, pcEnd, pdValues[j]);
+            if (oResult.ec != std::errc() || (oResult.ptr < pcEnd && !IsSeparator(*oResult.ptr)))
+            {
+                return LINE_INVALID;
+            }
+            pcBegin = oResult.ptr;
+        }
+        return LINE_POINT;
+    }
+
+    const CMappedInput& m_roInput;
+    EFormat m_eFormat;
+    SPlyLayout m_oLayout;
+    size_t m_nChunks = 0;
+    size_t m_nChunkBytes = 0;           // text formats
+    size_t m_nChunkPoints = 0;          // PLY
+};
+
+
+
+/** Output of the pipeline: header, formatting and the vertex count of PLY files. **/
+class CPointWriter
+{
+public:
+    CPointWriter(EFormat eFormat, bool bLatLonAlt, int nDecimals) : m_eFormat(eFormat), m_bLatLonAlt(bLatLonAlt), m_nDecimals(nDecimals) {}
+
+    ~CPointWriter()
+    {
+        if (m_poFile)
+        {
+            std::fclose(m_poFile);
+        }
+    }
+
+    bool Open(const std::string& rsPath)
+    {
+        m_poFile = std::fopen(rsPath.c_str(), "wb");
+        if (!m_poFile)
+        {
+            return false;
+        }
+        std::setvbuf(m_poFile, nullptr, _IOFBF, 1 << 20);
+        const char* apcNames[3] = { m_bLatLonAlt ? "lat" : "x", m_bLatLonAlt ? "lon" : "y", m_bLatLonAlt ? "alt" : "z" };
+        std::string sHeader;
+        if (m_eFormat == EFormat::CSV)
+        {
+            sHeader = std::string(apcNames[0]) + "," + apcNames[1] + "," + apcNames[2] + "\n";
+        }
+        else if (m_eFormat == EFormat::PLY)
+        {
+            sHeader = std::string("ply\nformat ") + (std::endian::native == std::endian::big ? "binary_big_endian" : "binary_little_endian")
+                + " 1.0\ncomment written by CooTransformationConverter\nelement vertex ";
+            // fixed width, the count is known after the last chunk
+            m_nCountOffset = sHeader.size();
+            sHeader += std::string(20, '0') + "\n";
+            for (const char* pcName : apcNames)
+            {
+                sHeader += std::string("property double ") + pcName + "\n";
+            }
+            sHeader += "end_header\n";
+        }
+        return std::fwrite(sHeader.data(), 1, sHeader.size(), m_poFile) == sHeader.size();
+    }
+
+    /** Formats nPoints points (3 values each) into rvecBuffer; called on the worker threads. **/
+    void Format(const double* pdPoints, size_t nPoints, std::vector<char>& rvecBuffer) const
+    {
+        if (m_eFormat == EFormat::PLY)
+        {
+            const char* pcPoints = reinterpret_cast<const char*>(pdPoints);
+            rvecBuffer.assign(pcPoints, pcPoints + nPoints * 3 * sizeof(double));
+            return;
+        }
+        const char cSeparator = m_eFormat == EFormat::CSV ? ',' : ' ';
+        // shortest form needs at most 24 characters, fixed form up to 310 digits before the point
+        const size_t nMaxValue = m_nDecimals < 0 ? 25 : 312 + static_cast<size_t>(m_nDecimals);
+        rvecBuffer.resize(nPoints * 3 * 32 + nMaxValue);
+        char* pcOut = rvecBuffer.data();
+        for (size_t i = 0; i < 3 * nPoints; ++i)
+        {
+            if (static_cast<size_t>(rvecBuffer.data() + rvecBuffer.size() - pcOut) < nMaxValue)
+            {
+                const size_t nUsed = pcOut - rvecBuffer.data();
+                rvecBuffer.resize(rvecBuffer.size() * 2 + 512);
+                pcOut = rvecBuffer.data() + nUsed;
+            }
+            char* pcLimit = rvecBuffer.data() + rvecBuffer.size();
+            const std::to_chars_result oResult = m_nDecimals < 0 ? std::to_chars(pcOut, pcLimit, pdPoints[i])
+                : std::to_chars(pcOut, pcLimit, pdPoints[i], std::chars_format::fixed, m_nDecimals);
+            pcOut = oResult.ptr;
+            *pcOut++ = i % 3 == 2 ? '\n' : cSeparator;
+        }
+        rvecBuffer.resize(pcOut - rvecBuffer.data());
+    }
+
+    bool Write(const std::vector<char>& rvecBuffer, size_t nPoints)
+    {
+        m_nPoints += nPoints;
+        return std::fwrite(rvecBuffer.data(), 1, rvecBuffer.size(), m_poFile) == rvecBuffer.size();
+    }
+
+    bool Close()
+    {
+        bool bSuccess = true;
+        if (m_eFormat == EFormat::PLY)
+        {
+            char acCount[21];
+            std::snprintf(acCount, sizeof(acCount), "%020llu", static_cast<unsigned long long>(m_nPoints));
+            bSuccess = std::fseek(m_poFile, static_cast<long>(m_nCountOffset), SEEK_SET) == 0 && std::fwrite(acCount, 1, 20, m_poFile) == 20;
+        }
+        bSuccess = std::fclose(m_poFile) == 0 && bSuccess;
+        m_poFile = nullptr;
+        return bSuccess;
+    }
+
+private:
+    EFormat m_eFormat;
+    bool m_bLatLonAlt;
+    int m_nDecimals;
+    std::FILE* m_poFile = nullptr;
+    size_t m_nCountOffset = 0;
+    uint64_t m_nPoints = 0;
+};
+
+
+
+/** Buffers of one chunk in flight. **/
+struct SChunkSlot
+{
+    size_t m_nChunk = 0;
+    bool m_bReady = false;
+    std::vector<double> m_vecIn;
+    std::vector<double> m_vecOut;
+    std::vector<int> m_vecStatus;
+    std::vector<char> m_vecText;
+    size_t m_nPoints = 0;
+    size_t m_nFailed = 0;
+    std::string m_sError;
+};
+
+
+struct SResult
+{
+    uint64_t m_nPoints = 0;
+    uint64_t m_nFailed = 0;
+    size_t m_nBufferBytes = 0;
+};
+
+
+static void ConvertChunk(const SConfig& roConfig, const CPointReader& roReader, const CPointWriter& roWriter, SChunkSlot& roSlot)
+{
+    roSlot.m_sError.clear();
+    roSlot.m_nFailed = 0;
+    if (!roReader.Read(roSlot.m_nChunk, roSlot.m_vecIn, roSlot.m_sError))
+    {
+        return;
+    }
+    roSlot.m_nPoints = roSlot.m_vecIn.size() / 3;
+    roSlot.m_vecOut.resize(roSlot.m_vecIn.size());
+    roSlot.m_vecStatus.resize(roSlot.m_nPoints);
+    const unsigned int nCount = static_cast<unsigned int>(roSlot.m_nPoints);
+    const double* pdIn = roSlot.m_vecIn.data();
+    double* pdOut = roSlot.m_vecOut.data();
+    const int nResult = roConfig.m_bToXyz
+        ? LatLonAlt2XyzBatch(roConfig.m_sPlanet.c_str(), nCount, pdIn, pdIn + 1, pdIn + 2, 3, pdOut, pdOut + 1, pdOut + 2, 3, roSlot.m_vecStatus.data())
+        : Xyz2LatLonAltBatch(roConfig.m_sPlanet.c_str(), nCount, pdIn, pdIn + 1, pdIn + 2, 3, pdOut, pdOut + 1, pdOut + 2, 3, roSlot.m_vecStatus.data());
+    if (nResult == -2)
+    {
+        roSlot.m_sError = "failed to lookup radii of \"" + roConfig.m_sPlanet + "\"";
+        return;
+    }
+    if (nResult == -3)
+    {
+        for (size_t i = 0; i < roSlot.m_nPoints; ++i)
+        {
+            if (roSlot.m_vecStatus[i] != 0)
+            {
+                std::fill(pdOut + 3 * i, pdOut + 3 * i + 3, std::numeric_limits<double>::quiet_NaN());
+                ++roSlot.m_nFailed;
+            }
+        }
+    }
+    else if (nResult != 0)
+    {
+        roSlot.m_sError = "conversion failed with code " + std::to_string(nResult);
+        return;
+    }
+    roWriter.Format(pdOut, roSlot.m_nPoints, roSlot.m_vecText);
+}
+
+
+/** Worker threads convert chunks into a ring of 2 * nThreads slots; the calling thread writes
+  * the slots in chunk order. A chunk is only started when its slot has been written, which
+  * bounds the memory in use.
+  **/
+static bool RunPipeline(const SConfig& roConfig, CMappedInput& roInput, const CPointReader& roReader, CPointWriter& roWriter, SResult& roResult)
+{
+    const unsigned int nThreads = roConfig.m_nThreads > 0 ? roConfig.m_nThreads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t nChunks = roReader.ChunkCount();
+    std::vector<SChunkSlot> vecSlots(2 * static_cast<size_t>(nThreads));
+    std::mutex oMutex;
+    std::condition_variable oCondition;
+    size_t nNextChunk = 0;
+    size_t nWritten = 0;
+    bool bStop = false;
+
+    std::vector<std::thread> vecWorkers;
+    for (unsigned int t = 0; t < nThreads; ++t)
+    {
+        vecWorkers.emplace_back([&]()
+        {
+            for (;;)
+            {
+                SChunkSlot* poSlot = nullptr;
+                {
+                    std::unique_lock<std::mutex> oLock(oMutex);
+                    oCondition.wait(oLock, [&]() { return bStop || nNextChunk >= nChunks || nNextChunk < nWritten + vecSlots.size(); });
+                    if (bStop || nNextChunk >= nChunks)
+                    {
+                        return;
+                    }
+                    poSlot = &vecSlots[nNextChunk % vecSlots.size()];
+                    poSlot->m_nChunk = nNextChunk++;
+                }
+                ConvertChunk(roConfig, roReader, roWriter, *poSlot);
+                {
+                    std::lock_guard<std::mutex> oLock(oMutex);
+                    poSlot->m_bReady = true;
+                }
+                oCondition.notify_all();
+            }
+        });
+    }
+
+    bool bSuccess = true;
+    for (size_t nChunk = 0; nChunk < nChunks; ++nChunk)
+    {
+        SChunkSlot& roSlot = vecSlots[nChunk % vecSlots.size()];
+        {
+            std::unique_lock<std::mutex> oLock(oMutex);
+            oCondition.wait(oLock, [&]() { return roSlot.m_bReady; });
+        }
+        if (!roSlot.m_sError.empty())
+        {
+            std::cerr << "Error: " << roSlot.m_sError << "." << std::endl;
+            bSuccess = false;
+        }
+        else if (!roWriter.Write(roSlot.m_vecText, roSlot.m_nPoints))
+        {
+            std::cerr << "Error: failed to write \"" << roConfig.m_sOutput << "\"." << std::endl;
+            bSuccess = false;
+        }
+        roResult.m_nPoints += roSlot.m_nPoints;
+        roResult.m_nFailed += roSlot.m_nFailed;
+        roInput.Release(roReader.ChunkEnd(nChunk));
+        {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            roSlot.m_bReady = false;
+            ++nWritten;
+            bStop = !bSuccess;
+        }
+        oCondition.notify_all();
+        if (!bSuccess)
+        {
+            break;
+        }
+    }
+    for (std::thread& roWorker : vecWorkers)
+    {
+        roWorker.join();
+    }
+    for (const SChunkSlot& roSlot : vecSlots)
+    {
+        roResult.m_nBufferBytes += roSlot.m_vecIn.capacity() * sizeof(double) + roSlot.m_vecOut.capacity() * sizeof(double)
+            + roSlot.m_vecStatus.capacity() * sizeof(int) + roSlot.m_vecText.capacity();
+    }
+    return bSuccess;
+}
+
+
+
+template <typename T>
+static bool ParseNumber(const char* pcValue, T& rValue)
+{
+    const char* pcEnd = pcValue + std::strlen(pcValue);
+    const std::from_chars_result oResult = std::from_chars(pcValue, pcEnd, rValue);
+    return oResult.ec == std::errc() && oResult.ptr == pcEnd;
+}
+
+
+static bool ParseArguments(int argc, char** argv, SConfig& roConfig)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string sArg = argv[i];
+        const bool bHasValue = i + 1 < argc;
+        if (sArg == "--kernel" && bHasValue)
+        {
+            roConfig.m_vecKernels.push_back(argv[++i]);
+        }
+        else if (sArg == "--planet" && bHasValue)
+        {
+            roConfig.m_sPlanet = argv[++i];
+        }
+        else if (sArg == "--input" && bHasValue)
+        {
+            roConfig.m_sInput = argv[++i];
+        }
+        else if (sArg == "--output" && bHasValue)
+        {
+            roConfig.m_sOutput = argv[++i];
+        }
+        else if (sArg == "--direction" && bHasValue)
+        {
+            const std::string sDirection = argv[++i];
+            if (sDirection != "xyz2lla" && sDirection != "lla2xyz")
+            {
+                return false;
+            }
+            roConfig.m_bToXyz = sDirection == "lla2xyz";
+        }
+        else if (sArg == "--threads" && bHasValue)
+        {
+            if (!ParseNumber(argv[++i], roConfig.m_nThreads))
+            {
+                return false;
+            }
+        }
+        else if (sArg == "--chunk-size" && bHasValue)
+        {
+            // at most 1 GiB keeps the point count of a chunk below 2^32
+            size_t nChunkMiB = 0;
+            if (!ParseNumber(argv[++i], nChunkMiB))
+            {
+                return false;
+            }
+            roConfig.m_nChunkBytes = std::clamp<size_t>(nChunkMiB, 1, 1024) << 20;
+        }
+        else if (sArg == "--decimals" && bHasValue)
+        {
+            int nDecimals = 0;
+            if (!ParseNumber(argv[++i], nDecimals))
+            {
+                return false;
+            }
+            roConfig.m_nDecimals = std::clamp(nDecimals, 0, 17);
+        }
+        else if (sArg == "--backend" && bHasValue)
+        {
+            if (!ParseNumber(argv[++i], roConfig.m_nBackend))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return !roConfig.m_sPlanet.empty() && !roConfig.m_sInput.empty() && !roConfig.m_sOutput.empty();
+}
+
+
+int main(int argc, char** argv)
+{
+    SConfig oConfig;
+    if (!ParseArguments(argc, argv, oConfig))
+    {
+        std::cerr << "Usage: " << argv[0] << " --kernel <file> [--kernel <file> ...] --planet <name> --input <file> --output <file>\n"
+            "           [--direction xyz2lla|lla2xyz] [--threads <n>] [--chunk-size <MiB>] [--decimals <n>] [--backend <id>]" << std::endl;
+        return 1;
+    }
+    EFormat eInputFormat;
+    EFormat eOutputFormat;
+    if (!FormatFromPath(oConfig.m_sInput, eInputFormat) || !FormatFromPath(oConfig.m_sOutput, eOutputFormat))
+    {
+        std::cerr << "Error: unknown file extension, supported are .xyz, .txt, .csv and .ply." << std::endl;
+        return 1;
+    }
+
+    Init(false, nullptr, -1, -1);
+    for (const std::string& rsKernel : oConfig.m_vecKernels)
+    {
+        if (AddSpiceKernel(rsKernel.c_str()) != 0)
+        {
+            std::cerr << "Error: failed to load SPICE kernel \"" << rsKernel << "\"." << std::endl;
+            DeInit();
+            return 1;
+        }
+    }
+    if (SetGeodeticBackend(oConfig.m_nBackend) != 0)
+    {
+        std::cerr << "Error: geodetic backend " << oConfig.m_nBackend << " is not available." << std::endl;
+        DeInit();
+        return 1;
+    }
+
+    const auto oStart = std::chrono::steady_clock::now();
+    CMappedInput oInput;
+    SPlyLayout oLayout;
+    std::string sError;
+    bool bSuccess = oInput.Open(oConfig.m_sInput);
+    if (!bSuccess)
+    {
+        std::cerr << "Error: failed to open \"" << oConfig.m_sInput << "\"." << std::endl;
+    }
+    else if (eInputFormat == EFormat::PLY && !ParsePlyHeader(oInput.Data(), oInput.Size(), oConfig.m_bToXyz, oLayout, sError))
+    {
+        std::cerr << "Error: " << sError << "." << std::endl;
+        bSuccess = false;
+    }
+
+    SResult oResult;
+    if (bSuccess)
+    {
+        const CPointReader oReader(oInput, eInputFormat, oLayout, oConfig.m_nChunkBytes);
+        CPointWriter oWriter(eOutputFormat, !oConfig.m_bToXyz, oConfig.m_nDecimals);
+        if (!oWriter.Open(oConfig.m_sOutput))
+        {
+            std::cerr << "Error: failed to create \"" << oConfig.m_sOutput << "\"." << std::endl;
+            bSuccess = false;
+        }
+        else
+        {
+            bSuccess = RunPipeline(oConfig, oInput, oReader, oWriter, oResult);
+            if (!oWriter.Close() && bSuccess)
+            {
+                std::cerr << "Error: failed to write \"" << oConfig.m_sOutput << "\"." << std::endl;
+                bSuccess = false;
+            }
+        }
+    }
+    const double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - oStart).count();
+    DeInit();
+    if (!bSuccess)
+    {
+        return 1;
+    }
+
+    char acLine[512];
+    std::snprintf(acLine, sizeof(acLine),
+        "{\"points\": %llu, \"failed\": %llu, \"input_bytes\": %zu, \"seconds\": %.4f, \"points_per_sec\": %.1f, \"mib_per_sec\": %.1f, \"buffer_bytes\": %zu}",
+        static_cast<unsigned long long>(oResult.m_nPoints), static_cast<unsigned long long>(oResult.m_nFailed), oInput.Size(), dSeconds,
+        dSeconds > 0.0 ? oResult.m_nPoints / dSeconds : 0.0, dSeconds > 0.0 ? oInput.Size() / dSeconds / (1 << 20) : 0.0, oResult.m_nBufferBytes);
+    std::cout << acLine << std::endl;
+    return 0;
+}
@@ -11,10 +11,106 @@
 *   - baseline
 * 5:
     - introduced error code -1 (=illegal nullptr arguments) for most functions.
+* 6:
+    - added batch conversion functions Xyz2LatLonRadBatch(), Xyz2LatLonAltBatch() and LatLonAlt2XyzBatch().
+* 7:
+    - body radii are cached until the next AddSpiceKernel() call.
+    - added GetBodyRadiiCacheStats() and ResetBodyRadiiCacheStats().
+* 8:
+    - added Datetime2Et() and GetRelStateSeries().
+* 9:
+    - added CreateEphemerisCache() and DestroyEphemerisCache().
+* 10:
+    - all functions are thread-safe. Calls into SPICE are serialized; concurrent single-point
+      conversions (Xyz2LatLonRad(), Xyz2LatLonAlt(), LatLonAlt2Xyz()) are coalesced into batches.
+* 11:
+    - added InitEx() with asynchronous file logging.
+* 12:
+    - added GetStats() and ResetStats().
+* 13:
+    - added SetGeodeticBackend() and GetGeodeticBackend() with native (scalar, AVX2, AVX-512)
+      spherical-model conversions for Xyz2LatLonAlt(), LatLonAlt2Xyz() and their batch versions.
+* 14:
+    - GetPositionTransformationMatrix() returns -3 if SPICE cannot compute the rotation.
+    - rotation matrices are cached per frame pair and epoch (LRU) until the next AddSpiceKernel() call.
+    - added GetPositionTransformationMatrixSeries(), SetFrameRotationCacheSize(),
+      GetFrameRotationCacheStats() and ResetFrameRotationCacheStats().
+* 15:
+    - added body and frame handles: GetBodyHandle(), GetFrameHandle(), Xyz2LatLonAltByHandle(),
+      LatLonAlt2XyzByHandle(), GetRelStateByHandle() and GetPositionTransformationMatrixByHandle().
+      Functions taking handles return -5 for invalid handles and handles created before the last
+      AddSpiceKernel() call.
+    - frame rotations are cached per frame code instead of per frame name.
+* 16:
+    - added AddSpiceKernelCached() with a binary kernel pool cache, and ClearSpiceKernels().
+* 17:
+    - loaded SPK and CK kernels are indexed by coverage. GetRelState(), GetRelStateSeries(),
+      GetRelStateByHandle() and the GetPositionTransformationMatrix() functions return -6 for
+      epochs outside the coverage without calling SPICE.
+    - added GetCoverageWindows().
+* 18:
+    - added LatLonGrid2Xyz() and LatLonGrid2XyzTiled() for DEM rasters.
+* 19:
+    - added GetIlluminationAngles() for surface points over a series of epochs.
+* 20:
+    - added GetRelStateMulti() for several targets at the same observer time.
+* 21:
+    - added LatLonAlt2XyzBatchF32() and LatLonGrid2XyzF32() writing float vertices relative to
+      a center into interleaved vertex buffers, and GetVertexF32ErrorBound().
 */
 
 extern "C"
 {
+    /**
+     * Entry points covered by GetStats().
+     * STATS_STR2ET counts every datetime conversion, including the ones done by
+     * GetRelState(), GetRelStateMulti(), GetRelStateSeries() and GetPositionTransformationMatrix().
+     */
+    enum EStatsFunction
+    {
+        STATS_XYZ2LATLONRAD = 0,
+        STATS_XYZ2LATLONALT = 1,
+        STATS_LATLONALT2XYZ = 2,
+        STATS_XYZ2LATLONRADBATCH = 3,
+        STATS_XYZ2LATLONALTBATCH = 4,
+        STATS_LATLONALT2XYZBATCH = 5,
+        STATS_GETRELSTATE = 6,
+        STATS_GETRELSTATESERIES = 7,
+        STATS_GETPOSITIONTRANSFORMATIONMATRIX = 8,
+        STATS_ADDSPICEKERNEL = 9,
+        STATS_STR2ET = 10,
+        STATS_GETPOSITIONTRANSFORMATIONMATRIXSERIES = 11,
+        STATS_XYZ2LATLONALTBYHANDLE = 12,
+        STATS_LATLONALT2XYZBYHANDLE = 13,
+        STATS_GETRELSTATEBYHANDLE = 14,
+        STATS_GETPOSITIONTRANSFORMATIONMATRIXBYHANDLE = 15,
+        STATS_ADDSPICEKERNELCACHED = 16,
+        STATS_LATLONGRID2XYZ = 17,
+        STATS_LATLONGRID2XYZTILED = 18,
+        STATS_GETILLUMINATIONANGLES = 19,
+        STATS_GETRELSTATEMULTI = 20,
+        STATS_LATLONALT2XYZBATCHF32 = 21,
+        STATS_LATLONGRID2XYZF32 = 22,
+        STATS_FUNCTION_COUNT = 23
+    };
+
+    enum
+    {
+        STATS_RESULT_CODES = 8,
+        STATS_LATENCY_BUCKETS = 32
+    };
+
+    /**
+     * Call statistics of one entry point (see GetStats()).
+     */
+    struct SFunctionStats
+    {
+        unsigned long long m_nCalls;                                /* number of calls */
+        unsigned long long m_nTotalNs;                              /* sum of all call latencies in nanoseconds */
+        unsigned long long m_anResults[STATS_RESULT_CODES];         /* [i]: calls that returned -i, [7]: calls that returned any other code */
+        unsigned long long m_anLatencyNs[STATS_LATENCY_BUCKETS];    /* [i]: calls that took [2^i, 2^(i+1)) ns, [31]: calls that took longer */
+    };
+
     /**
      * @brief Get API version.
      *
@@ -45,8 +141,31 @@ extern "C"
     JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
     int Init(bool bConsoleLog, const char *pcLogFile, int nConsoleLogLevel, int nFileLogLevel);
 
+    /**
+     * @brief Init logging with optional asynchronous file logging.
+     *
+     * Same as Init(), but if nAsyncLogQueueSize is not 0, log file records are formatted by the
+     * calling thread, queued in a bounded lock-free ring and written in batches by a background
+     * thread. DeInit() writes all queued records before closing the file.
+     * Overflow policies:
+     * 0: Drop records while the queue is full. The number of dropped records is written to the log file.
+     * 1: Block the calling thread until the writer has made room.
+     * @param[in] bConsoleLog               Enable or disable logging to stderr.
+     * @param[in] pcLogFile                 Optional path to log file. Can be NULL.
+     * @param[in] nConsoleLogLevel          Console log level value [0, 5].
+     * @param[in] nFileLogLevel             File log level value [0, 5].
+     * @param[in] nAsyncLogQueueSize        Number of queued log records (rounded up to a power of two). 0 writes synchronously.
+     * @param[in] nAsyncLogOverflowPolicy   Overflow policy [0, 1].
+     * @return
+     *  0   Success
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int InitEx(bool bConsoleLog, const char *pcLogFile, int nConsoleLogLevel, int nFileLogLevel, unsigned int nAsyncLogQueueSize, int nAsyncLogOverflowPolicy);
+
     /**
      * @brief Flush log messages and close the log file.
+     *
+     * Stops the asynchronous log writer (see InitEx()) after it has written all queued records.
      */
     JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
     void DeInit();
@@ -54,6 +173,8 @@ extern "C"
     /**
      * @brief Load an additional SPICE kernel.
      *
+     * Invalidates all cached body radii, frame rotations and datetime conversions, all body and
+     * frame handles and drops all ephemeris caches.
      * @param[in] pcSpiceKernelFile Path to a SPICE kernel file. This can be a meta-kernel file as well.
      * @return
      *  0   Success
@@ -63,6 +184,143 @@ extern "C"
     JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
     int AddSpiceKernel(const char *pcSpiceKernelFile);
 
+    /**
+     * @brief Load an additional SPICE kernel through a binary kernel pool cache.
+     *
+     * Same as AddSpiceKernel(), but the kernel pool variables set by the (meta-)kernel are written
+     * to a cache file in pcCacheDir. Later calls restore them from that file instead of parsing
+     * the text kernels again; binary kernels (SPK, CK, ...) are still loaded with furnsh_c().
+     * The cache file is only used if the kernel file, all text kernels it loads and the kernel
+     * pool before the call are unchanged, otherwise it is rebuilt. Restored text kernels are not
+     * listed by the SPICE kernel database (ktotal_c(), kdata_c()).
+     * The load time is logged with log level INFO in both cases.
+     * Cache states:
+     * 0: Restored from the cache file
+     * 1: Loaded by SPICE, cache file written
+     * 2: Loaded by SPICE, cache file could not be written
+     * @param[in]  pcSpiceKernelFile    Path to a SPICE kernel file. This can be a meta-kernel file as well.
+     * @param[in]  pcCacheDir           Existing directory for cache files.
+     * @param[out] pnCacheStatus        Optional cache state. Can be NULL.
+     * @return
+     *  0   Success
+     *  -1  Failed to run function. pcSpiceKernelFile and pcCacheDir must not be NULL.
+     *  -2  Failed to load the kernel
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int AddSpiceKernelCached(const char *pcSpiceKernelFile, const char *pcCacheDir, int *pnCacheStatus);
+
+    /**
+     * @brief Unload all SPICE kernels and clear the kernel pool.
+     *
+     * Invalidates the same caches and handles as AddSpiceKernel().
+     * @return
+     *  0   Success
+     *  -2  Failed to clear the kernels
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int ClearSpiceKernels();
+
+    /**
+     * @brief Get the time windows covered by the loaded SPK or CK kernels.
+     *
+     * Every kernel load indexes the coverage of new SPK files per body (spkcov_c()) and of new CK
+     * files per CK structure (ckcov_c(), interpolation intervals; requires the SCLK and LSK
+     * kernels, CK files loaded before them are indexed by a later load). If a file cannot be
+     * indexed otherwise, a warning is logged and the epoch checks of its kind are left to SPICE.
+     * A body or frame without windows has no data of its own; SPICE may still derive it (e.g. the
+     * solar system barycenter).
+     * Kinds:
+     * 0: SPK coverage of a body
+     * 1: CK coverage of a CK-based frame
+     * @param[in]   nKind       Coverage kind [0, 1].
+     * @param[in]   pcName      Case-insensitive name of the body or frame.
+     * @param[out]  pdWindows   Up to nMaxWindows pairs of start and end ephemeris time, sorted and disjoint. Can be NULL if nMaxWindows is 0.
+     * @param[in]   nMaxWindows Capacity of pdWindows in windows.
+     * @param[out]  pnWindows   Total number of windows, may exceed nMaxWindows.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown kind, body or frame
+     * -3   The frame is not CK-based
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetCoverageWindows(int nKind, const char *pcName, double *pdWindows, unsigned int nMaxWindows, unsigned int *pnWindows);
+
+    /**
+     * @brief Get statistics of the body radii cache.
+     *
+     * Radii and flattening used by Xyz2LatLonAlt(), LatLonAlt2Xyz() and their batch versions are
+     * cached per body name. The cache is cleared by AddSpiceKernel().
+     * @param[out]  pnHits      Number of radii lookups answered from the cache.
+     * @param[out]  pnMisses    Number of radii lookups that queried the kernel pool.
+     * @param[out]  pnEntries   Number of bodies currently cached.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetBodyRadiiCacheStats(unsigned long long *pnHits, unsigned long long *pnMisses, unsigned int *pnEntries);
+
+    /**
+     * @brief Reset the hit and miss counters of the body radii cache.
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    void ResetBodyRadiiCacheStats();
+
+    /**
+     * @brief Select how Xyz2LatLonAlt(), LatLonAlt2Xyz() and their batch versions convert coordinates.
+     *
+     * These functions use a spherical body model (polar radius = equatorial radius). The native
+     * backends evaluate it in closed form without calling SPICE; only the body radii and the
+     * longitude sense are still taken from the kernel pool. Native results match the SPICE
+     * backend within 1e-10 deg for latitude and longitude and within 1e-6 m for altitude and
+     * cartesian coordinates (distances up to 1e9 m). Bodies whose longitude sense SPICE cannot
+     * determine are always converted by SPICE.
+     * Backends:
+     * 0: SPICE recpgr_c() and pgrrec_c() (default)
+     * 1: Native, fastest backend supported by the CPU
+     * 2: Native, scalar
+     * 3: Native, AVX2
+     * 4: Native, AVX-512
+     * @param[in] nBackend  Backend [0, 4].
+     * @return
+     *  0   Success
+     * -2   Backend not available (unknown, not compiled in or not supported by the CPU)
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int SetGeodeticBackend(int nBackend);
+
+    /**
+     * @brief Get the active geodetic backend.
+     *
+     * @return Backend id, see SetGeodeticBackend(). Backend 1 is reported as the backend it selected.
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetGeodeticBackend();
+
+    /**
+     * @brief Get call statistics of an entry point.
+     *
+     * Call counts, return codes and latencies are collected for all entry points listed in
+     * EStatsFunction. Every thread records into its own counters, so collection stays enabled
+     * under load; this function sums the counters of all threads. Counts of concurrently running
+     * calls may be incomplete.
+     * @param[in]   nFunction   Entry point, see EStatsFunction.
+     * @param[out]  poStats     Statistics since the library was loaded or since the last ResetStats() call.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown entry point
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetStats(int nFunction, struct SFunctionStats *poStats);
+
+    /**
+     * @brief Reset the call statistics of all entry points.
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    void ResetStats();
+
     /**
      * @brief Transform planet-centered cartesian coordinates to spherical coordinates.
      *
@@ -118,6 +376,281 @@ extern "C"
     JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
     int LatLonAlt2Xyz(const char *pcPlanet, double dLat, double dLon, double dAlt, double *pdX, double *pdY, double *pdZ);
 
+    /**
+     * @brief Transform an array of planet-centered cartesian coordinates to spherical coordinates.
+     *
+     * Batch version of Xyz2LatLonRad().
+     * Every component is addressed by its own pointer plus a common stride (in doubles), so both
+     * interleaved (pdX = p, pdY = p + 1, pdZ = p + 2, stride 3) and structure-of-arrays (stride 1)
+     * layouts are supported. The same applies to the output arrays.
+     * @param[in]   nCount      Number of points.
+     * @param[in]   pdX         First X-coordinate in meters.
+     * @param[in]   pdY         First Y-coordinate in meters.
+     * @param[in]   pdZ         First Z-coordinate in meters.
+     * @param[in]   nInStride   Distance between two consecutive input points in doubles.
+     * @param[out]  pdLat       First latitude in degrees.
+     * @param[out]  pdLon       First longitude in degrees.
+     * @param[out]  pdRad       First radius in meters.
+     * @param[in]   nOutStride  Distance between two consecutive output points in doubles.
+     * @param[out]  pnStatus    Optional array of nCount per-point status codes (same codes as Xyz2LatLonRad()). Can be NULL.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to transform one or more coordinates (see pnStatus).
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int Xyz2LatLonRadBatch(
+        unsigned int nCount,
+        const double *pdX, const double *pdY, const double *pdZ, unsigned int nInStride,
+        double *pdLat, double *pdLon, double *pdRad, unsigned int nOutStride,
+        int *pnStatus);
+
+    /**
+     * @brief Transform an array of planet-centered cartesian coordinates into planetographic coordinates.
+     *
+     * Batch version of Xyz2LatLonAlt(). The radii of the planet are looked up once per batch.
+     * See Xyz2LatLonRadBatch() for the memory layout of the arrays.
+     * @param[in]   pcPlanet    Case-insensitive name of planet (eg. "mars" or "EARTH").
+     * @param[in]   nCount      Number of points.
+     * @param[in]   pdX         First X-coordinate in meters.
+     * @param[in]   pdY         First Y-coordinate in meters.
+     * @param[in]   pdZ         First Z-coordinate in meters.
+     * @param[in]   nInStride   Distance between two consecutive input points in doubles.
+     * @param[out]  pdLat       First latitude in degrees w.r.t. the referenced spheroid.
+     * @param[out]  pdLon       First longitude in degrees w.r.t. the referenced spheroid.
+     * @param[out]  pdAlt       First altitude in meters w.r.t. the referenced spheroid.
+     * @param[in]   nOutStride  Distance between two consecutive output points in doubles.
+     * @param[out]  pnStatus    Optional array of nCount per-point status codes (same codes as Xyz2LatLonAlt()). Can be NULL.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to lookup radii of the planet
+     * -3   Failed to transform one or more coordinates (see pnStatus).
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int Xyz2LatLonAltBatch(
+        const char *pcPlanet,
+        unsigned int nCount,
+        const double *pdX, const double *pdY, const double *pdZ, unsigned int nInStride,
+        double *pdLat, double *pdLon, double *pdAlt, unsigned int nOutStride,
+        int *pnStatus);
+
+    /**
+     * @brief Transform an array of planetographic coordinates to planet-centered cartesian coordinates.
+     *
+     * Batch version of LatLonAlt2Xyz(). The radii of the planet are looked up once per batch.
+     * See Xyz2LatLonRadBatch() for the memory layout of the arrays.
+     * @param[in]   pcPlanet    Case-insensitive name of planet (eg. "mars" or "EARTH")
+     * @param[in]   nCount      Number of points.
+     * @param[in]   pdLat       First latitude in degrees w.r.t. the referenced spheroid
+     * @param[in]   pdLon       First longitude in degrees w.r.t. the referenced spheroid
+     * @param[in]   pdAlt       First altitude in meters w.r.t. the referenced spheroid
+     * @param[in]   nInStride   Distance between two consecutive input points in doubles.
+     * @param[out]  pdX         First X-coordinate in meters
+     * @param[out]  pdY         First Y-coordinate in meters
+     * @param[out]  pdZ         First Z-coordinate in meters
+     * @param[in]   nOutStride  Distance between two consecutive output points in doubles.
+     * @param[out]  pnStatus    Optional array of nCount per-point status codes (same codes as LatLonAlt2Xyz()). Can be NULL.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to lookup radii for the planet
+     * -3   Failed to transform one or more coordinates (see pnStatus).
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int LatLonAlt2XyzBatch(
+        const char *pcPlanet,
+        unsigned int nCount,
+        const double *pdLat, const double *pdLon, const double *pdAlt, unsigned int nInStride,
+        double *pdX, double *pdY, double *pdZ, unsigned int nOutStride,
+        int *pnStatus);
+
+    /**
+     * Regular planetographic raster (e.g. of a DEM): row r has latitude m_dLatStart + r * m_dLatStep,
+     * column c has longitude m_dLonStart + c * m_dLonStep (see LatLonGrid2Xyz()).
+     */
+    struct SLatLonGrid
+    {
+        double m_dLatStart;         /* latitude of the first row in degrees */
+        double m_dLatStep;          /* latitude difference of consecutive rows in degrees, negative for north-up rasters */
+        double m_dLonStart;         /* longitude of the first column in degrees */
+        double m_dLonStep;          /* longitude difference of consecutive columns in degrees */
+        unsigned int m_nRows;
+        unsigned int m_nColumns;
+    };
+
+    /**
+     * @brief Transform a raster of altitudes into planet-centered cartesian vertices.
+     *
+     * Same conversion as LatLonAlt2XyzBatch() for every cell of the raster, but the radii are
+     * looked up once and sine and cosine are computed once per row and once per column instead
+     * of once per cell. The raster is converted in blocks of rows on up to nThreads threads.
+     * Cells with a NaN altitude (no data) get NaN coordinates.
+     * @param[in]   pcPlanet        Case-insensitive name of planet (eg. "mars" or "EARTH").
+     * @param[in]   poGrid          Raster definition.
+     * @param[in]   pdAlt           Altitude of cell (r, c) in meters at pdAlt[r * nAltRowStride + c].
+     * @param[in]   nAltRowStride   Distance between two rows of pdAlt in doubles, 0 for m_nColumns.
+     * @param[out]  pdXyz           m_nRows * m_nColumns vertices (x, y, z) in meters, row by row.
+     * @param[in]   nThreads        Maximum number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to lookup radii or longitude sense of the planet
+     * -3   Invalid raster (no rows or columns, non-finite start or step, nAltRowStride < m_nColumns)
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int LatLonGrid2Xyz(
+        const char *pcPlanet,
+        const struct SLatLonGrid *poGrid,
+        const double *pdAlt,
+        unsigned int nAltRowStride,
+        double *pdXyz,
+        unsigned int nThreads);
+
+    /**
+     * Supplies the altitudes of a tile for LatLonGrid2XyzTiled(): nRows x nColumns values in meters,
+     * row by row, for the cells starting at raster row nRow and column nColumn. Returns 0 on
+     * success, any other value stops the conversion.
+     */
+    typedef int (*FnLatLonGridHeights)(void *pUserData, unsigned int nRow, unsigned int nColumn,
+        unsigned int nRows, unsigned int nColumns, double *pdAlt);
+
+    /**
+     * Receives the vertices of a tile from LatLonGrid2XyzTiled(): nRows x nColumns vertices
+     * (x, y, z) in meters, row by row. The buffer is only valid during the call. Returns 0 on
+     * success, any other value stops the conversion.
+     */
+    typedef int (*FnLatLonGridVertices)(void *pUserData, unsigned int nRow, unsigned int nColumn,
+        unsigned int nRows, unsigned int nColumns, const double *pdXyz);
+
+    /**
+     * @brief Transform a raster that does not fit into memory tile by tile.
+     *
+     * Same conversion as LatLonGrid2Xyz(). The raster is cut into tiles of nTileRows x
+     * nTileColumns cells (smaller at the last row and column). For each tile, pfnHeights fills
+     * the altitudes and pfnVertices receives the vertices. Tiles are processed on up to nThreads
+     * threads in no particular order, so the callbacks are called concurrently and must be
+     * thread-safe. Every thread owns one tile buffer; memory use is about
+     * nThreads * nTileRows * nTileColumns * 32 bytes regardless of the raster size.
+     * @param[in]   pcPlanet        Case-insensitive name of planet (eg. "mars" or "EARTH").
+     * @param[in]   poGrid          Raster definition.
+     * @param[in]   nTileRows       Rows per tile.
+     * @param[in]   nTileColumns    Columns per tile.
+     * @param[in]   pfnHeights      Altitude source.
+     * @param[in]   pfnVertices     Vertex sink.
+     * @param[in]   pUserData       Passed to the callbacks. Can be NULL.
+     * @param[in]   nThreads        Maximum number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to lookup radii or longitude sense of the planet
+     * -3   Invalid raster (no rows or columns, non-finite start or step) or tile size 0
+     * -4   A callback stopped the conversion
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int LatLonGrid2XyzTiled(
+        const char *pcPlanet,
+        const struct SLatLonGrid *poGrid,
+        unsigned int nTileRows,
+        unsigned int nTileColumns,
+        FnLatLonGridHeights pfnHeights,
+        FnLatLonGridVertices pfnVertices,
+        void *pUserData,
+        unsigned int nThreads);
+
+    /**
+     * Float vertex output of LatLonAlt2XyzBatchF32() and LatLonGrid2XyzF32() for GPU vertex buffers.
+     * Vertex i gets its position relative to m_adCenter as three floats (x, y, z) at byte
+     * m_nOffset + i * m_nStride of m_pVertices; the other bytes of the vertex are left untouched.
+     * The center is subtracted in double precision before narrowing, so the error depends on the
+     * distance from the center only (see GetVertexF32ErrorBound()).
+     */
+    struct SVertexOutputF32
+    {
+        double m_adCenter[3];       /* planet-centered origin of the vertices in meters */
+        void *m_pVertices;          /* first byte of the vertex buffer */
+        unsigned int m_nStride;     /* bytes between two consecutive vertices, at least 12 */
+        unsigned int m_nOffset;     /* byte offset of the position within a vertex */
+    };
+
+    /**
+     * @brief Transform an array of planetographic coordinates to float vertices relative to a center.
+     *
+     * Same conversion as LatLonAlt2XyzBatch(), but the cartesian coordinates are written as
+     * floats relative to poOutput->m_adCenter directly into an interleaved vertex buffer.
+     * @param[in]   pcPlanet    Case-insensitive name of planet (eg. "mars" or "EARTH")
+     * @param[in]   nCount      Number of points.
+     * @param[in]   pdLat       First latitude in degrees w.r.t. the referenced spheroid
+     * @param[in]   pdLon       First longitude in degrees w.r.t. the referenced spheroid
+     * @param[in]   pdAlt       First altitude in meters w.r.t. the referenced spheroid
+     * @param[in]   nInStride   Distance between two consecutive input points in doubles.
+     * @param[in]   poOutput    Center and layout of the nCount output vertices.
+     * @param[out]  pdMaxError  Optional largest distance in meters between a written vertex and the
+     *                          double precision result, ignoring failed points. Can be NULL.
+     * @param[out]  pnStatus    Optional array of nCount per-point status codes (same codes as LatLonAlt2Xyz()). Can be NULL.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to lookup radii for the planet
+     * -3   Failed to transform one or more coordinates (see pnStatus).
+     * -4   Invalid vertex output (stride below 12 bytes or non-finite center)
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int LatLonAlt2XyzBatchF32(
+        const char *pcPlanet,
+        unsigned int nCount,
+        const double *pdLat, const double *pdLon, const double *pdAlt, unsigned int nInStride,
+        const struct SVertexOutputF32 *poOutput,
+        double *pdMaxError,
+        int *pnStatus);
+
+    /**
+     * @brief Convert a planetographic raster to float vertices relative to a center.
+     *
+     * Same conversion as LatLonGrid2Xyz(); cell (r, c) is written to vertex r * m_nColumns + c of
+     * poOutput. Cells with a NaN altitude (no data) get NaN vertices.
+     * @param[in]   pcPlanet        Case-insensitive name of planet (eg. "mars" or "EARTH").
+     * @param[in]   poGrid          Raster definition.
+     * @param[in]   pdAlt           Altitude of cell (r, c) in meters at pdAlt[r * nAltRowStride + c].
+     * @param[in]   nAltRowStride   Distance between two rows of pdAlt in doubles, 0 for m_nColumns.
+     * @param[in]   poOutput        Center and layout of the m_nRows * m_nColumns output vertices.
+     * @param[out]  pdMaxError      Optional largest distance in meters between a written vertex and
+     *                              the double precision result, ignoring no data cells. Can be NULL.
+     * @param[in]   nThreads        Maximum number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to lookup radii or longitude sense of the planet
+     * -3   Invalid raster (no rows or columns, non-finite start or step, nAltRowStride < m_nColumns)
+     * -4   Invalid vertex output (stride below 12 bytes or non-finite center)
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int LatLonGrid2XyzF32(
+        const char *pcPlanet,
+        const struct SLatLonGrid *poGrid,
+        const double *pdAlt,
+        unsigned int nAltRowStride,
+        const struct SVertexOutputF32 *poOutput,
+        double *pdMaxError,
+        unsigned int nThreads);
+
+    /**
+     * @brief Get the worst-case float vertex error for a tile of a given size.
+     *
+     * Upper bound of the distance between a vertex written by LatLonAlt2XyzBatchF32() or
+     * LatLonGrid2XyzF32() and the double precision result, for all vertices within dTileRadius
+     * meters of the center in every coordinate. The bound stays below 1 mm for tile radii below
+     * 16384 m (0.85 mm) and doubles with every further power of two.
+     * @param[in]   dTileRadius     Largest absolute coordinate of a vertex relative to the center in meters.
+     * @param[out]  pdMaxError      Error bound in meters.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Negative or non-finite tile radius
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetVertexF32ErrorBound(double dTileRadius, double *pdMaxError);
+
     /**
      * @brief Get the relative position and rotation of a celestial body.
      * 
@@ -136,6 +669,7 @@ extern "C"
      * -2   Failed to convert datetime string format
      * -3   Failed to get relative state of support body w.r.t. observer body
      * -4   Failed to get relative state of target body w.r.t. observer body
+     * -6   Epoch outside the coverage of the loaded SPK or CK kernels (see GetCoverageWindows())
      */
     JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
     int GetRelState(
@@ -147,6 +681,192 @@ extern "C"
         double *pdPosVec,
         double *pdRotMat);
 
+    /**
+     * @brief Get the relative positions and rotations of several celestial bodies at the same time.
+     *
+     * Multi-target version of GetRelState(). The datetime is converted, the observer and the
+     * reference frame are resolved and the support body is looked up once for all targets.
+     * @param[in]   ppcTargetBodies         Array of nTargets case-insensitive names of celestial bodies (eg. "phobos" or "DEIMOS")
+     * @param[in]   nTargets                Number of targets.
+     * @param[in]   pcSupportBody           Case-insensitive name of a celestial body (eg. "mars" or "EARTH")
+     * @param[in]   pcObserverBody          Case-insensitive name of a celestial body (eg. "mars" or "EARTH")
+     * @param[in]   pcObserverDatetime      Datetime string (e.g. "2026-12-03 08:15:00.00")
+     * @param[in]   pcOutputReferenceFrame  Reference frame (e.g. "J2000")
+     * @param[out]  pdPosVecs               nTargets contiguous 3x1 positions in meters
+     * @param[out]  pdRotMats               nTargets contiguous 3x3 rotation matrices
+     * @param[out]  pnStatus                Optional array of nTargets per-target status codes (same codes as GetRelState()). Can be NULL.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to convert datetime string format
+     * -3   Failed to get relative state of support body w.r.t. observer body
+     * -4   Failed to get relative state of one or more targets w.r.t. observer body (see pnStatus)
+     * -6   Epoch outside the coverage of the loaded SPK or CK kernels for the support body
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetRelStateMulti(
+        const char *const *ppcTargetBodies,
+        unsigned int nTargets,
+        const char *pcSupportBody,
+        const char *pcObserverBody,
+        const char *pcObserverDatetime,
+        const char *pcOutputReferenceFrame,
+        double *pdPosVecs,
+        double *pdRotMats,
+        int *pnStatus);
+
+    /**
+     * @brief Convert a datetime string to ephemeris time.
+     *
+     * @param[in]   pcDatetime  Datetime string (e.g. "2026-12-03 08:15:00.00")
+     * @param[out]  pdEt        Ephemeris time (seconds past J2000 TDB)
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to convert datetime string format
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int Datetime2Et(const char *pcDatetime, double *pdEt);
+
+    /**
+     * @brief Get the relative position and rotation of a celestial body for a series of epochs.
+     *
+     * Series version of GetRelState(). The epochs are either given explicitly by pdEts or
+     * generated as dStartEt + i * dStepEt for i in [0, nCount).
+     * @param[in]   pcTargetBody            Case-insensitive name of a celestial body (eg. "mars" or "EARTH")
+     * @param[in]   pcSupportBody           Case-insensitive name of a celestial body (eg. "mars" or "EARTH")
+     * @param[in]   pcObserverBody          Case-insensitive name of a celestial body (eg. "mars" or "EARTH")
+     * @param[in]   pcOutputReferenceFrame  Reference frame (e.g. "J2000")
+     * @param[in]   dStartEt                Ephemeris time of the first epoch. Ignored if pdEts is not NULL.
+     * @param[in]   dStepEt                 Seconds between two epochs. Ignored if pdEts is not NULL.
+     * @param[in]   pdEts                   Optional array of nCount ephemeris times. Can be NULL.
+     * @param[in]   nCount                  Number of epochs.
+     * @param[out]  pdPosVecs               nCount contiguous 3x1 positions in meters
+     * @param[out]  pdRotMats               nCount contiguous 3x3 rotation matrices
+     * @param[out]  pnStatus                Optional array of nCount per-epoch status codes (same codes as GetRelState()). Can be NULL.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to get the relative state for one or more epochs (see pnStatus)
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetRelStateSeries(
+        const char *pcTargetBody,
+        const char *pcSupportBody,
+        const char *pcObserverBody,
+        const char *pcOutputReferenceFrame,
+        double dStartEt,
+        double dStepEt,
+        const double *pdEts,
+        unsigned int nCount,
+        double *pdPosVecs,
+        double *pdRotMats,
+        int *pnStatus);
+
+    /**
+     * @brief Get incidence, emission and phase angles of surface points for a series of epochs.
+     *
+     * The positions of the sun and the observer w.r.t. the body are looked up once per epoch
+     * (no aberration correction, see GetRelState()); the angles of all points are then computed
+     * by the native kernels without calling SPICE. Epochs are given as in GetRelStateSeries().
+     * Points and normals are given in the body frame and use the memory layout of
+     * Xyz2LatLonRadBatch(). Normals need not be unit vectors.
+     * Incidence is the angle between normal and the direction to the sun, emission the angle
+     * between normal and the direction to the observer, phase the angle between both directions.
+     * The angles of point i at epoch e are written to index e * nCount + i of each output array.
+     * Epochs that fail yield NaN angles.
+     * @param[in]   pcBody          Case-insensitive name of the celestial body (eg. "mars")
+     * @param[in]   pcBodyFrame     Body-fixed reference frame of the points (e.g. "IAU_MARS")
+     * @param[in]   pcObserverBody  Case-insensitive name of the observer (eg. "earth" or a spacecraft)
+     * @param[in]   dStartEt        Ephemeris time of the first epoch. Ignored if pdEts is not NULL.
+     * @param[in]   dStepEt         Seconds between two epochs. Ignored if pdEts is not NULL.
+     * @param[in]   pdEts           Optional array of nEpochs ephemeris times. Can be NULL.
+     * @param[in]   nEpochs         Number of epochs.
+     * @param[in]   nCount          Number of points.
+     * @param[in]   pdX             First X-coordinate in meters w.r.t. the body center.
+     * @param[in]   pdY             First Y-coordinate in meters w.r.t. the body center.
+     * @param[in]   pdZ             First Z-coordinate in meters w.r.t. the body center.
+     * @param[in]   pdNx            First X-component of the surface normal. If pdNx, pdNy or pdNz is NULL, the radial direction is used.
+     * @param[in]   pdNy            First Y-component of the surface normal.
+     * @param[in]   pdNz            First Z-component of the surface normal.
+     * @param[in]   nInStride       Distance between two consecutive points (and normals) in doubles.
+     * @param[out]  pdIncidence     nEpochs * nCount incidence angles in degrees [0, 180]
+     * @param[out]  pdEmission      nEpochs * nCount emission angles in degrees [0, 180]
+     * @param[out]  pdPhase         nEpochs * nCount phase angles in degrees [0, 180]
+     * @param[out]  pnStatus        Optional array of nEpochs per-epoch status codes. Can be NULL.
+     *                              0: success, -3: failed to get the sun position, -4: failed to get
+     *                              the observer position, -6: epoch outside the loaded coverage.
+     * @param[in]   nThreads        Number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Failed to get the positions for one or more epochs (see pnStatus)
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetIlluminationAngles(
+        const char *pcBody,
+        const char *pcBodyFrame,
+        const char *pcObserverBody,
+        double dStartEt,
+        double dStepEt,
+        const double *pdEts,
+        unsigned int nEpochs,
+        unsigned int nCount,
+        const double *pdX, const double *pdY, const double *pdZ,
+        const double *pdNx, const double *pdNy, const double *pdNz,
+        unsigned int nInStride,
+        double *pdIncidence, double *pdEmission, double *pdPhase,
+        int *pnStatus,
+        unsigned int nThreads);
+
+    /**
+     * @brief Precompute the state of a target w.r.t. an observer over a time window.
+     *
+     * The state is sampled with spkezr_c (no aberration correction) and represented by
+     * equally spaced cubic Hermite segments built from position and velocity. The segment count
+     * is doubled until the position deviation from spkezr_c at every segment midpoint, where the
+     * interpolation error peaks, is below dTolerance.
+     * As long as the cache exists, GetRelState() and GetRelStateSeries() answer queries for the
+     * same target, observer and reference frame within [dStartEt, dEndEt] in constant time from
+     * the cache. GetRelState() needs one cache for the target and one for the support body.
+     * All caches are dropped by AddSpiceKernel().
+     * @param[in]   pcTargetBody        Case-insensitive name of a celestial body (eg. "mars" or "EARTH")
+     * @param[in]   pcObserverBody      Case-insensitive name of a celestial body (eg. "mars" or "EARTH")
+     * @param[in]   pcReferenceFrame    Reference frame (e.g. "J2000")
+     * @param[in]   dStartEt            Ephemeris time of the window start
+     * @param[in]   dEndEt              Ephemeris time of the window end
+     * @param[in]   dTolerance          Maximum position deviation in meters
+     * @param[out]  pnCacheId           Id of the new cache
+     * @param[out]  pdMaxError          Worst-case position deviation in meters found during validation
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Empty time window or non-positive tolerance
+     * -3   Failed to sample the state of the target w.r.t. the observer
+     * -4   Tolerance not reachable
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int CreateEphemerisCache(
+        const char *pcTargetBody,
+        const char *pcObserverBody,
+        const char *pcReferenceFrame,
+        double dStartEt,
+        double dEndEt,
+        double dTolerance,
+        int *pnCacheId,
+        double *pdMaxError);
+
+    /**
+     * @brief Release an ephemeris cache created by CreateEphemerisCache().
+     *
+     * @param[in]   nCacheId    Id of the cache.
+     * @return
+     *  0   Success
+     * -2   Unknown cache id
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int DestroyEphemerisCache(int nCacheId);
+
     /**
      * @brief Return the matrix that transforms position vectors from one
      * specified frame to another at a specified epoch.
@@ -160,6 +880,8 @@ extern "C"
      *  0   Success
      * -1   Failed to run function. Argument(s) must not be NULL.
      * -2   Failed to convert datetime string format
+     * -3   Failed to compute the rotation (e.g. unknown frame or missing orientation data)
+     * -6   Epoch outside the CK coverage of either frame (see GetCoverageWindows())
      */
     JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
     int GetPositionTransformationMatrix(
@@ -168,6 +890,159 @@ extern "C"
         const char *pcDatetime,
         double *pdRotMat);
 
+    /**
+     * @brief Return the matrices that transform position vectors from one frame to another
+     * at a series of epochs.
+     *
+     * Matrices are cached per frame pair and epoch, see SetFrameRotationCacheSize().
+     * Quaternions follow the SPICE convention (m2q_c): (cos(theta/2), sin(theta/2) * axis).
+     * @param[in]   pcFrom      Name of the frame to transform from (e.g. "IAU_MARS")
+     * @param[in]   pcTo        Name of the frame to transform to (e.g. "J2000")
+     * @param[in]   pdEts       nCount epochs as ephemeris time (see Datetime2Et()).
+     * @param[in]   nCount      Number of epochs.
+     * @param[out]  pdRotMats   Optional nCount row-major 3x3 rotation matrices (9 * nCount values). Can be NULL.
+     * @param[out]  pdQuats     Optional nCount rotation quaternions (4 * nCount values). Can be NULL.
+     * @param[out]  pnStatus    Optional per-epoch result codes (0, -3 or -6 as in GetPositionTransformationMatrix()). Can be NULL.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. pcFrom, pcTo and pdEts must not be NULL, and pdRotMats and pdQuats must not both be NULL.
+     * -2   One or more epochs failed (see pnStatus), their outputs are set to 0.
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetPositionTransformationMatrixSeries(
+        const char *pcFrom,
+        const char *pcTo,
+        const double *pdEts,
+        unsigned int nCount,
+        double *pdRotMats,
+        double *pdQuats,
+        int *pnStatus);
+
+    /**
+     * @brief Set the number of cached frame rotations.
+     *
+     * GetPositionTransformationMatrix() and GetPositionTransformationMatrixSeries() cache the
+     * rotation per frame pair and epoch. When the cache is full, the
+     * least recently used rotation is evicted. The cache is cleared by AddSpiceKernel().
+     * @param[in] nEntries  Maximum number of cached rotations (default 256). 0 disables the cache.
+     * @return
+     *  0   Success
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int SetFrameRotationCacheSize(unsigned int nEntries);
+
+    /**
+     * @brief Get statistics of the frame rotation cache.
+     *
+     * @param[out]  pnHits      Number of rotations answered from the cache.
+     * @param[out]  pnMisses    Number of rotations computed by SPICE.
+     * @param[out]  pnEntries   Number of rotations currently cached.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetFrameRotationCacheStats(unsigned long long *pnHits, unsigned long long *pnMisses, unsigned int *pnEntries);
+
+    /**
+     * @brief Reset the hit and miss counters of the frame rotation cache.
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    void ResetFrameRotationCacheStats();
+
+    /**
+     * @brief Resolve a body name to a handle.
+     *
+     * The name is resolved once (bodn2c_c) together with the body radii, if the kernel pool has
+     * them. Functions taking handles do no name lookups. Resolving the same name again returns the
+     * same handle. Handles become invalid when AddSpiceKernel() is called; functions taking an
+     * invalid handle return -5, the name must then be resolved again.
+     * @param[in]   pcBody      Case-insensitive name or NAIF ID string of a body (e.g. "mars" or "499")
+     * @param[out]  pnHandle    Body handle.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown body
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetBodyHandle(const char *pcBody, int *pnHandle);
+
+    /**
+     * @brief Resolve a reference frame name to a handle.
+     *
+     * The name is resolved once (namfrm_c). See GetBodyHandle() for the lifetime of handles.
+     * @param[in]   pcFrame     Case-insensitive name of a reference frame (e.g. "J2000")
+     * @param[out]  pnHandle    Frame handle.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown frame
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetFrameHandle(const char *pcFrame, int *pnHandle);
+
+    /**
+     * @brief Same as Xyz2LatLonAlt(), with the planet given as body handle (see GetBodyHandle()).
+     *
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   No radii available for the planet
+     * -3   Failed to transform coordinates
+     * -5   Invalid or outdated handle
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int Xyz2LatLonAltByHandle(int nBodyHandle, double dX, double dY, double dZ, double *pdLat, double *pdLon, double *pdAlt);
+
+    /**
+     * @brief Same as LatLonAlt2Xyz(), with the planet given as body handle (see GetBodyHandle()).
+     *
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   No radii available for the planet
+     * -3   Failed to transform coordinates
+     * -5   Invalid or outdated handle
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int LatLonAlt2XyzByHandle(int nBodyHandle, double dLat, double dLon, double dAlt, double *pdX, double *pdY, double *pdZ);
+
+    /**
+     * @brief Same as GetRelState(), with bodies and frame given as handles and the epoch as
+     * ephemeris time (see Datetime2Et()).
+     *
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -3   Failed to get relative state of support body w.r.t. observer body
+     * -4   Failed to get relative state of target body w.r.t. observer body
+     * -5   Invalid or outdated handle
+     * -6   Epoch outside the coverage of the loaded SPK or CK kernels (see GetCoverageWindows())
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetRelStateByHandle(
+        int nTargetBody,
+        int nSupportBody,
+        int nObserverBody,
+        double dEt,
+        int nOutputReferenceFrame,
+        double *pdPosVec,
+        double *pdRotMat);
+
+    /**
+     * @brief Same as GetPositionTransformationMatrix(), with the frames given as handles and the
+     * epoch as ephemeris time (see Datetime2Et()).
+     *
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -3   Failed to compute the rotation
+     * -5   Invalid or outdated handle
+     * -6   Epoch outside the CK coverage of either frame (see GetCoverageWindows())
+     */
+    JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+    int GetPositionTransformationMatrixByHandle(int nFrom, int nTo, double dEt, double *pdRotMat);
+
 } // extern "C"
 
 #endif // JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_HPP
@@ -0,0 +1,101 @@
+"""Compare per-point ctypes calls of the CooTransformation library with the NumPy batch bindings.
+
+Usage:
+    python benchmark_pycootransformation.py --library <path to CooTransformation shared library>
+        [--body MARS] [--count 200000] kernel [kernel ...]
+
+PyCooTransformation must be importable (e.g. run from the install bin directory). Exits with 1 if
+the results of both paths differ.
+"""
+
+import argparse
+import ctypes
+import sys
+import time
+
+import numpy as np
+
+import PyCooTransformation
+
+
+def load_library(path):
+    lib = ctypes.CDLL(path)
+    double_p = ctypes.POINTER(ctypes.c_double)
+    for name in ("Xyz2LatLonAlt", "LatLonAlt2Xyz"):
+        function = getattr(lib, name)
+        function.argtypes = [ctypes.c_char_p, ctypes.c_double, ctypes.c_double, ctypes.c_double, double_p, double_p, double_p]
+        function.restype = ctypes.c_int
+    return lib
+
+
+def per_point(function, body, points):
+    out = np.empty_like(points)
+    a, b, c = ctypes.c_double(), ctypes.c_double(), ctypes.c_double()
+    refs = (ctypes.byref(a), ctypes.byref(b), ctypes.byref(c))
+    for i, (x, y, z) in enumerate(points.tolist()):
+        if function(body, x, y, z, *refs) != 0:
+            raise RuntimeError("per-point call failed at index %d" % i)
+        out[i] = (a.value, b.value, c.value)
+    return out
+
+
+def timed(function, *args):
+    start = time.perf_counter()
+    result = function(*args)
+    return result, time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--library", required=True)
+    parser.add_argument("--body", default="MARS")
+    parser.add_argument("--count", type=int, default=200000)
+    parser.add_argument("kernels", nargs="+")
+    args = parser.parse_args()
+
+    lib = load_library(args.library)
+    PyCooTransformation.init()
+    for kernel in args.kernels:
+        PyCooTransformation.add_spice_kernel(kernel)
+
+    rng = np.random.default_rng(42)
+    lla = np.column_stack((rng.uniform(-89.0, 89.0, args.count),
+                           rng.uniform(-180.0, 180.0, args.count),
+                           rng.uniform(-5000.0, 20000.0, args.count)))
+    body = args.body.encode()
+
+    xyz_scalar, t_xyz_scalar = timed(per_point, lib.LatLonAlt2Xyz, body, lla)
+    (xyz_batch, status), t_xyz_batch = timed(PyCooTransformation.latlonalt2xyz, args.body, lla)
+    if np.any(status != 0):
+        print("latlonalt2xyz: %d points failed" % np.count_nonzero(status))
+        return 1
+
+    lla_scalar, t_lla_scalar = timed(per_point, lib.Xyz2LatLonAlt, body, xyz_scalar)
+    (lla_batch, status), t_lla_batch = timed(PyCooTransformation.xyz2latlonalt, args.body, xyz_scalar)
+    if np.any(status != 0):
+        print("xyz2latlonalt: %d points failed" % np.count_nonzero(status))
+        return 1
+
+    # strided input: a Fortran-ordered copy must give the same result without a copy in the bindings
+    (lla_strided, _), _ = timed(PyCooTransformation.xyz2latlonalt, args.body, np.asfortranarray(xyz_scalar))
+
+    ok = True
+    for name, scalar, batch in (("latlonalt2xyz", xyz_scalar, xyz_batch),
+                                ("xyz2latlonalt", lla_scalar, lla_batch),
+                                ("xyz2latlonalt strided", lla_scalar, lla_strided)):
+        error = np.max(np.abs(scalar - batch)) if len(scalar) else 0.0
+        if not np.allclose(scalar, batch, rtol=1e-12, atol=1e-6):
+            print("%s: results differ, max abs error %g" % (name, error))
+            ok = False
+
+    print("%-16s %10s %12s %12s %8s" % ("function", "points", "ctypes [s]", "numpy [s]", "speedup"))
+    for name, t_scalar, t_batch in (("LatLonAlt2Xyz", t_xyz_scalar, t_xyz_batch),
+                                    ("Xyz2LatLonAlt", t_lla_scalar, t_lla_batch)):
+        print("%-16s %10d %12.4f %12.4f %8.1f" % (name, args.count, t_scalar, t_batch, t_scalar / max(t_batch, 1e-9)))
+
+    PyCooTransformation.deinit()
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
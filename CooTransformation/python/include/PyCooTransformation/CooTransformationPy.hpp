@@ -0,0 +1,5 @@
+#include <CooTransformation/CooTransformation.hpp>
+
+#include <boost/python.hpp>
+
+namespace bp = boost::python;
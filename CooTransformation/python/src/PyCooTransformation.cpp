@@ -0,0 +1,330 @@
+#include <PyCooTransformation/CooTransformationPy.hpp>
+
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+
+/** PyCooTransformation
+* ===================
+*
+* NumPy bindings of the CooTransformation batch functions. Arrays are accessed through the
+* Python buffer protocol without copies or per-element Python objects, and the GIL is released
+* while a batch runs. Points are (N, 3) float64 arrays with strides that are multiples of 8 bytes
+* and a non-negative point (row) stride, so views like a[:, ::-1] or Fortran-ordered arrays work
+* as well; a[::-1] must be copied.
+* Results are new NumPy arrays unless an output array is passed with out=.
+*
+* Whole-call failures (nullptr arguments, unknown body) raise RuntimeError; per-point and
+* per-epoch failures are reported in the returned int32 status array with the codes of the C API.
+**/
+
+namespace
+{
+    // Holds a buffer export of a Python object for the lifetime of the view.
+    class CBufferView
+    {
+    public:
+        CBufferView(const bp::object& roObject, bool bWritable)
+        {
+            const int nFlags = PyBUF_STRIDES | PyBUF_FORMAT | (bWritable ? PyBUF_WRITABLE : 0);
+            if (PyObject_GetBuffer(roObject.ptr(), &m_oBuffer, nFlags) != 0)
+            {
+                bp::throw_error_already_set();
+            }
+        }
+
+        ~CBufferView()
+        {
+            PyBuffer_Release(&m_oBuffer);
+        }
+
+        CBufferView(const CBufferView&) = delete;
+        CBufferView& operator=(const CBufferView&) = delete;
+
+        const Py_buffer* operator->() const { return &m_oBuffer; }
+
+    private:
+        Py_buffer m_oBuffer;
+    };
+
+
+    // Releases the GIL for the lifetime of the object.
+    class CGilRelease
+    {
+    public:
+        CGilRelease() : m_poState(PyEval_SaveThread()) {}
+        ~CGilRelease() { PyEval_RestoreThread(m_poState); }
+
+        CGilRelease(const CGilRelease&) = delete;
+        CGilRelease& operator=(const CGilRelease&) = delete;
+
+    private:
+        PyThreadState* m_poState;
+    };
+
+
+    // Native-endian format character, optionally with a '@', '=' or (on little-endian hosts) '<' prefix.
+    bool HasFormat(const CBufferView& roView, char cFormat, Py_ssize_t nItemSize)
+    {
+        const char* pcFormat = roView->format ? roView->format : "B";
+        if (roView->itemsize != nItemSize)
+        {
+            return false;
+        }
+        const bool bLittleEndian = [] { const unsigned short n = 1; unsigned char c; std::memcpy(&c, &n, 1); return c == 1; }();
+        if (pcFormat[0] == '@' || pcFormat[0] == '=' || (pcFormat[0] == '<' && bLittleEndian))
+        {
+            ++pcFormat;
+        }
+        return pcFormat[0] == cFormat && pcFormat[1] == '\0';
+    }
+
+
+    unsigned int CheckedCount(Py_ssize_t nCount)
+    {
+        if (nCount < 0 || static_cast<unsigned long long>(nCount) > UINT_MAX)
+        {
+            throw std::invalid_argument("too many elements for the CooTransformation API");
+        }
+        return static_cast<unsigned int>(nCount);
+    }
+
+
+    // (N, 3) float64 buffer as three component pointers and a stride in doubles.
+    struct SPoints
+    {
+        double* m_apdComponents[3];
+        unsigned int m_nStride;
+        unsigned int m_nCount;
+    };
+
+    SPoints PointsOf(const CBufferView& roView, const char* pcName)
+    {
+        const std::string sName = pcName;
+        if (!HasFormat(roView, 'd', sizeof(double)) || roView->ndim != 2 || roView->shape[1] != 3)
+        {
+            throw std::invalid_argument(sName + " must be a float64 array of shape (N, 3)");
+        }
+        const Py_ssize_t nPointStride = roView->shape[0] > 1 ? roView->strides[0] : static_cast<Py_ssize_t>(3 * sizeof(double));
+        const Py_ssize_t nComponentStride = roView->strides[1];
+        // the C API takes an unsigned point stride; the component pointers may lie in either order
+        const Py_ssize_t nDoubleSize = static_cast<Py_ssize_t>(sizeof(double));
+        if (nPointStride < 0 || nPointStride % nDoubleSize != 0 || nComponentStride % nDoubleSize != 0
+            || static_cast<unsigned long long>(nPointStride / sizeof(double)) > UINT_MAX)
+        {
+            throw std::invalid_argument(sName + " must have strides that are multiples of 8 bytes and a non-negative row stride");
+        }
+
+        SPoints oPoints;
+        double* pdBase = static_cast<double*>(roView->buf);
+        for (int i = 0; i < 3; ++i)
+        {
+            oPoints.m_apdComponents[i] = pdBase + i * (nComponentStride / nDoubleSize);
+        }
+        oPoints.m_nStride = static_cast<unsigned int>(nPointStride / sizeof(double));
+        oPoints.m_nCount = CheckedCount(roView->shape[0]);
+        return oPoints;
+    }
+
+    // Contiguous 1-D buffer of nItemSize items with format cFormat.
+    template <typename T>
+    T* ContiguousOf(const CBufferView& roView, char cFormat, const char* pcName, unsigned int& rnCount)
+    {
+        if (!HasFormat(roView, cFormat, sizeof(T)) || roView->ndim != 1
+            || (roView->shape[0] > 1 && roView->strides[0] != static_cast<Py_ssize_t>(sizeof(T))))
+        {
+            throw std::invalid_argument(std::string(pcName) + " must be a contiguous 1-D array of " + (cFormat == 'd' ? "float64" : "int32"));
+        }
+        rnCount = CheckedCount(roView->shape[0]);
+        return static_cast<T*>(roView->buf);
+    }
+
+
+    bp::object NewArray(const bp::tuple& roShape, const char* pcType)
+    {
+        static bp::object s_oEmpty = bp::import("numpy").attr("empty");
+        return s_oEmpty(roShape, pcType);
+    }
+
+
+    void CheckResult(int nResult, int nPartialFailure, const char* pcFunction)
+    {
+        if (nResult != 0 && nResult != nPartialFailure)
+        {
+            throw std::runtime_error(std::string(pcFunction) + "() failed with " + std::to_string(nResult));
+        }
+    }
+
+
+    using BatchFunction = int (*)(const char*, unsigned int,
+        const double*, const double*, const double*, unsigned int,
+        double*, double*, double*, unsigned int, int*);
+
+    // Runs one of the batch conversions on (N, 3) arrays. Returns (out, status).
+    bp::tuple RunBatch(BatchFunction pfnBatch, const char* pcFunction, int nPartialFailure,
+        const std::string& rsBody, const bp::object& roIn, bp::object oOut)
+    {
+        CBufferView oInView(roIn, false);
+        const SPoints oIn = PointsOf(oInView, "points");
+        if (oOut.is_none())
+        {
+            oOut = NewArray(bp::make_tuple(oIn.m_nCount, 3), "float64");
+        }
+        CBufferView oOutView(oOut, true);
+        const SPoints oOutPoints = PointsOf(oOutView, "out");
+        if (oOutPoints.m_nCount != oIn.m_nCount)
+        {
+            throw std::invalid_argument("out must have the same number of points as the input");
+        }
+        bp::object oStatus = NewArray(bp::make_tuple(oIn.m_nCount), "int32");
+        CBufferView oStatusView(oStatus, true);
+        unsigned int nStatusCount = 0;
+        int* pnStatus = ContiguousOf<int>(oStatusView, 'i', "status", nStatusCount);
+
+        int nResult = 0;
+        {
+            CGilRelease oGilRelease;
+            nResult = pfnBatch(rsBody.c_str(), oIn.m_nCount,
+                oIn.m_apdComponents[0], oIn.m_apdComponents[1], oIn.m_apdComponents[2], oIn.m_nStride,
+                oOutPoints.m_apdComponents[0], oOutPoints.m_apdComponents[1], oOutPoints.m_apdComponents[2], oOutPoints.m_nStride,
+                pnStatus);
+        }
+        CheckResult(nResult, nPartialFailure, pcFunction);
+        return bp::make_tuple(oOut, oStatus);
+    }
+
+
+    int Xyz2LatLonRadBatchAdapter(const char*, unsigned int nCount,
+        const double* pdX, const double* pdY, const double* pdZ, unsigned int nInStride,
+        double* pdLat, double* pdLon, double* pdRad, unsigned int nOutStride, int* pnStatus)
+    {
+        return Xyz2LatLonRadBatch(nCount, pdX, pdY, pdZ, nInStride, pdLat, pdLon, pdRad, nOutStride, pnStatus);
+    }
+
+
+    bp::tuple Xyz2LatLonRadPy(const bp::object& roXyz, const bp::object& roOut)
+    {
+        return RunBatch(&Xyz2LatLonRadBatchAdapter, "Xyz2LatLonRadBatch", -2, std::string(), roXyz, roOut);
+    }
+
+    bp::tuple Xyz2LatLonAltPy(const std::string& rsBody, const bp::object& roXyz, const bp::object& roOut)
+    {
+        return RunBatch(&Xyz2LatLonAltBatch, "Xyz2LatLonAltBatch", -3, rsBody, roXyz, roOut);
+    }
+
+    bp::tuple LatLonAlt2XyzPy(const std::string& rsBody, const bp::object& roLatLonAlt, const bp::object& roOut)
+    {
+        return RunBatch(&LatLonAlt2XyzBatch, "LatLonAlt2XyzBatch", -3, rsBody, roLatLonAlt, roOut);
+    }
+
+
+    // Returns (positions (N, 3), rotations (N, 3, 3), status (N,)).
+    bp::tuple GetRelStateSeriesPy(const std::string& rsTarget, const std::string& rsSupport, const std::string& rsObserver,
+        const std::string& rsFrame, const bp::object& roEts)
+    {
+        CBufferView oEtsView(roEts, false);
+        unsigned int nCount = 0;
+        const double* pdEts = ContiguousOf<const double>(oEtsView, 'd', "ets", nCount);
+
+        bp::object oPositions = NewArray(bp::make_tuple(nCount, 3), "float64");
+        bp::object oRotations = NewArray(bp::make_tuple(nCount, 3, 3), "float64");
+        bp::object oStatus = NewArray(bp::make_tuple(nCount), "int32");
+        CBufferView oPositionsView(oPositions, true);
+        CBufferView oRotationsView(oRotations, true);
+        CBufferView oStatusView(oStatus, true);
+
+        int nResult = 0;
+        {
+            CGilRelease oGilRelease;
+            nResult = GetRelStateSeries(rsTarget.c_str(), rsSupport.c_str(), rsObserver.c_str(), rsFrame.c_str(),
+                0.0, 0.0, pdEts, nCount,
+                static_cast<double*>(oPositionsView->buf), static_cast<double*>(oRotationsView->buf), static_cast<int*>(oStatusView->buf));
+        }
+        CheckResult(nResult, -2, "GetRelStateSeries");
+        return bp::make_tuple(oPositions, oRotations, oStatus);
+    }
+
+
+    // Returns (rotations (N, 3, 3), status (N,)).
+    bp::tuple GetPositionTransformationMatrixSeriesPy(const std::string& rsFrom, const std::string& rsTo, const bp::object& roEts)
+    {
+        CBufferView oEtsView(roEts, false);
+        unsigned int nCount = 0;
+        const double* pdEts = ContiguousOf<const double>(oEtsView, 'd', "ets", nCount);
+
+        bp::object oRotations = NewArray(bp::make_tuple(nCount, 3, 3), "float64");
+        bp::object oStatus = NewArray(bp::make_tuple(nCount), "int32");
+        CBufferView oRotationsView(oRotations, true);
+        CBufferView oStatusView(oStatus, true);
+
+        int nResult = 0;
+        {
+            CGilRelease oGilRelease;
+            nResult = GetPositionTransformationMatrixSeries(rsFrom.c_str(), rsTo.c_str(), pdEts, nCount,
+                static_cast<double*>(oRotationsView->buf), nullptr, static_cast<int*>(oStatusView->buf));
+        }
+        CheckResult(nResult, -2, "GetPositionTransformationMatrixSeries");
+        return bp::make_tuple(oRotations, oStatus);
+    }
+
+
+    double Datetime2EtPy(const std::string& rsDatetime)
+    {
+        double dEt = 0.0;
+        CheckResult(Datetime2Et(rsDatetime.c_str(), &dEt), 0, "Datetime2Et");
+        return dEt;
+    }
+
+
+    void InitPy(bool bConsoleLog, const bp::object& roLogFile, int nConsoleLogLevel, int nFileLogLevel)
+    {
+        const std::string sLogFile = roLogFile.is_none() ? std::string() : bp::extract<std::string>(roLogFile)();
+        Init(bConsoleLog, roLogFile.is_none() ? nullptr : sLogFile.c_str(), nConsoleLogLevel, nFileLogLevel);
+    }
+
+
+    void AddSpiceKernelPy(const std::string& rsKernel)
+    {
+        int nResult = 0;
+        {
+            CGilRelease oGilRelease;
+            nResult = AddSpiceKernel(rsKernel.c_str());
+        }
+        CheckResult(nResult, 0, "AddSpiceKernel");
+    }
+
+
+    void SetGeodeticBackendPy(int nBackend)
+    {
+        CheckResult(SetGeodeticBackend(nBackend), 0, "SetGeodeticBackend");
+    }
+}
+
+
+
+BOOST_PYTHON_MODULE(PyCooTransformation)
+{
+    bp::def("api_version", &GetAPIVersion);
+    bp::def("init", &InitPy,
+        (bp::arg("console_log") = false, bp::arg("log_file") = bp::object(), bp::arg("console_log_level") = 1, bp::arg("file_log_level") = 1));
+    bp::def("deinit", &DeInit);
+    bp::def("add_spice_kernel", &AddSpiceKernelPy, (bp::arg("path")));
+    bp::def("set_geodetic_backend", &SetGeodeticBackendPy, (bp::arg("backend")));
+    bp::def("get_geodetic_backend", &GetGeodeticBackend);
+    bp::def("datetime2et", &Datetime2EtPy, (bp::arg("datetime")));
+
+    bp::def("xyz2latlonrad", &Xyz2LatLonRadPy, (bp::arg("xyz"), bp::arg("out") = bp::object()),
+        "(N, 3) cartesian coordinates -> ((N, 3) latitude [deg], longitude [deg], radius, (N,) status)");
+    bp::def("xyz2latlonalt", &Xyz2LatLonAltPy, (bp::arg("body"), bp::arg("xyz"), bp::arg("out") = bp::object()),
+        "(N, 3) cartesian coordinates [m] -> ((N, 3) planetographic latitude [deg], longitude [deg], altitude [m], (N,) status)");
+    bp::def("latlonalt2xyz", &LatLonAlt2XyzPy, (bp::arg("body"), bp::arg("latlonalt"), bp::arg("out") = bp::object()),
+        "(N, 3) planetographic latitude [deg], longitude [deg], altitude [m] -> ((N, 3) cartesian coordinates [m], (N,) status)");
+    bp::def("get_rel_state_series", &GetRelStateSeriesPy,
+        (bp::arg("target"), bp::arg("support"), bp::arg("observer"), bp::arg("frame"), bp::arg("ets")),
+        "(N,) ephemeris times -> ((N, 3) positions [m], (N, 3, 3) rotations, (N,) status)");
+    bp::def("get_position_transformation_matrix_series", &GetPositionTransformationMatrixSeriesPy,
+        (bp::arg("frame_from"), bp::arg("frame_to"), bp::arg("ets")),
+        "(N,) ephemeris times -> ((N, 3, 3) rotations, (N,) status)");
+}
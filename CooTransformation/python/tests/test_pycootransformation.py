@@ -0,0 +1,125 @@
+"""Tests of the NumPy batch bindings in PyCooTransformation.
+
+Usage:
+    PYTHONPATH=<directory of PyCooTransformation> \
+    PYCOOTRANSFORMATION_KERNELS=<kernel>[<os.pathsep><kernel> ...] [PYCOOTRANSFORMATION_BODY=MARS] \
+        python -m pytest tests/test_pycootransformation.py
+
+The kernels must provide the radii of the body. Without PYCOOTRANSFORMATION_KERNELS the tests
+that convert points are skipped; argument checks and unknown bodies are tested without kernels.
+"""
+
+import os
+
+import numpy as np
+import pytest
+
+import PyCooTransformation
+
+
+KERNELS = [path for path in os.environ.get("PYCOOTRANSFORMATION_KERNELS", "").split(os.pathsep) if path]
+BODY = os.environ.get("PYCOOTRANSFORMATION_BODY", "MARS")
+
+needs_kernels = pytest.mark.skipif(not KERNELS, reason="PYCOOTRANSFORMATION_KERNELS is not set")
+
+
+@pytest.fixture(scope="module", autouse=True)
+def library():
+    PyCooTransformation.init()
+    for kernel in KERNELS:
+        PyCooTransformation.add_spice_kernel(kernel)
+    yield
+    PyCooTransformation.deinit()
+
+
+def random_latlonalt(count, seed=42):
+    rng = np.random.default_rng(seed)
+    return np.column_stack((rng.uniform(-89.0, 89.0, count),
+                            rng.uniform(-180.0, 180.0, count),
+                            rng.uniform(-5000.0, 20000.0, count)))
+
+
+@needs_kernels
+def test_round_trip():
+    lla = random_latlonalt(1000)
+    xyz, status = PyCooTransformation.latlonalt2xyz(BODY, lla)
+    assert xyz.shape == (1000, 3) and xyz.dtype == np.float64
+    assert status.shape == (1000,) and status.dtype == np.int32
+    assert np.all(status == 0)
+
+    lla_back, status = PyCooTransformation.xyz2latlonalt(BODY, xyz)
+    assert np.all(status == 0)
+    np.testing.assert_allclose(lla_back[:, 0], lla[:, 0], rtol=0.0, atol=1e-9)
+    # longitudes may come back in [0, 360) instead of [-180, 180)
+    longitude_error = (lla_back[:, 1] - lla[:, 1] + 180.0) % 360.0 - 180.0
+    np.testing.assert_allclose(longitude_error, 0.0, rtol=0.0, atol=1e-9)
+    np.testing.assert_allclose(lla_back[:, 2], lla[:, 2], rtol=0.0, atol=1e-6)
+
+
+@needs_kernels
+def test_strided_input_and_out():
+    lla = random_latlonalt(500)
+    expected, _ = PyCooTransformation.latlonalt2xyz(BODY, lla)
+
+    xyz, status = PyCooTransformation.latlonalt2xyz(BODY, np.asfortranarray(lla))
+    assert np.all(status == 0)
+    np.testing.assert_array_equal(xyz, expected)
+
+    # every second row of a wider array
+    padded = np.full((2 * len(lla), 4), np.nan)
+    padded[::2, :3] = lla
+    xyz, status = PyCooTransformation.latlonalt2xyz(BODY, padded[::2, :3])
+    assert np.all(status == 0)
+    np.testing.assert_array_equal(xyz, expected)
+
+    # reversed column order: negative component stride
+    reversed_columns = np.ascontiguousarray(lla[:, ::-1])
+    xyz, status = PyCooTransformation.latlonalt2xyz(BODY, reversed_columns[:, ::-1])
+    assert np.all(status == 0)
+    np.testing.assert_array_equal(xyz, expected)
+
+    out = np.full((len(lla), 3), np.nan)
+    _, status = PyCooTransformation.latlonalt2xyz(BODY, lla, out=out[:, ::-1])
+    assert np.all(status == 0)
+    np.testing.assert_array_equal(out[:, ::-1], expected)
+
+    out = np.full((3, len(lla)), np.nan).T  # Fortran-ordered output
+    result, status = PyCooTransformation.latlonalt2xyz(BODY, lla, out=out)
+    assert result is out
+    assert np.all(status == 0)
+    np.testing.assert_array_equal(out, expected)
+
+
+@pytest.mark.parametrize("points", [
+    np.zeros((4, 3), dtype=np.float32),
+    np.zeros((4, 3), dtype=np.int64),
+    np.zeros((4, 2)),
+    np.zeros((4, 3, 1)),
+    np.zeros(12),
+])
+def test_wrong_dtype_or_shape(points):
+    with pytest.raises(ValueError):
+        PyCooTransformation.xyz2latlonalt(BODY, points)
+    with pytest.raises(ValueError):
+        PyCooTransformation.latlonalt2xyz(BODY, points)
+
+
+def test_negative_row_stride():
+    with pytest.raises(ValueError):
+        PyCooTransformation.xyz2latlonalt(BODY, np.zeros((4, 3))[::-1])
+
+
+def test_wrong_out():
+    points = np.zeros((4, 3))
+    with pytest.raises(ValueError):
+        PyCooTransformation.latlonalt2xyz(BODY, points, out=np.zeros((5, 3)))
+    with pytest.raises(ValueError):
+        PyCooTransformation.latlonalt2xyz(BODY, points, out=np.zeros((4, 3), dtype=np.float32))
+
+
+def test_unknown_body():
+    points = np.zeros((4, 3))
+    with pytest.raises(RuntimeError):
+        PyCooTransformation.xyz2latlonalt("NO_SUCH_BODY", points)
+    with pytest.raises(RuntimeError):
+        PyCooTransformation.latlonalt2xyz("NO_SUCH_BODY", points)
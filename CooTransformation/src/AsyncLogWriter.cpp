@@ -0,0 +1,150 @@
+#include "AsyncLogWriter.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+
+CAsyncLogWriter::CAsyncLogWriter(std::unique_ptr<std::ofstream> poFile, size_t nCapacity, EOverflowPolicy eOverflowPolicy)
+    : m_poFile(std::move(poFile))
+    , m_eOverflowPolicy(eOverflowPolicy)
+    , m_nEnqueuePos(0)
+    , m_nDequeuePos(0)
+    , m_nDropped(0)
+    , m_bRunning(true)
+{
+    // round capacity up to a power of two so slot indices can be masked
+    size_t nSize = 2;
+    while (nSize < nCapacity)
+    {
+        nSize <<= 1;
+    }
+    m_nMask = nSize - 1;
+    m_aoSlots = std::make_unique<SSlot[]>(nSize);
+    for (size_t i = 0; i < nSize; ++i)
+    {
+        m_aoSlots[i].m_nSequence.store(i, std::memory_order_relaxed);
+    }
+
+    m_oThread = std::thread(&CAsyncLogWriter::Run, this);
+}
+
+
+CAsyncLogWriter::~CAsyncLogWriter()
+{
+    Stop();
+}
+
+
+bool CAsyncLogWriter::Push(std::string&& rsRecord)
+{
+    while (!TryPush(rsRecord))
+    {
+        if (m_eOverflowPolicy == DROP || !m_bRunning.load(std::memory_order_relaxed))
+        {
+            m_nDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+
+void CAsyncLogWriter::Stop()
+{
+    if (m_oThread.joinable())
+    {
+        m_bRunning.store(false);
+        m_oThread.join();
+    }
+}
+
+
+bool CAsyncLogWriter::TryPush(std::string& rsRecord)
+{
+    // bounded MPMC queue by D. Vyukov, used here with a single consumer
+    size_t nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+    SSlot* poSlot = nullptr;
+    for (;;)
+    {
+        poSlot = &m_aoSlots[nPos & m_nMask];
+        size_t nSequence = poSlot->m_nSequence.load(std::memory_order_acquire);
+        intptr_t nDiff = static_cast<intptr_t>(nSequence) - static_cast<intptr_t>(nPos);
+        if (nDiff == 0)
+        {
+            if (m_nEnqueuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (nDiff < 0)
+        {
+            return false; // full
+        }
+        else
+        {
+            nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    poSlot->m_sRecord = std::move(rsRecord);
+    poSlot->m_nSequence.store(nPos + 1, std::memory_order_release);
+    return true;
+}
+
+
+bool CAsyncLogWriter::TryPop(std::string& rsRecord)
+{
+    SSlot& roSlot = m_aoSlots[m_nDequeuePos & m_nMask];
+    if (roSlot.m_nSequence.load(std::memory_order_acquire) != m_nDequeuePos + 1)
+    {
+        return false; // empty
+    }
+
+    rsRecord.swap(roSlot.m_sRecord);
+    roSlot.m_sRecord.clear();
+    roSlot.m_nSequence.store(m_nDequeuePos + m_nMask + 1, std::memory_order_release);
+    ++m_nDequeuePos;
+    return true;
+}
+
+
+void CAsyncLogWriter::Run()
+{
+    std::string sBatch;
+    std::string sRecord;
+    for (;;)
+    {
+        // read the flag before draining, so records pushed before Stop() are always written
+        bool bRunning = m_bRunning.load();
+
+        size_t nRecords = 0;
+        while (nRecords <= m_nMask && TryPop(sRecord))
+        {
+            sBatch += sRecord;
+            ++nRecords;
+        }
+
+        unsigned long long nDropped = m_nDropped.exchange(0, std::memory_order_relaxed);
+        if (nDropped != 0)
+        {
+            sBatch += "[log writer] " + std::to_string(nDropped) + " log record(s) dropped.\n";
+        }
+
+        if (!sBatch.empty())
+        {
+            m_poFile->write(sBatch.data(), static_cast<std::streamsize>(sBatch.size()));
+            m_poFile->flush();
+            sBatch.clear();
+        }
+        else if (!bRunning)
+        {
+            break;
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    m_poFile->close();
+}
@@ -0,0 +1,60 @@
+#ifndef JR_PRO3D_EXTENSIONS_ASYNCLOGWRITER_HPP
+#define JR_PRO3D_EXTENSIONS_ASYNCLOGWRITER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+
+/** CAsyncLogWriter: writes preformatted log records to a file on a background thread.
+  * Producers push records into a bounded lock-free ring (multi-producer, single-consumer);
+  * the writer thread drains the ring in batches and flushes once per batch.
+  **/
+class CAsyncLogWriter
+{
+public:
+    enum EOverflowPolicy
+    {
+        DROP = 0,   /* discard records while the ring is full; the writer logs the number of lost records */
+        BLOCK = 1   /* wait until the writer has made room */
+    };
+
+    CAsyncLogWriter(std::unique_ptr<std::ofstream> poFile, size_t nCapacity, EOverflowPolicy eOverflowPolicy);
+    ~CAsyncLogWriter();
+
+    CAsyncLogWriter(const CAsyncLogWriter&) = delete;
+    CAsyncLogWriter& operator=(const CAsyncLogWriter&) = delete;
+
+    /** Queue a record. Returns false if the record was dropped. **/
+    bool Push(std::string&& rsRecord);
+
+    /** Write all queued records, flush and close the file. Further records are dropped. **/
+    void Stop();
+
+private:
+    struct SSlot
+    {
+        std::atomic<size_t> m_nSequence;
+        std::string m_sRecord;
+    };
+
+    bool TryPush(std::string& rsRecord);
+    bool TryPop(std::string& rsRecord);
+    void Run();
+
+    std::unique_ptr<std::ofstream> m_poFile;
+    std::unique_ptr<SSlot[]> m_aoSlots;
+    size_t m_nMask;
+    EOverflowPolicy m_eOverflowPolicy;
+
+    alignas(64) std::atomic<size_t> m_nEnqueuePos;
+    alignas(64) size_t m_nDequeuePos; // writer thread only
+    std::atomic<unsigned long long> m_nDropped;
+    std::atomic<bool> m_bRunning;
+    std::thread m_oThread;
+};
+
+#endif // JR_PRO3D_EXTENSIONS_ASYNCLOGWRITER_HPP
@@ -1,4 +1,11 @@
 #include<CooTransformation/CooTransformation.hpp>
+#include "AsyncLogWriter.hpp"
+#include "GeodeticKernels.hpp"
+#include "KernelPoolCache.hpp"
+#include "LatLonGrid.hpp"
+#include "LruCache.hpp"
+#include "Stats.hpp"
+#include "VertexOutput.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -14,6 +21,15 @@
 #include <vector>
 #include <algorithm>
 #include <type_traits>
+#include <cmath>
+#include <cctype>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <chrono>
 // #include <filesystem>
 
 #include <SpiceUsr.h>
@@ -39,11 +55,77 @@ static std::string LogLevelStr[] =
     "Trace"
 };
 
-static int s_nConsoleLogLevel = static_cast<int>(TRACE);
-static int s_nFileLogLevel = static_cast<int>(TRACE);
-static bool s_bLogConsole = true;
+static std::atomic<int> s_nConsoleLogLevel = static_cast<int>(TRACE);
+static std::atomic<int> s_nFileLogLevel = static_cast<int>(TRACE);
+static std::atomic<bool> s_bLogConsole = true;
+static std::mutex s_oLogMutex; // guards s_logfile and the output streams
 static std::unique_ptr<std::ofstream> s_logfile;
 
+// Set instead of s_logfile when file logging is asynchronous. Owned by InitEx()/DeInit(); DeInit()
+// waits for s_nAsyncLogProducers to drop to zero before it destroys the writer.
+static std::atomic<CAsyncLogWriter*> s_poAsyncLogWriter = nullptr;
+static std::atomic<int> s_nAsyncLogProducers = 0;
+
+// Highest level accepted by any enabled sink (-1: logging disabled). Checked by COO_LOG()
+// before the message is built, so disabled messages cost one relaxed load.
+static std::atomic<int> s_nActiveLogLevel = static_cast<int>(TRACE);
+
+
+
+static inline bool IsLogEnabled(LogLevel eLogType)
+{
+#ifdef COOTRANSFORMATION_NO_TRACE_LOG
+    if (eLogType == LogLevel::TRACE)
+    {
+        return false;
+    }
+#endif
+    return s_nActiveLogLevel.load(std::memory_order_relaxed) >= static_cast<int>(eLogType);
+}
+
+// Evaluates the message arguments only if the level is enabled. With COOTRANSFORMATION_NO_TRACE_LOG
+// defined, TRACE messages are removed at compile time.
+#define COO_LOG(eLogType, ...) \
+    do { if (IsLogEnabled(eLogType)) { Log(eLogType, __VA_ARGS__); } } while (false)
+
+
+
+static void UpdateActiveLogLevel()
+{
+    std::lock_guard<std::mutex> oLock(s_oLogMutex);
+    int nActive = s_bLogConsole ? s_nConsoleLogLevel.load() : -1;
+    if ((s_logfile && s_logfile->is_open()) || s_poAsyncLogWriter.load())
+    {
+        nActive = std::max(nActive, s_nFileLogLevel.load());
+    }
+    s_nActiveLogLevel = nActive;
+}
+
+
+
+static const std::string& LogTimestamp()
+{
+    // localtime and put_time are only needed once per second and thread
+    thread_local std::time_t s_nTimestampTime = -1;
+    thread_local std::string s_sTimestamp;
+
+    auto time = std::time(nullptr);
+    if (time != s_nTimestampTime)
+    {
+        std::tm tm = {};
+#ifdef _WIN32
+        localtime_s(&tm, &time);
+#else
+        localtime_r(&time, &tm);
+#endif
+        std::stringstream ss;
+        ss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S.%z%Z");
+        s_sTimestamp = ss.str();
+        s_nTimestampTime = time;
+    }
+    return s_sTimestamp;
+}
+
 
 
 static void Log(LogLevel eLogType, const std::string& rsMsg)
@@ -52,18 +134,28 @@ static void Log(LogLevel eLogType, const std::string& rsMsg)
 
     if (s_bLogConsole && s_nConsoleLogLevel >= static_cast<int>(eLogType))
     {
+        std::lock_guard<std::mutex> oLock(s_oLogMutex);
         std::cerr << "CooTransformation: " << sMsg << std::endl;
     }
-    if (s_logfile && s_logfile->is_open() && s_nFileLogLevel >= static_cast<int>(eLogType))
+    if (s_nFileLogLevel >= static_cast<int>(eLogType))
     {
-        auto time = std::time(nullptr);
-        auto tm = *std::localtime(&time);
-        std::stringstream ss;
-        ss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S.%z%Z");
-        std::string timestamp = ss.str();
+        ++s_nAsyncLogProducers;
+        CAsyncLogWriter* poAsyncLogWriter = s_poAsyncLogWriter.load();
+        if (poAsyncLogWriter)
+        {
+            poAsyncLogWriter->Push("[" + LogTimestamp() + "] " + sMsg + "\n");
+        }
+        --s_nAsyncLogProducers;
 
-        *s_logfile << "[" + timestamp + "] " << sMsg << std::endl;
-        s_logfile->flush();
+        if (!poAsyncLogWriter)
+        {
+            std::lock_guard<std::mutex> oLock(s_oLogMutex);
+            if (s_logfile && s_logfile->is_open())
+            {
+                *s_logfile << "[" + LogTimestamp() + "] " << sMsg << '\n';
+                s_logfile->flush();
+            }
+        }
     }
 }
 
@@ -111,421 +203,3079 @@ static void SetSpiceErrorHandling(const std::string& rsAction, const std::string
 }   // SetSpiceErrorHandling()
 
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-int Str2Et( const std::string& rsTimestamp, double& rdEt )
-{
-    Log(LogLevel::TRACE, "Str2Et() called with timestamp = \"" + rsTimestamp + "\".");
-
-    str2et_c( rsTimestamp.c_str(), &rdEt );
-    if( SpiceHasFailed() )
-    {
-        char acSMsg[SPICE_ERROR_LMSGLN]; // short message
-        char acXMsg[SPICE_ERROR_LMSGLN]; // explanation of short message
-        getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
-        getmsg_c("EXPLAIN", SPICE_ERROR_LMSGLN, acXMsg);
-        reset_c();
-        Log(LogLevel::ERROR,
-            std::string("Str2Et() failed with error: \"") + acSMsg + "\": \"" + acXMsg + "\"");
-        return -1;
-    }
 
-    Log(LogLevel::TRACE, "Str2Et() finished with et = " + std::to_string( rdEt ));
-    return 0;
-}
+// CSPICE is not thread-safe. Every access to SPICE and to the caches below must hold this lock.
+// It is recursive because exported functions call each other (e.g. GetRelState() -> Str2Et()).
+static std::recursive_mutex s_oSpiceMutex;
+using SpiceLock = std::lock_guard<std::recursive_mutex>;
 
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-unsigned int GetAPIVersion()
+struct SBodyRadii
 {
-    Log(LogLevel::TRACE, "GetAPIVersion() called.");
-    Log(LogLevel::TRACE, "GetAPIVersion() finished.");
-    return 5;
-}
-
+    double m_adRadii[3];
+    double m_dRadiusEquat;
+    double m_dFlattening;
+    int m_nLongitudeSense; // planetographic longitude: 1 positive east, -1 positive west, 0 unknown
+};
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-int Init(bool bConsoleLog, const char* pcLogFile, int nConsoleLogLevel, int nFileLogLevel)
-{
-    Log(LogLevel::TRACE, "Init() called.");
-    DeInit();
+// Radii and flattening per normalized body name. Filled lazily by LookupBodyRadii() and cleared
+// whenever AddSpiceKernel() modifies the kernel pool.
+static std::unordered_map<std::string, SBodyRadii> s_mapBodyRadii;
+static unsigned long long s_nBodyRadiiCacheHits = 0;
+static unsigned long long s_nBodyRadiiCacheMisses = 0;
 
-    // temporarily enable logging:
-    s_nConsoleLogLevel = static_cast<int>(TRACE);
-    s_nFileLogLevel = static_cast<int>(TRACE);
-    s_bLogConsole = true;
 
-    // clamp log levels:
-    nConsoleLogLevel = std::clamp( nConsoleLogLevel, -1, static_cast<int>(LogLevel::TRACE));
-    nFileLogLevel = std::clamp( nConsoleLogLevel, -1, static_cast<int>(LogLevel::TRACE));
 
-    if ( nConsoleLogLevel >= 0 )
-    {
-        Log(LogLevel::TRACE, "Console log level set to \"" + LogLevelStr[nConsoleLogLevel] + "\"." );
-    }
-    else
+static std::string NormalizeSpiceName(const char* pcName)
+{
+    // Same rules SPICE applies to body and frame names: case-insensitive, leading/trailing
+    // blanks ignored and consecutive embedded blanks compressed to one.
+    std::string sName;
+    bool bPendingBlank = false;
+    for (const char* pc = pcName; *pc; ++pc)
     {
-        s_bLogConsole = false;
+        if (std::isspace(static_cast<unsigned char>(*pc)))
+        {
+            bPendingBlank = !sName.empty();
+            continue;
+        }
+        if (bPendingBlank)
+        {
+            sName += ' ';
+            bPendingBlank = false;
+        }
+        sName += static_cast<char>(std::toupper(static_cast<unsigned char>(*pc)));
     }
+    return sName;
+}   // NormalizeSpiceName()
 
-    s_bLogConsole = bConsoleLog;
-    s_nConsoleLogLevel = nConsoleLogLevel;
-    s_nFileLogLevel = nFileLogLevel;
 
 
-    if( pcLogFile )
+static bool MatchesSpiceName(const char* pcName, const std::string& rsNormalizedName)
+{
+    // Allocation-free equivalent of NormalizeSpiceName(pcName) == rsNormalizedName.
+    size_t nPos = 0;
+    bool bPendingBlank = false;
+    for (const char* pc = pcName; *pc; ++pc)
     {
-        std::string sLogFile = pcLogFile;
-        if(!sLogFile.empty())
+        if (std::isspace(static_cast<unsigned char>(*pc)))
         {
-            s_logfile = std::make_unique<std::ofstream>(std::ofstream(sLogFile, std::ios::out|std::ios::app));
-            if(s_logfile->is_open())
-            {
-                Log(LogLevel::DEBUG, "Initialized log file: \"" + sLogFile + "\"");
-            }
-            else
+            bPendingBlank = (nPos != 0);
+            continue;
+        }
+        if (bPendingBlank)
+        {
+            if (nPos >= rsNormalizedName.size() || rsNormalizedName[nPos] != ' ')
             {
-                Log(LogLevel::WARNING, "Could not open log file: \"" + sLogFile + "\"!");
+                return false;
             }
+            ++nPos;
+            bPendingBlank = false;
         }
+        if (nPos >= rsNormalizedName.size() ||
+            rsNormalizedName[nPos] != static_cast<char>(std::toupper(static_cast<unsigned char>(*pc))))
+        {
+            return false;
+        }
+        ++nPos;
     }
+    return nPos == rsNormalizedName.size();
+}   // MatchesSpiceName()
 
-    // Initialize CSPICE library
-    std::string sSpiceVersion(tkvrsn_c("toolkit"));
-    Log(LogLevel::INFO, "Initializing SPICE toolkit version '" + sSpiceVersion + "'.");
 
-    // Set error handling system of CSPICE to continue if error occurs
-    SetSpiceErrorHandling("RETURN", "NULL", "SHORT, EXPLAIN");
 
-    Log(LogLevel::TRACE, "Init() finished.");
+static int QueryBodyRadii(const std::string& rsBody, const SpiceInt* pnBodyId, SBodyRadii& roBody)
+{
+    // Look up the radii for the planet, by NAIF ID if known. Although we omit it here, we could first call badkpv_c
+    // to make sure the variable BODY?99_RADII has three elements and numeric data type.
+    // If the variable is not present in the kernel pool, bodvrd_c will signal an error.
+    SpiceInt nDim = 0;
+    SBodyRadii oBody = {};
+    if (pnBodyId)
+    {
+        bodvcd_c(*pnBodyId, "RADII", 3, &nDim, oBody.m_adRadii);
+    }
+    else
+    {
+        bodvrd_c(rsBody.c_str(), "RADII", 3, &nDim, oBody.m_adRadii);
+    }
+    if (SpiceHasFailed() || nDim != 3)
+    {
+        reset_c();
+        return -1;
+    }
+
+    // Compute flattening coefficient.
+    double dRadiusEquat = oBody.m_adRadii[0];
+    double dRadiusPole = dRadiusEquat; // use spherical Mars model instead of spheroid to be consistent with MCZ conventions
+    oBody.m_dRadiusEquat = dRadiusEquat;
+    oBody.m_dFlattening = (dRadiusEquat - dRadiusPole) / dRadiusEquat;
+
+    // The native geodetic kernels need the longitude sense recpgr_c() uses for this body
+    // (positive west for prograde bodies except Earth, Moon and Sun, or a PGR_POSITIVE_LON override).
+    // The point on the +Y axis has longitude 90 deg if positive east and 270 deg if positive west.
+    double adProbe[3] = { 0.0, 1.0, 0.0 };
+    double dProbeLon = 0.0;
+    double dProbeLat = 0.0;
+    double dProbeAlt = 0.0;
+    recpgr_c(rsBody.c_str(), adProbe, dRadiusEquat, oBody.m_dFlattening, &dProbeLon, &dProbeLat, &dProbeAlt);
+    if (SpiceHasFailed())
+    {
+        reset_c();
+        oBody.m_nLongitudeSense = 0;
+    }
+    else
+    {
+        oBody.m_nLongitudeSense = (dProbeLon < pi_c()) ? 1 : -1;
+    }
+
+    roBody = oBody;
     return 0;
-}
+}   // QueryBodyRadii()
 
 
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-int AddSpiceKernel(const char* pcKernelPath)
+static int LookupBodyRadii(const char* pcPlanet, SBodyRadii& roBody)
 {
-    if( !pcKernelPath )
+    std::string sBody = NormalizeSpiceName(pcPlanet);
+    auto it = s_mapBodyRadii.find(sBody);
+    if (it != s_mapBodyRadii.end())
     {
-        Log(LogLevel::ERROR, "AddSpiceKernel() called with nullptr arguments." );
-        return -1;
+        ++s_nBodyRadiiCacheHits;
+        roBody = it->second;
+        return 0;
     }
+    ++s_nBodyRadiiCacheMisses;
 
-    std::string pcSpiceKernelPath = pcKernelPath;
-
-    Log(LogLevel::TRACE, "AddSpiceKernel() called with spice kernel path = \"" + pcSpiceKernelPath + "\".");
-    if (!pcSpiceKernelPath.empty())
+    if (QueryBodyRadii(sBody, nullptr, roBody) != 0)
     {
-        furnsh_c(pcSpiceKernelPath.c_str());
-        if (SpiceHasFailed())
-        {
-            char acSMsg[SPICE_ERROR_LMSGLN]; // short message
-            char acXMsg[SPICE_ERROR_LMSGLN]; // explanation of short message
-            getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
-            getmsg_c("EXPLAIN", SPICE_ERROR_LMSGLN, acXMsg);
-            reset_c();
-            Log(LogLevel::WARNING,
-                "Could not load CSPICE: \"" + pcSpiceKernelPath + "\" (" + acSMsg + ": " + acXMsg + ")!");
-            return -2;
-        }
-        else
-        {
-            Log(LogLevel::INFO, "Loaded CSpice Kernel \"" + pcSpiceKernelPath + "\".");
-        }
+        return -1;
     }
-
-    Log(LogLevel::TRACE, "AddSpiceKernel() finished.");
+    s_mapBodyRadii.emplace(std::move(sBody), roBody);
     return 0;
-}
+}   // LookupBodyRadii()
 
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-void DeInit()
+
+// Bodies and frames resolved once by GetBodyHandle() and GetFrameHandle(). Handle values are
+// never reused: every new handle takes the next value of a counter that is not reset. AddSpiceKernel()
+// clears the tables, so old handles are no longer found instead of pointing at stale data, no
+// matter how many kernel pool changes happened since.
+struct SBodyHandle
 {
-    s_logfile.reset();
-}
+    std::string m_sName; // normalized
+    SpiceInt m_nId;
+    int m_nRadiiResult; // result of QueryBodyRadii()
+    SBodyRadii m_oRadii;
+};
 
+struct SFrameHandle
+{
+    std::string m_sName; // normalized
+    SpiceInt m_nCode;
+};
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-int Xyz2LatLonRad(double dX, double dY, double dZ, double* pdLat, double* pdLon, double* pdRad)
+static std::unordered_map<int, SBodyHandle> s_mapBodyHandles;
+static std::unordered_map<int, SFrameHandle> s_mapFrameHandles;
+static int s_nLastHandle = 0;
+
+
+// Next unused handle value, or 0 once the int range is exhausted.
+static int NextHandle()
 {
-    if( !pdLat || !pdLon || !pdRad )
+    if (s_nLastHandle == std::numeric_limits<int>::max())
     {
-        Log(LogLevel::ERROR, "Xyz2LatLonRad() called with nullptr arguments." );
-        return -1;
+        return 0;
     }
+    return ++s_nLastHandle;
+}
 
-    Log(LogLevel::TRACE, "Xyz2LatLonRad() called with xyz = (" + std::to_string(dX) + ", " + std::to_string(dY) + ", " + std::to_string(dZ) + ")");
 
-    double adXyz[3] = { dX * 0.001, dY * 0.001, dZ * 0.001 };
-    reclat_c(adXyz, pdRad, pdLon, pdLat);
-    if (SpiceHasFailed())
-    {
-        reset_c();
-        return -1;
-    }
-    // Convert to degree and meters
-    *pdLon /= rpd_c();
-    *pdLat /= rpd_c();
-    *pdRad *= 1000.0;
+static const SBodyHandle* FindBodyHandle(int nHandle)
+{
+    auto it = s_mapBodyHandles.find(nHandle);
+    return (it != s_mapBodyHandles.end()) ? &it->second : nullptr;
+}
 
-    Log(LogLevel::TRACE, "Xyz2LatLonRad() finished with lat, lon, rad = (" + std::to_string(*pdLat) + ", " + std::to_string(*pdLon) + ", " + std::to_string(*pdRad) + ")");
 
-    return 0;
+static const SFrameHandle* FindFrameHandle(int nHandle)
+{
+    auto it = s_mapFrameHandles.find(nHandle);
+    return (it != s_mapFrameHandles.end()) ? &it->second : nullptr;
 }
 
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-int Xyz2LatLonAlt(const char* pcPlanet, double dX, double dY, double dZ, double* pdLat, double* pdLon, double* pdAlt)
+
+// A body or frame passed either by name or through a handle (m_bResolved, m_nCode holds the
+// NAIF ID or frame code). Resolved references never require a name lookup by this library.
+struct SSpiceRef
 {
-    if( !pcPlanet || !pdLat || !pdLon || !pdAlt )
-    {
-        Log(LogLevel::ERROR, "Xyz2LatLonAlt() called with nullptr arguments." );
-        return -1;
-    }
+    const char* m_pcName;
+    SpiceInt m_nCode;
+    bool m_bResolved;
+};
+
+static SSpiceRef NameRef(const char* pcName)
+{
+    return { pcName, 0, false };
+}
 
-    Log(LogLevel::TRACE, "Xyz2LatLonAlt() called with planet = " + std::string{pcPlanet} + ", xyz = (" + std::to_string(dX) + ", " + std::to_string(dY) + ", " + std::to_string(dZ) + ")");
 
-    // Look up the radii for the planet. Although we omit it here, we could first call badkpv_c
-    // to make sure the variable BODY?99_RADII has three elements and numeric data type.
-    // If the variable is not present in the kernel pool, bodvrd_c will signal an error.
-    SpiceInt nDim = 0;
-    double adRadii[3] = { 0.0, 0.0, 0.0 };
-    bodvrd_c(pcPlanet, "RADII", 3, &nDim, adRadii);
-    if (SpiceHasFailed() || nDim != 3)
+static SSpiceRef ResolveBodyRef(const char* pcName)
+{
+    // Unknown names stay unresolved, so SPICE reports the error where the body is used.
+    SpiceInt nId = 0;
+    SpiceBoolean bFound = SPICEFALSE;
+    bodn2c_c(pcName, &nId, &bFound);
+    if (SpiceHasFailed())
     {
         reset_c();
-        return -2;
+        return NameRef(pcName);
     }
+    return bFound ? SSpiceRef{ pcName, nId, true } : NameRef(pcName);
+}
 
-    // Compute flattening coefficient.
-    double dRadiusEquat = adRadii[0];
-    double dRadiusPole = dRadiusEquat; // use spherical Mars model instead of spheroid to be consistent with MCZ conventions
-    double dFlattening = (dRadiusEquat - dRadiusPole) / dRadiusEquat;
 
-    // Do the conversion.
-    double adXyz[3] = { dX * 0.001, dY * 0.001, dZ * 0.001 };
-    recpgr_c(pcPlanet, adXyz, dRadiusEquat, dFlattening, pdLon, pdLat, pdAlt);
+static SSpiceRef ResolveFrameRef(const char* pcName)
+{
+    SpiceInt nCode = 0;
+    namfrm_c(pcName, &nCode);
     if (SpiceHasFailed())
     {
         reset_c();
-        return -3;
+        return NameRef(pcName);
     }
-    // Convert to degree and meters
-    *pdLon /= rpd_c();
-    *pdLat /= rpd_c();
-    *pdAlt *= 1000.0;
+    return (nCode != 0) ? SSpiceRef{ pcName, nCode, true } : NameRef(pcName);
+}
 
-    Log(LogLevel::TRACE, "Xyz2LatLonAlt() finished with lat, lon, alt = (" + std::to_string(*pdLat) + ", " + std::to_string(*pdLon) + ", " + std::to_string(*pdAlt) + ")");
 
-    return 0;
+
+// Active geodetic backend, see SetGeodeticBackend(). nullptr kernels select the SPICE path.
+static std::atomic<const SGeodeticKernels*> s_poGeodeticKernels{nullptr};
+static std::atomic<int> s_nGeodeticBackend{GEODETIC_BACKEND_SPICE};
+
+
+static const SGeodeticKernels* GetNativeKernels(const SBodyRadii& roBody)
+{
+    // Bodies whose longitude sense could not be determined stay on the SPICE path, which reports the error.
+    return (roBody.m_nLongitudeSense != 0) ? s_poGeodeticKernels.load(std::memory_order_relaxed) : nullptr;
 }
 
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-int LatLonAlt2Xyz(const char* pcPlanet, double dLat, double dLon, double dAlt, double* pdX, double* pdY, double* pdZ)
+// Run a native kernel over strided arrays. Kernels only accept contiguous arrays, so strided data
+// is copied through small blocks on the stack.
+template <typename Kernel>
+static void RunNativeKernel(
+    Kernel pfnKernel, size_t nCount,
+    const double* pdInA, const double* pdInB, const double* pdInC, size_t nInStride,
+    double dRadius, bool bPositiveEast,
+    double* pdOutA, double* pdOutB, double* pdOutC, size_t nOutStride)
 {
-    if( !pcPlanet || !pdX || !pdY || !pdZ )
+    if (nInStride == 1 && nOutStride == 1)
     {
-        Log(LogLevel::ERROR, "LatLonAlt2Xyz() called with nullptr arguments." );
-        return -1;
+        pfnKernel(nCount, pdInA, pdInB, pdInC, dRadius, bPositiveEast, pdOutA, pdOutB, pdOutC);
+        return;
     }
 
-    Log(LogLevel::TRACE, "LatLonAlt2Xyz() called with planet = " + std::string{pcPlanet} + ", xyz = (" + std::to_string(dLat) + ", " + std::to_string(dLon) + ", " + std::to_string(dAlt) + ")");
-    // Look up the radii for the planet. Although we omit it here, we could first call badkpv_c
-    // to make sure the variable BODY?99_RADII has three elements and numeric data type.
-    // If the variable is not present in the kernel pool, bodvrd_c will signal an error.
-    SpiceInt nDim = 0;
-    double adRadii[3] = { 0.0, 0.0, 0.0 };
-    bodvrd_c(pcPlanet, "RADII", 3, &nDim, adRadii);
-    if (SpiceHasFailed() || nDim != 3)
+    constexpr size_t BLOCK_SIZE = 256;
+    double adIn[3][BLOCK_SIZE];
+    double adOut[3][BLOCK_SIZE];
+    for (size_t nStart = 0; nStart < nCount; nStart += BLOCK_SIZE)
     {
-        reset_c();
-        return -2;
+        const size_t nBlock = std::min(BLOCK_SIZE, nCount - nStart);
+        for (size_t i = 0; i < nBlock; ++i)
+        {
+            adIn[0][i] = pdInA[(nStart + i) * nInStride];
+            adIn[1][i] = pdInB[(nStart + i) * nInStride];
+            adIn[2][i] = pdInC[(nStart + i) * nInStride];
+        }
+        pfnKernel(nBlock, adIn[0], adIn[1], adIn[2], dRadius, bPositiveEast, adOut[0], adOut[1], adOut[2]);
+        for (size_t i = 0; i < nBlock; ++i)
+        {
+            pdOutA[(nStart + i) * nOutStride] = adOut[0][i];
+            pdOutB[(nStart + i) * nOutStride] = adOut[1][i];
+            pdOutC[(nStart + i) * nOutStride] = adOut[2][i];
+        }
     }
+}   // RunNativeKernel()
 
-    // Compute flattening coefficient.
-    double dRadiusEquat = adRadii[0];
-    double dRadiusPole = dRadiusEquat; // use spherical Mars model instead of spheroid to be consistent with MCZ conventions
-    double dFlattening = (dRadiusEquat - dRadiusPole) / dRadiusEquat;
 
-    // Do the conversion.
-    double adXyz[3] = { 0.0, 0.0, 0.0 };
-    pgrrec_c(pcPlanet, dLon * rpd_c(), dLat * rpd_c(), dAlt * 0.001, dRadiusEquat, dFlattening, adXyz);
-    if (SpiceHasFailed())
-    {
-        reset_c();
-        return -3;
-    }
-    // Convert to meters
-    *pdX = adXyz[0] * 1000.0;
-    *pdY = adXyz[1] * 1000.0;
-    *pdZ = adXyz[2] * 1000.0;
 
-    Log(LogLevel::TRACE, "LatLonAlt2Xyz() finished with xyz = (" + std::to_string(*pdX) + ", " + std::to_string(*pdY) + ", " + std::to_string(*pdZ) + ")");
-    return 0;
-}
+// Piecewise cubic Hermite representation of the state of a target w.r.t. an observer.
+// Nodes are equally spaced, so a lookup is a single index computation.
+struct SEphemerisCache
+{
+    int m_nId;
+    std::string m_sTarget;
+    std::string m_sObserver;
+    std::string m_sFrame;
+    SpiceInt m_nTargetId;   // NAIF IDs and frame code for handle-based lookups,
+    SpiceInt m_nObserverId; // NO_SPICE_CODE if SPICE cannot resolve the name
+    SpiceInt m_nFrameCode;
+    double m_dStartEt;
+    double m_dEndEt;
+    double m_dStep;
+    double m_dMaxError; // [km]
+    std::vector<std::array<double, 6>> m_vecNodes; // [km], [km/s]
+};
 
+static const SpiceInt NO_SPICE_CODE = std::numeric_limits<SpiceInt>::min();
 
-JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
-int GetRelState(
-    const char* pcTargetBody,
-    const char* pcSupportBody,
-    const char* pcObserverBody,
-    const char* pcObserverTime,
-    const char* pcOutputReferenceFrame,
-    double* pdPosVec,
-    double* pdRotMat
-)
+static std::vector<std::unique_ptr<SEphemerisCache>> s_vecEphemerisCaches;
+static int s_nNextEphemerisCacheId = 1;
+
+
+
+static void EvalEphemerisCache(const SEphemerisCache& roCache, double dEt, double* pdState)
 {
-    if( !pcTargetBody || !pcSupportBody || !pcObserverBody || !pcObserverTime || !pcOutputReferenceFrame || !pdPosVec || !pdRotMat )
+    const size_t nSegments = roCache.m_vecNodes.size() - 1;
+    double dSegment = std::floor((dEt - roCache.m_dStartEt) / roCache.m_dStep);
+    size_t nSegment = static_cast<size_t>(std::clamp(dSegment, 0.0, static_cast<double>(nSegments - 1)));
+
+    const double dH = roCache.m_dStep;
+    const double dT = (dEt - (roCache.m_dStartEt + static_cast<double>(nSegment) * dH)) / dH;
+    const double dT2 = dT * dT;
+    const double dT3 = dT2 * dT;
+
+    // Hermite basis and its derivative w.r.t. dT
+    const double dH00 = 2.0 * dT3 - 3.0 * dT2 + 1.0;
+    const double dH10 = dT3 - 2.0 * dT2 + dT;
+    const double dH01 = -2.0 * dT3 + 3.0 * dT2;
+    const double dH11 = dT3 - dT2;
+    const double dD00 = 6.0 * dT2 - 6.0 * dT;
+    const double dD10 = 3.0 * dT2 - 4.0 * dT + 1.0;
+    const double dD01 = -dD00;
+    const double dD11 = 3.0 * dT2 - 2.0 * dT;
+
+    const auto& rP0 = roCache.m_vecNodes[nSegment];
+    const auto& rP1 = roCache.m_vecNodes[nSegment + 1];
+    for (int i = 0; i < 3; ++i)
     {
-        Log(LogLevel::ERROR, "GetRelState() called with nullptr arguments." );
-        return -1;
+        pdState[i] = dH00 * rP0[i] + dH10 * dH * rP0[i + 3] + dH01 * rP1[i] + dH11 * dH * rP1[i + 3];
+        pdState[i + 3] = (dD00 * rP0[i] + dD01 * rP1[i]) / dH + dD10 * rP0[i + 3] + dD11 * rP1[i + 3];
     }
+}   // EvalEphemerisCache()
 
-    Log(LogLevel::TRACE, std::string{"GetRelState() called with "} +
-        "target body = \"" + std::string{pcTargetBody} + "\", " +
-        "support body = \"" + std::string{pcSupportBody} + "\", " +
-        "observer body = \"" + std::string{pcObserverBody} + "\", " +
-        "observer time = \"" + std::string{pcObserverTime} + "\", " +
-        "reference frame = \"" + std::string{pcOutputReferenceFrame} + "\"."
-    );
 
-    //Return the state (position and velocity) of a target body
-    //    relative to an observing body, optionally corrected for light
-    //    time (planetary aberration) and stellar aberration.
 
-    double dObserverTime = {};
-    int ret_val = Str2Et( pcObserverTime, dObserverTime );
-    if(ret_val != 0)
-    {
-        return -2;
-    }
+// Coverage of the loaded SPK files per body and of the loaded CK files per CK structure, see
+// GetCoverageWindows(). Queries outside the coverage are rejected before calling SPICE. Ids
+// without segments of their own are not in the maps, since SPICE may still derive them (e.g.
+// the solar system barycenter).
+using CoverageWindows = std::vector<std::pair<double, double>>; // sorted, disjoint, [ET]
 
-    auto sAberrationCorrection = std::string{"NONE"};
-    //if ( pcAberrationCorrection != nullptr )
-    //{
-    //    sAberrationCorrection = pcAberrationCorrection;
-    //}
+static std::unordered_map<SpiceInt, CoverageWindows> s_mapSpkCoverage;
+static std::unordered_map<SpiceInt, CoverageWindows> s_mapCkCoverage;
+static std::unordered_set<std::string> s_setIndexedKernels;
+// CK structure id per frame code, 0 for frames of other classes. Depends on the frame kernels,
+// so it is cleared by InvalidateKernelPoolCaches().
+static std::unordered_map<SpiceInt, SpiceInt> s_mapFrameCkIds;
 
+// Set if a loaded file could not be indexed; its ids may be covered beyond the index, so the
+// checks of that kind are left to SPICE.
+static bool s_bSpkCoverageIncomplete = false;
+static bool s_bCkCoverageIncomplete = false;
 
-    // Support body position for rotation, e.g. SUN:
-    auto dSupportPosVec = std::array<double, 3>{};
-    {
-        //SpiceDouble state[6] = {};
-        auto state = std::array<double, 6>{};
-        double unused = {};
-        spkezr_c( pcSupportBody, dObserverTime, pcOutputReferenceFrame, sAberrationCorrection.c_str(), pcObserverBody, state.data(), &unused );
-        if(SpiceHasFailed())
-        {
+// Initial cell sizes, doubled while a kernel does not fit up to COVERAGE_MAX_CELL_SIZE.
+static const SpiceInt COVERAGE_INITIAL_IDS = 1000;
+static const SpiceInt COVERAGE_INITIAL_DOUBLES = 20000;
+static const SpiceInt COVERAGE_MAX_CELL_SIZE = 1 << 26;
+
+
+
+// SpiceCell on the heap, the SPICE*_CELL macros only declare fixed-size static cells.
+template <typename T>
+class CCoverageCell
+{
+public:
+    CCoverageCell(SpiceCellDataType eType, SpiceInt nSize) : m_eType(eType)
+    {
+        Resize(nSize);
+    }
+
+    // Drops the content.
+    void Resize(SpiceInt nSize)
+    {
+        m_vecData.assign(static_cast<size_t>(SPICE_CELL_CTRLSZ + nSize), T());
+        m_oCell = { m_eType, 0, nSize, 0, SPICETRUE, SPICEFALSE, SPICEFALSE, m_vecData.data(), m_vecData.data() + SPICE_CELL_CTRLSZ };
+    }
+
+    bool Grow()
+    {
+        if (m_oCell.size >= COVERAGE_MAX_CELL_SIZE)
+        {
+            return false;
+        }
+        Resize(std::min(2 * m_oCell.size, COVERAGE_MAX_CELL_SIZE));
+        return true;
+    }
+
+    SpiceCell* Cell()
+    {
+        return &m_oCell;
+    }
+
+private:
+    SpiceCellDataType m_eType;
+    std::vector<T> m_vecData;
+    SpiceCell m_oCell;
+};
+
+
+
+static void MergeCoverageWindows(CoverageWindows& rvecWindows)
+{
+    std::sort(rvecWindows.begin(), rvecWindows.end());
+    size_t nMerged = 0;
+    for (const auto& rWindow : rvecWindows)
+    {
+        if (nMerged > 0 && rWindow.first <= rvecWindows[nMerged - 1].second)
+        {
+            rvecWindows[nMerged - 1].second = std::max(rvecWindows[nMerged - 1].second, rWindow.second);
+        }
+        else
+        {
+            rvecWindows[nMerged++] = rWindow;
+        }
+    }
+    rvecWindows.resize(nMerged);
+}   // MergeCoverageWindows()
+
+
+
+// Reads the coverage of one SPK or CK file per id and grows the cells while they are too small.
+// Leaves a SPICE error set on other failures.
+static void ReadFileCoverage(const char* pcFile, bool bSpk, CCoverageCell<SpiceInt>& roIds, CCoverageCell<SpiceDouble>& roCover,
+    std::vector<std::pair<SpiceInt, CoverageWindows>>& rvecFileCoverage)
+{
+    for (;;)
+    {
+        rvecFileCoverage.clear();
+        scard_c(0, roIds.Cell());
+        if (bSpk)
+        {
+            spkobj_c(pcFile, roIds.Cell());
+        }
+        else
+        {
+            ckobj_c(pcFile, roIds.Cell());
+        }
+        const bool bIdsFull = SpiceHasFailed();
+        for (SpiceInt j = 0; j < card_c(roIds.Cell()) && !SpiceHasFailed(); ++j)
+        {
+            const SpiceInt nId = SPICE_CELL_ELEM_I(roIds.Cell(), j);
+            scard_c(0, roCover.Cell());
+            if (bSpk)
+            {
+                spkcov_c(pcFile, nId, roCover.Cell());
+            }
+            else
+            {
+                // interval level: the exact times at which pointing is available
+                ckcov_c(pcFile, nId, SPICEFALSE, "INTERVAL", 0.0, "TDB", roCover.Cell());
+            }
+            CoverageWindows vecWindows(static_cast<size_t>(wncard_c(roCover.Cell())));
+            for (SpiceInt k = 0; k < static_cast<SpiceInt>(vecWindows.size()); ++k)
+            {
+                wnfetd_c(roCover.Cell(), k, &vecWindows[k].first, &vecWindows[k].second);
+            }
+            rvecFileCoverage.emplace_back(nId, std::move(vecWindows));
+        }
+        if (!SpiceHasFailed())
+        {
+            return;
+        }
+
+        char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+        getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
+        const bool bCellFull = strcmp(acSMsg, "SPICE(CELLTOOSMALL)") == 0 || strcmp(acSMsg, "SPICE(SETEXCESS)") == 0
+            || strcmp(acSMsg, "SPICE(WINDOWEXCESS)") == 0;
+        if (!bCellFull || !(bIdsFull ? roIds.Grow() : roCover.Grow()))
+        {
+            return;
+        }
+        reset_c();
+    }
+}   // ReadFileCoverage()
+
+
+
+// Adds the coverage of the SPK and CK files loaded since the last call. Caller holds s_oSpiceMutex.
+static void UpdateCoverageIndex()
+{
+    CCoverageCell<SpiceInt> oIds(SPICE_INT, COVERAGE_INITIAL_IDS);
+    CCoverageCell<SpiceDouble> oCover(SPICE_DP, COVERAGE_INITIAL_DOUBLES);
+
+    SpiceInt nCount = 0;
+    ktotal_c("SPK CK", &nCount);
+    std::unordered_set<SpiceInt> setSpkIds;
+    std::unordered_set<SpiceInt> setCkIds;
+    for (SpiceInt i = 0; i < nCount && !SpiceHasFailed(); ++i)
+    {
+        SpiceChar acFile[FILENAME_MAX];
+        SpiceChar acType[32];
+        SpiceChar acSource[FILENAME_MAX];
+        SpiceInt nHandle = 0;
+        SpiceBoolean bFound = SPICEFALSE;
+        kdata_c(i, "SPK CK", FILENAME_MAX, sizeof(acType), FILENAME_MAX, acFile, acType, acSource, &nHandle, &bFound);
+        if (!bFound || SpiceHasFailed() || s_setIndexedKernels.count(acFile) != 0)
+        {
+            continue;
+        }
+
+        const bool bSpk = strcmp(acType, "SPK") == 0;
+        std::vector<std::pair<SpiceInt, CoverageWindows>> vecFileCoverage;
+        ReadFileCoverage(acFile, bSpk, oIds, oCover, vecFileCoverage);
+        if (SpiceHasFailed())
+        {
+            char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+            getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
             reset_c();
-            return -3;
+            if (!bSpk && (strcmp(acSMsg, "SPICE(KERNELVARNOTFOUND)") == 0 || strcmp(acSMsg, "SPICE(NOLEAPSECONDS)") == 0))
+            {
+                // no SCLK or LSK kernel for the CK yet; the file is indexed again after the next load
+                COO_LOG(LogLevel::DEBUG, "Could not index the coverage of \"" + std::string{acFile} + "\" yet (" + acSMsg + ").");
+                continue;
+            }
+            COO_LOG(LogLevel::WARNING, "Could not index the coverage of \"" + std::string{acFile} + "\" (" + acSMsg + "), "
+                + (bSpk ? "SPK" : "CK") + " coverage checks are left to SPICE.");
+            (bSpk ? s_bSpkCoverageIncomplete : s_bCkCoverageIncomplete) = true;
+            s_setIndexedKernels.insert(acFile);
+            continue;
+        }
+        auto& rmapCoverage = bSpk ? s_mapSpkCoverage : s_mapCkCoverage;
+        for (auto& rFileCoverage : vecFileCoverage)
+        {
+            CoverageWindows& rvecWindows = rmapCoverage[rFileCoverage.first];
+            rvecWindows.insert(rvecWindows.end(), rFileCoverage.second.begin(), rFileCoverage.second.end());
+            (bSpk ? setSpkIds : setCkIds).insert(rFileCoverage.first);
+        }
+        s_setIndexedKernels.insert(acFile);
+    }
+    if (SpiceHasFailed())
+    {
+        reset_c();
+    }
+
+    for (SpiceInt nId : setSpkIds)
+    {
+        MergeCoverageWindows(s_mapSpkCoverage[nId]);
+    }
+    for (SpiceInt nId : setCkIds)
+    {
+        MergeCoverageWindows(s_mapCkCoverage[nId]);
+    }
+}   // UpdateCoverageIndex()
+
+
+
+static void ClearCoverageIndex()
+{
+    s_mapSpkCoverage.clear();
+    s_mapCkCoverage.clear();
+    s_setIndexedKernels.clear();
+    s_bSpkCoverageIncomplete = false;
+    s_bCkCoverageIncomplete = false;
+}
+
+
+
+static bool IsCovered(const std::unordered_map<SpiceInt, CoverageWindows>& rmapCoverage, SpiceInt nId, double dEt)
+{
+    auto it = rmapCoverage.find(nId);
+    if (it == rmapCoverage.end())
+    {
+        return true;
+    }
+    const CoverageWindows& rvecWindows = it->second;
+    auto itWindow = std::upper_bound(rvecWindows.begin(), rvecWindows.end(), dEt,
+        [](double d, const std::pair<double, double>& rWindow) { return d < rWindow.first; });
+    return itWindow != rvecWindows.begin() && dEt <= std::prev(itWindow)->second;
+}
+
+
+
+static SpiceInt FrameCkId(SpiceInt nFrameCode)
+{
+    auto it = s_mapFrameCkIds.find(nFrameCode);
+    if (it != s_mapFrameCkIds.end())
+    {
+        return it->second;
+    }
+    SpiceInt nCenter = 0;
+    SpiceInt nClass = 0;
+    SpiceInt nClassId = 0;
+    SpiceBoolean bFound = SPICEFALSE;
+    frinfo_c(nFrameCode, &nCenter, &nClass, &nClassId, &bFound);
+    if (SpiceHasFailed())
+    {
+        reset_c();
+        bFound = SPICEFALSE;
+    }
+    const SpiceInt nCkId = (bFound && nClass == 3) ? nClassId : 0;
+    s_mapFrameCkIds.emplace(nFrameCode, nCkId);
+    return nCkId;
+}
+
+
+
+// False only if the index proves that SPICE cannot orient the frame at dEt. Unresolved
+// references are left to SPICE.
+static bool IsFrameCovered(const SSpiceRef& roFrame, double dEt)
+{
+    if (!roFrame.m_bResolved || s_mapCkCoverage.empty() || s_bCkCoverageIncomplete)
+    {
+        return true;
+    }
+    const SpiceInt nCkId = FrameCkId(roFrame.m_nCode);
+    return nCkId == 0 || IsCovered(s_mapCkCoverage, nCkId, dEt);
+}
+
+
+
+static bool IsStateCovered(const SSpiceRef& roTarget, double dEt, const SSpiceRef& roFrame, const SSpiceRef& roObserver)
+{
+    if (roTarget.m_bResolved && roObserver.m_bResolved && roTarget.m_nCode != roObserver.m_nCode && !s_bSpkCoverageIncomplete
+        && (!IsCovered(s_mapSpkCoverage, roTarget.m_nCode, dEt) || !IsCovered(s_mapSpkCoverage, roObserver.m_nCode, dEt)))
+    {
+        return false;
+    }
+    return IsFrameCovered(roFrame, dEt);
+}
+
+
+
+static bool MatchesSpiceRef(const SSpiceRef& roRef, const std::string& rsNormalizedName, SpiceInt nCode)
+{
+    return roRef.m_bResolved ? (roRef.m_nCode == nCode) : MatchesSpiceName(roRef.m_pcName, rsNormalizedName);
+}
+
+
+// Returns -1 if SPICE fails and -2 if dEt is outside the coverage index.
+static int GetBodyState(const SSpiceRef& roTarget, double dEt, const SSpiceRef& roFrame, const SSpiceRef& roObserver, double* pdState)
+{
+    for (const auto& poCache : s_vecEphemerisCaches)
+    {
+        if (dEt >= poCache->m_dStartEt && dEt <= poCache->m_dEndEt &&
+            MatchesSpiceRef(roTarget, poCache->m_sTarget, poCache->m_nTargetId) &&
+            MatchesSpiceRef(roObserver, poCache->m_sObserver, poCache->m_nObserverId) &&
+            MatchesSpiceRef(roFrame, poCache->m_sFrame, poCache->m_nFrameCode))
+        {
+            EvalEphemerisCache(*poCache, dEt, pdState);
+            return 0;
+        }
+    }
+
+    if (!IsStateCovered(roTarget, dEt, roFrame, roObserver))
+    {
+        return -2;
+    }
+
+    double dLightTime = {};
+    if (roTarget.m_bResolved && roObserver.m_bResolved)
+    {
+        spkez_c( roTarget.m_nCode, dEt, roFrame.m_pcName, "NONE", roObserver.m_nCode, pdState, &dLightTime );
+    }
+    else
+    {
+        spkezr_c( roTarget.m_pcName, dEt, roFrame.m_pcName, "NONE", roObserver.m_pcName, pdState, &dLightTime );
+    }
+    if(SpiceHasFailed())
+    {
+        reset_c();
+        return -1;
+    }
+    return 0;
+}   // GetBodyState()
+
+
+
+// Rotation matrices from pxform_c() per frame pair and epoch, keyed by frame codes.
+struct SFrameRotationKey
+{
+    SpiceInt m_nFrom;
+    SpiceInt m_nTo;
+    double m_dEt;
+
+    bool operator==(const SFrameRotationKey& roOther) const
+    {
+        return m_dEt == roOther.m_dEt && m_nFrom == roOther.m_nFrom && m_nTo == roOther.m_nTo;
+    }
+};
+
+struct SFrameRotationKeyHash
+{
+    size_t operator()(const SFrameRotationKey& roKey) const
+    {
+        size_t nHash = std::hash<double>()(roKey.m_dEt);
+        nHash = (nHash ^ static_cast<size_t>(roKey.m_nFrom)) * 0x9e3779b97f4a7c15ULL;
+        nHash = (nHash ^ static_cast<size_t>(roKey.m_nTo)) * 0x9e3779b97f4a7c15ULL;
+        return nHash;
+    }
+};
+
+static CLruCache<SFrameRotationKey, std::array<double, 9>, SFrameRotationKeyHash> s_oFrameRotationCache(256);
+static unsigned long long s_nFrameRotationCacheHits = 0;
+static unsigned long long s_nFrameRotationCacheMisses = 0;
+
+// Datetime strings already converted by Str2Et(). The result depends on the leapseconds kernel,
+// so this is cleared by AddSpiceKernel() as well.
+static CLruCache<std::string, double> s_oEtCache(64);
+
+
+
+static int GetFrameRotation(const SSpiceRef& roFrom, const SSpiceRef& roTo, double dEt, double* pdRotMat)
+{
+    // Returns the row-major 3x3 matrix rotating positions from roFrom to roTo at dEt, -1 if
+    // SPICE fails and -2 if dEt is outside the CK coverage of either frame.
+    const char* pcFrom = roFrom.m_pcName;
+    const char* pcTo = roTo.m_pcName;
+    SFrameRotationKey oKey = { roFrom.m_nCode, roTo.m_nCode, dEt };
+    if (!roFrom.m_bResolved)
+    {
+        namfrm_c(pcFrom, &oKey.m_nFrom);
+    }
+    if (!roTo.m_bResolved)
+    {
+        namfrm_c(pcTo, &oKey.m_nTo);
+    }
+
+    // Unknown frames (code 0) are left to pxform_c(), which reports the error.
+    const bool bCacheable = (oKey.m_nFrom != 0 && oKey.m_nTo != 0);
+    if (bCacheable)
+    {
+        if (const std::array<double, 9>* padCached = s_oFrameRotationCache.Find(oKey))
+        {
+            ++s_nFrameRotationCacheHits;
+            std::copy(padCached->begin(), padCached->end(), pdRotMat);
+            return 0;
+        }
+    }
+    if (oKey.m_nFrom != oKey.m_nTo &&
+        (!IsFrameCovered({ pcFrom, oKey.m_nFrom, oKey.m_nFrom != 0 }, dEt) || !IsFrameCovered({ pcTo, oKey.m_nTo, oKey.m_nTo != 0 }, dEt)))
+    {
+        return -2;
+    }
+    ++s_nFrameRotationCacheMisses;
+
+    double adRotMat[3][3];
+    pxform_c(pcFrom, pcTo, dEt, adRotMat);
+    if (SpiceHasFailed())
+    {
+        char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+        char acXMsg[SPICE_ERROR_LMSGLN]; // explanation of short message
+        getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
+        getmsg_c("EXPLAIN", SPICE_ERROR_LMSGLN, acXMsg);
+        reset_c();
+        COO_LOG(LogLevel::ERROR,
+            "pxform_c() failed for \"" + std::string{pcFrom} + "\" -> \"" + pcTo + "\": \"" + acSMsg + "\": \"" + acXMsg + "\"");
+        return -1;
+    }
+
+    std::array<double, 9> adFlat;
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            adFlat[3 * i + j] = adRotMat[i][j];
+        }
+    }
+    if (bCacheable)
+    {
+        s_oFrameRotationCache.Insert(oKey, adFlat);
+    }
+    std::copy(adFlat.begin(), adFlat.end(), pdRotMat);
+    return 0;
+}   // GetFrameRotation()
+
+
+
+// Single-point conversions requested concurrently by several threads are queued and executed
+// in one go by whichever thread holds s_oSpiceMutex next (flat combining). An uncontended
+// caller simply processes its own request, so the added latency at low load is one extra
+// mutex round trip.
+enum class EPointRequest
+{
+    Xyz2LatLonRad,
+    Xyz2LatLonAlt,
+    LatLonAlt2Xyz
+};
+
+struct SPointRequest
+{
+    EPointRequest m_eType;
+    const char* m_pcPlanet;
+    double m_adIn[3];
+    double m_adOut[3] = {};
+    int m_nResult = 0;
+    bool m_bDone = false; // written under s_oSpiceMutex
+    int m_nBodyHandle = 0; // used instead of m_pcPlanet if not 0
+};
+
+static std::mutex s_oPendingMutex;
+static std::vector<SPointRequest*> s_vecPendingRequests;    // guarded by s_oPendingMutex
+static std::vector<SPointRequest*> s_vecProcessingRequests; // guarded by s_oSpiceMutex
+
+
+
+static void ProcessPendingPointRequests()
+{
+    {
+        std::lock_guard<std::mutex> oLock(s_oPendingMutex);
+        s_vecProcessingRequests.swap(s_vecPendingRequests);
+    }
+
+    const char* pcLastPlanet = nullptr;
+    int nLastRadiiResult = 0;
+    SBodyRadii oBody = {};
+    const SGeodeticKernels* poKernels = nullptr;
+
+    for (SPointRequest* poRequest : s_vecProcessingRequests)
+    {
+        SPointRequest& roRequest = *poRequest;
+        roRequest.m_nResult = 0;
+
+        if (roRequest.m_eType == EPointRequest::Xyz2LatLonRad)
+        {
+            double adXyz[3] = { roRequest.m_adIn[0] * 0.001, roRequest.m_adIn[1] * 0.001, roRequest.m_adIn[2] * 0.001 };
+            double dRad = 0.0;
+            double dLon = 0.0;
+            double dLat = 0.0;
+            reclat_c(adXyz, &dRad, &dLon, &dLat);
+            if (SpiceHasFailed())
+            {
+                reset_c();
+                roRequest.m_nResult = -1;
+            }
+            // Convert to degree and meters
+            roRequest.m_adOut[0] = dLat / rpd_c();
+            roRequest.m_adOut[1] = dLon / rpd_c();
+            roRequest.m_adOut[2] = dRad * 1000.0;
+            roRequest.m_bDone = true;
+            continue;
+        }
+
+        const char* pcPlanet = roRequest.m_pcPlanet;
+        if (roRequest.m_nBodyHandle != 0)
+        {
+            // Handles carry their radii; they are validated here because AddSpiceKernel() may
+            // have run since the request was queued.
+            const SBodyHandle* poHandle = FindBodyHandle(roRequest.m_nBodyHandle);
+            if (!poHandle)
+            {
+                roRequest.m_nResult = -5;
+                roRequest.m_bDone = true;
+                continue;
+            }
+            pcPlanet = poHandle->m_sName.c_str();
+            pcLastPlanet = nullptr;
+            nLastRadiiResult = poHandle->m_nRadiiResult;
+            oBody = poHandle->m_oRadii;
+            poKernels = (nLastRadiiResult == 0) ? GetNativeKernels(oBody) : nullptr;
+        }
+        // Consecutive requests for the same planet share one radii lookup.
+        else if (!pcLastPlanet || std::strcmp(pcLastPlanet, roRequest.m_pcPlanet) != 0)
+        {
+            pcLastPlanet = roRequest.m_pcPlanet;
+            nLastRadiiResult = LookupBodyRadii(roRequest.m_pcPlanet, oBody);
+            poKernels = (nLastRadiiResult == 0) ? GetNativeKernels(oBody) : nullptr;
+        }
+        if (nLastRadiiResult != 0)
+        {
+            roRequest.m_nResult = -2;
+            roRequest.m_bDone = true;
+            continue;
+        }
+
+        if (poKernels)
+        {
+            auto pfnKernel = (roRequest.m_eType == EPointRequest::Xyz2LatLonAlt) ? poKernels->m_pfnXyz2LatLonAlt : poKernels->m_pfnLatLonAlt2Xyz;
+            pfnKernel(1, &roRequest.m_adIn[0], &roRequest.m_adIn[1], &roRequest.m_adIn[2], oBody.m_dRadiusEquat * 1000.0, oBody.m_nLongitudeSense > 0,
+                &roRequest.m_adOut[0], &roRequest.m_adOut[1], &roRequest.m_adOut[2]);
+        }
+        else if (roRequest.m_eType == EPointRequest::Xyz2LatLonAlt)
+        {
+            // Do the conversion.
+            double adXyz[3] = { roRequest.m_adIn[0] * 0.001, roRequest.m_adIn[1] * 0.001, roRequest.m_adIn[2] * 0.001 };
+            double dLon = 0.0;
+            double dLat = 0.0;
+            double dAlt = 0.0;
+            recpgr_c(pcPlanet, adXyz, oBody.m_dRadiusEquat, oBody.m_dFlattening, &dLon, &dLat, &dAlt);
+            if (SpiceHasFailed())
+            {
+                reset_c();
+                roRequest.m_nResult = -3;
+            }
+            // Convert to degree and meters
+            roRequest.m_adOut[0] = dLat / rpd_c();
+            roRequest.m_adOut[1] = dLon / rpd_c();
+            roRequest.m_adOut[2] = dAlt * 1000.0;
+        }
+        else
+        {
+            // Do the conversion.
+            double adXyz[3] = { 0.0, 0.0, 0.0 };
+            pgrrec_c(pcPlanet, roRequest.m_adIn[1] * rpd_c(), roRequest.m_adIn[0] * rpd_c(), roRequest.m_adIn[2] * 0.001, oBody.m_dRadiusEquat, oBody.m_dFlattening, adXyz);
+            if (SpiceHasFailed())
+            {
+                reset_c();
+                roRequest.m_nResult = -3;
+            }
+            // Convert to meters
+            roRequest.m_adOut[0] = adXyz[0] * 1000.0;
+            roRequest.m_adOut[1] = adXyz[1] * 1000.0;
+            roRequest.m_adOut[2] = adXyz[2] * 1000.0;
         }
+        roRequest.m_bDone = true;
+    }
+    s_vecProcessingRequests.clear();
+}   // ProcessPendingPointRequests()
+
+
+
+static int SubmitPointRequest(SPointRequest& roRequest)
+{
+    roRequest.m_bDone = false;
+    {
+        std::lock_guard<std::mutex> oLock(s_oPendingMutex);
+        s_vecPendingRequests.push_back(&roRequest);
+    }
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    // The previous lock holder may already have served this request while we were waiting.
+    if (!roRequest.m_bDone)
+    {
+        ProcessPendingPointRequests();
+    }
+    return roRequest.m_nResult;
+}   // SubmitPointRequest()
+
+
+
+static int Str2EtImpl( const std::string& rsTimestamp, double& rdEt )
+{
+    COO_LOG(LogLevel::TRACE, "Str2Et() called with timestamp = \"" + rsTimestamp + "\".");
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    if (const double* pdCachedEt = s_oEtCache.Find(rsTimestamp))
+    {
+        rdEt = *pdCachedEt;
+        COO_LOG(LogLevel::TRACE, "Str2Et() finished with cached et = " + std::to_string( rdEt ));
+        return 0;
+    }
+
+    str2et_c( rsTimestamp.c_str(), &rdEt );
+    if( SpiceHasFailed() )
+    {
+        char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+        char acXMsg[SPICE_ERROR_LMSGLN]; // explanation of short message
+        getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
+        getmsg_c("EXPLAIN", SPICE_ERROR_LMSGLN, acXMsg);
+        reset_c();
+        COO_LOG(LogLevel::ERROR,
+            std::string("Str2Et() failed with error: \"") + acSMsg + "\": \"" + acXMsg + "\"");
+        return -1;
+    }
+    s_oEtCache.Insert(rsTimestamp, rdEt);
+
+    COO_LOG(LogLevel::TRACE, "Str2Et() finished with et = " + std::to_string( rdEt ));
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int Str2Et( const std::string& rsTimestamp, double& rdEt )
+{
+    return MeasureCall(STATS_STR2ET, [&] { return Str2EtImpl(rsTimestamp, rdEt); });
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+unsigned int GetAPIVersion()
+{
+    COO_LOG(LogLevel::TRACE, "GetAPIVersion() called.");
+    COO_LOG(LogLevel::TRACE, "GetAPIVersion() finished.");
+    return 21;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int Init(bool bConsoleLog, const char* pcLogFile, int nConsoleLogLevel, int nFileLogLevel)
+{
+    return InitEx(bConsoleLog, pcLogFile, nConsoleLogLevel, nFileLogLevel, 0, 0);
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int InitEx(bool bConsoleLog, const char* pcLogFile, int nConsoleLogLevel, int nFileLogLevel, unsigned int nAsyncLogQueueSize, int nAsyncLogOverflowPolicy)
+{
+    COO_LOG(LogLevel::TRACE, "Init() called.");
+    DeInit();
+
+    // temporarily enable logging:
+    s_nConsoleLogLevel = static_cast<int>(TRACE);
+    s_nFileLogLevel = static_cast<int>(TRACE);
+    s_bLogConsole = true;
+    UpdateActiveLogLevel();
+
+    // clamp log levels:
+    nConsoleLogLevel = std::clamp( nConsoleLogLevel, -1, static_cast<int>(LogLevel::TRACE));
+    nFileLogLevel = std::clamp( nFileLogLevel, -1, static_cast<int>(LogLevel::TRACE));
+
+    if ( nConsoleLogLevel >= 0 )
+    {
+        COO_LOG(LogLevel::TRACE, "Console log level set to \"" + LogLevelStr[nConsoleLogLevel] + "\"." );
+    }
+    else
+    {
+        s_bLogConsole = false;
+    }
+
+    s_bLogConsole = bConsoleLog && nConsoleLogLevel >= 0;
+    s_nConsoleLogLevel = nConsoleLogLevel;
+    s_nFileLogLevel = nFileLogLevel;
+    UpdateActiveLogLevel();
+
+
+    if( pcLogFile )
+    {
+        std::string sLogFile = pcLogFile;
+        if(!sLogFile.empty())
+        {
+            auto poLogFile = std::make_unique<std::ofstream>(std::ofstream(sLogFile, std::ios::out|std::ios::app));
+            bool bOpen = poLogFile->is_open();
+            if(bOpen && nAsyncLogQueueSize > 0)
+            {
+                auto eOverflowPolicy = (nAsyncLogOverflowPolicy == CAsyncLogWriter::BLOCK) ? CAsyncLogWriter::BLOCK : CAsyncLogWriter::DROP;
+                s_poAsyncLogWriter = new CAsyncLogWriter(std::move(poLogFile), nAsyncLogQueueSize, eOverflowPolicy);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> oLock(s_oLogMutex);
+                s_logfile = std::move(poLogFile);
+            }
+            UpdateActiveLogLevel();
+            if(bOpen)
+            {
+                COO_LOG(LogLevel::DEBUG, "Initialized log file: \"" + sLogFile + "\"" +
+                    (nAsyncLogQueueSize > 0 ? " (asynchronous, queue size " + std::to_string(nAsyncLogQueueSize) + ")." : "."));
+            }
+            else
+            {
+                COO_LOG(LogLevel::WARNING, "Could not open log file: \"" + sLogFile + "\"!");
+            }
+        }
+    }
+
+    // Initialize CSPICE library
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    std::string sSpiceVersion(tkvrsn_c("toolkit"));
+    COO_LOG(LogLevel::INFO, "Initializing SPICE toolkit version '" + sSpiceVersion + "'.");
+
+    // Set error handling system of CSPICE to continue if error occurs
+    SetSpiceErrorHandling("RETURN", "NULL", "SHORT, EXPLAIN");
+
+    COO_LOG(LogLevel::TRACE, "Init() finished.");
+    return 0;
+}
+
+
+
+// Everything derived from the kernel pool. Caller holds s_oSpiceMutex.
+static void InvalidateKernelPoolCaches()
+{
+    s_mapBodyRadii.clear();
+    s_oFrameRotationCache.Clear();
+    s_oEtCache.Clear();
+    s_mapBodyHandles.clear();
+    s_mapFrameHandles.clear();
+    s_mapFrameCkIds.clear();
+    if (!s_vecEphemerisCaches.empty())
+    {
+        COO_LOG(LogLevel::INFO, "Dropping " + std::to_string(s_vecEphemerisCaches.size()) + " ephemeris cache(s) after kernel pool change.");
+        s_vecEphemerisCaches.clear();
+    }
+}   // InvalidateKernelPoolCaches()
+
+
+
+static int AddSpiceKernelImpl(const char* pcKernelPath)
+{
+    if( !pcKernelPath )
+    {
+        COO_LOG(LogLevel::ERROR, "AddSpiceKernel() called with nullptr arguments." );
+        return -1;
+    }
+
+    std::string pcSpiceKernelPath = pcKernelPath;
+
+    COO_LOG(LogLevel::TRACE, "AddSpiceKernel() called with spice kernel path = \"" + pcSpiceKernelPath + "\".");
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    if (!pcSpiceKernelPath.empty())
+    {
+        furnsh_c(pcSpiceKernelPath.c_str());
+
+        // The pool may have changed even if loading failed halfway through a meta-kernel.
+        InvalidateKernelPoolCaches();
+        if (SpiceHasFailed())
+        {
+            char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+            char acXMsg[SPICE_ERROR_LMSGLN]; // explanation of short message
+            getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
+            getmsg_c("EXPLAIN", SPICE_ERROR_LMSGLN, acXMsg);
+            reset_c();
+            UpdateCoverageIndex();
+            COO_LOG(LogLevel::WARNING,
+                "Could not load CSPICE: \"" + pcSpiceKernelPath + "\" (" + acSMsg + ": " + acXMsg + ")!");
+            return -2;
+        }
+        else
+        {
+            UpdateCoverageIndex();
+            COO_LOG(LogLevel::INFO, "Loaded CSpice Kernel \"" + pcSpiceKernelPath + "\".");
+        }
+    }
+
+    COO_LOG(LogLevel::TRACE, "AddSpiceKernel() finished.");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int AddSpiceKernel(const char* pcKernelPath)
+{
+    return MeasureCall(STATS_ADDSPICEKERNEL, [&] { return AddSpiceKernelImpl(pcKernelPath); });
+}
+
+
+static std::string KernelPoolCachePath(const std::string& rsCacheDir, uint64_t nKey)
+{
+    char acName[32];
+    snprintf(acName, sizeof(acName), "%016llx.pool", static_cast<unsigned long long>(nKey));
+    std::string sPath = rsCacheDir;
+    if (!sPath.empty() && sPath.back() != '/' && sPath.back() != '\\')
+    {
+        sPath += '/';
+    }
+    return sPath + acName;
+}   // KernelPoolCachePath()
+
+
+
+static bool KernelFilesUnchanged(const SPoolSnapshot& roSnapshot)
+{
+    for (const SKernelFile& roKernel : roSnapshot.m_vecKernels)
+    {
+        uint64_t nHash = 0;
+        if (roKernel.m_bText && (!HashFile(roKernel.m_sPath, nHash) || nHash != roKernel.m_nHash))
+        {
+            return false;
+        }
+    }
+    return true;
+}   // KernelFilesUnchanged()
+
+
+
+static int AddSpiceKernelCachedImpl(const char* pcKernelPath, const char* pcCacheDir, int* pnCacheStatus)
+{
+    if (!pcKernelPath || !pcCacheDir)
+    {
+        COO_LOG(LogLevel::ERROR, "AddSpiceKernelCached() called with nullptr arguments.");
+        return -1;
+    }
+
+    const std::string sKernelPath = pcKernelPath;
+    const std::string sCacheDir = pcCacheDir;
+
+    COO_LOG(LogLevel::TRACE, "AddSpiceKernelCached() called with spice kernel path = \"" + sKernelPath + "\", cache directory = \"" + sCacheDir + "\".");
+
+    int nCacheStatus = 2;
+    if (pnCacheStatus)
+    {
+        *pnCacheStatus = nCacheStatus;
+    }
+    if (sKernelPath.empty())
+    {
+        return 0;
+    }
+
+    const auto oStart = std::chrono::steady_clock::now();
+    auto fnElapsedMs = [&oStart]()
+    {
+        return std::to_string(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - oStart).count());
+    };
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    // The snapshot only holds the variables the kernel changed, so the pool before the load is part of the key.
+    std::vector<SPoolVariable> vecPoolBefore;
+    uint64_t nKernelHash = 0;
+    const bool bPoolDumped = DumpKernelPool(vecPoolBefore);
+    const bool bKernelHashed = bPoolDumped && HashFile(sKernelPath, nKernelHash);
+    const bool bCacheable = bPoolDumped && bKernelHashed;
+    if (SpiceHasFailed())
+    {
+        reset_c();
+    }
+
+    SPoolSnapshot oSnapshot;
+    std::string sCachePath;
+    if (bCacheable)
+    {
+        const uint64_t nPoolHash = HashPoolVariables(vecPoolBefore);
+        oSnapshot.m_nKey = HashBytes(sKernelPath.c_str(), sKernelPath.size() + 1);
+        oSnapshot.m_nKey = HashBytes(&nKernelHash, sizeof(nKernelHash), oSnapshot.m_nKey);
+        oSnapshot.m_nKey = HashBytes(&nPoolHash, sizeof(nPoolHash), oSnapshot.m_nKey);
+        sCachePath = KernelPoolCachePath(sCacheDir, oSnapshot.m_nKey);
+
+        SPoolSnapshot oCached;
+        if (ReadPoolSnapshot(sCachePath, oCached) && oCached.m_nKey == oSnapshot.m_nKey && KernelFilesUnchanged(oCached))
+        {
+            size_t nBinaryKernels = 0;
+            if (RestoreKernelPool(oCached.m_vecVariables))
+            {
+                for (const SKernelFile& roKernel : oCached.m_vecKernels)
+                {
+                    if (!roKernel.m_bText)
+                    {
+                        furnsh_c(roKernel.m_sPath.c_str());
+                        ++nBinaryKernels;
+                        if (SpiceHasFailed())
+                        {
+                            break;
+                        }
+                    }
+                }
+            }
+            InvalidateKernelPoolCaches();
+            if (SpiceHasFailed())
+            {
+                char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+                char acXMsg[SPICE_ERROR_LMSGLN]; // explanation of short message
+                getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
+                getmsg_c("EXPLAIN", SPICE_ERROR_LMSGLN, acXMsg);
+                reset_c();
+                UpdateCoverageIndex();
+                COO_LOG(LogLevel::WARNING,
+                    "Could not restore CSPICE kernel \"" + sKernelPath + "\" from \"" + sCachePath + "\" (" + acSMsg + ": " + acXMsg + ")!");
+                return -2;
+            }
+            UpdateCoverageIndex();
+            nCacheStatus = 0;
+            if (pnCacheStatus)
+            {
+                *pnCacheStatus = nCacheStatus;
+            }
+            COO_LOG(LogLevel::INFO, "Restored CSpice Kernel \"" + sKernelPath + "\" from \"" + sCachePath + "\" in " + fnElapsedMs() + " ms ("
+                + std::to_string(oCached.m_vecVariables.size()) + " pool variables, " + std::to_string(nBinaryKernels) + " binary kernels).");
+            return 0;
+        }
+    }
+
+    furnsh_c(sKernelPath.c_str());
+    InvalidateKernelPoolCaches();
+    if (SpiceHasFailed())
+    {
+        char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+        char acXMsg[SPICE_ERROR_LMSGLN]; // explanation of short message
+        getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
+        getmsg_c("EXPLAIN", SPICE_ERROR_LMSGLN, acXMsg);
+        reset_c();
+        UpdateCoverageIndex();
+        COO_LOG(LogLevel::WARNING,
+            "Could not load CSPICE: \"" + sKernelPath + "\" (" + acSMsg + ": " + acXMsg + ")!");
+        return -2;
+    }
+    UpdateCoverageIndex();
+    const std::string sLoadMs = fnElapsedMs();
+
+    // reason why no cache was written, for the log
+    std::string sCacheFailure;
+    std::vector<SPoolVariable> vecPoolAfter;
+    if (!bPoolDumped)
+    {
+        sCacheFailure = "the kernel pool could not be dumped before loading";
+    }
+    else if (!bKernelHashed)
+    {
+        sCacheFailure = "the kernel file could not be read for hashing";
+    }
+    else if (!DumpKernelPool(vecPoolAfter))
+    {
+        sCacheFailure = "the kernel pool could not be dumped after loading";
+    }
+    else if (!ListLoadedKernels(sKernelPath, oSnapshot.m_vecKernels))
+    {
+        sCacheFailure = "the loaded kernel files could not be listed";
+    }
+    else
+    {
+        std::unordered_map<std::string, const SPoolVariable*> mapPoolBefore;
+        for (const SPoolVariable& roVariable : vecPoolBefore)
+        {
+            mapPoolBefore.emplace(roVariable.m_sName, &roVariable);
+        }
+        for (SPoolVariable& roVariable : vecPoolAfter)
+        {
+            auto it = mapPoolBefore.find(roVariable.m_sName);
+            if (it == mapPoolBefore.end() || !(*it->second == roVariable))
+            {
+                oSnapshot.m_vecVariables.push_back(std::move(roVariable));
+            }
+        }
+        if (WritePoolSnapshot(sCachePath, oSnapshot))
+        {
+            nCacheStatus = 1;
+        }
+        else
+        {
+            sCacheFailure = "the snapshot could not be written to \"" + sCachePath + "\"";
+        }
+    }
+    if (SpiceHasFailed())
+    {
+        reset_c();
+    }
+    if (pnCacheStatus)
+    {
+        *pnCacheStatus = nCacheStatus;
+    }
+
+    if (nCacheStatus == 1)
+    {
+        COO_LOG(LogLevel::INFO, "Loaded CSpice Kernel \"" + sKernelPath + "\" in " + sLoadMs + " ms, wrote \"" + sCachePath + "\" ("
+            + std::to_string(oSnapshot.m_vecVariables.size()) + " pool variables).");
+    }
+    else
+    {
+        COO_LOG(LogLevel::WARNING, "Loaded CSpice Kernel \"" + sKernelPath + "\" in " + sLoadMs + " ms, but wrote no kernel pool cache: " + sCacheFailure + ".");
+    }
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int AddSpiceKernelCached(const char* pcKernelPath, const char* pcCacheDir, int* pnCacheStatus)
+{
+    return MeasureCall(STATS_ADDSPICEKERNELCACHED, [&] { return AddSpiceKernelCachedImpl(pcKernelPath, pcCacheDir, pnCacheStatus); });
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int ClearSpiceKernels()
+{
+    COO_LOG(LogLevel::TRACE, "ClearSpiceKernels() called.");
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    kclear_c();
+    InvalidateKernelPoolCaches();
+    ClearCoverageIndex();
+    if (SpiceHasFailed())
+    {
+        char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+        getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
+        reset_c();
+        COO_LOG(LogLevel::WARNING, std::string("Could not clear CSPICE kernels (") + acSMsg + ")!");
+        return -2;
+    }
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetCoverageWindows(int nKind, const char* pcName, double* pdWindows, unsigned int nMaxWindows, unsigned int* pnWindows)
+{
+    if (!pcName || !pnWindows || (!pdWindows && nMaxWindows > 0))
+    {
+        COO_LOG(LogLevel::ERROR, "GetCoverageWindows() called with nullptr arguments.");
+        return -1;
+    }
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    const std::unordered_map<SpiceInt, CoverageWindows>* pmapCoverage = nullptr;
+    SpiceInt nId = 0;
+    if (nKind == 0)
+    {
+        const SSpiceRef oBody = ResolveBodyRef(pcName);
+        if (!oBody.m_bResolved)
+        {
+            return -2;
+        }
+        pmapCoverage = &s_mapSpkCoverage;
+        nId = oBody.m_nCode;
+    }
+    else if (nKind == 1)
+    {
+        const SSpiceRef oFrame = ResolveFrameRef(pcName);
+        if (!oFrame.m_bResolved)
+        {
+            return -2;
+        }
+        nId = FrameCkId(oFrame.m_nCode);
+        if (nId == 0)
+        {
+            return -3;
+        }
+        pmapCoverage = &s_mapCkCoverage;
+    }
+    else
+    {
+        return -2;
+    }
+
+    auto it = pmapCoverage->find(nId);
+    if (it == pmapCoverage->end())
+    {
+        *pnWindows = 0;
+        return 0;
+    }
+    *pnWindows = static_cast<unsigned int>(it->second.size());
+    const size_t nCopy = std::min<size_t>(nMaxWindows, it->second.size());
+    for (size_t i = 0; i < nCopy; ++i)
+    {
+        pdWindows[2 * i] = it->second[i].first;
+        pdWindows[2 * i + 1] = it->second[i].second;
+    }
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+void DeInit()
+{
+    std::unique_ptr<CAsyncLogWriter> poAsyncLogWriter(s_poAsyncLogWriter.exchange(nullptr));
+    if (poAsyncLogWriter)
+    {
+        // wait for Log() calls that still hold the old writer
+        while (s_nAsyncLogProducers.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+        poAsyncLogWriter->Stop();
+    }
+    {
+        std::lock_guard<std::mutex> oLock(s_oLogMutex);
+        s_logfile.reset();
+    }
+    UpdateActiveLogLevel();
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetBodyRadiiCacheStats(unsigned long long* pnHits, unsigned long long* pnMisses, unsigned int* pnEntries)
+{
+    if( !pnHits || !pnMisses || !pnEntries )
+    {
+        COO_LOG(LogLevel::ERROR, "GetBodyRadiiCacheStats() called with nullptr arguments." );
+        return -1;
+    }
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    *pnHits = s_nBodyRadiiCacheHits;
+    *pnMisses = s_nBodyRadiiCacheMisses;
+    *pnEntries = static_cast<unsigned int>(s_mapBodyRadii.size());
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+void ResetBodyRadiiCacheStats()
+{
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    s_nBodyRadiiCacheHits = 0;
+    s_nBodyRadiiCacheMisses = 0;
+}
+
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int SetGeodeticBackend(int nBackend)
+{
+    COO_LOG(LogLevel::TRACE, "SetGeodeticBackend() called with backend = " + std::to_string(nBackend) + ".");
+
+    if (nBackend == GEODETIC_BACKEND_SPICE)
+    {
+        s_poGeodeticKernels.store(nullptr);
+        s_nGeodeticBackend.store(GEODETIC_BACKEND_SPICE);
+        COO_LOG(LogLevel::INFO, "Geodetic conversions use SPICE.");
+        return 0;
+    }
+
+    int nResolved = nBackend;
+    const SGeodeticKernels* poKernels = GetGeodeticKernels(nBackend, nResolved);
+    if (!poKernels)
+    {
+        COO_LOG(LogLevel::ERROR, "SetGeodeticBackend() failed: backend " + std::to_string(nBackend) + " is not available.");
+        return -2;
+    }
+    s_poGeodeticKernels.store(poKernels);
+    s_nGeodeticBackend.store(nResolved);
+    COO_LOG(LogLevel::INFO, "Geodetic conversions use the native " + std::string{poKernels->m_pcName} + " kernels.");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetGeodeticBackend()
+{
+    return s_nGeodeticBackend.load();
+}
+
+
+static int Xyz2LatLonRadImpl(double dX, double dY, double dZ, double* pdLat, double* pdLon, double* pdRad)
+{
+    if( !pdLat || !pdLon || !pdRad )
+    {
+        COO_LOG(LogLevel::ERROR, "Xyz2LatLonRad() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "Xyz2LatLonRad() called with xyz = (" + std::to_string(dX) + ", " + std::to_string(dY) + ", " + std::to_string(dZ) + ")");
+
+    SPointRequest oRequest = { EPointRequest::Xyz2LatLonRad, nullptr, { dX, dY, dZ } };
+    int nResult = SubmitPointRequest(oRequest);
+    *pdLat = oRequest.m_adOut[0];
+    *pdLon = oRequest.m_adOut[1];
+    *pdRad = oRequest.m_adOut[2];
+    if (nResult != 0)
+    {
+        return nResult;
+    }
+
+    COO_LOG(LogLevel::TRACE, "Xyz2LatLonRad() finished with lat, lon, rad = (" + std::to_string(*pdLat) + ", " + std::to_string(*pdLon) + ", " + std::to_string(*pdRad) + ")");
+
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int Xyz2LatLonRad(double dX, double dY, double dZ, double* pdLat, double* pdLon, double* pdRad)
+{
+    return MeasureCall(STATS_XYZ2LATLONRAD, [&] { return Xyz2LatLonRadImpl(dX, dY, dZ, pdLat, pdLon, pdRad); });
+}
+
+
+static int Xyz2LatLonAltImpl(const char* pcPlanet, double dX, double dY, double dZ, double* pdLat, double* pdLon, double* pdAlt)
+{
+    if( !pcPlanet || !pdLat || !pdLon || !pdAlt )
+    {
+        COO_LOG(LogLevel::ERROR, "Xyz2LatLonAlt() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "Xyz2LatLonAlt() called with planet = " + std::string{pcPlanet} + ", xyz = (" + std::to_string(dX) + ", " + std::to_string(dY) + ", " + std::to_string(dZ) + ")");
+
+    SPointRequest oRequest = { EPointRequest::Xyz2LatLonAlt, pcPlanet, { dX, dY, dZ } };
+    int nResult = SubmitPointRequest(oRequest);
+    if (nResult == -2)
+    {
+        return nResult;
+    }
+    *pdLat = oRequest.m_adOut[0];
+    *pdLon = oRequest.m_adOut[1];
+    *pdAlt = oRequest.m_adOut[2];
+    if (nResult != 0)
+    {
+        return nResult;
+    }
+
+    COO_LOG(LogLevel::TRACE, "Xyz2LatLonAlt() finished with lat, lon, alt = (" + std::to_string(*pdLat) + ", " + std::to_string(*pdLon) + ", " + std::to_string(*pdAlt) + ")");
+
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int Xyz2LatLonAlt(const char* pcPlanet, double dX, double dY, double dZ, double* pdLat, double* pdLon, double* pdAlt)
+{
+    return MeasureCall(STATS_XYZ2LATLONALT, [&] { return Xyz2LatLonAltImpl(pcPlanet, dX, dY, dZ, pdLat, pdLon, pdAlt); });
+}
+
+
+static int LatLonAlt2XyzImpl(const char* pcPlanet, double dLat, double dLon, double dAlt, double* pdX, double* pdY, double* pdZ)
+{
+    if( !pcPlanet || !pdX || !pdY || !pdZ )
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonAlt2Xyz() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "LatLonAlt2Xyz() called with planet = " + std::string{pcPlanet} + ", xyz = (" + std::to_string(dLat) + ", " + std::to_string(dLon) + ", " + std::to_string(dAlt) + ")");
+    SPointRequest oRequest = { EPointRequest::LatLonAlt2Xyz, pcPlanet, { dLat, dLon, dAlt } };
+    int nResult = SubmitPointRequest(oRequest);
+    if (nResult != 0)
+    {
+        return nResult;
+    }
+    *pdX = oRequest.m_adOut[0];
+    *pdY = oRequest.m_adOut[1];
+    *pdZ = oRequest.m_adOut[2];
+
+    COO_LOG(LogLevel::TRACE, "LatLonAlt2Xyz() finished with xyz = (" + std::to_string(*pdX) + ", " + std::to_string(*pdY) + ", " + std::to_string(*pdZ) + ")");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int LatLonAlt2Xyz(const char* pcPlanet, double dLat, double dLon, double dAlt, double* pdX, double* pdY, double* pdZ)
+{
+    return MeasureCall(STATS_LATLONALT2XYZ, [&] { return LatLonAlt2XyzImpl(pcPlanet, dLat, dLon, dAlt, pdX, pdY, pdZ); });
+}
+
+
+static int Xyz2LatLonAltByHandleImpl(int nBodyHandle, double dX, double dY, double dZ, double* pdLat, double* pdLon, double* pdAlt)
+{
+    if( !pdLat || !pdLon || !pdAlt )
+    {
+        COO_LOG(LogLevel::ERROR, "Xyz2LatLonAltByHandle() called with nullptr arguments." );
+        return -1;
+    }
+
+    SPointRequest oRequest = { EPointRequest::Xyz2LatLonAlt, nullptr, { dX, dY, dZ } };
+    oRequest.m_nBodyHandle = nBodyHandle;
+    int nResult = SubmitPointRequest(oRequest);
+    if (nResult == -2 || nResult == -5)
+    {
+        return nResult;
+    }
+    *pdLat = oRequest.m_adOut[0];
+    *pdLon = oRequest.m_adOut[1];
+    *pdAlt = oRequest.m_adOut[2];
+    return nResult;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int Xyz2LatLonAltByHandle(int nBodyHandle, double dX, double dY, double dZ, double* pdLat, double* pdLon, double* pdAlt)
+{
+    return MeasureCall(STATS_XYZ2LATLONALTBYHANDLE, [&] { return Xyz2LatLonAltByHandleImpl(nBodyHandle, dX, dY, dZ, pdLat, pdLon, pdAlt); });
+}
+
+
+static int LatLonAlt2XyzByHandleImpl(int nBodyHandle, double dLat, double dLon, double dAlt, double* pdX, double* pdY, double* pdZ)
+{
+    if( !pdX || !pdY || !pdZ )
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonAlt2XyzByHandle() called with nullptr arguments." );
+        return -1;
+    }
+
+    SPointRequest oRequest = { EPointRequest::LatLonAlt2Xyz, nullptr, { dLat, dLon, dAlt } };
+    oRequest.m_nBodyHandle = nBodyHandle;
+    int nResult = SubmitPointRequest(oRequest);
+    if (nResult != 0)
+    {
+        return nResult;
+    }
+    *pdX = oRequest.m_adOut[0];
+    *pdY = oRequest.m_adOut[1];
+    *pdZ = oRequest.m_adOut[2];
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int LatLonAlt2XyzByHandle(int nBodyHandle, double dLat, double dLon, double dAlt, double* pdX, double* pdY, double* pdZ)
+{
+    return MeasureCall(STATS_LATLONALT2XYZBYHANDLE, [&] { return LatLonAlt2XyzByHandleImpl(nBodyHandle, dLat, dLon, dAlt, pdX, pdY, pdZ); });
+}
+
+
+static int Xyz2LatLonRadBatchImpl(
+    unsigned int nCount,
+    const double* pdX, const double* pdY, const double* pdZ, unsigned int nInStride,
+    double* pdLat, double* pdLon, double* pdRad, unsigned int nOutStride,
+    int* pnStatus)
+{
+    if( !pdX || !pdY || !pdZ || !pdLat || !pdLon || !pdRad )
+    {
+        COO_LOG(LogLevel::ERROR, "Xyz2LatLonRadBatch() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "Xyz2LatLonRadBatch() called with count = " + std::to_string(nCount) + ".");
+
+    // reclat_c() is a closed-form conversion that never signals an error, so the batch is
+    // evaluated directly instead of crossing the SPICE boundary for every point.
+    const double dDegPerRad = 1.0 / rpd_c();
+    const size_t nIn = nInStride;
+    const size_t nOut = nOutStride;
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        const double dX = pdX[i * nIn];
+        const double dY = pdY[i * nIn];
+        const double dZ = pdZ[i * nIn];
+        const double dRho = std::sqrt(dX * dX + dY * dY);
+        pdLat[i * nOut] = std::atan2(dZ, dRho) * dDegPerRad;
+        pdLon[i * nOut] = std::atan2(dY, dX) * dDegPerRad;
+        pdRad[i * nOut] = std::sqrt(dRho * dRho + dZ * dZ);
+    }
+    if (pnStatus)
+    {
+        std::fill(pnStatus, pnStatus + nCount, 0);
+    }
+
+    COO_LOG(LogLevel::TRACE, "Xyz2LatLonRadBatch() finished.");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int Xyz2LatLonRadBatch(
+    unsigned int nCount,
+    const double* pdX, const double* pdY, const double* pdZ, unsigned int nInStride,
+    double* pdLat, double* pdLon, double* pdRad, unsigned int nOutStride,
+    int* pnStatus)
+{
+    return MeasureCall(STATS_XYZ2LATLONRADBATCH, [&] { return Xyz2LatLonRadBatchImpl(nCount, pdX, pdY, pdZ, nInStride, pdLat, pdLon, pdRad, nOutStride, pnStatus); });
+}
+
+
+static int Xyz2LatLonAltBatchImpl(
+    const char* pcPlanet,
+    unsigned int nCount,
+    const double* pdX, const double* pdY, const double* pdZ, unsigned int nInStride,
+    double* pdLat, double* pdLon, double* pdAlt, unsigned int nOutStride,
+    int* pnStatus)
+{
+    if( !pcPlanet || !pdX || !pdY || !pdZ || !pdLat || !pdLon || !pdAlt )
+    {
+        COO_LOG(LogLevel::ERROR, "Xyz2LatLonAltBatch() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "Xyz2LatLonAltBatch() called with planet = " + std::string{pcPlanet} + ", count = " + std::to_string(nCount) + ".");
+
+    std::unique_lock<std::recursive_mutex> oSpiceLock(s_oSpiceMutex);
+
+    // Radii are resolved once for the whole batch.
+    SBodyRadii oBody = {};
+    if (LookupBodyRadii(pcPlanet, oBody) != 0)
+    {
+        COO_LOG(LogLevel::ERROR, "Xyz2LatLonAltBatch() failed to lookup radii of \"" + std::string{pcPlanet} + "\".");
+        return -2;
+    }
+    const double dRadiusEquat = oBody.m_dRadiusEquat;
+    const double dFlattening = oBody.m_dFlattening;
+
+    // The native kernels do not touch SPICE, so the lock is released before converting.
+    if (const SGeodeticKernels* poKernels = GetNativeKernels(oBody))
+    {
+        oSpiceLock.unlock();
+        RunNativeKernel(poKernels->m_pfnXyz2LatLonAlt, nCount, pdX, pdY, pdZ, nInStride, dRadiusEquat * 1000.0, oBody.m_nLongitudeSense > 0, pdLat, pdLon, pdAlt, nOutStride);
+        if (pnStatus)
+        {
+            std::fill(pnStatus, pnStatus + nCount, 0);
+        }
+        COO_LOG(LogLevel::TRACE, "Xyz2LatLonAltBatch() finished using the " + std::string{poKernels->m_pcName} + " kernels.");
+        return 0;
+    }
+
+    const double dDegPerRad = 1.0 / rpd_c();
+    const size_t nIn = nInStride;
+    const size_t nOut = nOutStride;
+    size_t nFailed = 0;
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        double adXyz[3] = { pdX[i * nIn] * 0.001, pdY[i * nIn] * 0.001, pdZ[i * nIn] * 0.001 };
+        double dLon = 0.0;
+        double dLat = 0.0;
+        double dAlt = 0.0;
+        recpgr_c(pcPlanet, adXyz, dRadiusEquat, dFlattening, &dLon, &dLat, &dAlt);
+        int nStatus = 0;
+        if (SpiceHasFailed())
+        {
+            reset_c();
+            nStatus = -3;
+            ++nFailed;
+        }
+        // Convert to degree and meters
+        pdLat[i * nOut] = dLat * dDegPerRad;
+        pdLon[i * nOut] = dLon * dDegPerRad;
+        pdAlt[i * nOut] = dAlt * 1000.0;
+        if (pnStatus)
+        {
+            pnStatus[i] = nStatus;
+        }
+    }
+
+    COO_LOG(LogLevel::TRACE, "Xyz2LatLonAltBatch() finished with " + std::to_string(nFailed) + " failed point(s).");
+    return (nFailed == 0) ? 0 : -3;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int Xyz2LatLonAltBatch(
+    const char* pcPlanet,
+    unsigned int nCount,
+    const double* pdX, const double* pdY, const double* pdZ, unsigned int nInStride,
+    double* pdLat, double* pdLon, double* pdAlt, unsigned int nOutStride,
+    int* pnStatus)
+{
+    return MeasureCall(STATS_XYZ2LATLONALTBATCH, [&] { return Xyz2LatLonAltBatchImpl(pcPlanet, nCount, pdX, pdY, pdZ, nInStride, pdLat, pdLon, pdAlt, nOutStride, pnStatus); });
+}
+
+
+static int LatLonAlt2XyzBatchImpl(
+    const char* pcPlanet,
+    unsigned int nCount,
+    const double* pdLat, const double* pdLon, const double* pdAlt, unsigned int nInStride,
+    double* pdX, double* pdY, double* pdZ, unsigned int nOutStride,
+    int* pnStatus)
+{
+    if( !pcPlanet || !pdLat || !pdLon || !pdAlt || !pdX || !pdY || !pdZ )
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonAlt2XyzBatch() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "LatLonAlt2XyzBatch() called with planet = " + std::string{pcPlanet} + ", count = " + std::to_string(nCount) + ".");
+
+    std::unique_lock<std::recursive_mutex> oSpiceLock(s_oSpiceMutex);
+
+    // Radii are resolved once for the whole batch.
+    SBodyRadii oBody = {};
+    if (LookupBodyRadii(pcPlanet, oBody) != 0)
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonAlt2XyzBatch() failed to lookup radii of \"" + std::string{pcPlanet} + "\".");
+        return -2;
+    }
+    const double dRadiusEquat = oBody.m_dRadiusEquat;
+    const double dFlattening = oBody.m_dFlattening;
+
+    // The native kernels do not touch SPICE, so the lock is released before converting.
+    if (const SGeodeticKernels* poKernels = GetNativeKernels(oBody))
+    {
+        oSpiceLock.unlock();
+        RunNativeKernel(poKernels->m_pfnLatLonAlt2Xyz, nCount, pdLat, pdLon, pdAlt, nInStride, dRadiusEquat * 1000.0, oBody.m_nLongitudeSense > 0, pdX, pdY, pdZ, nOutStride);
+        if (pnStatus)
+        {
+            std::fill(pnStatus, pnStatus + nCount, 0);
+        }
+        COO_LOG(LogLevel::TRACE, "LatLonAlt2XyzBatch() finished using the " + std::string{poKernels->m_pcName} + " kernels.");
+        return 0;
+    }
+
+    const double dRadPerDeg = rpd_c();
+    const size_t nIn = nInStride;
+    const size_t nOut = nOutStride;
+    size_t nFailed = 0;
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        double adXyz[3] = { 0.0, 0.0, 0.0 };
+        pgrrec_c(pcPlanet, pdLon[i * nIn] * dRadPerDeg, pdLat[i * nIn] * dRadPerDeg, pdAlt[i * nIn] * 0.001, dRadiusEquat, dFlattening, adXyz);
+        int nStatus = 0;
+        if (SpiceHasFailed())
+        {
+            reset_c();
+            nStatus = -3;
+            ++nFailed;
+        }
+        // Convert to meters
+        pdX[i * nOut] = adXyz[0] * 1000.0;
+        pdY[i * nOut] = adXyz[1] * 1000.0;
+        pdZ[i * nOut] = adXyz[2] * 1000.0;
+        if (pnStatus)
+        {
+            pnStatus[i] = nStatus;
+        }
+    }
+
+    COO_LOG(LogLevel::TRACE, "LatLonAlt2XyzBatch() finished with " + std::to_string(nFailed) + " failed point(s).");
+    return (nFailed == 0) ? 0 : -3;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int LatLonAlt2XyzBatch(
+    const char* pcPlanet,
+    unsigned int nCount,
+    const double* pdLat, const double* pdLon, const double* pdAlt, unsigned int nInStride,
+    double* pdX, double* pdY, double* pdZ, unsigned int nOutStride,
+    int* pnStatus)
+{
+    return MeasureCall(STATS_LATLONALT2XYZBATCH, [&] { return LatLonAlt2XyzBatchImpl(pcPlanet, nCount, pdLat, pdLon, pdAlt, nInStride, pdX, pdY, pdZ, nOutStride, pnStatus); });
+}
+
+
+
+// Radii and longitude sense for the grid functions. The grid conversion does not call SPICE, so
+// the lock is only held for the lookup.
+static int LookupGridSpheroid(const char* pcPlanet, SGridSpheroid& roSpheroid)
+{
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    SBodyRadii oBody = {};
+    if (LookupBodyRadii(pcPlanet, oBody) != 0 || oBody.m_nLongitudeSense == 0)
+    {
+        return -1;
+    }
+    roSpheroid = { oBody.m_dRadiusEquat * 1000.0, oBody.m_dFlattening, oBody.m_nLongitudeSense > 0 };
+    return 0;
+}
+
+
+static bool IsValidGrid(const SLatLonGrid& roGrid)
+{
+    return roGrid.m_nRows > 0 && roGrid.m_nColumns > 0
+        && std::isfinite(roGrid.m_dLatStart) && std::isfinite(roGrid.m_dLatStep)
+        && std::isfinite(roGrid.m_dLonStart) && std::isfinite(roGrid.m_dLonStep);
+}
+
+
+static int LatLonGrid2XyzImpl(const char* pcPlanet, const SLatLonGrid* poGrid, const double* pdAlt, unsigned int nAltRowStride, double* pdXyz, unsigned int nThreads)
+{
+    if( !pcPlanet || !poGrid || !pdAlt || !pdXyz )
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2Xyz() called with nullptr arguments." );
+        return -1;
+    }
+
+    const size_t nRows = poGrid->m_nRows;
+    const size_t nColumns = poGrid->m_nColumns;
+    const size_t nAltStride = (nAltRowStride == 0) ? nColumns : nAltRowStride;
+    COO_LOG(LogLevel::TRACE, "LatLonGrid2Xyz() called with planet = " + std::string{pcPlanet} + ", rows = " + std::to_string(nRows) + ", columns = " + std::to_string(nColumns) + ".");
+    if (!IsValidGrid(*poGrid) || nAltStride < nColumns)
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2Xyz() called with an invalid raster.");
+        return -3;
+    }
+
+    SGridSpheroid oSpheroid = {};
+    if (LookupGridSpheroid(pcPlanet, oSpheroid) != 0)
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2Xyz() failed to lookup radii of \"" + std::string{pcPlanet} + "\".");
+        return -2;
+    }
+
+    // Trigonometry once per row and column; blocks of about 64k cells are converted in parallel.
+    std::vector<SGridRow> vecRows(nRows);
+    std::vector<SGridColumn> vecColumns(nColumns);
+    MakeGridRows(oSpheroid, poGrid->m_dLatStart, poGrid->m_dLatStep, 0, nRows, vecRows.data());
+    MakeGridColumns(oSpheroid, poGrid->m_dLonStart, poGrid->m_dLonStep, 0, nColumns, vecColumns.data());
+    const size_t nBlockRows = std::max<size_t>(1, 65536 / nColumns);
+    const size_t nBlocks = (nRows + nBlockRows - 1) / nBlockRows;
+    ForEachGridTile(nBlocks, nThreads, [&](size_t nBlock, unsigned int)
+    {
+        const size_t nFirst = nBlock * nBlockRows;
+        GridTile2Xyz(vecRows.data() + nFirst, vecColumns.data(), std::min(nBlockRows, nRows - nFirst), nColumns,
+            pdAlt + nFirst * nAltStride, nAltStride, pdXyz + 3 * nFirst * nColumns, nColumns);
+        return true;
+    });
+
+    COO_LOG(LogLevel::TRACE, "LatLonGrid2Xyz() finished.");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int LatLonGrid2Xyz(const char* pcPlanet, const SLatLonGrid* poGrid, const double* pdAlt, unsigned int nAltRowStride, double* pdXyz, unsigned int nThreads)
+{
+    return MeasureCall(STATS_LATLONGRID2XYZ, [&] { return LatLonGrid2XyzImpl(pcPlanet, poGrid, pdAlt, nAltRowStride, pdXyz, nThreads); });
+}
+
+
+static int LatLonGrid2XyzTiledImpl(
+    const char* pcPlanet,
+    const SLatLonGrid* poGrid,
+    unsigned int nTileRows,
+    unsigned int nTileColumns,
+    FnLatLonGridHeights pfnHeights,
+    FnLatLonGridVertices pfnVertices,
+    void* pUserData,
+    unsigned int nThreads)
+{
+    if( !pcPlanet || !poGrid || !pfnHeights || !pfnVertices )
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2XyzTiled() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "LatLonGrid2XyzTiled() called with planet = " + std::string{pcPlanet} + ", rows = " + std::to_string(poGrid->m_nRows) + ", columns = " + std::to_string(poGrid->m_nColumns) + ".");
+    if (!IsValidGrid(*poGrid) || nTileRows == 0 || nTileColumns == 0)
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2XyzTiled() called with an invalid raster or tile size.");
+        return -3;
+    }
+
+    SGridSpheroid oSpheroid = {};
+    if (LookupGridSpheroid(pcPlanet, oSpheroid) != 0)
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2XyzTiled() failed to lookup radii of \"" + std::string{pcPlanet} + "\".");
+        return -2;
+    }
+
+    // Row and column terms are computed per tile, so nothing scales with the raster size.
+    struct STileBuffers
+    {
+        std::vector<SGridRow> m_vecRows;
+        std::vector<SGridColumn> m_vecColumns;
+        std::vector<double> m_vecAlt;
+        std::vector<double> m_vecXyz;
+    };
+    const size_t nTilesV = (static_cast<size_t>(poGrid->m_nRows) + nTileRows - 1) / nTileRows;
+    const size_t nTilesH = (static_cast<size_t>(poGrid->m_nColumns) + nTileColumns - 1) / nTileColumns;
+    std::vector<STileBuffers> vecBuffers(GridThreadCount(nTilesV * nTilesH, nThreads));
+    const bool bCompleted = ForEachGridTile(nTilesV * nTilesH, nThreads, [&](size_t nTile, unsigned int nThread)
+    {
+        const unsigned int nRow = static_cast<unsigned int>(nTile / nTilesH) * nTileRows;
+        const unsigned int nColumn = static_cast<unsigned int>(nTile % nTilesH) * nTileColumns;
+        const unsigned int nRows = std::min(nTileRows, poGrid->m_nRows - nRow);
+        const unsigned int nColumns = std::min(nTileColumns, poGrid->m_nColumns - nColumn);
+        STileBuffers& roBuffers = vecBuffers[nThread];
+        roBuffers.m_vecRows.resize(nRows);
+        roBuffers.m_vecColumns.resize(nColumns);
+        roBuffers.m_vecAlt.resize(static_cast<size_t>(nRows) * nColumns);
+        roBuffers.m_vecXyz.resize(3 * static_cast<size_t>(nRows) * nColumns);
+        if (pfnHeights(pUserData, nRow, nColumn, nRows, nColumns, roBuffers.m_vecAlt.data()) != 0)
+        {
+            return false;
+        }
+        MakeGridRows(oSpheroid, poGrid->m_dLatStart, poGrid->m_dLatStep, nRow, nRows, roBuffers.m_vecRows.data());
+        MakeGridColumns(oSpheroid, poGrid->m_dLonStart, poGrid->m_dLonStep, nColumn, nColumns, roBuffers.m_vecColumns.data());
+        GridTile2Xyz(roBuffers.m_vecRows.data(), roBuffers.m_vecColumns.data(), nRows, nColumns,
+            roBuffers.m_vecAlt.data(), nColumns, roBuffers.m_vecXyz.data(), nColumns);
+        return pfnVertices(pUserData, nRow, nColumn, nRows, nColumns, roBuffers.m_vecXyz.data()) == 0;
+    });
+    if (!bCompleted)
+    {
+        COO_LOG(LogLevel::WARNING, "LatLonGrid2XyzTiled() was stopped by a callback.");
+        return -4;
+    }
+
+    COO_LOG(LogLevel::TRACE, "LatLonGrid2XyzTiled() finished with " + std::to_string(nTilesV * nTilesH) + " tile(s).");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int LatLonGrid2XyzTiled(
+    const char* pcPlanet,
+    const SLatLonGrid* poGrid,
+    unsigned int nTileRows,
+    unsigned int nTileColumns,
+    FnLatLonGridHeights pfnHeights,
+    FnLatLonGridVertices pfnVertices,
+    void* pUserData,
+    unsigned int nThreads)
+{
+    return MeasureCall(STATS_LATLONGRID2XYZTILED, [&] { return LatLonGrid2XyzTiledImpl(pcPlanet, poGrid, nTileRows, nTileColumns, pfnHeights, pfnVertices, pUserData, nThreads); });
+}
+
+
+static int LatLonAlt2XyzBatchF32Impl(
+    const char* pcPlanet,
+    unsigned int nCount,
+    const double* pdLat, const double* pdLon, const double* pdAlt, unsigned int nInStride,
+    const SVertexOutputF32* poOutput,
+    double* pdMaxError,
+    int* pnStatus)
+{
+    if( !pcPlanet || !pdLat || !pdLon || !pdAlt || !poOutput )
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonAlt2XyzBatchF32() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "LatLonAlt2XyzBatchF32() called with planet = " + std::string{pcPlanet} + ", count = " + std::to_string(nCount) + ".");
+    if (!IsValidVertexOutput(*poOutput))
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonAlt2XyzBatchF32() called with an invalid vertex output.");
+        return -4;
+    }
+
+    std::unique_lock<std::recursive_mutex> oSpiceLock(s_oSpiceMutex);
+
+    SBodyRadii oBody = {};
+    if (LookupBodyRadii(pcPlanet, oBody) != 0)
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonAlt2XyzBatchF32() failed to lookup radii of \"" + std::string{pcPlanet} + "\".");
+        return -2;
+    }
+    const double dRadiusEquat = oBody.m_dRadiusEquat;
+    const double dFlattening = oBody.m_dFlattening;
+
+    // Vertices are written straight from small blocks of doubles on the stack.
+    const size_t nIn = nInStride;
+    double dMaxError2 = 0.0;
+    size_t nFailed = 0;
+    if (const SGeodeticKernels* poKernels = GetNativeKernels(oBody))
+    {
+        oSpiceLock.unlock();
+        constexpr size_t BLOCK_SIZE = 256;
+        double adXyz[3][BLOCK_SIZE];
+        for (size_t nStart = 0; nStart < nCount; nStart += BLOCK_SIZE)
+        {
+            const size_t nBlock = std::min<size_t>(BLOCK_SIZE, nCount - nStart);
+            RunNativeKernel(poKernels->m_pfnLatLonAlt2Xyz, nBlock, pdLat + nStart * nIn, pdLon + nStart * nIn, pdAlt + nStart * nIn, nIn,
+                dRadiusEquat * 1000.0, oBody.m_nLongitudeSense > 0, adXyz[0], adXyz[1], adXyz[2], 1);
+            for (size_t i = 0; i < nBlock; ++i)
+            {
+                dMaxError2 = std::max(dMaxError2, WriteVertexF32(*poOutput, nStart + i, adXyz[0][i], adXyz[1][i], adXyz[2][i]));
+            }
+        }
+        if (pnStatus)
+        {
+            std::fill(pnStatus, pnStatus + nCount, 0);
+        }
+    }
+    else
+    {
+        const double dRadPerDeg = rpd_c();
+        for (size_t i = 0; i < nCount; ++i)
+        {
+            double adXyz[3] = { 0.0, 0.0, 0.0 };
+            pgrrec_c(pcPlanet, pdLon[i * nIn] * dRadPerDeg, pdLat[i * nIn] * dRadPerDeg, pdAlt[i * nIn] * 0.001, dRadiusEquat, dFlattening, adXyz);
+            int nStatus = 0;
+            if (SpiceHasFailed())
+            {
+                reset_c();
+                nStatus = -3;
+                ++nFailed;
+            }
+            const double dError2 = WriteVertexF32(*poOutput, i, adXyz[0] * 1000.0, adXyz[1] * 1000.0, adXyz[2] * 1000.0);
+            dMaxError2 = (nStatus == 0) ? std::max(dMaxError2, dError2) : dMaxError2;
+            if (pnStatus)
+            {
+                pnStatus[i] = nStatus;
+            }
+        }
+    }
+
+    if (pdMaxError)
+    {
+        *pdMaxError = std::sqrt(dMaxError2);
+    }
+    COO_LOG(LogLevel::TRACE, "LatLonAlt2XyzBatchF32() finished with " + std::to_string(nFailed) + " failed point(s), max. error = " + std::to_string(std::sqrt(dMaxError2)) + " m.");
+    return (nFailed == 0) ? 0 : -3;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int LatLonAlt2XyzBatchF32(
+    const char* pcPlanet,
+    unsigned int nCount,
+    const double* pdLat, const double* pdLon, const double* pdAlt, unsigned int nInStride,
+    const SVertexOutputF32* poOutput,
+    double* pdMaxError,
+    int* pnStatus)
+{
+    return MeasureCall(STATS_LATLONALT2XYZBATCHF32, [&] { return LatLonAlt2XyzBatchF32Impl(pcPlanet, nCount, pdLat, pdLon, pdAlt, nInStride, poOutput, pdMaxError, pnStatus); });
+}
+
+
+static int LatLonGrid2XyzF32Impl(const char* pcPlanet, const SLatLonGrid* poGrid, const double* pdAlt, unsigned int nAltRowStride, const SVertexOutputF32* poOutput, double* pdMaxError, unsigned int nThreads)
+{
+    if( !pcPlanet || !poGrid || !pdAlt || !poOutput )
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2XyzF32() called with nullptr arguments." );
+        return -1;
+    }
+
+    const size_t nRows = poGrid->m_nRows;
+    const size_t nColumns = poGrid->m_nColumns;
+    const size_t nAltStride = (nAltRowStride == 0) ? nColumns : nAltRowStride;
+    COO_LOG(LogLevel::TRACE, "LatLonGrid2XyzF32() called with planet = " + std::string{pcPlanet} + ", rows = " + std::to_string(nRows) + ", columns = " + std::to_string(nColumns) + ".");
+    if (!IsValidGrid(*poGrid) || nAltStride < nColumns)
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2XyzF32() called with an invalid raster.");
+        return -3;
+    }
+    if (!IsValidVertexOutput(*poOutput))
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2XyzF32() called with an invalid vertex output.");
+        return -4;
+    }
+
+    SGridSpheroid oSpheroid = {};
+    if (LookupGridSpheroid(pcPlanet, oSpheroid) != 0)
+    {
+        COO_LOG(LogLevel::ERROR, "LatLonGrid2XyzF32() failed to lookup radii of \"" + std::string{pcPlanet} + "\".");
+        return -2;
+    }
+
+    // Same blocks as LatLonGrid2Xyz(); every thread keeps its own largest error.
+    std::vector<SGridRow> vecRows(nRows);
+    std::vector<SGridColumn> vecColumns(nColumns);
+    MakeGridRows(oSpheroid, poGrid->m_dLatStart, poGrid->m_dLatStep, 0, nRows, vecRows.data());
+    MakeGridColumns(oSpheroid, poGrid->m_dLonStart, poGrid->m_dLonStep, 0, nColumns, vecColumns.data());
+    const size_t nBlockRows = std::max<size_t>(1, 65536 / nColumns);
+    const size_t nBlocks = (nRows + nBlockRows - 1) / nBlockRows;
+    std::vector<double> vecMaxError2(GridThreadCount(nBlocks, nThreads), 0.0);
+    ForEachGridTile(nBlocks, nThreads, [&](size_t nBlock, unsigned int nThread)
+    {
+        const size_t nFirst = nBlock * nBlockRows;
+        const double dError2 = GridTile2VertexF32(vecRows.data() + nFirst, vecColumns.data(), std::min(nBlockRows, nRows - nFirst), nColumns,
+            pdAlt + nFirst * nAltStride, nAltStride, *poOutput, nFirst * nColumns, nColumns);
+        vecMaxError2[nThread] = std::max(vecMaxError2[nThread], dError2);
+        return true;
+    });
+
+    const double dMaxError = std::sqrt(*std::max_element(vecMaxError2.begin(), vecMaxError2.end()));
+    if (pdMaxError)
+    {
+        *pdMaxError = dMaxError;
+    }
+    COO_LOG(LogLevel::TRACE, "LatLonGrid2XyzF32() finished with max. error = " + std::to_string(dMaxError) + " m.");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int LatLonGrid2XyzF32(const char* pcPlanet, const SLatLonGrid* poGrid, const double* pdAlt, unsigned int nAltRowStride, const SVertexOutputF32* poOutput, double* pdMaxError, unsigned int nThreads)
+{
+    return MeasureCall(STATS_LATLONGRID2XYZF32, [&] { return LatLonGrid2XyzF32Impl(pcPlanet, poGrid, pdAlt, nAltRowStride, poOutput, pdMaxError, nThreads); });
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetVertexF32ErrorBound(double dTileRadius, double* pdMaxError)
+{
+    if( !pdMaxError )
+    {
+        COO_LOG(LogLevel::ERROR, "GetVertexF32ErrorBound() called with nullptr arguments." );
+        return -1;
+    }
+    if( !std::isfinite(dTileRadius) || dTileRadius < 0.0 )
+    {
+        COO_LOG(LogLevel::ERROR, "GetVertexF32ErrorBound() called with an invalid tile radius." );
+        return -2;
+    }
+
+    *pdMaxError = VertexF32ErrorBound(dTileRadius);
+    return 0;
+}
+
+
+// Support body position w.r.t. the observer [km], shared by all targets at the same epoch.
+static int GetSupportPosition(
+    const SSpiceRef& roSupportBody,
+    const SSpiceRef& roObserverBody,
+    double dObserverTime,
+    const SSpiceRef& roOutputReferenceFrame,
+    std::array<double, 3>& rdSupportPosVec
+)
+{
+    //SpiceDouble state[6] = {};
+    auto state = std::array<double, 6>{};
+    int nResult = GetBodyState( roSupportBody, dObserverTime, roOutputReferenceFrame, roObserverBody, state.data() );
+    if( nResult != 0 )
+    {
+        return (nResult == -2) ? -6 : -3;
+    }
+
+    rdSupportPosVec[0] = state[0];
+    rdSupportPosVec[1] = state[1];
+    rdSupportPosVec[2] = state[2];
+    return 0;
+}   // GetSupportPosition()
+
+
+
+static int ComputeRelStateFromSupport(
+    const SSpiceRef& roTargetBody,
+    const std::array<double, 3>& dSupportPosVec,
+    const SSpiceRef& roObserverBody,
+    double dObserverTime,
+    const SSpiceRef& roOutputReferenceFrame,
+    double* pdPosVec,
+    double* pdRotMat
+)
+{
+    // #1.-position of mars (target) from HERA (Observr) in ECLIPJ2000--> spkezr
+    // Target Position, e.g. Hera:
+    {
+        SpiceDouble state[6] = {};
+        int nResult = GetBodyState( roTargetBody, dObserverTime, roOutputReferenceFrame, roObserverBody, state );
+        if( nResult != 0 )
+        {
+            return (nResult == -2) ? -6 : -4;
+        }
+
+        pdPosVec[0] = state[0];
+        pdPosVec[1] = state[1];
+        pdPosVec[2] = state[2];
+    }
+
+    // Rotation:
+    {
+        //double dSunPos[3] = {dSunPosX, dSunPosY, dSunPosZ};
+        //double dHeraPos[3] = {*pdPosX, *pdPosY, *pdPosZ};
+        double dSunPosNorm[3] = {};
+        double dHeraPosNorm[3] = {};
+        double dUnused[3] = {};
+
+        // #4.- normalize HERA-SUn vector (uSOL)
+        // uSOL = spice.unorm(sunPos)[0]
+        unorm_c( dSupportPosVec.data(), dSunPosNorm, dUnused );
+
+
+        // #2.-normalize HERA-MARS vector -->uz
+        // uz = spice.unorm(MarsPos)[0]
+        unorm_c( pdPosVec, dHeraPosNorm, dUnused );
+        //double dUZ[3] = {-pdPosVec[0], -pdPosVec[1], -pdPosVec[2]};
+        double dUZ[3] = {dHeraPosNorm[0], dHeraPosNorm[1], dHeraPosNorm[2]};
+        double dUY[3];
+        double dUX[3];
+
+        // #5.- multiply uz x uSOL = vy
+        // vy = spice.vcrss(uz, uSOL)
+        vcrss_c( dUZ, dSunPosNorm, dUY );
+
+        // #6.-normalize vy (=uy)
+        // uy= spice.unorm(vy)[0]
+        double dTmp[3];
+        unorm_c( dUY, dTmp, dUnused );
+        dUY[0] = dTmp[0];
+        dUY[1] = dTmp[1];
+        dUY[2] = dTmp[2];
+
+        // #7.- multiply uz x uy (= vx)
+        //vx = spice.vcrss(uy, uz)
+        vcrss_c( dUY, dUZ, dUX );
+
+
+        // #8.- normalize vx (= ux)
+        // ux = spice.unorm(vx)[0]
+        unorm_c( dUX, dTmp, dUnused );
+        dUX[0] = dTmp[0];
+        dUX[1] = dTmp[1];
+        dUX[2] = dTmp[2];
+
+        // #9.-compose rotation matrix
+        // np.array([ux, uy, uz])
+        // compose:
+        pdRotMat[0] = dUX[0];
+        pdRotMat[1] = dUX[1];
+        pdRotMat[2] = dUX[2];
+
+        pdRotMat[3] = dUY[0];
+        pdRotMat[4] = dUY[1];
+        pdRotMat[5] = dUY[2];
+
+        pdRotMat[6] = dUZ[0];
+        pdRotMat[7] = dUZ[1];
+        pdRotMat[8] = dUZ[2];
+
+        //// compose + transpose:
+        //pdRotMat[0] = dUX[0];
+        //pdRotMat[1] = dUY[0];
+        //pdRotMat[2] = dUZ[0];
+
+        //pdRotMat[3] = dUX[1];
+        //pdRotMat[4] = dUY[1];
+        //pdRotMat[5] = dUZ[1];
+
+        //pdRotMat[6] = dUX[2];
+        //pdRotMat[7] = dUY[2];
+        //pdRotMat[8] = dUZ[2];
+    }
+
+    // [km] to [m];
+    pdPosVec[0] *= 1000;
+    pdPosVec[1] *= 1000;
+    pdPosVec[2] *= 1000;
+
+    return 0;
+}   // ComputeRelStateFromSupport()
+
+
+
+static int ComputeRelState(
+    const SSpiceRef& roTargetBody,
+    const SSpiceRef& roSupportBody,
+    const SSpiceRef& roObserverBody,
+    double dObserverTime,
+    const SSpiceRef& roOutputReferenceFrame,
+    double* pdPosVec,
+    double* pdRotMat
+)
+{
+    //Return the state (position and velocity) of a target body
+    //    relative to an observing body, optionally corrected for light
+    //    time (planetary aberration) and stellar aberration.
+
+    // Aberration correction is always "NONE" (see GetBodyState()).
+
+
+    // Support body position for rotation, e.g. SUN:
+    auto dSupportPosVec = std::array<double, 3>{};
+    int nResult = GetSupportPosition( roSupportBody, roObserverBody, dObserverTime, roOutputReferenceFrame, dSupportPosVec );
+    if( nResult != 0 )
+    {
+        return nResult;
+    }
+
+    return ComputeRelStateFromSupport( roTargetBody, dSupportPosVec, roObserverBody, dObserverTime, roOutputReferenceFrame, pdPosVec, pdRotMat );
+}   // ComputeRelState()
+
+
+static int GetRelStateImpl(
+    const char* pcTargetBody,
+    const char* pcSupportBody,
+    const char* pcObserverBody,
+    const char* pcObserverTime,
+    const char* pcOutputReferenceFrame,
+    double* pdPosVec,
+    double* pdRotMat
+)
+{
+    if( !pcTargetBody || !pcSupportBody || !pcObserverBody || !pcObserverTime || !pcOutputReferenceFrame || !pdPosVec || !pdRotMat )
+    {
+        COO_LOG(LogLevel::ERROR, "GetRelState() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, std::string{"GetRelState() called with "} +
+        "target body = \"" + std::string{pcTargetBody} + "\", " +
+        "support body = \"" + std::string{pcSupportBody} + "\", " +
+        "observer body = \"" + std::string{pcObserverBody} + "\", " +
+        "observer time = \"" + std::string{pcObserverTime} + "\", " +
+        "reference frame = \"" + std::string{pcOutputReferenceFrame} + "\"."
+    );
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    double dObserverTime = {};
+    int ret_val = Str2Et( pcObserverTime, dObserverTime );
+    if(ret_val != 0)
+    {
+        return -2;
+    }
+
+    // Resolved names are checked against the coverage index and use spkez_c().
+    ret_val = ComputeRelState( ResolveBodyRef(pcTargetBody), ResolveBodyRef(pcSupportBody), ResolveBodyRef(pcObserverBody), dObserverTime, ResolveFrameRef(pcOutputReferenceFrame), pdPosVec, pdRotMat );
+    if(ret_val != 0)
+    {
+        return ret_val;
+    }
+
+    COO_LOG(LogLevel::TRACE, std::string{"GetRelState() finished with "} +
+        "pos = (" + std::to_string(pdPosVec[0]) + ", " + std::to_string(pdPosVec[1]) + ", " + std::to_string(pdPosVec[2]) + "), " +
+        "rot = (" + std::to_string(pdRotMat[0]) + ", " + std::to_string(pdRotMat[1]) + ", " + std::to_string(pdRotMat[2]) + ", " +
+        std::to_string(pdRotMat[3]) + ", " + std::to_string(pdRotMat[4]) + ", " + std::to_string(pdRotMat[5]) + ", " +
+        std::to_string(pdRotMat[6]) + ", " + std::to_string(pdRotMat[7]) + ", " + std::to_string(pdRotMat[8]) + ")."
+    );
+
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetRelState(
+    const char* pcTargetBody,
+    const char* pcSupportBody,
+    const char* pcObserverBody,
+    const char* pcObserverTime,
+    const char* pcOutputReferenceFrame,
+    double* pdPosVec,
+    double* pdRotMat
+)
+{
+    return MeasureCall(STATS_GETRELSTATE, [&] { return GetRelStateImpl(pcTargetBody, pcSupportBody, pcObserverBody, pcObserverTime, pcOutputReferenceFrame, pdPosVec, pdRotMat); });
+}
+
+
+static int GetRelStateMultiImpl(
+    const char* const* ppcTargetBodies,
+    unsigned int nTargets,
+    const char* pcSupportBody,
+    const char* pcObserverBody,
+    const char* pcObserverTime,
+    const char* pcOutputReferenceFrame,
+    double* pdPosVecs,
+    double* pdRotMats,
+    int* pnStatus
+)
+{
+    if( !ppcTargetBodies || !pcSupportBody || !pcObserverBody || !pcObserverTime || !pcOutputReferenceFrame || !pdPosVecs || !pdRotMats ||
+        std::any_of(ppcTargetBodies, ppcTargetBodies + nTargets, [](const char* pcTarget) { return pcTarget == nullptr; }) )
+    {
+        COO_LOG(LogLevel::ERROR, "GetRelStateMulti() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, std::string{"GetRelStateMulti() called with "} +
+        "targets = " + std::to_string(nTargets) + ", " +
+        "support body = \"" + std::string{pcSupportBody} + "\", " +
+        "observer body = \"" + std::string{pcObserverBody} + "\", " +
+        "observer time = \"" + std::string{pcObserverTime} + "\", " +
+        "reference frame = \"" + std::string{pcOutputReferenceFrame} + "\"."
+    );
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    // time, observer, frame and support body are shared by all targets
+    double dObserverTime = {};
+    if( Str2Et( pcObserverTime, dObserverTime ) != 0 )
+    {
+        return -2;
+    }
+
+    const SSpiceRef oObserver = ResolveBodyRef(pcObserverBody);
+    const SSpiceRef oFrame = ResolveFrameRef(pcOutputReferenceFrame);
+    auto dSupportPosVec = std::array<double, 3>{};
+    const int nSupportStatus = GetSupportPosition( ResolveBodyRef(pcSupportBody), oObserver, dObserverTime, oFrame, dSupportPosVec );
+    if( nSupportStatus != 0 )
+    {
+        if (pnStatus)
+        {
+            std::fill(pnStatus, pnStatus + nTargets, nSupportStatus);
+        }
+        COO_LOG(LogLevel::ERROR, "GetRelStateMulti() failed to get the state of the support body \"" + std::string{pcSupportBody} + "\"." );
+        return nSupportStatus;
+    }
+
+    size_t nFailed = 0;
+    for (size_t i = 0; i < nTargets; ++i)
+    {
+        const int nStatus = ComputeRelStateFromSupport( ResolveBodyRef(ppcTargetBodies[i]), dSupportPosVec, oObserver, dObserverTime, oFrame, pdPosVecs + 3 * i, pdRotMats + 9 * i );
+        if (nStatus != 0)
+        {
+            ++nFailed;
+        }
+        if (pnStatus)
+        {
+            pnStatus[i] = nStatus;
+        }
+    }
+
+    if (nFailed != 0)
+    {
+        COO_LOG(LogLevel::WARNING, "GetRelStateMulti() failed for " + std::to_string(nFailed) + " of " + std::to_string(nTargets) + " target(s).");
+        return -4;
+    }
+
+    COO_LOG(LogLevel::TRACE, "GetRelStateMulti() finished.");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetRelStateMulti(
+    const char* const* ppcTargetBodies,
+    unsigned int nTargets,
+    const char* pcSupportBody,
+    const char* pcObserverBody,
+    const char* pcObserverTime,
+    const char* pcOutputReferenceFrame,
+    double* pdPosVecs,
+    double* pdRotMats,
+    int* pnStatus
+)
+{
+    return MeasureCall(STATS_GETRELSTATEMULTI, [&] { return GetRelStateMultiImpl(ppcTargetBodies, nTargets, pcSupportBody, pcObserverBody, pcObserverTime, pcOutputReferenceFrame, pdPosVecs, pdRotMats, pnStatus); });
+}
+
+
+static int GetRelStateByHandleImpl(
+    int nTargetBody,
+    int nSupportBody,
+    int nObserverBody,
+    double dEt,
+    int nOutputReferenceFrame,
+    double* pdPosVec,
+    double* pdRotMat
+)
+{
+    if( !pdPosVec || !pdRotMat )
+    {
+        COO_LOG(LogLevel::ERROR, "GetRelStateByHandle() called with nullptr arguments." );
+        return -1;
+    }
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    const SBodyHandle* poTarget = FindBodyHandle(nTargetBody);
+    const SBodyHandle* poSupport = FindBodyHandle(nSupportBody);
+    const SBodyHandle* poObserver = FindBodyHandle(nObserverBody);
+    const SFrameHandle* poFrame = FindFrameHandle(nOutputReferenceFrame);
+    if( !poTarget || !poSupport || !poObserver || !poFrame )
+    {
+        COO_LOG(LogLevel::ERROR, "GetRelStateByHandle() called with an invalid or outdated handle." );
+        return -5;
+    }
+
+    return ComputeRelState(
+        { poTarget->m_sName.c_str(), poTarget->m_nId, true },
+        { poSupport->m_sName.c_str(), poSupport->m_nId, true },
+        { poObserver->m_sName.c_str(), poObserver->m_nId, true },
+        dEt,
+        { poFrame->m_sName.c_str(), poFrame->m_nCode, true },
+        pdPosVec, pdRotMat );
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetRelStateByHandle(
+    int nTargetBody,
+    int nSupportBody,
+    int nObserverBody,
+    double dEt,
+    int nOutputReferenceFrame,
+    double* pdPosVec,
+    double* pdRotMat
+)
+{
+    return MeasureCall(STATS_GETRELSTATEBYHANDLE, [&] { return GetRelStateByHandleImpl(nTargetBody, nSupportBody, nObserverBody, dEt, nOutputReferenceFrame, pdPosVec, pdRotMat); });
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int Datetime2Et(const char* pcDatetime, double* pdEt)
+{
+    if( !pcDatetime || !pdEt )
+    {
+        COO_LOG(LogLevel::ERROR, "Datetime2Et() called with nullptr arguments." );
+        return -1;
+    }
+
+    if( Str2Et( pcDatetime, *pdEt ) != 0 )
+    {
+        return -2;
+    }
+    return 0;
+}
+
+
+static int GetRelStateSeriesImpl(
+    const char* pcTargetBody,
+    const char* pcSupportBody,
+    const char* pcObserverBody,
+    const char* pcOutputReferenceFrame,
+    double dStartEt,
+    double dStepEt,
+    const double* pdEts,
+    unsigned int nCount,
+    double* pdPosVecs,
+    double* pdRotMats,
+    int* pnStatus
+)
+{
+    if( !pcTargetBody || !pcSupportBody || !pcObserverBody || !pcOutputReferenceFrame || !pdPosVecs || !pdRotMats )
+    {
+        COO_LOG(LogLevel::ERROR, "GetRelStateSeries() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, std::string{"GetRelStateSeries() called with "} +
+        "target body = \"" + std::string{pcTargetBody} + "\", " +
+        "support body = \"" + std::string{pcSupportBody} + "\", " +
+        "observer body = \"" + std::string{pcObserverBody} + "\", " +
+        "reference frame = \"" + std::string{pcOutputReferenceFrame} + "\", " +
+        "count = " + std::to_string(nCount) + "."
+    );
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    // names are resolved once for the whole series
+    const SSpiceRef oTarget = ResolveBodyRef(pcTargetBody);
+    const SSpiceRef oSupport = ResolveBodyRef(pcSupportBody);
+    const SSpiceRef oObserver = ResolveBodyRef(pcObserverBody);
+    const SSpiceRef oFrame = ResolveFrameRef(pcOutputReferenceFrame);
+
+    size_t nFailed = 0;
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        const double dEt = pdEts ? pdEts[i] : dStartEt + static_cast<double>(i) * dStepEt;
+        int nStatus = ComputeRelState( oTarget, oSupport, oObserver, dEt, oFrame, pdPosVecs + 3 * i, pdRotMats + 9 * i );
+        if (nStatus != 0)
+        {
+            ++nFailed;
+        }
+        if (pnStatus)
+        {
+            pnStatus[i] = nStatus;
+        }
+    }
+
+    if (nFailed != 0)
+    {
+        COO_LOG(LogLevel::WARNING, "GetRelStateSeries() failed for " + std::to_string(nFailed) + " of " + std::to_string(nCount) + " epoch(s).");
+        return -2;
+    }
+
+    COO_LOG(LogLevel::TRACE, "GetRelStateSeries() finished.");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetRelStateSeries(
+    const char* pcTargetBody,
+    const char* pcSupportBody,
+    const char* pcObserverBody,
+    const char* pcOutputReferenceFrame,
+    double dStartEt,
+    double dStepEt,
+    const double* pdEts,
+    unsigned int nCount,
+    double* pdPosVecs,
+    double* pdRotMats,
+    int* pnStatus
+)
+{
+    return MeasureCall(STATS_GETRELSTATESERIES, [&] { return GetRelStateSeriesImpl(pcTargetBody, pcSupportBody, pcObserverBody, pcOutputReferenceFrame, dStartEt, dStepEt, pdEts, nCount, pdPosVecs, pdRotMats, pnStatus); });
+}
+
+
+static int GetIlluminationAnglesImpl(
+    const char* pcBody,
+    const char* pcBodyFrame,
+    const char* pcObserverBody,
+    double dStartEt,
+    double dStepEt,
+    const double* pdEts,
+    unsigned int nEpochs,
+    unsigned int nCount,
+    const double* pdX, const double* pdY, const double* pdZ,
+    const double* pdNx, const double* pdNy, const double* pdNz,
+    unsigned int nInStride,
+    double* pdIncidence, double* pdEmission, double* pdPhase,
+    int* pnStatus,
+    unsigned int nThreads
+)
+{
+    if( !pcBody || !pcBodyFrame || !pcObserverBody || !pdX || !pdY || !pdZ || !pdIncidence || !pdEmission || !pdPhase )
+    {
+        COO_LOG(LogLevel::ERROR, "GetIlluminationAngles() called with nullptr arguments." );
+        return -1;
+    }
+    if( !pdNx || !pdNy || !pdNz )
+    {
+        // the outward radial direction of a point is the point itself
+        pdNx = pdX;
+        pdNy = pdY;
+        pdNz = pdZ;
+    }
+
+    COO_LOG(LogLevel::TRACE, std::string{"GetIlluminationAngles() called with "} +
+        "body = \"" + std::string{pcBody} + "\", " +
+        "body frame = \"" + std::string{pcBodyFrame} + "\", " +
+        "observer body = \"" + std::string{pcObserverBody} + "\", " +
+        "epochs = " + std::to_string(nEpochs) + ", " +
+        "points = " + std::to_string(nCount) + "."
+    );
+
+    // Sun and observer w.r.t. the body center in the body frame [m], once per epoch.
+    std::vector<std::array<double, 6>> vecSources(nEpochs);
+    std::vector<int> vecStatus(nEpochs, 0);
+    size_t nFailed = 0;
+    {
+        SpiceLock oSpiceLock(s_oSpiceMutex);
+
+        const SSpiceRef oBody = ResolveBodyRef(pcBody);
+        const SSpiceRef oSun = ResolveBodyRef("SUN");
+        const SSpiceRef oObserver = ResolveBodyRef(pcObserverBody);
+        const SSpiceRef oFrame = ResolveFrameRef(pcBodyFrame);
+
+        for (size_t e = 0; e < nEpochs; ++e)
+        {
+            const double dEt = pdEts ? pdEts[e] : dStartEt + static_cast<double>(e) * dStepEt;
+            double adState[6] = {};
+            int nStatus = GetBodyState( oSun, dEt, oFrame, oBody, adState );
+            if (nStatus == 0)
+            {
+                std::copy(adState, adState + 3, vecSources[e].data());
+                nStatus = GetBodyState( oObserver, dEt, oFrame, oBody, adState );
+                std::copy(adState, adState + 3, vecSources[e].data() + 3);
+                nStatus = (nStatus == 0) ? 0 : (nStatus == -2) ? -6 : -4;
+            }
+            else
+            {
+                nStatus = (nStatus == -2) ? -6 : -3;
+            }
+            for (double& rdValue : vecSources[e])
+            {
+                rdValue *= 1000.0;
+            }
+            vecStatus[e] = nStatus;
+            nFailed += (nStatus != 0) ? 1 : 0;
+        }
+    }
+
+    // The angles do not touch SPICE. There is no SPICE variant, so the SPICE backend uses the best native kernels.
+    const SGeodeticKernels* poKernels = s_poGeodeticKernels.load(std::memory_order_relaxed);
+    if (!poKernels)
+    {
+        int nResolved = 0;
+        poKernels = GetGeodeticKernels(GEODETIC_BACKEND_NATIVE, nResolved);
+    }
+
+    // Blocks of up to 16k points per epoch are evaluated in parallel; strided input is copied
+    // through small blocks on the stack.
+    constexpr size_t BLOCK_SIZE = 16384;
+    constexpr size_t COPY_SIZE = 256;
+    const size_t nIn = nInStride;
+    const size_t nBlocks = (static_cast<size_t>(nCount) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    ForEachGridTile(nEpochs * nBlocks, nThreads, [&](size_t nTile, unsigned int)
+    {
+        const size_t e = nTile / nBlocks;
+        const size_t nFirst = (nTile % nBlocks) * BLOCK_SIZE;
+        const size_t nLast = std::min<size_t>(nFirst + BLOCK_SIZE, nCount);
+        const size_t nOut = e * nCount;
+        if (vecStatus[e] != 0)
+        {
+            const double dNaN = std::numeric_limits<double>::quiet_NaN();
+            std::fill(pdIncidence + nOut + nFirst, pdIncidence + nOut + nLast, dNaN);
+            std::fill(pdEmission + nOut + nFirst, pdEmission + nOut + nLast, dNaN);
+            std::fill(pdPhase + nOut + nFirst, pdPhase + nOut + nLast, dNaN);
+            return true;
+        }
+        const double* pdSun = vecSources[e].data();
+        const double* pdObserver = vecSources[e].data() + 3;
+        if (nIn == 1)
+        {
+            poKernels->m_pfnIlluminationAngles(nLast - nFirst, pdX + nFirst, pdY + nFirst, pdZ + nFirst,
+                pdNx + nFirst, pdNy + nFirst, pdNz + nFirst, pdSun, pdObserver,
+                pdIncidence + nOut + nFirst, pdEmission + nOut + nFirst, pdPhase + nOut + nFirst);
+            return true;
+        }
+        double adIn[6][COPY_SIZE];
+        const double* apdIn[6] = { pdX, pdY, pdZ, pdNx, pdNy, pdNz };
+        for (size_t nStart = nFirst; nStart < nLast; nStart += COPY_SIZE)
+        {
+            const size_t nCopy = std::min(COPY_SIZE, nLast - nStart);
+            for (size_t k = 0; k < 6; ++k)
+            {
+                for (size_t i = 0; i < nCopy; ++i)
+                {
+                    adIn[k][i] = apdIn[k][(nStart + i) * nIn];
+                }
+            }
+            poKernels->m_pfnIlluminationAngles(nCopy, adIn[0], adIn[1], adIn[2], adIn[3], adIn[4], adIn[5], pdSun, pdObserver,
+                pdIncidence + nOut + nStart, pdEmission + nOut + nStart, pdPhase + nOut + nStart);
+        }
+        return true;
+    });
+
+    if (pnStatus)
+    {
+        std::copy(vecStatus.begin(), vecStatus.end(), pnStatus);
+    }
+    if (nFailed != 0)
+    {
+        COO_LOG(LogLevel::WARNING, "GetIlluminationAngles() failed for " + std::to_string(nFailed) + " of " + std::to_string(nEpochs) + " epoch(s).");
+        return -2;
+    }
+
+    COO_LOG(LogLevel::TRACE, "GetIlluminationAngles() finished using the " + std::string{poKernels->m_pcName} + " kernels.");
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetIlluminationAngles(
+    const char* pcBody,
+    const char* pcBodyFrame,
+    const char* pcObserverBody,
+    double dStartEt,
+    double dStepEt,
+    const double* pdEts,
+    unsigned int nEpochs,
+    unsigned int nCount,
+    const double* pdX, const double* pdY, const double* pdZ,
+    const double* pdNx, const double* pdNy, const double* pdNz,
+    unsigned int nInStride,
+    double* pdIncidence, double* pdEmission, double* pdPhase,
+    int* pnStatus,
+    unsigned int nThreads
+)
+{
+    return MeasureCall(STATS_GETILLUMINATIONANGLES, [&] { return GetIlluminationAnglesImpl(pcBody, pcBodyFrame, pcObserverBody, dStartEt, dStepEt, pdEts, nEpochs, nCount, pdX, pdY, pdZ, pdNx, pdNy, pdNz, nInStride, pdIncidence, pdEmission, pdPhase, pnStatus, nThreads); });
+}
 
-        dSupportPosVec[0] = state[0];
-        dSupportPosVec[1] = state[1];
-        dSupportPosVec[2] = state[2];
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int CreateEphemerisCache(
+    const char* pcTargetBody,
+    const char* pcObserverBody,
+    const char* pcReferenceFrame,
+    double dStartEt,
+    double dEndEt,
+    double dTolerance,
+    int* pnCacheId,
+    double* pdMaxError
+)
+{
+    if( !pcTargetBody || !pcObserverBody || !pcReferenceFrame || !pnCacheId || !pdMaxError )
+    {
+        COO_LOG(LogLevel::ERROR, "CreateEphemerisCache() called with nullptr arguments." );
+        return -1;
     }
 
-    // #1.-position of mars (target) from HERA (Observr) in ECLIPJ2000--> spkezr
-    // Target Position, e.g. Hera:
+    COO_LOG(LogLevel::TRACE, std::string{"CreateEphemerisCache() called with "} +
+        "target body = \"" + std::string{pcTargetBody} + "\", " +
+        "observer body = \"" + std::string{pcObserverBody} + "\", " +
+        "reference frame = \"" + std::string{pcReferenceFrame} + "\", " +
+        "et = [" + std::to_string(dStartEt) + ", " + std::to_string(dEndEt) + "], " +
+        "tolerance = " + std::to_string(dTolerance) + "."
+    );
+
+    if( !(dEndEt > dStartEt) || !(dTolerance > 0.0) )
     {
-        SpiceDouble state[6] = {};
-        double unused = {};
-        spkezr_c( pcTargetBody, dObserverTime, pcOutputReferenceFrame, sAberrationCorrection.c_str(), pcObserverBody, state, &unused );
+        COO_LOG(LogLevel::ERROR, "CreateEphemerisCache() called with an empty time window or non-positive tolerance." );
+        return -2;
+    }
+
+    // Cubic Hermite interpolation error peaks in the middle of a segment, so the fit is validated
+    // against spkezr_c at every segment midpoint. If the tolerance is not met, the midpoints
+    // become additional nodes and the segment count doubles.
+    const size_t nMaxSegments = size_t{1} << 22;
+    const double dToleranceKm = dTolerance * 0.001;
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    auto poCache = std::make_unique<SEphemerisCache>();
+    poCache->m_sTarget = NormalizeSpiceName(pcTargetBody);
+    poCache->m_sObserver = NormalizeSpiceName(pcObserverBody);
+    poCache->m_sFrame = NormalizeSpiceName(pcReferenceFrame);
+    SpiceBoolean bFound = SPICEFALSE;
+    bodn2c_c(poCache->m_sTarget.c_str(), &poCache->m_nTargetId, &bFound);
+    poCache->m_nTargetId = bFound ? poCache->m_nTargetId : NO_SPICE_CODE;
+    bodn2c_c(poCache->m_sObserver.c_str(), &poCache->m_nObserverId, &bFound);
+    poCache->m_nObserverId = bFound ? poCache->m_nObserverId : NO_SPICE_CODE;
+    namfrm_c(poCache->m_sFrame.c_str(), &poCache->m_nFrameCode);
+    poCache->m_nFrameCode = (poCache->m_nFrameCode != 0) ? poCache->m_nFrameCode : NO_SPICE_CODE;
+    poCache->m_dStartEt = dStartEt;
+    poCache->m_dEndEt = dEndEt;
+
+    auto SampleState = [&](double dEt, std::array<double, 6>& rState) -> bool
+    {
+        double dLightTime = {};
+        spkezr_c( poCache->m_sTarget.c_str(), dEt, poCache->m_sFrame.c_str(), "NONE", poCache->m_sObserver.c_str(), rState.data(), &dLightTime );
         if(SpiceHasFailed())
         {
+            char acSMsg[SPICE_ERROR_LMSGLN]; // short message
+            getmsg_c("SHORT", SPICE_ERROR_LMSGLN, acSMsg);
             reset_c();
-            return -4;
+            COO_LOG(LogLevel::ERROR, "CreateEphemerisCache() failed to sample state at et = " + std::to_string(dEt) + " (" + acSMsg + ").");
+            return false;
         }
+        return true;
+    };
 
-        pdPosVec[0] = state[0];
-        pdPosVec[1] = state[1];
-        pdPosVec[2] = state[2];
+    size_t nSegments = 16;
+    poCache->m_vecNodes.resize(nSegments + 1);
+    for (size_t i = 0; i <= nSegments; ++i)
+    {
+        double dEt = (i == nSegments) ? dEndEt : dStartEt + (dEndEt - dStartEt) * static_cast<double>(i) / static_cast<double>(nSegments);
+        if (!SampleState(dEt, poCache->m_vecNodes[i]))
+        {
+            return -3;
+        }
     }
 
-    // Rotation:
+    std::vector<std::array<double, 6>> vecMidpoints;
+    for (;;)
     {
-        //double dSunPos[3] = {dSunPosX, dSunPosY, dSunPosZ};
-        //double dHeraPos[3] = {*pdPosX, *pdPosY, *pdPosZ};
-        double dSunPosNorm[3] = {};
-        double dHeraPosNorm[3] = {};
-        double dUnused[3] = {};
+        poCache->m_dStep = (dEndEt - dStartEt) / static_cast<double>(nSegments);
 
-        // #4.- normalize HERA-SUn vector (uSOL)
-        // uSOL = spice.unorm(sunPos)[0]
-        unorm_c( dSupportPosVec.data(), dSunPosNorm, dUnused );
+        double dMaxError = 0.0;
+        vecMidpoints.resize(nSegments);
+        for (size_t i = 0; i < nSegments; ++i)
+        {
+            double dEt = dStartEt + (static_cast<double>(i) + 0.5) * poCache->m_dStep;
+            if (!SampleState(dEt, vecMidpoints[i]))
+            {
+                return -3;
+            }
+            double adInterpolated[6];
+            EvalEphemerisCache(*poCache, dEt, adInterpolated);
+            double dDx = adInterpolated[0] - vecMidpoints[i][0];
+            double dDy = adInterpolated[1] - vecMidpoints[i][1];
+            double dDz = adInterpolated[2] - vecMidpoints[i][2];
+            dMaxError = std::max(dMaxError, std::sqrt(dDx * dDx + dDy * dDy + dDz * dDz));
+        }
+        poCache->m_dMaxError = dMaxError;
 
+        if (dMaxError <= dToleranceKm)
+        {
+            break;
+        }
+        if (nSegments * 2 > nMaxSegments)
+        {
+            COO_LOG(LogLevel::ERROR, "CreateEphemerisCache() could not reach tolerance " + std::to_string(dTolerance) +
+                " m, best deviation " + std::to_string(dMaxError * 1000.0) + " m.");
+            return -4;
+        }
 
-        // #2.-normalize HERA-MARS vector -->uz
-        // uz = spice.unorm(MarsPos)[0]
-        unorm_c( pdPosVec, dHeraPosNorm, dUnused );
-        //double dUZ[3] = {-pdPosVec[0], -pdPosVec[1], -pdPosVec[2]};
-        double dUZ[3] = {dHeraPosNorm[0], dHeraPosNorm[1], dHeraPosNorm[2]};
-        double dUY[3];
-        double dUX[3];
+        // interleave the midpoints as new nodes:
+        std::vector<std::array<double, 6>> vecNodes(2 * nSegments + 1);
+        for (size_t i = 0; i < nSegments; ++i)
+        {
+            vecNodes[2 * i] = poCache->m_vecNodes[i];
+            vecNodes[2 * i + 1] = vecMidpoints[i];
+        }
+        vecNodes[2 * nSegments] = poCache->m_vecNodes[nSegments];
+        poCache->m_vecNodes = std::move(vecNodes);
+        nSegments *= 2;
+    }
 
-        // #5.- multiply uz x uSOL = vy
-        // vy = spice.vcrss(uz, uSOL)
-        vcrss_c( dUZ, dSunPosNorm, dUY );
+    poCache->m_nId = s_nNextEphemerisCacheId++;
+    *pnCacheId = poCache->m_nId;
+    *pdMaxError = poCache->m_dMaxError * 1000.0;
 
-        // #6.-normalize vy (=uy)
-        // uy= spice.unorm(vy)[0]
-        double dTmp[3];
-        unorm_c( dUY, dTmp, dUnused );
-        dUY[0] = dTmp[0];
-        dUY[1] = dTmp[1];
-        dUY[2] = dTmp[2];
+    COO_LOG(LogLevel::DEBUG, "CreateEphemerisCache() created cache " + std::to_string(poCache->m_nId) + " with " +
+        std::to_string(nSegments) + " segments, max deviation " + std::to_string(*pdMaxError) + " m.");
+    s_vecEphemerisCaches.push_back(std::move(poCache));
+    return 0;
+}
 
-        // #7.- multiply uz x uy (= vx)
-        //vx = spice.vcrss(uy, uz)
-        vcrss_c( dUY, dUZ, dUX );
 
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int DestroyEphemerisCache(int nCacheId)
+{
+    COO_LOG(LogLevel::TRACE, "DestroyEphemerisCache() called with cache id = " + std::to_string(nCacheId) + ".");
 
-        // #8.- normalize vx (= ux)
-        // ux = spice.unorm(vx)[0]
-        unorm_c( dUX, dTmp, dUnused );
-        dUX[0] = dTmp[0];
-        dUX[1] = dTmp[1];
-        dUX[2] = dTmp[2];
+    SpiceLock oSpiceLock(s_oSpiceMutex);
 
-        // #9.-compose rotation matrix
-        // np.array([ux, uy, uz])
-        // compose:
-        pdRotMat[0] = dUX[0];
-        pdRotMat[1] = dUX[1];
-        pdRotMat[2] = dUX[2];
+    auto it = std::find_if(s_vecEphemerisCaches.begin(), s_vecEphemerisCaches.end(),
+        [nCacheId](const auto& poCache) { return poCache->m_nId == nCacheId; });
+    if (it == s_vecEphemerisCaches.end())
+    {
+        COO_LOG(LogLevel::WARNING, "DestroyEphemerisCache() called with unknown cache id " + std::to_string(nCacheId) + ".");
+        return -2;
+    }
+    s_vecEphemerisCaches.erase(it);
+    return 0;
+}
 
-        pdRotMat[3] = dUY[0];
-        pdRotMat[4] = dUY[1];
-        pdRotMat[5] = dUY[2];
 
-        pdRotMat[6] = dUZ[0];
-        pdRotMat[7] = dUZ[1];
-        pdRotMat[8] = dUZ[2];
+static int GetPositionTransformationMatrixImpl(
+    const char* pcFrom,
+    const char* pcTo,
+    const char* pcDatetime,
+    double* pdRotMat
+)
+{
+    if( !pcFrom || !pcTo || !pcDatetime || !pdRotMat )
+    {
+        COO_LOG(LogLevel::ERROR, "GetPositionTransformationMatrix() called with nullptr arguments." );
+        return -1;
+    }
 
-        //// compose + transpose:
-        //pdRotMat[0] = dUX[0];
-        //pdRotMat[1] = dUY[0];
-        //pdRotMat[2] = dUZ[0];
+    COO_LOG(LogLevel::TRACE, "GetPositionTransformationMatrix() called with from = \"" + std::string{pcFrom} + "\", to = \"" + std::string{pcTo} + "\".");
 
-        //pdRotMat[3] = dUX[1];
-        //pdRotMat[4] = dUY[1];
-        //pdRotMat[5] = dUZ[1];
+    SpiceLock oSpiceLock(s_oSpiceMutex);
 
-        //pdRotMat[6] = dUX[2];
-        //pdRotMat[7] = dUY[2];
-        //pdRotMat[8] = dUZ[2];
+    double dEt;
+    int ret_val = Str2Et( pcDatetime, dEt );
+    if(ret_val != 0)
+    {
+        return -2;
     }
 
-    // [km] to [m];
-    pdPosVec[0] *= 1000;
-    pdPosVec[1] *= 1000;
-    pdPosVec[2] *= 1000;
+    ret_val = GetFrameRotation(NameRef(pcFrom), NameRef(pcTo), dEt, pdRotMat);
+    if (ret_val != 0)
+    {
+        return (ret_val == -2) ? -6 : -3;
+    }
 
-    Log(LogLevel::TRACE, std::string{"GetRelState() finished with "} +
-        "pos = (" + std::to_string(pdPosVec[0]) + ", " + std::to_string(pdPosVec[1]) + ", " + std::to_string(pdPosVec[2]) + "), " +
+    COO_LOG(LogLevel::TRACE, std::string{"GetPositionTransformationMatrix() finished with "} +
         "rot = (" + std::to_string(pdRotMat[0]) + ", " + std::to_string(pdRotMat[1]) + ", " + std::to_string(pdRotMat[2]) + ", " +
         std::to_string(pdRotMat[3]) + ", " + std::to_string(pdRotMat[4]) + ", " + std::to_string(pdRotMat[5]) + ", " +
         std::to_string(pdRotMat[6]) + ", " + std::to_string(pdRotMat[7]) + ", " + std::to_string(pdRotMat[8]) + ")."
@@ -543,42 +3293,256 @@ int GetPositionTransformationMatrix(
     double* pdRotMat
 )
 {
-    if( !pcFrom || !pcTo || !pcDatetime || !pdRotMat )
+    return MeasureCall(STATS_GETPOSITIONTRANSFORMATIONMATRIX, [&] { return GetPositionTransformationMatrixImpl(pcFrom, pcTo, pcDatetime, pdRotMat); });
+}
+
+
+static int GetPositionTransformationMatrixSeriesImpl(
+    const char* pcFrom,
+    const char* pcTo,
+    const double* pdEts,
+    unsigned int nCount,
+    double* pdRotMats,
+    double* pdQuats,
+    int* pnStatus
+)
+{
+    if( !pcFrom || !pcTo || !pdEts || (!pdRotMats && !pdQuats) )
     {
-        Log(LogLevel::ERROR, "GetPositionTransformationMatrix() called with nullptr arguments." );
+        COO_LOG(LogLevel::ERROR, "GetPositionTransformationMatrixSeries() called with nullptr arguments." );
         return -1;
     }
 
-    Log(LogLevel::TRACE, "GetPositionTransformationMatrix() called with from = \"" + std::string{pcFrom} + "\", to = \"" + std::string{pcTo} + "\".");
+    COO_LOG(LogLevel::TRACE, "GetPositionTransformationMatrixSeries() called with from = \"" + std::string{pcFrom} + "\", to = \"" + std::string{pcTo} + "\", count = " + std::to_string(nCount) + ".");
 
-    double dEt;
-    int ret_val = Str2Et( pcDatetime, dEt );
-    if(ret_val != 0)
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    const SSpiceRef oFrom = ResolveFrameRef(pcFrom);
+    const SSpiceRef oTo = ResolveFrameRef(pcTo);
+
+    size_t nFailed = 0;
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        double adRotMat[9];
+        int nStatus = GetFrameRotation(oFrom, oTo, pdEts[i], adRotMat);
+        if (nStatus != 0)
+        {
+            nStatus = (nStatus == -2) ? -6 : -3;
+            ++nFailed;
+            std::fill(adRotMat, adRotMat + 9, 0.0);
+        }
+        if (pdRotMats)
+        {
+            std::copy(adRotMat, adRotMat + 9, pdRotMats + 9 * i);
+        }
+        if (pdQuats)
+        {
+            if (nStatus == 0)
+            {
+                double adMat[3][3] = {
+                    { adRotMat[0], adRotMat[1], adRotMat[2] },
+                    { adRotMat[3], adRotMat[4], adRotMat[5] },
+                    { adRotMat[6], adRotMat[7], adRotMat[8] } };
+                m2q_c(adMat, pdQuats + 4 * i);
+                if (SpiceHasFailed())
+                {
+                    reset_c();
+                    nStatus = -3;
+                    ++nFailed;
+                }
+            }
+            else
+            {
+                std::fill(pdQuats + 4 * i, pdQuats + 4 * i + 4, 0.0);
+            }
+        }
+        if (pnStatus)
+        {
+            pnStatus[i] = nStatus;
+        }
+    }
+
+    COO_LOG(LogLevel::TRACE, "GetPositionTransformationMatrixSeries() finished with " + std::to_string(nFailed) + " failed epoch(s).");
+    return (nFailed == 0) ? 0 : -2;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetPositionTransformationMatrixSeries(
+    const char* pcFrom,
+    const char* pcTo,
+    const double* pdEts,
+    unsigned int nCount,
+    double* pdRotMats,
+    double* pdQuats,
+    int* pnStatus
+)
+{
+    return MeasureCall(STATS_GETPOSITIONTRANSFORMATIONMATRIXSERIES, [&] { return GetPositionTransformationMatrixSeriesImpl(pcFrom, pcTo, pdEts, nCount, pdRotMats, pdQuats, pnStatus); });
+}
+
+
+static int GetPositionTransformationMatrixByHandleImpl(int nFrom, int nTo, double dEt, double* pdRotMat)
+{
+    if( !pdRotMat )
+    {
+        COO_LOG(LogLevel::ERROR, "GetPositionTransformationMatrixByHandle() called with nullptr arguments." );
+        return -1;
+    }
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    const SFrameHandle* poFrom = FindFrameHandle(nFrom);
+    const SFrameHandle* poTo = FindFrameHandle(nTo);
+    if( !poFrom || !poTo )
+    {
+        COO_LOG(LogLevel::ERROR, "GetPositionTransformationMatrixByHandle() called with an invalid or outdated handle." );
+        return -5;
+    }
+
+    int nResult = GetFrameRotation({ poFrom->m_sName.c_str(), poFrom->m_nCode, true }, { poTo->m_sName.c_str(), poTo->m_nCode, true }, dEt, pdRotMat);
+    if (nResult != 0)
+    {
+        return (nResult == -2) ? -6 : -3;
+    }
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetPositionTransformationMatrixByHandle(int nFrom, int nTo, double dEt, double* pdRotMat)
+{
+    return MeasureCall(STATS_GETPOSITIONTRANSFORMATIONMATRIXBYHANDLE, [&] { return GetPositionTransformationMatrixByHandleImpl(nFrom, nTo, dEt, pdRotMat); });
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int SetFrameRotationCacheSize(unsigned int nEntries)
+{
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    s_oFrameRotationCache.SetCapacity(nEntries);
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetFrameRotationCacheStats(unsigned long long* pnHits, unsigned long long* pnMisses, unsigned int* pnEntries)
+{
+    if( !pnHits || !pnMisses || !pnEntries )
+    {
+        COO_LOG(LogLevel::ERROR, "GetFrameRotationCacheStats() called with nullptr arguments." );
+        return -1;
+    }
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    *pnHits = s_nFrameRotationCacheHits;
+    *pnMisses = s_nFrameRotationCacheMisses;
+    *pnEntries = static_cast<unsigned int>(s_oFrameRotationCache.Size());
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+void ResetFrameRotationCacheStats()
+{
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+    s_nFrameRotationCacheHits = 0;
+    s_nFrameRotationCacheMisses = 0;
+}
+
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetBodyHandle(const char* pcBody, int* pnHandle)
+{
+    if( !pcBody || !pnHandle )
+    {
+        COO_LOG(LogLevel::ERROR, "GetBodyHandle() called with nullptr arguments." );
+        return -1;
+    }
+
+    COO_LOG(LogLevel::TRACE, "GetBodyHandle() called with body = \"" + std::string{pcBody} + "\".");
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    std::string sBody = NormalizeSpiceName(pcBody);
+    for (const auto& roEntry : s_mapBodyHandles)
+    {
+        if (roEntry.second.m_sName == sBody)
+        {
+            *pnHandle = roEntry.first;
+            return 0;
+        }
+    }
+
+    SpiceInt nId = 0;
+    SpiceBoolean bFound = SPICEFALSE;
+    bodn2c_c(sBody.c_str(), &nId, &bFound);
+    if (SpiceHasFailed() || !bFound)
+    {
+        reset_c();
+        COO_LOG(LogLevel::ERROR, "GetBodyHandle() failed: unknown body \"" + sBody + "\".");
+        return -2;
+    }
+    const int nHandle = NextHandle();
+    if (nHandle == 0)
     {
+        COO_LOG(LogLevel::ERROR, "GetBodyHandle() failed: too many handles.");
         return -2;
     }
 
-    double dTmp[3][3];
-    pxform_c( pcFrom, pcTo, dEt, dTmp);
+    // Radii are resolved up front; bodies without radii can still be used for states.
+    SBodyHandle oHandle = { sBody, nId, 0, {} };
+    oHandle.m_nRadiiResult = QueryBodyRadii(sBody, &nId, oHandle.m_oRadii);
+    s_mapBodyHandles.emplace(nHandle, std::move(oHandle));
+    *pnHandle = nHandle;
 
-    // reshape:
-    pdRotMat[0] = dTmp[0][0];
-    pdRotMat[1] = dTmp[0][1];
-    pdRotMat[2] = dTmp[0][2];
+    COO_LOG(LogLevel::TRACE, "GetBodyHandle() finished with NAIF ID " + std::to_string(nId) + ".");
+    return 0;
+}
 
-    pdRotMat[3] = dTmp[1][0];
-    pdRotMat[4] = dTmp[1][1];
-    pdRotMat[5] = dTmp[1][2];
 
-    pdRotMat[6] = dTmp[2][0];
-    pdRotMat[7] = dTmp[2][1];
-    pdRotMat[8] = dTmp[2][2];
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetFrameHandle(const char* pcFrame, int* pnHandle)
+{
+    if( !pcFrame || !pnHandle )
+    {
+        COO_LOG(LogLevel::ERROR, "GetFrameHandle() called with nullptr arguments." );
+        return -1;
+    }
 
-    Log(LogLevel::TRACE, std::string{"GetPositionTransformationMatrix() finished with "} +
-        "rot = (" + std::to_string(pdRotMat[0]) + ", " + std::to_string(pdRotMat[1]) + ", " + std::to_string(pdRotMat[2]) + ", " +
-        std::to_string(pdRotMat[3]) + ", " + std::to_string(pdRotMat[4]) + ", " + std::to_string(pdRotMat[5]) + ", " +
-        std::to_string(pdRotMat[6]) + ", " + std::to_string(pdRotMat[7]) + ", " + std::to_string(pdRotMat[8]) + ")."
-    );
+    COO_LOG(LogLevel::TRACE, "GetFrameHandle() called with frame = \"" + std::string{pcFrame} + "\".");
+
+    SpiceLock oSpiceLock(s_oSpiceMutex);
+
+    std::string sFrame = NormalizeSpiceName(pcFrame);
+    for (const auto& roEntry : s_mapFrameHandles)
+    {
+        if (roEntry.second.m_sName == sFrame)
+        {
+            *pnHandle = roEntry.first;
+            return 0;
+        }
+    }
+
+    SpiceInt nCode = 0;
+    namfrm_c(sFrame.c_str(), &nCode);
+    if (SpiceHasFailed() || nCode == 0)
+    {
+        reset_c();
+        COO_LOG(LogLevel::ERROR, "GetFrameHandle() failed: unknown frame \"" + sFrame + "\".");
+        return -2;
+    }
+    const int nHandle = NextHandle();
+    if (nHandle == 0)
+    {
+        COO_LOG(LogLevel::ERROR, "GetFrameHandle() failed: too many handles.");
+        return -2;
+    }
+
+    s_mapFrameHandles.emplace(nHandle, SFrameHandle{ sFrame, nCode });
+    *pnHandle = nHandle;
 
+    COO_LOG(LogLevel::TRACE, "GetFrameHandle() finished with frame code " + std::to_string(nCode) + ".");
     return 0;
 }
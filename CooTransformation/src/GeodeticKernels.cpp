@@ -0,0 +1,150 @@
+#include "GeodeticKernels.hpp"
+
+#include <cmath>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+    struct SScalar
+    {
+        using T = double;
+        using M = bool;
+        static constexpr size_t WIDTH = 1;
+
+        static T Set(double d) { return d; }
+        static T Load(const double* pd) { return *pd; }
+        static void Store(double* pd, T t) { *pd = t; }
+        static T Add(T a, T b) { return a + b; }
+        static T Sub(T a, T b) { return a - b; }
+        static T Mul(T a, T b) { return a * b; }
+        static T Div(T a, T b) { return a / b; }
+        static T MulAdd(T a, T b, T c) { return a * b + c; }
+        static T Sqrt(T a) { return std::sqrt(a); }
+        static T Abs(T a) { return std::fabs(a); }
+        static T Neg(T a) { return -a; }
+        static T Min(T a, T b) { return a < b ? a : b; }
+        static T Max(T a, T b) { return a > b ? a : b; }
+        static T Round(T a) { return std::nearbyint(a); }
+        static T Floor(T a) { return std::floor(a); }
+        static T CopySign(T a, T b) { return std::copysign(a, b); }
+        static M Lt(T a, T b) { return a < b; }
+        static M Gt(T a, T b) { return a > b; }
+        static M Eq(T a, T b) { return a == b; }
+        static T Select(M m, T a, T b) { return m ? a : b; }
+    };
+}
+
+#include "GeodeticKernelsImpl.hpp"
+
+
+void Xyz2LatLonAltSphereScalar(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, double dRadius, bool bPositiveEast, double* pdLat, double* pdLon, double* pdAlt)
+{
+    Xyz2LatLonAltSphereKernel<SScalar>(nCount, pdX, pdY, pdZ, dRadius, bPositiveEast, pdLat, pdLon, pdAlt);
+}
+
+
+void LatLonAlt2XyzSphereScalar(size_t nCount, const double* pdLat, const double* pdLon, const double* pdAlt, double dRadius, bool bPositiveEast, double* pdX, double* pdY, double* pdZ)
+{
+    LatLonAlt2XyzSphereKernel<SScalar>(nCount, pdLat, pdLon, pdAlt, dRadius, bPositiveEast, pdX, pdY, pdZ);
+}
+
+
+void IlluminationAnglesScalar(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, const double* pdNx, const double* pdNy, const double* pdNz, const double* pdSource, const double* pdObserver, double* pdIncidence, double* pdEmission, double* pdPhase)
+{
+    IlluminationAnglesKernel<SScalar>(nCount, pdX, pdY, pdZ, pdNx, pdNy, pdNz, pdSource, pdObserver, pdIncidence, pdEmission, pdPhase);
+}
+
+
+
+static bool CpuSupports(int nBackend)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int anInfo[4] = {};
+    __cpuid(anInfo, 1);
+    const bool bOsXSave = (anInfo[2] & (1 << 27)) != 0;
+    const bool bFma = (anInfo[2] & (1 << 12)) != 0;
+    if (!bOsXSave)
+    {
+        return false;
+    }
+    const unsigned long long nXcr0 = _xgetbv(0);
+    __cpuidex(anInfo, 7, 0);
+    if (nBackend == GEODETIC_BACKEND_AVX2)
+    {
+        return bFma && (anInfo[1] & (1 << 5)) != 0 && (nXcr0 & 0x6) == 0x6;
+    }
+    if (nBackend == GEODETIC_BACKEND_AVX512)
+    {
+        return (anInfo[1] & (1 << 16)) != 0 && (nXcr0 & 0xe6) == 0xe6;
+    }
+    return false;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (nBackend == GEODETIC_BACKEND_AVX2)
+    {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    if (nBackend == GEODETIC_BACKEND_AVX512)
+    {
+        return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    (void)nBackend;
+    return false;
+#endif
+}   // CpuSupports()
+
+
+
+const SGeodeticKernels* GetGeodeticKernels(int nBackend, int& rnResolved)
+{
+    static const SGeodeticKernels s_oScalar = { "scalar", &Xyz2LatLonAltSphereScalar, &LatLonAlt2XyzSphereScalar, &IlluminationAnglesScalar };
+#ifdef COOTRANSFORMATION_HAVE_AVX2
+    static const SGeodeticKernels s_oAvx2 = { "AVX2", &Xyz2LatLonAltSphereAvx2, &LatLonAlt2XyzSphereAvx2, &IlluminationAnglesAvx2 };
+    static const bool s_bAvx2 = CpuSupports(GEODETIC_BACKEND_AVX2);
+#endif
+#ifdef COOTRANSFORMATION_HAVE_AVX512
+    static const SGeodeticKernels s_oAvx512 = { "AVX-512", &Xyz2LatLonAltSphereAvx512, &LatLonAlt2XyzSphereAvx512, &IlluminationAnglesAvx512 };
+    static const bool s_bAvx512 = CpuSupports(GEODETIC_BACKEND_AVX512);
+#endif
+
+    rnResolved = nBackend;
+    switch (nBackend)
+    {
+    case GEODETIC_BACKEND_NATIVE:
+#ifdef COOTRANSFORMATION_HAVE_AVX512
+        if (s_bAvx512)
+        {
+            rnResolved = GEODETIC_BACKEND_AVX512;
+            return &s_oAvx512;
+        }
+#endif
+#ifdef COOTRANSFORMATION_HAVE_AVX2
+        if (s_bAvx2)
+        {
+            rnResolved = GEODETIC_BACKEND_AVX2;
+            return &s_oAvx2;
+        }
+#endif
+        rnResolved = GEODETIC_BACKEND_SCALAR;
+        return &s_oScalar;
+    case GEODETIC_BACKEND_SCALAR:
+        return &s_oScalar;
+#ifdef COOTRANSFORMATION_HAVE_AVX2
+    case GEODETIC_BACKEND_AVX2:
+        return s_bAvx2 ? &s_oAvx2 : nullptr;
+#endif
+#ifdef COOTRANSFORMATION_HAVE_AVX512
+    case GEODETIC_BACKEND_AVX512:
+        return s_bAvx512 ? &s_oAvx512 : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}   // GetGeodeticKernels()
@@ -0,0 +1,76 @@
+#ifndef JR_PRO3D_EXTENSIONS_GEODETICKERNELS_HPP
+#define JR_PRO3D_EXTENSIONS_GEODETICKERNELS_HPP
+
+#include <cstddef>
+
+
+/** Native closed-form conversions for the spherical body model (flattening 0) used by
+  * Xyz2LatLonAlt() and LatLonAlt2Xyz(). They replace recpgr_c()/pgrrec_c() and produce
+  * planetographic coordinates: latitude [-90, 90] deg, longitude [0, 360) deg in the body's
+  * longitude sense, altitude and cartesian coordinates in meters. Arrays are contiguous.
+  **/
+typedef void (*FnXyz2LatLonAltSphere)(
+    size_t nCount, const double* pdX, const double* pdY, const double* pdZ,
+    double dRadius, bool bPositiveEast,
+    double* pdLat, double* pdLon, double* pdAlt);
+
+typedef void (*FnLatLonAlt2XyzSphere)(
+    size_t nCount, const double* pdLat, const double* pdLon, const double* pdAlt,
+    double dRadius, bool bPositiveEast,
+    double* pdX, double* pdY, double* pdZ);
+
+/** Incidence, emission and phase angles [deg] of surface points (pdX, pdY, pdZ) with normals
+  * (pdNx, pdNy, pdNz) for a light source at pdSource[3] and an observer at pdObserver[3]. All
+  * positions share one frame and unit; normals need not be unit vectors.
+  **/
+typedef void (*FnIlluminationAngles)(
+    size_t nCount, const double* pdX, const double* pdY, const double* pdZ,
+    const double* pdNx, const double* pdNy, const double* pdNz,
+    const double* pdSource, const double* pdObserver,
+    double* pdIncidence, double* pdEmission, double* pdPhase);
+
+
+struct SGeodeticKernels
+{
+    const char* m_pcName;
+    FnXyz2LatLonAltSphere m_pfnXyz2LatLonAlt;
+    FnLatLonAlt2XyzSphere m_pfnLatLonAlt2Xyz;
+    FnIlluminationAngles m_pfnIlluminationAngles;
+};
+
+
+/** Backend ids, see SetGeodeticBackend(). **/
+enum EGeodeticBackend
+{
+    GEODETIC_BACKEND_SPICE = 0,
+    GEODETIC_BACKEND_NATIVE = 1,
+    GEODETIC_BACKEND_SCALAR = 2,
+    GEODETIC_BACKEND_AVX2 = 3,
+    GEODETIC_BACKEND_AVX512 = 4
+};
+
+
+/** Kernels of a native backend, or nullptr if the backend was not compiled in or the CPU
+  * does not support it. GEODETIC_BACKEND_NATIVE resolves to the best available backend and
+  * rnResolved receives its id. GEODETIC_BACKEND_SPICE has no kernels.
+  **/
+const SGeodeticKernels* GetGeodeticKernels(int nBackend, int& rnResolved);
+
+
+void Xyz2LatLonAltSphereScalar(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, double dRadius, bool bPositiveEast, double* pdLat, double* pdLon, double* pdAlt);
+void LatLonAlt2XyzSphereScalar(size_t nCount, const double* pdLat, const double* pdLon, const double* pdAlt, double dRadius, bool bPositiveEast, double* pdX, double* pdY, double* pdZ);
+void IlluminationAnglesScalar(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, const double* pdNx, const double* pdNy, const double* pdNz, const double* pdSource, const double* pdObserver, double* pdIncidence, double* pdEmission, double* pdPhase);
+
+#ifdef COOTRANSFORMATION_HAVE_AVX2
+void Xyz2LatLonAltSphereAvx2(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, double dRadius, bool bPositiveEast, double* pdLat, double* pdLon, double* pdAlt);
+void LatLonAlt2XyzSphereAvx2(size_t nCount, const double* pdLat, const double* pdLon, const double* pdAlt, double dRadius, bool bPositiveEast, double* pdX, double* pdY, double* pdZ);
+void IlluminationAnglesAvx2(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, const double* pdNx, const double* pdNy, const double* pdNz, const double* pdSource, const double* pdObserver, double* pdIncidence, double* pdEmission, double* pdPhase);
+#endif
+
+#ifdef COOTRANSFORMATION_HAVE_AVX512
+void Xyz2LatLonAltSphereAvx512(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, double dRadius, bool bPositiveEast, double* pdLat, double* pdLon, double* pdAlt);
+void LatLonAlt2XyzSphereAvx512(size_t nCount, const double* pdLat, const double* pdLon, const double* pdAlt, double dRadius, bool bPositiveEast, double* pdX, double* pdY, double* pdZ);
+void IlluminationAnglesAvx512(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, const double* pdNx, const double* pdNy, const double* pdNz, const double* pdSource, const double* pdObserver, double* pdIncidence, double* pdEmission, double* pdPhase);
+#endif
+
+#endif // JR_PRO3D_EXTENSIONS_GEODETICKERNELS_HPP
@@ -0,0 +1,60 @@
+// Compiled with AVX2 and FMA enabled (see CMakeLists.txt). Only called after a CPU check.
+#include "GeodeticKernels.hpp"
+
+#include <immintrin.h>
+
+
+namespace
+{
+    struct SAvx2
+    {
+        using T = __m256d;
+        using M = __m256d;
+        static constexpr size_t WIDTH = 4;
+
+        static T Set(double d) { return _mm256_set1_pd(d); }
+        static T Load(const double* pd) { return _mm256_loadu_pd(pd); }
+        static void Store(double* pd, T t) { _mm256_storeu_pd(pd, t); }
+        static T Add(T a, T b) { return _mm256_add_pd(a, b); }
+        static T Sub(T a, T b) { return _mm256_sub_pd(a, b); }
+        static T Mul(T a, T b) { return _mm256_mul_pd(a, b); }
+        static T Div(T a, T b) { return _mm256_div_pd(a, b); }
+        static T MulAdd(T a, T b, T c) { return _mm256_fmadd_pd(a, b, c); }
+        static T Sqrt(T a) { return _mm256_sqrt_pd(a); }
+        static T Abs(T a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+        static T Neg(T a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+        static T Min(T a, T b) { return _mm256_min_pd(a, b); }
+        static T Max(T a, T b) { return _mm256_max_pd(a, b); }
+        static T Round(T a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+        static T Floor(T a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+        static T CopySign(T a, T b)
+        {
+            const T tSign = _mm256_set1_pd(-0.0);
+            return _mm256_or_pd(_mm256_andnot_pd(tSign, a), _mm256_and_pd(tSign, b));
+        }
+        static M Lt(T a, T b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+        static M Gt(T a, T b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+        static M Eq(T a, T b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+        static T Select(M m, T a, T b) { return _mm256_blendv_pd(b, a, m); }
+    };
+}
+
+#include "GeodeticKernelsImpl.hpp"
+
+
+void Xyz2LatLonAltSphereAvx2(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, double dRadius, bool bPositiveEast, double* pdLat, double* pdLon, double* pdAlt)
+{
+    Xyz2LatLonAltSphereKernel<SAvx2>(nCount, pdX, pdY, pdZ, dRadius, bPositiveEast, pdLat, pdLon, pdAlt);
+}
+
+
+void LatLonAlt2XyzSphereAvx2(size_t nCount, const double* pdLat, const double* pdLon, const double* pdAlt, double dRadius, bool bPositiveEast, double* pdX, double* pdY, double* pdZ)
+{
+    LatLonAlt2XyzSphereKernel<SAvx2>(nCount, pdLat, pdLon, pdAlt, dRadius, bPositiveEast, pdX, pdY, pdZ);
+}
+
+
+void IlluminationAnglesAvx2(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, const double* pdNx, const double* pdNy, const double* pdNz, const double* pdSource, const double* pdObserver, double* pdIncidence, double* pdEmission, double* pdPhase)
+{
+    IlluminationAnglesKernel<SAvx2>(nCount, pdX, pdY, pdZ, pdNx, pdNy, pdNz, pdSource, pdObserver, pdIncidence, pdEmission, pdPhase);
+}
@@ -0,0 +1,60 @@
+// Compiled with AVX-512F enabled (see CMakeLists.txt). Only called after a CPU check.
+#include "GeodeticKernels.hpp"
+
+#include <immintrin.h>
+
+
+namespace
+{
+    struct SAvx512
+    {
+        using T = __m512d;
+        using M = __mmask8;
+        static constexpr size_t WIDTH = 8;
+
+        static T Set(double d) { return _mm512_set1_pd(d); }
+        static T Load(const double* pd) { return _mm512_loadu_pd(pd); }
+        static void Store(double* pd, T t) { _mm512_storeu_pd(pd, t); }
+        static T Add(T a, T b) { return _mm512_add_pd(a, b); }
+        static T Sub(T a, T b) { return _mm512_sub_pd(a, b); }
+        static T Mul(T a, T b) { return _mm512_mul_pd(a, b); }
+        static T Div(T a, T b) { return _mm512_div_pd(a, b); }
+        static T MulAdd(T a, T b, T c) { return _mm512_fmadd_pd(a, b, c); }
+        static T Sqrt(T a) { return _mm512_sqrt_pd(a); }
+        static T Abs(T a) { return _mm512_abs_pd(a); }
+        static T Neg(T a) { return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL)))); }
+        static T Min(T a, T b) { return _mm512_min_pd(a, b); }
+        static T Max(T a, T b) { return _mm512_max_pd(a, b); }
+        static T Round(T a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+        static T Floor(T a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+        static T CopySign(T a, T b)
+        {
+            const __m512i nSign = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL));
+            return _mm512_castsi512_pd(_mm512_ternarylogic_epi64(nSign, _mm512_castpd_si512(a), _mm512_castpd_si512(b), 0xac));
+        }
+        static M Lt(T a, T b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+        static M Gt(T a, T b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+        static M Eq(T a, T b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+        static T Select(M m, T a, T b) { return _mm512_mask_blend_pd(m, b, a); }
+    };
+}
+
+#include "GeodeticKernelsImpl.hpp"
+
+
+void Xyz2LatLonAltSphereAvx512(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, double dRadius, bool bPositiveEast, double* pdLat, double* pdLon, double* pdAlt)
+{
+    Xyz2LatLonAltSphereKernel<SAvx512>(nCount, pdX, pdY, pdZ, dRadius, bPositiveEast, pdLat, pdLon, pdAlt);
+}
+
+
+void LatLonAlt2XyzSphereAvx512(size_t nCount, const double* pdLat, const double* pdLon, const double* pdAlt, double dRadius, bool bPositiveEast, double* pdX, double* pdY, double* pdZ)
+{
+    LatLonAlt2XyzSphereKernel<SAvx512>(nCount, pdLat, pdLon, pdAlt, dRadius, bPositiveEast, pdX, pdY, pdZ);
+}
+
+
+void IlluminationAnglesAvx512(size_t nCount, const double* pdX, const double* pdY, const double* pdZ, const double* pdNx, const double* pdNy, const double* pdNz, const double* pdSource, const double* pdObserver, double* pdIncidence, double* pdEmission, double* pdPhase)
+{
+    IlluminationAnglesKernel<SAvx512>(nCount, pdX, pdY, pdZ, pdNx, pdNy, pdNz, pdSource, pdObserver, pdIncidence, pdEmission, pdPhase);
+}
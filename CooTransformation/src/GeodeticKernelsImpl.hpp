@@ -0,0 +1,312 @@
+#ifndef JR_PRO3D_EXTENSIONS_GEODETICKERNELSIMPL_HPP
+#define JR_PRO3D_EXTENSIONS_GEODETICKERNELSIMPL_HPP
+
+#include <cstddef>
+
+// Kernel templates shared by the scalar, AVX2 and AVX-512 translation units. Each unit includes
+// this header once with its own vector traits V and its own compiler flags. Everything lives in an
+// anonymous namespace so the per-ISA instantiations can never be merged by the linker.
+//
+// V provides: T (vector of doubles), M (lane mask), WIDTH, Set(), Load(), Store(), Add(), Sub(),
+// Mul(), Div(), MulAdd(a, b, c) = a * b + c, Sqrt(), Abs(), Neg(), Min(), Max(), Round(), Floor(),
+// CopySign(), Lt(), Gt(), Eq(), Select(m, a, b) = m ? a : b.
+//
+// atan and sin/cos use the Cephes double precision approximations (max. error about 1 ulp).
+
+namespace
+{
+    constexpr double GEODETIC_PI = 3.14159265358979323846;
+    constexpr double GEODETIC_PIO2 = 1.57079632679489661923;
+    constexpr double GEODETIC_PIO4 = 7.85398163397448309616E-1;
+    constexpr double GEODETIC_MOREBITS = 6.123233995736765886130E-17; // pi/2 - GEODETIC_PIO2
+    constexpr double GEODETIC_DEG_PER_RAD = 180.0 / GEODETIC_PI;
+    constexpr double GEODETIC_RAD_PER_DEG = GEODETIC_PI / 180.0;
+
+
+    template <typename V>
+    inline typename V::T Atan2(typename V::T tY, typename V::T tX)
+    {
+        using T = typename V::T;
+        const T tZero = V::Set(0.0);
+        const T tOne = V::Set(1.0);
+
+        // reduce to atan(a) with a in [0, 1]
+        T tAbsX = V::Abs(tX);
+        T tAbsY = V::Abs(tY);
+        T tNum = V::Min(tAbsX, tAbsY);
+        T tDen = V::Max(tAbsX, tAbsY);
+        T tA = V::Select(V::Eq(tDen, tZero), tZero, V::Div(tNum, tDen));
+
+        // atan(a) = pi/4 + atan((a - 1) / (a + 1)) for a > 0.66
+        auto mBig = V::Gt(tA, V::Set(0.66));
+        T tT = V::Select(mBig, V::Div(V::Sub(tA, tOne), V::Add(tA, tOne)), tA);
+        T tOffset = V::Select(mBig, V::Set(GEODETIC_PIO4), tZero);
+        T tMoreBits = V::Select(mBig, V::Set(0.5 * GEODETIC_MOREBITS), tZero);
+
+        T tZ = V::Mul(tT, tT);
+        T tP = V::Set(-8.750608600031904122785E-1);
+        tP = V::MulAdd(tP, tZ, V::Set(-1.615753718733365076637E1));
+        tP = V::MulAdd(tP, tZ, V::Set(-7.500855792314704667340E1));
+        tP = V::MulAdd(tP, tZ, V::Set(-1.228866684490136173410E2));
+        tP = V::MulAdd(tP, tZ, V::Set(-6.485021904942025371773E1));
+        T tQ = V::Add(tZ, V::Set(2.485846490142306297962E1));
+        tQ = V::MulAdd(tQ, tZ, V::Set(1.650270098316988542046E2));
+        tQ = V::MulAdd(tQ, tZ, V::Set(4.328810604912902668951E2));
+        tQ = V::MulAdd(tQ, tZ, V::Set(4.853903996359136964868E2));
+        tQ = V::MulAdd(tQ, tZ, V::Set(1.945506571482613964425E2));
+        T tR = V::MulAdd(V::Mul(tT, tZ), V::Div(tP, tQ), tT);
+        tR = V::Add(tOffset, V::Add(tR, tMoreBits));
+
+        // undo the reduction: swap of x and y, left half plane, sign of y
+        tR = V::Select(V::Gt(tAbsY, tAbsX), V::Add(V::Sub(V::Set(GEODETIC_PIO2), tR), V::Set(GEODETIC_MOREBITS)), tR);
+        tR = V::Select(V::Lt(tX, tZero), V::Add(V::Sub(V::Set(GEODETIC_PI), tR), V::Set(2.0 * GEODETIC_MOREBITS)), tR);
+        return V::CopySign(tR, tY);
+    }
+
+
+    template <typename V>
+    inline void SinCosDeg(typename V::T tDeg, typename V::T& rtSin, typename V::T& rtCos)
+    {
+        using T = typename V::T;
+
+        // Reduce by quadrants in degrees, which is exact for multiples of 90 deg.
+        T tQuadrant = V::Round(V::Mul(tDeg, V::Set(1.0 / 90.0)));
+        T tX = V::Mul(V::MulAdd(tQuadrant, V::Set(-90.0), tDeg), V::Set(GEODETIC_RAD_PER_DEG)); // [-pi/4, pi/4]
+        T tXX = V::Mul(tX, tX);
+
+        T tS = V::Set(1.58962301576546568060E-10);
+        tS = V::MulAdd(tS, tXX, V::Set(-2.50507477628578072866E-8));
+        tS = V::MulAdd(tS, tXX, V::Set(2.75573136213857245213E-6));
+        tS = V::MulAdd(tS, tXX, V::Set(-1.98412698295895385996E-4));
+        tS = V::MulAdd(tS, tXX, V::Set(8.33333333332211858878E-3));
+        tS = V::MulAdd(tS, tXX, V::Set(-1.66666666666666307295E-1));
+        tS = V::MulAdd(V::Mul(tX, tXX), tS, tX);
+
+        T tC = V::Set(-1.13585365213876817300E-11);
+        tC = V::MulAdd(tC, tXX, V::Set(2.08757008419747316778E-9));
+        tC = V::MulAdd(tC, tXX, V::Set(-2.75573141792967388112E-7));
+        tC = V::MulAdd(tC, tXX, V::Set(2.48015872888517045348E-5));
+        tC = V::MulAdd(tC, tXX, V::Set(-1.38888888888730564116E-3));
+        tC = V::MulAdd(tC, tXX, V::Set(4.16666666666665929218E-2));
+        tC = V::MulAdd(V::Mul(tXX, tXX), tC, V::MulAdd(tXX, V::Set(-0.5), V::Set(1.0)));
+
+        // quadrant q mod 4: 1 and 3 swap sin and cos, 2 and 3 negate sin, 1 and 2 negate cos
+        T tMod4 = V::Sub(tQuadrant, V::Mul(V::Floor(V::Mul(tQuadrant, V::Set(0.25))), V::Set(4.0)));
+        auto mSwap = V::Eq(V::Abs(V::Sub(tMod4, V::Set(2.0))), V::Set(1.0));
+        auto mNegSin = V::Gt(tMod4, V::Set(1.5));
+        auto mNegCos = V::Lt(V::Abs(V::Sub(tMod4, V::Set(1.5))), V::Set(1.0));
+        T tSin = V::Select(mSwap, tC, tS);
+        T tCos = V::Select(mSwap, tS, tC);
+        rtSin = V::Select(mNegSin, V::Neg(tSin), tSin);
+        rtCos = V::Select(mNegCos, V::Neg(tCos), tCos);
+    }
+
+
+    template <typename V>
+    inline void Xyz2LatLonAltSphere(
+        typename V::T tX, typename V::T tY, typename V::T tZ, double dRadius, bool bPositiveEast,
+        typename V::T& rtLat, typename V::T& rtLon, typename V::T& rtAlt)
+    {
+        using T = typename V::T;
+        T tRxy2 = V::MulAdd(tX, tX, V::Mul(tY, tY));
+        T tR = V::Sqrt(V::MulAdd(tZ, tZ, tRxy2));
+        rtLat = V::Mul(Atan2<V>(tZ, V::Sqrt(tRxy2)), V::Set(GEODETIC_DEG_PER_RAD));
+
+        // same convention as recpgr_c: longitude in the body's sense, mapped to [0, 2 pi)
+        T tLon = Atan2<V>(tY, tX);
+        if (!bPositiveEast)
+        {
+            tLon = V::Neg(tLon);
+        }
+        tLon = V::Select(V::Lt(tLon, V::Set(0.0)), V::Add(tLon, V::Set(2.0 * GEODETIC_PI)), tLon);
+        rtLon = V::Mul(tLon, V::Set(GEODETIC_DEG_PER_RAD));
+        rtAlt = V::Sub(tR, V::Set(dRadius));
+    }
+
+
+    template <typename V>
+    inline void LatLonAlt2XyzSphere(
+        typename V::T tLat, typename V::T tLon, typename V::T tAlt, double dRadius, bool bPositiveEast,
+        typename V::T& rtX, typename V::T& rtY, typename V::T& rtZ)
+    {
+        using T = typename V::T;
+        T tSinLat, tCosLat, tSinLon, tCosLon;
+        SinCosDeg<V>(tLat, tSinLat, tCosLat);
+        SinCosDeg<V>(tLon, tSinLon, tCosLon);
+        if (!bPositiveEast)
+        {
+            tSinLon = V::Neg(tSinLon);
+        }
+        T tR = V::Add(tAlt, V::Set(dRadius));
+        T tRxy = V::Mul(tR, tCosLat);
+        rtX = V::Mul(tRxy, tCosLon);
+        rtY = V::Mul(tRxy, tSinLon);
+        rtZ = V::Mul(tR, tSinLat);
+    }
+
+
+    // Runs fnPoint over full vectors and pads the remainder into one more vector, so every point
+    // goes through the same instruction sequence.
+    template <typename V, typename F>
+    inline void ForEachVector(
+        size_t nCount, const double* pdA, const double* pdB, const double* pdC,
+        double* pdOutA, double* pdOutB, double* pdOutC, F fnPoint)
+    {
+        using T = typename V::T;
+        size_t i = 0;
+        for (; i + V::WIDTH <= nCount; i += V::WIDTH)
+        {
+            T tA, tB, tC;
+            fnPoint(V::Load(pdA + i), V::Load(pdB + i), V::Load(pdC + i), tA, tB, tC);
+            V::Store(pdOutA + i, tA);
+            V::Store(pdOutB + i, tB);
+            V::Store(pdOutC + i, tC);
+        }
+        if (i < nCount)
+        {
+            double adIn[3][V::WIDTH] = {};
+            double adOut[3][V::WIDTH];
+            const size_t nRest = nCount - i;
+            for (size_t j = 0; j < nRest; ++j)
+            {
+                adIn[0][j] = pdA[i + j];
+                adIn[1][j] = pdB[i + j];
+                adIn[2][j] = pdC[i + j];
+            }
+            T tA, tB, tC;
+            fnPoint(V::Load(adIn[0]), V::Load(adIn[1]), V::Load(adIn[2]), tA, tB, tC);
+            V::Store(adOut[0], tA);
+            V::Store(adOut[1], tB);
+            V::Store(adOut[2], tC);
+            for (size_t j = 0; j < nRest; ++j)
+            {
+                pdOutA[i + j] = adOut[0][j];
+                pdOutB[i + j] = adOut[1][j];
+                pdOutC[i + j] = adOut[2][j];
+            }
+        }
+    }
+
+
+    template <typename V>
+    void Xyz2LatLonAltSphereKernel(
+        size_t nCount, const double* pdX, const double* pdY, const double* pdZ,
+        double dRadius, bool bPositiveEast,
+        double* pdLat, double* pdLon, double* pdAlt)
+    {
+        using T = typename V::T;
+        ForEachVector<V>(nCount, pdX, pdY, pdZ, pdLat, pdLon, pdAlt,
+            [dRadius, bPositiveEast](T tX, T tY, T tZ, T& rtLat, T& rtLon, T& rtAlt)
+            {
+                Xyz2LatLonAltSphere<V>(tX, tY, tZ, dRadius, bPositiveEast, rtLat, rtLon, rtAlt);
+            });
+    }
+
+
+    template <typename V>
+    void LatLonAlt2XyzSphereKernel(
+        size_t nCount, const double* pdLat, const double* pdLon, const double* pdAlt,
+        double dRadius, bool bPositiveEast,
+        double* pdX, double* pdY, double* pdZ)
+    {
+        using T = typename V::T;
+        ForEachVector<V>(nCount, pdLat, pdLon, pdAlt, pdX, pdY, pdZ,
+            [dRadius, bPositiveEast](T tLat, T tLon, T tAlt, T& rtX, T& rtY, T& rtZ)
+            {
+                LatLonAlt2XyzSphere<V>(tLat, tLon, tAlt, dRadius, bPositiveEast, rtX, rtY, rtZ);
+            });
+    }
+
+
+    // Angle between two vectors as atan2(|a x b|, a . b), which stays accurate near 0 and 180 deg
+    // where acos of the normalized dot product loses half of the digits.
+    template <typename V>
+    inline typename V::T VectorAngleDeg(
+        typename V::T tAx, typename V::T tAy, typename V::T tAz,
+        typename V::T tBx, typename V::T tBy, typename V::T tBz)
+    {
+        using T = typename V::T;
+        T tCx = V::MulAdd(tAy, tBz, V::Neg(V::Mul(tAz, tBy)));
+        T tCy = V::MulAdd(tAz, tBx, V::Neg(V::Mul(tAx, tBz)));
+        T tCz = V::MulAdd(tAx, tBy, V::Neg(V::Mul(tAy, tBx)));
+        T tCross = V::Sqrt(V::MulAdd(tCx, tCx, V::MulAdd(tCy, tCy, V::Mul(tCz, tCz))));
+        T tDot = V::MulAdd(tAx, tBx, V::MulAdd(tAy, tBy, V::Mul(tAz, tBz)));
+        return V::Mul(Atan2<V>(tCross, tDot), V::Set(GEODETIC_DEG_PER_RAD));
+    }
+
+
+    template <typename V>
+    inline void IlluminationAngles(
+        typename V::T tX, typename V::T tY, typename V::T tZ,
+        typename V::T tNx, typename V::T tNy, typename V::T tNz,
+        const double* pdSource, const double* pdObserver,
+        typename V::T& rtIncidence, typename V::T& rtEmission, typename V::T& rtPhase)
+    {
+        using T = typename V::T;
+        T tSx = V::Sub(V::Set(pdSource[0]), tX);
+        T tSy = V::Sub(V::Set(pdSource[1]), tY);
+        T tSz = V::Sub(V::Set(pdSource[2]), tZ);
+        T tOx = V::Sub(V::Set(pdObserver[0]), tX);
+        T tOy = V::Sub(V::Set(pdObserver[1]), tY);
+        T tOz = V::Sub(V::Set(pdObserver[2]), tZ);
+        rtIncidence = VectorAngleDeg<V>(tNx, tNy, tNz, tSx, tSy, tSz);
+        rtEmission = VectorAngleDeg<V>(tNx, tNy, tNz, tOx, tOy, tOz);
+        rtPhase = VectorAngleDeg<V>(tSx, tSy, tSz, tOx, tOy, tOz);
+    }
+
+
+    template <typename V>
+    void IlluminationAnglesKernel(
+        size_t nCount, const double* pdX, const double* pdY, const double* pdZ,
+        const double* pdNx, const double* pdNy, const double* pdNz,
+        const double* pdSource, const double* pdObserver,
+        double* pdIncidence, double* pdEmission, double* pdPhase)
+    {
+        using T = typename V::T;
+        const double* apdIn[6] = { pdX, pdY, pdZ, pdNx, pdNy, pdNz };
+        double* apdOut[3] = { pdIncidence, pdEmission, pdPhase };
+
+        // same padding of the remainder as ForEachVector(), with six inputs
+        for (size_t i = 0; i < nCount; i += V::WIDTH)
+        {
+            const size_t nLanes = (nCount - i < V::WIDTH) ? nCount - i : V::WIDTH;
+            T atIn[6];
+            for (size_t k = 0; k < 6; ++k)
+            {
+                if (nLanes == V::WIDTH)
+                {
+                    atIn[k] = V::Load(apdIn[k] + i);
+                }
+                else
+                {
+                    double adLanes[V::WIDTH] = {};
+                    for (size_t j = 0; j < nLanes; ++j)
+                    {
+                        adLanes[j] = apdIn[k][i + j];
+                    }
+                    atIn[k] = V::Load(adLanes);
+                }
+            }
+            T atOut[3];
+            IlluminationAngles<V>(atIn[0], atIn[1], atIn[2], atIn[3], atIn[4], atIn[5], pdSource, pdObserver, atOut[0], atOut[1], atOut[2]);
+            for (size_t k = 0; k < 3; ++k)
+            {
+                if (nLanes == V::WIDTH)
+                {
+                    V::Store(apdOut[k] + i, atOut[k]);
+                }
+                else
+                {
+                    double adLanes[V::WIDTH];
+                    V::Store(adLanes, atOut[k]);
+                    for (size_t j = 0; j < nLanes; ++j)
+                    {
+                        apdOut[k][i + j] = adLanes[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif // JR_PRO3D_EXTENSIONS_GEODETICKERNELSIMPL_HPP
@@ -0,0 +1,527 @@
+#include "KernelPoolCache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+#include <SpiceUsr.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+
+// File layout (host byte order, checked with the marker):
+//   "COOPOOL" '\0', uint32 version, uint32 byte order marker, uint64 key,
+//   uint32 kernel count, per kernel: uint8 text flag, uint64 hash, string path,
+//   uint32 variable count, per variable: string name, uint8 type, uint32 value count, values,
+//   uint64 hash of all preceding bytes.
+// Strings are stored as uint32 length and bytes, numeric values as doubles.
+static const char s_acMagic[8] = { 'C', 'O', 'O', 'P', 'O', 'O', 'L', '\0' };
+static const uint32_t POOL_SNAPSHOT_VERSION = 1;
+static const uint32_t POOL_SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+static const SpiceInt POOL_NAME_LENGTH = 64;        // pool variable names have at most 32 characters
+static const SpiceInt POOL_STRING_LENGTH = 1024;    // longer string values are truncated by gcpool_c()
+static const SpiceInt POOL_CHUNK = 64;
+
+
+
+// Temp file in the cache directory, unique per process and call so that two processes
+// caching the same kernel do not write into each other's file.
+static std::string TempPathFor(const std::string& rsPath)
+{
+#ifdef _WIN32
+    const unsigned long nPid = GetCurrentProcessId();
+#else
+    const unsigned long nPid = static_cast<unsigned long>(getpid());
+#endif
+    return rsPath + ".tmp." + std::to_string(nPid) + "." + std::to_string(std::random_device()());
+}
+
+
+// Moves the finished snapshot over an existing one in a single step.
+static bool ReplaceFileWith(const std::string& rsTempPath, const std::string& rsPath)
+{
+#ifdef _WIN32
+    return MoveFileExA(rsTempPath.c_str(), rsPath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(rsTempPath.c_str(), rsPath.c_str()) == 0;
+#endif
+}
+
+
+static bool SpiceHasFailed()
+{
+    // return_c() instead of failed_c(), see CooTransformation.cpp
+    return (return_c() == SPICETRUE);
+}
+
+
+
+uint64_t HashBytes(const void* pData, size_t nSize, uint64_t nHash)
+{
+    const unsigned char* pc = static_cast<const unsigned char*>(pData);
+    for (size_t i = 0; i < nSize; ++i)
+    {
+        nHash ^= pc[i];
+        nHash *= 0x100000001b3ULL;
+    }
+    return nHash;
+}
+
+
+
+bool HashFile(const std::string& rsPath, uint64_t& rnHash)
+{
+    std::ifstream oFile(rsPath, std::ios::in | std::ios::binary);
+    if (!oFile)
+    {
+        return false;
+    }
+    uint64_t nHash = HashBytes(nullptr, 0);
+    char acBuffer[65536];
+    while (oFile)
+    {
+        oFile.read(acBuffer, sizeof(acBuffer));
+        nHash = HashBytes(acBuffer, static_cast<size_t>(oFile.gcount()), nHash);
+    }
+    if (!oFile.eof())
+    {
+        return false;
+    }
+    rnHash = nHash;
+    return true;
+}   // HashFile()
+
+
+
+static uint64_t HashPoolVariable(const SPoolVariable& roVariable, uint64_t nHash)
+{
+    nHash = HashBytes(roVariable.m_sName.data(), roVariable.m_sName.size() + 1, nHash);
+    nHash = HashBytes(&roVariable.m_cType, 1, nHash);
+    nHash = HashBytes(roVariable.m_vecNumbers.data(), roVariable.m_vecNumbers.size() * sizeof(double), nHash);
+    for (const std::string& rsValue : roVariable.m_vecStrings)
+    {
+        nHash = HashBytes(rsValue.data(), rsValue.size() + 1, nHash);
+    }
+    return nHash;
+}
+
+
+
+uint64_t HashPoolVariables(std::vector<SPoolVariable> vecVariables)
+{
+    std::sort(vecVariables.begin(), vecVariables.end(),
+        [](const SPoolVariable& roA, const SPoolVariable& roB) { return roA.m_sName < roB.m_sName; });
+    uint64_t nHash = HashBytes(nullptr, 0);
+    for (const SPoolVariable& roVariable : vecVariables)
+    {
+        nHash = HashPoolVariable(roVariable, nHash);
+    }
+    return nHash;
+}
+
+
+
+bool DumpKernelPool(std::vector<SPoolVariable>& rvecVariables)
+{
+    rvecVariables.clear();
+
+    std::vector<std::string> vecNames;
+    std::vector<SpiceChar> vecBuffer(POOL_CHUNK * POOL_NAME_LENGTH);
+    SpiceInt nStart = 0;
+    SpiceInt nFound = 0;
+    SpiceBoolean bFound = SPICEFALSE;
+    do
+    {
+        gnpool_c("*", nStart, POOL_CHUNK, POOL_NAME_LENGTH, &nFound, vecBuffer.data(), &bFound);
+        if (SpiceHasFailed())
+        {
+            return false;
+        }
+        for (SpiceInt i = 0; bFound && i < nFound; ++i)
+        {
+            vecNames.emplace_back(&vecBuffer[i * POOL_NAME_LENGTH]);
+        }
+        nStart += nFound;
+    } while (bFound && nFound == POOL_CHUNK);
+
+    vecBuffer.resize(POOL_CHUNK * POOL_STRING_LENGTH);
+    rvecVariables.reserve(vecNames.size());
+    for (const std::string& rsName : vecNames)
+    {
+        SPoolVariable oVariable;
+        oVariable.m_sName = rsName;
+        SpiceInt nValues = 0;
+        SpiceChar acType[1] = { 'X' };
+        dtpool_c(rsName.c_str(), &bFound, &nValues, acType);
+        if (SpiceHasFailed())
+        {
+            return false;
+        }
+        if (!bFound)
+        {
+            continue;
+        }
+        oVariable.m_cType = acType[0];
+        if (oVariable.m_cType == 'N')
+        {
+            oVariable.m_vecNumbers.resize(nValues);
+            gdpool_c(rsName.c_str(), 0, nValues, &nFound, oVariable.m_vecNumbers.data(), &bFound);
+            oVariable.m_vecNumbers.resize(bFound ? nFound : 0);
+        }
+        else
+        {
+            for (SpiceInt nFirst = 0; nFirst < nValues; nFirst += POOL_CHUNK)
+            {
+                gcpool_c(rsName.c_str(), nFirst, POOL_CHUNK, POOL_STRING_LENGTH, &nFound, vecBuffer.data(), &bFound);
+                for (SpiceInt i = 0; bFound && i < nFound; ++i)
+                {
+                    oVariable.m_vecStrings.emplace_back(&vecBuffer[i * POOL_STRING_LENGTH]);
+                }
+            }
+        }
+        if (SpiceHasFailed())
+        {
+            return false;
+        }
+        rvecVariables.push_back(std::move(oVariable));
+    }
+    return true;
+}   // DumpKernelPool()
+
+
+
+bool RestoreKernelPool(const std::vector<SPoolVariable>& rvecVariables)
+{
+    std::vector<SpiceChar> vecBuffer;
+    for (const SPoolVariable& roVariable : rvecVariables)
+    {
+        if (roVariable.m_cType == 'N')
+        {
+            pdpool_c(roVariable.m_sName.c_str(), static_cast<SpiceInt>(roVariable.m_vecNumbers.size()), roVariable.m_vecNumbers.data());
+        }
+        else
+        {
+            size_t nLength = 1;
+            for (const std::string& rsValue : roVariable.m_vecStrings)
+            {
+                nLength = std::max(nLength, rsValue.size() + 1);
+            }
+            vecBuffer.assign(roVariable.m_vecStrings.size() * nLength, '\0');
+            for (size_t i = 0; i < roVariable.m_vecStrings.size(); ++i)
+            {
+                memcpy(&vecBuffer[i * nLength], roVariable.m_vecStrings[i].data(), roVariable.m_vecStrings[i].size());
+            }
+            pcpool_c(roVariable.m_sName.c_str(), static_cast<SpiceInt>(roVariable.m_vecStrings.size()), static_cast<SpiceInt>(nLength), vecBuffer.data());
+        }
+        if (SpiceHasFailed())
+        {
+            return false;
+        }
+    }
+    return true;
+}   // RestoreKernelPool()
+
+
+
+bool ListLoadedKernels(const std::string& rsKernel, std::vector<SKernelFile>& rvecKernels)
+{
+    rvecKernels.clear();
+
+    SpiceInt nCount = 0;
+    ktotal_c("ALL", &nCount);
+    if (SpiceHasFailed())
+    {
+        return false;
+    }
+
+    // furnsh_c() moves a kernel that is loaded again to the end, so the last entry is the current one.
+    bool bFoundKernel = false;
+    for (SpiceInt i = 0; i < nCount; ++i)
+    {
+        SpiceChar acFile[FILENAME_MAX];
+        SpiceChar acType[32];
+        SpiceChar acSource[FILENAME_MAX];
+        SpiceInt nHandle = 0;
+        SpiceBoolean bFound = SPICEFALSE;
+        kdata_c(i, "ALL", FILENAME_MAX, sizeof(acType), FILENAME_MAX, acFile, acType, acSource, &nHandle, &bFound);
+        if (SpiceHasFailed())
+        {
+            return false;
+        }
+        if (!bFound)
+        {
+            continue;
+        }
+        if (rsKernel == acFile && acSource[0] == '\0')
+        {
+            rvecKernels.clear();
+            bFoundKernel = true;
+        }
+        else if (!bFoundKernel || rsKernel != acSource)
+        {
+            continue;
+        }
+        const bool bText = strcmp(acType, "TEXT") == 0 || strcmp(acType, "META") == 0;
+        rvecKernels.push_back({ acFile, bText, 0 });
+    }
+    if (!bFoundKernel)
+    {
+        return false;
+    }
+
+    for (SKernelFile& roKernel : rvecKernels)
+    {
+        if (roKernel.m_bText && !HashFile(roKernel.m_sPath, roKernel.m_nHash))
+        {
+            return false;
+        }
+    }
+    return true;
+}   // ListLoadedKernels()
+
+
+
+namespace
+{
+    class CSnapshotWriter
+    {
+    public:
+        void Write(const void* pData, size_t nSize)
+        {
+            const char* pc = static_cast<const char*>(pData);
+            m_vecData.insert(m_vecData.end(), pc, pc + nSize);
+        }
+
+        template <typename T>
+        void Write(T tValue)
+        {
+            Write(&tValue, sizeof(T));
+        }
+
+        void Write(const std::string& rsValue)
+        {
+            Write(static_cast<uint32_t>(rsValue.size()));
+            Write(rsValue.data(), rsValue.size());
+        }
+
+        std::vector<char> m_vecData;
+    };
+
+    class CSnapshotReader
+    {
+    public:
+        CSnapshotReader(const char* pcData, size_t nSize)
+            : m_pcData(pcData), m_nSize(nSize)
+        {
+        }
+
+        bool Read(void* pData, size_t nSize)
+        {
+            if (nSize > m_nSize - m_nOffset)
+            {
+                return false;
+            }
+            memcpy(pData, m_pcData + m_nOffset, nSize);
+            m_nOffset += nSize;
+            return true;
+        }
+
+        template <typename T>
+        bool Read(T& rtValue)
+        {
+            return Read(&rtValue, sizeof(T));
+        }
+
+        bool Read(std::string& rsValue)
+        {
+            uint32_t nLength = 0;
+            if (!Read(nLength) || nLength > m_nSize - m_nOffset)
+            {
+                return false;
+            }
+            rsValue.assign(m_pcData + m_nOffset, nLength);
+            m_nOffset += nLength;
+            return true;
+        }
+
+        // guards the element count read from the file against the remaining bytes
+        bool Fits(uint32_t nCount, size_t nMinElementSize) const
+        {
+            return nCount <= (m_nSize - m_nOffset) / nMinElementSize;
+        }
+
+    private:
+        const char* m_pcData;
+        size_t m_nSize;
+        size_t m_nOffset = 0;
+    };
+}
+
+
+
+bool ReadPoolSnapshot(const std::string& rsPath, SPoolSnapshot& roSnapshot)
+{
+    std::ifstream oFile(rsPath, std::ios::in | std::ios::binary);
+    if (!oFile)
+    {
+        return false;
+    }
+    std::vector<char> vecData((std::istreambuf_iterator<char>(oFile)), std::istreambuf_iterator<char>());
+    if (vecData.size() < sizeof(s_acMagic) + sizeof(uint64_t))
+    {
+        return false;
+    }
+
+    const size_t nPayload = vecData.size() - sizeof(uint64_t);
+    uint64_t nStoredHash = 0;
+    memcpy(&nStoredHash, vecData.data() + nPayload, sizeof(uint64_t));
+    if (HashBytes(vecData.data(), nPayload) != nStoredHash)
+    {
+        return false;
+    }
+
+    CSnapshotReader oReader(vecData.data(), nPayload);
+    char acMagic[sizeof(s_acMagic)];
+    uint32_t nVersion = 0;
+    uint32_t nByteOrder = 0;
+    if (!oReader.Read(acMagic, sizeof(acMagic)) || memcmp(acMagic, s_acMagic, sizeof(acMagic)) != 0
+        || !oReader.Read(nVersion) || nVersion != POOL_SNAPSHOT_VERSION
+        || !oReader.Read(nByteOrder) || nByteOrder != POOL_SNAPSHOT_BYTE_ORDER
+        || !oReader.Read(roSnapshot.m_nKey))
+    {
+        return false;
+    }
+
+    uint32_t nKernels = 0;
+    if (!oReader.Read(nKernels) || !oReader.Fits(nKernels, 13))
+    {
+        return false;
+    }
+    roSnapshot.m_vecKernels.resize(nKernels);
+    for (SKernelFile& roKernel : roSnapshot.m_vecKernels)
+    {
+        uint8_t nText = 0;
+        if (!oReader.Read(nText) || !oReader.Read(roKernel.m_nHash) || !oReader.Read(roKernel.m_sPath))
+        {
+            return false;
+        }
+        roKernel.m_bText = nText != 0;
+    }
+
+    uint32_t nVariables = 0;
+    if (!oReader.Read(nVariables) || !oReader.Fits(nVariables, 9))
+    {
+        return false;
+    }
+    roSnapshot.m_vecVariables.resize(nVariables);
+    for (SPoolVariable& roVariable : roSnapshot.m_vecVariables)
+    {
+        uint8_t nType = 0;
+        uint32_t nValues = 0;
+        if (!oReader.Read(roVariable.m_sName) || !oReader.Read(nType) || !oReader.Read(nValues)
+            || (nType != 'N' && nType != 'C'))
+        {
+            return false;
+        }
+        roVariable.m_cType = static_cast<char>(nType);
+        if (nType == 'N')
+        {
+            if (!oReader.Fits(nValues, sizeof(double)))
+            {
+                return false;
+            }
+            roVariable.m_vecNumbers.resize(nValues);
+            if (!oReader.Read(roVariable.m_vecNumbers.data(), nValues * sizeof(double)))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            if (!oReader.Fits(nValues, sizeof(uint32_t)))
+            {
+                return false;
+            }
+            roVariable.m_vecStrings.resize(nValues);
+            for (std::string& rsValue : roVariable.m_vecStrings)
+            {
+                if (!oReader.Read(rsValue))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}   // ReadPoolSnapshot()
+
+
+
+bool WritePoolSnapshot(const std::string& rsPath, const SPoolSnapshot& roSnapshot)
+{
+    CSnapshotWriter oWriter;
+    oWriter.Write(s_acMagic, sizeof(s_acMagic));
+    oWriter.Write(POOL_SNAPSHOT_VERSION);
+    oWriter.Write(POOL_SNAPSHOT_BYTE_ORDER);
+    oWriter.Write(roSnapshot.m_nKey);
+
+    oWriter.Write(static_cast<uint32_t>(roSnapshot.m_vecKernels.size()));
+    for (const SKernelFile& roKernel : roSnapshot.m_vecKernels)
+    {
+        oWriter.Write(static_cast<uint8_t>(roKernel.m_bText ? 1 : 0));
+        oWriter.Write(roKernel.m_nHash);
+        oWriter.Write(roKernel.m_sPath);
+    }
+
+    oWriter.Write(static_cast<uint32_t>(roSnapshot.m_vecVariables.size()));
+    for (const SPoolVariable& roVariable : roSnapshot.m_vecVariables)
+    {
+        oWriter.Write(roVariable.m_sName);
+        oWriter.Write(static_cast<uint8_t>(roVariable.m_cType));
+        if (roVariable.m_cType == 'N')
+        {
+            oWriter.Write(static_cast<uint32_t>(roVariable.m_vecNumbers.size()));
+            oWriter.Write(roVariable.m_vecNumbers.data(), roVariable.m_vecNumbers.size() * sizeof(double));
+        }
+        else
+        {
+            oWriter.Write(static_cast<uint32_t>(roVariable.m_vecStrings.size()));
+            for (const std::string& rsValue : roVariable.m_vecStrings)
+            {
+                oWriter.Write(rsValue);
+            }
+        }
+    }
+    oWriter.Write(HashBytes(oWriter.m_vecData.data(), oWriter.m_vecData.size()));
+
+    // Concurrent loads read either the old or the new snapshot; a file torn by a crash
+    // fails the hash check in ReadPoolSnapshot() and is rebuilt by the next load.
+    const std::string sTempPath = TempPathFor(rsPath);
+    {
+        std::ofstream oFile(sTempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        oFile.write(oWriter.m_vecData.data(), static_cast<std::streamsize>(oWriter.m_vecData.size()));
+        if (!oFile.flush())
+        {
+            oFile.close();
+            std::remove(sTempPath.c_str());
+            return false;
+        }
+    }
+    if (!ReplaceFileWith(sTempPath, rsPath))
+    {
+        std::remove(sTempPath.c_str());
+        return false;
+    }
+    return true;
+}   // WritePoolSnapshot()
@@ -0,0 +1,66 @@
+#ifndef JR_PRO3D_EXTENSIONS_KERNELPOOLCACHE_HPP
+#define JR_PRO3D_EXTENSIONS_KERNELPOOLCACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/** Binary snapshot of the kernel pool variables set by loading a (meta-)kernel, see AddSpiceKernelCached().
+  *
+  * Restoring the snapshot with pdpool_c() and pcpool_c() replaces parsing the text kernels. Binary
+  * kernels (SPK, CK, binary PCK, ...) are not part of the pool; the snapshot lists them so they can be
+  * loaded with furnsh_c() again. A snapshot is only valid for the same kernel pool contents before
+  * the load and the same text kernel contents, which are both part of its key.
+  *
+  * The SPICE functions below do not reset SPICE errors; callers check return_c() and reset_c().
+  **/
+
+struct SPoolVariable
+{
+    std::string m_sName;
+    char m_cType;                           // 'N' numeric, 'C' character
+    std::vector<double> m_vecNumbers;
+    std::vector<std::string> m_vecStrings;
+
+    bool operator==(const SPoolVariable& roOther) const = default;
+};
+
+struct SKernelFile
+{
+    std::string m_sPath;
+    bool m_bText;                           // text and meta-kernels are restored from the pool snapshot
+    uint64_t m_nHash;                       // content hash of text kernels, 0 for binary kernels
+};
+
+struct SPoolSnapshot
+{
+    uint64_t m_nKey = 0;
+    std::vector<SKernelFile> m_vecKernels;  // in load order
+    std::vector<SPoolVariable> m_vecVariables;
+};
+
+
+/** FNV-1a 64 bit. **/
+uint64_t HashBytes(const void* pData, size_t nSize, uint64_t nHash = 0xcbf29ce484222325ULL);
+
+/** Content hash of a file. Returns false if the file cannot be read. **/
+bool HashFile(const std::string& rsPath, uint64_t& rnHash);
+
+/** Hash of a set of pool variables that does not depend on their order. **/
+uint64_t HashPoolVariables(std::vector<SPoolVariable> vecVariables);
+
+/** Read all variables of the kernel pool (gnpool_c, dtpool_c, gdpool_c, gcpool_c). **/
+bool DumpKernelPool(std::vector<SPoolVariable>& rvecVariables);
+
+/** Write variables into the kernel pool (pdpool_c, pcpool_c). **/
+bool RestoreKernelPool(const std::vector<SPoolVariable>& rvecVariables);
+
+/** Kernels loaded by furnsh_c(rsKernel), i.e. rsKernel itself and, for a meta-kernel, the kernels it loaded (kdata_c). **/
+bool ListLoadedKernels(const std::string& rsKernel, std::vector<SKernelFile>& rvecKernels);
+
+/** Read and write snapshot files. WritePoolSnapshot() writes a temporary file and renames it. **/
+bool ReadPoolSnapshot(const std::string& rsPath, SPoolSnapshot& roSnapshot);
+bool WritePoolSnapshot(const std::string& rsPath, const SPoolSnapshot& roSnapshot);
+
+#endif // JR_PRO3D_EXTENSIONS_KERNELPOOLCACHE_HPP
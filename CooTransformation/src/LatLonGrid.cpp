@@ -0,0 +1,142 @@
+#include "LatLonGrid.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+
+static const double s_dRadPerDeg = 3.14159265358979323846 / 180.0;
+
+
+// Reduction by quadrants in degrees, so multiples of 90 deg give exact zeros and ones.
+static void SinCosDeg(double dDeg, double& rdSin, double& rdCos)
+{
+    const double dQuadrant = std::nearbyint(dDeg / 90.0);
+    const double dX = (dDeg - 90.0 * dQuadrant) * s_dRadPerDeg;
+    const double dSin = std::sin(dX);
+    const double dCos = std::cos(dX);
+    const long long nQuadrant = static_cast<long long>(std::fmod(dQuadrant, 4.0) + 4.0) % 4;
+    switch (nQuadrant)
+    {
+    case 0: rdSin = dSin;  rdCos = dCos;  break;
+    case 1: rdSin = dCos;  rdCos = -dSin; break;
+    case 2: rdSin = -dSin; rdCos = -dCos; break;
+    default: rdSin = -dCos; rdCos = dSin; break;
+    }
+}
+
+
+void MakeGridRows(const SGridSpheroid& roSpheroid, double dLatStart, double dLatStep, size_t nFirst, size_t nCount, SGridRow* poRows)
+{
+    const double dE2 = roSpheroid.m_dFlattening * (2.0 - roSpheroid.m_dFlattening);
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        SGridRow& roRow = poRows[i];
+        SinCosDeg(dLatStart + static_cast<double>(nFirst + i) * dLatStep, roRow.m_dSinLat, roRow.m_dCosLat);
+        roRow.m_dN = roSpheroid.m_dRadius / std::sqrt(1.0 - dE2 * roRow.m_dSinLat * roRow.m_dSinLat);
+        roRow.m_dNz = roRow.m_dN * (1.0 - dE2);
+    }
+}
+
+
+void MakeGridColumns(const SGridSpheroid& roSpheroid, double dLonStart, double dLonStep, size_t nFirst, size_t nCount, SGridColumn* poColumns)
+{
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        SGridColumn& roColumn = poColumns[i];
+        SinCosDeg(dLonStart + static_cast<double>(nFirst + i) * dLonStep, roColumn.m_dSinLon, roColumn.m_dCosLon);
+        if (!roSpheroid.m_bPositiveEast)
+        {
+            roColumn.m_dSinLon = -roColumn.m_dSinLon;
+        }
+    }
+}
+
+
+void GridTile2Xyz(
+    const SGridRow* poRows, const SGridColumn* poColumns, size_t nRows, size_t nColumns,
+    const double* pdAlt, size_t nAltStride, double* pdXyz, size_t nXyzStride)
+{
+    for (size_t r = 0; r < nRows; ++r)
+    {
+        const SGridRow oRow = poRows[r];
+        const double* pdRowAlt = pdAlt + r * nAltStride;
+        double* pdRowXyz = pdXyz + 3 * r * nXyzStride;
+        for (size_t c = 0; c < nColumns; ++c)
+        {
+            const double dAlt = pdRowAlt[c];
+            const double dRxy = (oRow.m_dN + dAlt) * oRow.m_dCosLat;
+            pdRowXyz[3 * c + 0] = dRxy * poColumns[c].m_dCosLon;
+            pdRowXyz[3 * c + 1] = dRxy * poColumns[c].m_dSinLon;
+            pdRowXyz[3 * c + 2] = (oRow.m_dNz + dAlt) * oRow.m_dSinLat;
+        }
+    }
+}
+
+
+double GridTile2VertexF32(
+    const SGridRow* poRows, const SGridColumn* poColumns, size_t nRows, size_t nColumns,
+    const double* pdAlt, size_t nAltStride, const SVertexOutputF32& roOut, size_t nFirstVertex, size_t nVertexRowStride)
+{
+    double dMaxError2 = 0.0;
+    for (size_t r = 0; r < nRows; ++r)
+    {
+        const SGridRow oRow = poRows[r];
+        const double* pdRowAlt = pdAlt + r * nAltStride;
+        const size_t nRowVertex = nFirstVertex + r * nVertexRowStride;
+        for (size_t c = 0; c < nColumns; ++c)
+        {
+            const double dAlt = pdRowAlt[c];
+            const double dRxy = (oRow.m_dN + dAlt) * oRow.m_dCosLat;
+            const double dError2 = WriteVertexF32(roOut, nRowVertex + c,
+                dRxy * poColumns[c].m_dCosLon, dRxy * poColumns[c].m_dSinLon, (oRow.m_dNz + dAlt) * oRow.m_dSinLat);
+            // NaN cells (no data) are not counted
+            dMaxError2 = (dError2 > dMaxError2) ? dError2 : dMaxError2;
+        }
+    }
+    return dMaxError2;
+}
+
+
+unsigned int GridThreadCount(size_t nTiles, unsigned int nThreads)
+{
+    const unsigned int nHardware = std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<unsigned int>(std::clamp<size_t>(nTiles, 1, nThreads == 0 ? nHardware : nThreads));
+}
+
+
+bool ForEachGridTile(size_t nTiles, unsigned int nThreads, const std::function<bool(size_t, unsigned int)>& fnTile)
+{
+    std::atomic<size_t> nNextTile{ 0 };
+    std::atomic<bool> bStop{ false };
+    auto fnWorker = [&](unsigned int nThread)
+    {
+        while (!bStop.load(std::memory_order_relaxed))
+        {
+            const size_t nTile = nNextTile.fetch_add(1, std::memory_order_relaxed);
+            if (nTile >= nTiles)
+            {
+                return;
+            }
+            if (!fnTile(nTile, nThread))
+            {
+                bStop = true;
+            }
+        }
+    };
+
+    const unsigned int nUsed = GridThreadCount(nTiles, nThreads);
+    std::vector<std::thread> vecThreads;
+    for (unsigned int t = 1; t < nUsed; ++t)
+    {
+        vecThreads.emplace_back(fnWorker, t);
+    }
+    fnWorker(0);
+    for (std::thread& roThread : vecThreads)
+    {
+        roThread.join();
+    }
+    return !bStop;
+}
@@ -0,0 +1,68 @@
+#ifndef JR_PRO3D_EXTENSIONS_LATLONGRID_HPP
+#define JR_PRO3D_EXTENSIONS_LATLONGRID_HPP
+
+#include "VertexOutput.hpp"
+
+#include <cstddef>
+#include <functional>
+
+
+/** Body model of the grid conversion, the same as pgrrec_c() uses: equatorial radius in meters,
+  * flattening and the longitude sense of planetographic coordinates.
+  **/
+struct SGridSpheroid
+{
+    double m_dRadius;
+    double m_dFlattening;
+    bool m_bPositiveEast;
+};
+
+/** Terms of one raster row (latitude) that are shared by all cells of the row. **/
+struct SGridRow
+{
+    double m_dCosLat;
+    double m_dSinLat;
+    double m_dN;                // prime vertical radius of curvature [m]
+    double m_dNz;               // m_dN * (1 - e^2)
+};
+
+/** Terms of one raster column (longitude), with the longitude sense applied. **/
+struct SGridColumn
+{
+    double m_dCosLon;
+    double m_dSinLon;
+};
+
+
+/** Rows nFirst .. nFirst + nCount - 1 of a raster whose row r has latitude dLatStart + r * dLatStep [deg]. **/
+void MakeGridRows(const SGridSpheroid& roSpheroid, double dLatStart, double dLatStep, size_t nFirst, size_t nCount, SGridRow* poRows);
+
+/** Columns nFirst .. nFirst + nCount - 1 of a raster whose column c has longitude dLonStart + c * dLonStep [deg]. **/
+void MakeGridColumns(const SGridSpheroid& roSpheroid, double dLonStart, double dLonStep, size_t nFirst, size_t nCount, SGridColumn* poColumns);
+
+/** Cartesian coordinates of nRows x nColumns cells: altitude pdAlt[r * nAltStride + c] [m],
+  * vertex (x, y, z) at pdXyz + 3 * (r * nXyzStride + c) [m].
+  **/
+void GridTile2Xyz(
+    const SGridRow* poRows, const SGridColumn* poColumns, size_t nRows, size_t nColumns,
+    const double* pdAlt, size_t nAltStride, double* pdXyz, size_t nXyzStride);
+
+/** Same cells as GridTile2Xyz(), written as float vertices relative to the center of roOut: cell
+  * (r, c) goes to vertex nFirstVertex + r * nVertexRowStride + c. Returns the largest squared
+  * narrowing error [m^2] (see WriteVertexF32()).
+  **/
+double GridTile2VertexF32(
+    const SGridRow* poRows, const SGridColumn* poColumns, size_t nRows, size_t nColumns,
+    const double* pdAlt, size_t nAltStride, const SVertexOutputF32& roOut, size_t nFirstVertex, size_t nVertexRowStride);
+
+/** Run fnTile(nTile, nThread) for all tiles on up to nThreads threads (0: all hardware threads),
+  * including the calling thread. nThread < the number of threads used identifies the thread, so
+  * callers can keep per-thread buffers. If fnTile returns false, no further tiles are started and
+  * false is returned.
+  **/
+bool ForEachGridTile(size_t nTiles, unsigned int nThreads, const std::function<bool(size_t, unsigned int)>& fnTile);
+
+/** Number of threads ForEachGridTile() uses. **/
+unsigned int GridThreadCount(size_t nTiles, unsigned int nThreads);
+
+#endif // JR_PRO3D_EXTENSIONS_LATLONGRID_HPP
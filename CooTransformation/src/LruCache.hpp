@@ -0,0 +1,90 @@
+#ifndef JR_PRO3D_EXTENSIONS_LRUCACHE_HPP
+#define JR_PRO3D_EXTENSIONS_LRUCACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+
+/** CLruCache: fixed-capacity map that evicts the least recently used entry.
+  * Not thread-safe; callers guard it with their own lock. A capacity of 0 disables the cache.
+  **/
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class CLruCache
+{
+public:
+    explicit CLruCache(size_t nCapacity)
+        : m_nCapacity(nCapacity)
+    {
+    }
+
+    /** Returns the cached value and marks it as most recently used, or nullptr. **/
+    const Value* Find(const Key& roKey)
+    {
+        auto it = m_mapEntries.find(roKey);
+        if (it == m_mapEntries.end())
+        {
+            return nullptr;
+        }
+        m_lstEntries.splice(m_lstEntries.begin(), m_lstEntries, it->second);
+        return &it->second->second;
+    }
+
+    void Insert(const Key& roKey, const Value& roValue)
+    {
+        if (m_nCapacity == 0)
+        {
+            return;
+        }
+        auto it = m_mapEntries.find(roKey);
+        if (it != m_mapEntries.end())
+        {
+            it->second->second = roValue;
+            m_lstEntries.splice(m_lstEntries.begin(), m_lstEntries, it->second);
+            return;
+        }
+        if (m_mapEntries.size() >= m_nCapacity)
+        {
+            // reuse the node of the evicted entry
+            m_mapEntries.erase(m_lstEntries.back().first);
+            m_lstEntries.splice(m_lstEntries.begin(), m_lstEntries, std::prev(m_lstEntries.end()));
+            m_lstEntries.front().first = roKey;
+            m_lstEntries.front().second = roValue;
+        }
+        else
+        {
+            m_lstEntries.emplace_front(roKey, roValue);
+        }
+        m_mapEntries.emplace(m_lstEntries.front().first, m_lstEntries.begin());
+    }
+
+    void SetCapacity(size_t nCapacity)
+    {
+        m_nCapacity = nCapacity;
+        while (m_mapEntries.size() > m_nCapacity)
+        {
+            m_mapEntries.erase(m_lstEntries.back().first);
+            m_lstEntries.pop_back();
+        }
+    }
+
+    void Clear()
+    {
+        m_mapEntries.clear();
+        m_lstEntries.clear();
+    }
+
+    size_t Size() const { return m_mapEntries.size(); }
+    size_t Capacity() const { return m_nCapacity; }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    size_t m_nCapacity;
+    std::list<Entry> m_lstEntries; // most recently used first
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> m_mapEntries;
+};
+
+#endif // JR_PRO3D_EXTENSIONS_LRUCACHE_HPP
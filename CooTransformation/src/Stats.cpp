@@ -0,0 +1,152 @@
+#include "Stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+
+// Counters are written by their owning thread only, so a relaxed load/store pair is enough
+// to increment them (no locked read-modify-write on the hot path). Readers may see a
+// slightly stale value but never a torn one.
+struct SFunctionCounters
+{
+    std::atomic<uint64_t> m_nCalls{0};
+    std::atomic<uint64_t> m_nTotalNs{0};
+    std::atomic<uint64_t> m_anResults[STATS_RESULT_CODES] = {};
+    std::atomic<uint64_t> m_anLatencyNs[STATS_LATENCY_BUCKETS] = {};
+};
+
+
+struct SThreadStats
+{
+    SFunctionCounters m_aoFunctions[STATS_FUNCTION_COUNT];
+};
+
+
+static inline void Increment(std::atomic<uint64_t>& rnCounter, uint64_t nValue = 1)
+{
+    rnCounter.store(rnCounter.load(std::memory_order_relaxed) + nValue, std::memory_order_relaxed);
+}
+
+
+static void Accumulate(SFunctionStats& roStats, const SFunctionCounters& roCounters)
+{
+    roStats.m_nCalls += roCounters.m_nCalls.load(std::memory_order_relaxed);
+    roStats.m_nTotalNs += roCounters.m_nTotalNs.load(std::memory_order_relaxed);
+    for (unsigned int i = 0; i < STATS_RESULT_CODES; ++i)
+    {
+        roStats.m_anResults[i] += roCounters.m_anResults[i].load(std::memory_order_relaxed);
+    }
+    for (unsigned int i = 0; i < STATS_LATENCY_BUCKETS; ++i)
+    {
+        roStats.m_anLatencyNs[i] += roCounters.m_anLatencyNs[i].load(std::memory_order_relaxed);
+    }
+}
+
+
+static void Subtract(SFunctionStats& roStats, const SFunctionStats& roBaseline)
+{
+    roStats.m_nCalls -= roBaseline.m_nCalls;
+    roStats.m_nTotalNs -= roBaseline.m_nTotalNs;
+    for (unsigned int i = 0; i < STATS_RESULT_CODES; ++i)
+    {
+        roStats.m_anResults[i] -= roBaseline.m_anResults[i];
+    }
+    for (unsigned int i = 0; i < STATS_LATENCY_BUCKETS; ++i)
+    {
+        roStats.m_anLatencyNs[i] -= roBaseline.m_anLatencyNs[i];
+    }
+}
+
+
+// Registry of live counter blocks. Blocks of exited threads are folded into s_aoRetiredStats.
+// ResetStats() does not touch the blocks (they have a single writer); it records a baseline instead.
+static std::mutex s_oStatsMutex;
+static std::vector<SThreadStats*> s_vecThreadStats;
+static SFunctionStats s_aoRetiredStats[STATS_FUNCTION_COUNT] = {};
+static SFunctionStats s_aoBaselineStats[STATS_FUNCTION_COUNT] = {};
+
+
+class CThreadStatsHandle
+{
+public:
+    CThreadStatsHandle()
+    {
+        std::lock_guard<std::mutex> oLock(s_oStatsMutex);
+        s_vecThreadStats.push_back(&m_oStats);
+    }
+
+    ~CThreadStatsHandle()
+    {
+        std::lock_guard<std::mutex> oLock(s_oStatsMutex);
+        for (unsigned int i = 0; i < STATS_FUNCTION_COUNT; ++i)
+        {
+            Accumulate(s_aoRetiredStats[i], m_oStats.m_aoFunctions[i]);
+        }
+        s_vecThreadStats.erase(std::find(s_vecThreadStats.begin(), s_vecThreadStats.end(), &m_oStats));
+    }
+
+    SThreadStats m_oStats;
+};
+
+
+static SFunctionStats CollectStats(unsigned int nFunction)
+{
+    // caller holds s_oStatsMutex
+    SFunctionStats oStats = s_aoRetiredStats[nFunction];
+    for (const SThreadStats* poThreadStats : s_vecThreadStats)
+    {
+        Accumulate(oStats, poThreadStats->m_aoFunctions[nFunction]);
+    }
+    return oStats;
+}
+
+
+void RecordCall(EStatsFunction eFunction, int nResult, uint64_t nElapsedNs)
+{
+    thread_local CThreadStatsHandle s_oThreadStats;
+    SFunctionCounters& roCounters = s_oThreadStats.m_oStats.m_aoFunctions[eFunction];
+
+    // bucket i holds latencies in [2^i, 2^(i+1)) ns, the last bucket everything above
+    unsigned int nBucket = std::min<unsigned int>(std::bit_width(nElapsedNs | 1) - 1, STATS_LATENCY_BUCKETS - 1);
+    // slot i holds return code -i, the last slot all other codes
+    unsigned int nResultSlot = (nResult <= 0 && nResult > -static_cast<int>(STATS_RESULT_CODES - 1))
+        ? static_cast<unsigned int>(-nResult) : STATS_RESULT_CODES - 1;
+
+    Increment(roCounters.m_nCalls);
+    Increment(roCounters.m_nTotalNs, nElapsedNs);
+    Increment(roCounters.m_anResults[nResultSlot]);
+    Increment(roCounters.m_anLatencyNs[nBucket]);
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+int GetStats(int nFunction, SFunctionStats* poStats)
+{
+    if( !poStats )
+    {
+        return -1;
+    }
+    if( nFunction < 0 || nFunction >= STATS_FUNCTION_COUNT )
+    {
+        return -2;
+    }
+
+    std::lock_guard<std::mutex> oLock(s_oStatsMutex);
+    *poStats = CollectStats(static_cast<unsigned int>(nFunction));
+    Subtract(*poStats, s_aoBaselineStats[nFunction]);
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_COOTRANSFORMATION_EXPORT
+void ResetStats()
+{
+    std::lock_guard<std::mutex> oLock(s_oStatsMutex);
+    for (unsigned int i = 0; i < STATS_FUNCTION_COUNT; ++i)
+    {
+        s_aoBaselineStats[i] = CollectStats(i);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef JR_PRO3D_EXTENSIONS_STATS_HPP
+#define JR_PRO3D_EXTENSIONS_STATS_HPP
+
+#include <CooTransformation/CooTransformation.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+
+/** Per-thread call statistics of the exported entry points (see GetStats()).
+  * Every thread owns a counter block that only it writes to; GetStats() sums all blocks.
+  **/
+void RecordCall(EStatsFunction eFunction, int nResult, uint64_t nElapsedNs);
+
+
+/** Run fnCall and record its result and latency for eFunction. **/
+template <typename F>
+inline int MeasureCall(EStatsFunction eFunction, F&& fnCall)
+{
+    const auto oStart = std::chrono::steady_clock::now();
+    const int nResult = fnCall();
+    const auto oElapsed = std::chrono::steady_clock::now() - oStart;
+    RecordCall(eFunction, nResult,
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(oElapsed).count()));
+    return nResult;
+}
+
+#endif // JR_PRO3D_EXTENSIONS_STATS_HPP
@@ -0,0 +1,53 @@
+#ifndef JR_PRO3D_EXTENSIONS_VERTEXOUTPUT_HPP
+#define JR_PRO3D_EXTENSIONS_VERTEXOUTPUT_HPP
+
+#include <CooTransformation/CooTransformation.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+
+/** Layout checks of SVertexOutputF32: a buffer, finite center and room for three floats per vertex. **/
+inline bool IsValidVertexOutput(const SVertexOutputF32& roOut)
+{
+    return roOut.m_pVertices != nullptr && roOut.m_nStride >= 3 * sizeof(float)
+        && std::isfinite(roOut.m_adCenter[0]) && std::isfinite(roOut.m_adCenter[1]) && std::isfinite(roOut.m_adCenter[2]);
+}
+
+
+/** Writes (dX, dY, dZ) - center [m] as floats to vertex nIndex and returns the squared narrowing
+  * error [m^2], i.e. the distance between the stored floats and the double precision offsets.
+  * The vertex need not be aligned to float.
+  **/
+inline double WriteVertexF32(const SVertexOutputF32& roOut, size_t nIndex, double dX, double dY, double dZ)
+{
+    const double adRel[3] = { dX - roOut.m_adCenter[0], dY - roOut.m_adCenter[1], dZ - roOut.m_adCenter[2] };
+    const float afRel[3] = { static_cast<float>(adRel[0]), static_cast<float>(adRel[1]), static_cast<float>(adRel[2]) };
+    unsigned char* pcVertex = static_cast<unsigned char*>(roOut.m_pVertices) + roOut.m_nOffset + nIndex * roOut.m_nStride;
+    std::memcpy(pcVertex, afRel, sizeof(afRel));
+
+    const double dEx = static_cast<double>(afRel[0]) - adRel[0];
+    const double dEy = static_cast<double>(afRel[1]) - adRel[1];
+    const double dEz = static_cast<double>(afRel[2]) - adRel[2];
+    return dEx * dEx + dEy * dEy + dEz * dEz;
+}
+
+
+/** Upper bound [m] of the narrowing error of WriteVertexF32() for vertices within dRadius meters
+  * of the center: every component is rounded once in double (the subtraction) and once to float,
+  * by at most half a unit in the last place of the binade containing dRadius.
+  **/
+inline double VertexF32ErrorBound(double dRadius)
+{
+    if (!(dRadius > 0.0))
+    {
+        return 0.0;
+    }
+    int nExponent = 0;
+    std::frexp(dRadius, &nExponent); // dRadius in [2^(nExponent - 1), 2^nExponent)
+    const double dHalfUlp = std::ldexp(1.0, nExponent - 1 - 24) + std::ldexp(1.0, nExponent - 1 - 53);
+    return std::sqrt(3.0) * dHalfUlp;
+}
+
+#endif // JR_PRO3D_EXTENSIONS_VERTEXOUTPUT_HPP
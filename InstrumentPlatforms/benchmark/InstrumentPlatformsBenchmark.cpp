@@ -0,0 +1,378 @@
+/** InstrumentPlatformsBenchmark
+* ============================
+*
+* Measures the throughput of ProjectPoints() on synthetic terrain: a height field of 10^7 and
+* 10^8 points (10^6 with --quick) seen by a camera on a pan/tilt mast. Each point count is run
+* with one pose, with a mosaic of 16 poses (from EvaluateKinematicChain()) and with one pose and
+* depth test.
+*
+* GetCollisionFreeGrid() is measured for a 401 x 201 pan/tilt grid of the mast camera against
+* a synthetic platform of 256 boxes.
+*
+* WritePlatformFile() and OpenPlatformFile() are measured for a catalogue of 10^4 instruments
+* (10^3 with --quick) with 3 axes each; opening includes reading every instrument once.
+*
+* Every result is written as one JSON object per line, so results of different builds can be
+* compared with standard tools.
+*
+* Usage: InstrumentPlatformsBenchmark [--output <file>] [--quick] [--threads <n>]
+**/
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+
+struct SConfig
+{
+    std::string m_sOutput;
+    bool m_bQuick = false;
+    unsigned int m_nThreads = 0;
+};
+
+
+class CResultWriter
+{
+public:
+    explicit CResultWriter(const std::string& rsOutput)
+    {
+        if (!rsOutput.empty())
+        {
+            m_oFile.open(rsOutput, std::ios::out | std::ios::trunc);
+        }
+    }
+
+    void Write(const std::string& rsBenchmark, const std::string& rsMode, size_t nPoints, unsigned int nPoses,
+        unsigned int nThreads, double dSeconds, unsigned long long nVisible)
+    {
+        const double dNsPerPoint = dSeconds * 1.0e9 / (static_cast<double>(nPoints) * nPoses);
+        char acLine[512];
+        std::snprintf(acLine, sizeof(acLine),
+            "{\"benchmark\": \"%s\", \"mode\": \"%s\", \"points\": %zu, \"poses\": %u, \"threads\": %u, "
+            "\"seconds\": %.4f, \"ns_per_point\": %.3f, \"points_per_sec\": %.1f, \"visible\": %llu}",
+            rsBenchmark.c_str(), rsMode.c_str(), nPoints, nPoses, nThreads,
+            dSeconds, dNsPerPoint, dNsPerPoint > 0.0 ? 1.0e9 / dNsPerPoint : 0.0, nVisible);
+        WriteLine(acLine);
+    }
+
+    void WriteGrid(const std::string& rsBenchmark, size_t nConfigurations, unsigned int nBoxes,
+        unsigned int nThreads, double dSeconds, unsigned int nFeasible)
+    {
+        const double dNsPerConfiguration = dSeconds * 1.0e9 / static_cast<double>(nConfigurations);
+        char acLine[512];
+        std::snprintf(acLine, sizeof(acLine),
+            "{\"benchmark\": \"%s\", \"configurations\": %zu, \"boxes\": %u, \"threads\": %u, "
+            "\"seconds\": %.4f, \"ns_per_configuration\": %.3f, \"feasible\": %u}",
+            rsBenchmark.c_str(), nConfigurations, nBoxes, nThreads, dSeconds, dNsPerConfiguration, nFeasible);
+        WriteLine(acLine);
+    }
+
+    void WriteCatalogue(const std::string& rsBenchmark, unsigned int nInstruments, unsigned long long nBytes, double dSeconds)
+    {
+        char acLine[512];
+        std::snprintf(acLine, sizeof(acLine),
+            "{\"benchmark\": \"%s\", \"instruments\": %u, \"bytes\": %llu, \"seconds\": %.6f, \"us_per_instrument\": %.4f}",
+            rsBenchmark.c_str(), nInstruments, nBytes, dSeconds, dSeconds * 1.0e6 / nInstruments);
+        WriteLine(acLine);
+    }
+
+private:
+    void WriteLine(const char* pcLine)
+    {
+        std::cout << pcLine << std::endl;
+        if (m_oFile.is_open())
+        {
+            m_oFile << pcLine << std::endl;
+        }
+    }
+
+    std::ofstream m_oFile;
+};
+
+
+/** Minimum over repetitions of the run time of fnRun() in seconds. **/
+static double MeasureSeconds(int nRepetitions, const std::function<void()>& fnRun)
+{
+    double dBest = 0.0;
+    for (int nRepetition = 0; nRepetition < nRepetitions; ++nRepetition)
+    {
+        auto oStart = std::chrono::steady_clock::now();
+        fnRun();
+        const double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - oStart).count();
+        dBest = nRepetition == 0 ? dSeconds : std::min(dBest, dSeconds);
+    }
+    return dBest;
+}
+
+
+/** Rolling terrain of about 1 km x 1 km in front of the origin, x forward, z up [m]. **/
+static std::vector<SPoint3D> MakeTerrain(size_t nPoints)
+{
+    const size_t nSide = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nPoints))));
+    const double dSpacing = 1000.0 / nSide;
+    std::vector<SPoint3D> vecPoints(nPoints);
+    for (size_t i = 0; i < nPoints; ++i)
+    {
+        const double dX = 5.0 + (i / nSide) * dSpacing;
+        const double dY = -500.0 + (i % nSide) * dSpacing;
+        vecPoints[i] = { dX, dY, -2.0 + 3.0 * std::sin(0.02 * dX) * std::cos(0.03 * dY) };
+    }
+    return vecPoints;
+}
+
+
+/** Kinematic chain of a pan/tilt mast camera 2 m above ground looking along +x. **/
+static bool CreateMastChain(int& rnChainId)
+{
+    SAxis oPan{ "pan", "mast pan", { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }, -200.0, 200.0, 0.0 };
+    SAxis oTilt{ "tilt", "mast tilt", { 0.0, 0.0, 2.0 }, { 0.0, -1.0, 2.0 }, -100.0, 100.0, 0.0 };
+    SAxis* apoAxes[] = { &oPan, &oTilt };
+    SInstrument oInstrument{};
+    oInstrument.m_pcInstrumentName = "mast camera";
+    oInstrument.m_nNrOfInstrumentAxes = 2;
+    oInstrument.m_poInstrumentAxes = apoAxes;
+    oInstrument.m_oInstrumentExtrinsics = { "GRF", { 0.0, 0.0, 2.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 },
+        { { -0.1, -0.15, 1.85 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.3, 0.0 }, { 0.0, 0.0, 0.3 } } };
+    return CreateKinematicChain(&oInstrument, &rnChainId) == 0;
+}
+
+
+static bool MakeMosaicPoses(unsigned int nPoses, std::vector<SInstrumentExtrinsics>& rvecPoses)
+{
+    int nChainId = 0;
+    if (!CreateMastChain(nChainId))
+    {
+        return false;
+    }
+    // 4 x 4 mosaic: pan -30..+30 gon, tilt down 5..20 gon
+    std::vector<double> vecAngles;
+    for (unsigned int i = 0; i < nPoses; ++i)
+    {
+        vecAngles.push_back(-30.0 + 20.0 * (i % 4));
+        vecAngles.push_back(-5.0 - 5.0 * ((i / 4) % 4));
+    }
+    rvecPoses.resize(nPoses);
+    const bool bEvaluated = EvaluateKinematicChain(nChainId, nPoses, vecAngles.data(), rvecPoses.data(), nullptr, 1) == 0;
+    DestroyKinematicChain(nChainId);
+    return bEvaluated;
+}
+
+
+/** Platform of nBoxes boxes: a deck below the mast and rings of small boxes (antennas, masts) around it. **/
+static std::vector<SBoundingBox> MakePlatformBoxes(unsigned int nBoxes)
+{
+    std::vector<SBoundingBox> vecBoxes;
+    vecBoxes.push_back({ { -1.0, -0.8, 1.0 }, { 2.0, 0.0, 0.0 }, { 0.0, 1.6, 0.0 }, { 0.0, 0.0, 0.3 } });
+    for (unsigned int i = 1; i < nBoxes; ++i)
+    {
+        const double dAngle = 0.1 * i;
+        const double dRadius = 0.8 + 0.01 * (i % 64);
+        const double dC = std::cos(dAngle);
+        const double dS = std::sin(dAngle);
+        vecBoxes.push_back({ { dRadius * dC, dRadius * dS, 1.3 + 0.005 * (i % 128) },
+            { 0.05 * dC, 0.05 * dS, 0.0 }, { -0.05 * dS, 0.05 * dC, 0.0 }, { 0.0, 0.0, 0.1 } });
+    }
+    return vecBoxes;
+}
+
+
+static bool RunCollisionBenchmark(const SConfig& roConfig, CResultWriter& roWriter)
+{
+    int nChainId = 0;
+    if (!CreateMastChain(nChainId))
+    {
+        return false;
+    }
+    const std::vector<SBoundingBox> vecBoxes = MakePlatformBoxes(256);
+    const unsigned int anSteps[] = { 401, 201 };
+    std::vector<unsigned char> vecFeasible(anSteps[0] * anSteps[1]);
+    unsigned int nFeasible = 0;
+    int nResult = 0;
+    const double dSeconds = MeasureSeconds(3, [&]()
+    {
+        nResult = GetCollisionFreeGrid(nChainId, static_cast<unsigned int>(vecBoxes.size()), vecBoxes.data(), anSteps,
+            vecFeasible.data(), nullptr, &nFeasible, roConfig.m_nThreads);
+    });
+    DestroyKinematicChain(nChainId);
+    if (nResult != 0)
+    {
+        return false;
+    }
+    roWriter.WriteGrid("GetCollisionFreeGrid", vecFeasible.size(), static_cast<unsigned int>(vecBoxes.size()), roConfig.m_nThreads, dSeconds, nFeasible);
+    return true;
+}
+
+
+/** Catalogue of nInstruments cameras on individual masts: pan and tilt axis per mast plus one shared platform axis. **/
+static bool RunPlatformFileBenchmark(const SConfig& roConfig, CResultWriter& roWriter)
+{
+    const unsigned int nInstruments = roConfig.m_bQuick ? 1000 : 10000;
+    const std::string sPath = "InstrumentPlatformsBenchmark.iplat";
+
+    std::vector<std::string> vecNames(nInstruments);
+    std::vector<SAxis> vecAxes(2 * nInstruments);
+    std::vector<SAxis*> vecAxisRefs(3 * nInstruments);
+    std::vector<double> vecFocalLengths = { 12.0, 25.0, 50.0, 100.0 };
+    std::vector<SInstrument> vecInstruments(nInstruments);
+    SAxis oPlatformAxis{ "yaw", "platform yaw", { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }, -200.0, 200.0, 0.0 };
+    for (unsigned int i = 0; i < nInstruments; ++i)
+    {
+        vecNames[i] = "camera " + std::to_string(i);
+        const double dX = 0.01 * i;
+        vecAxes[2 * i] = { "pan", "mast pan", { dX, 0.0, 0.0 }, { dX, 0.0, 1.0 }, -200.0, 200.0, 0.0 };
+        vecAxes[2 * i + 1] = { "tilt", "mast tilt", { dX, 0.0, 2.0 }, { dX, -1.0, 2.0 }, -100.0, 100.0, 0.0 };
+        vecAxisRefs[3 * i] = &oPlatformAxis;
+        vecAxisRefs[3 * i + 1] = &vecAxes[2 * i];
+        vecAxisRefs[3 * i + 2] = &vecAxes[2 * i + 1];
+        SInstrument& roInstrument = vecInstruments[i];
+        roInstrument.m_pcInstrumentName = vecNames[i].c_str();
+        roInstrument.m_nNrOfCalibratedFocalLengths = static_cast<unsigned int>(vecFocalLengths.size());
+        roInstrument.m_pdCalibratedFocalLengths = vecFocalLengths.data();
+        roInstrument.m_dCurrentFocalLengthInMm = 25.0;
+        roInstrument.m_oCurrentInstrumentIntrinsics = { 2048, 1536, 60.0, 45.0, 1024.0, 768.0, 0.0, 0.0 };
+        roInstrument.m_oInstrumentExtrinsics = { "GRF", { dX, 0.0, 2.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 },
+            { { dX - 0.1, -0.15, 1.85 }, { 0.2, 0.0, 0.0 }, { 0.0, 0.3, 0.0 }, { 0.0, 0.0, 0.3 } } };
+        roInstrument.m_nNrOfInstrumentAxes = 3;
+        roInstrument.m_poInstrumentAxes = &vecAxisRefs[3 * i];
+    }
+
+    int nResult = 0;
+    const double dWriteSeconds = MeasureSeconds(3, [&]()
+    {
+        nResult |= WritePlatformFile(sPath.c_str(), "benchmark platform", nInstruments, vecInstruments.data(), 0, nullptr);
+    });
+    std::ifstream oFile(sPath, std::ios::binary | std::ios::ate);
+    const unsigned long long nBytes = static_cast<unsigned long long>(oFile.tellg());
+    oFile.close();
+
+    double dChecksum = 0.0;
+    const double dOpenSeconds = MeasureSeconds(3, [&]()
+    {
+        int nPlatformId = 0;
+        const SInstrument* poInstruments = nullptr;
+        unsigned int nCount = 0;
+        nResult |= OpenPlatformFile(sPath.c_str(), &nPlatformId);
+        nResult |= GetPlatformInstruments(nPlatformId, &poInstruments, &nCount);
+        for (unsigned int i = 0; i < nCount; ++i)
+        {
+            dChecksum += poInstruments[i].m_pcInstrumentName[0] + poInstruments[i].m_pdCalibratedFocalLengths[1]
+                + poInstruments[i].m_poInstrumentAxes[2]->m_oEndPoint.m_dX;
+        }
+        nResult |= ClosePlatformFile(nPlatformId);
+    });
+    std::remove(sPath.c_str());
+    if (nResult != 0 || dChecksum == 0.0)
+    {
+        return false;
+    }
+    roWriter.WriteCatalogue("WritePlatformFile", nInstruments, nBytes, dWriteSeconds);
+    roWriter.WriteCatalogue("OpenPlatformFile", nInstruments, nBytes, dOpenSeconds);
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    SConfig oConfig;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string sArg = argv[i];
+        if (sArg == "--output" && i + 1 < argc)
+        {
+            oConfig.m_sOutput = argv[++i];
+        }
+        else if (sArg == "--quick")
+        {
+            oConfig.m_bQuick = true;
+        }
+        else if (sArg == "--threads" && i + 1 < argc)
+        {
+            oConfig.m_nThreads = static_cast<unsigned int>(std::stoul(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--output <file>] [--quick] [--threads <n>]" << std::endl;
+            return 1;
+        }
+    }
+
+    SInstrumentIntrinsics oIntrinsics{};
+    oIntrinsics.m_nResolutionH = 2048;
+    oIntrinsics.m_nResolutionV = 1536;
+    oIntrinsics.m_dFieldOfViewH = 60.0;
+    oIntrinsics.m_dFieldOfViewV = 45.0;
+    oIntrinsics.m_dPrinciplePointH = 1024.0;
+    oIntrinsics.m_dPrinciplePointV = 768.0;
+
+    std::vector<SInstrumentExtrinsics> vecMosaic;
+    if (!MakeMosaicPoses(16, vecMosaic))
+    {
+        std::cerr << "Failed to evaluate the mosaic poses." << std::endl;
+        return 1;
+    }
+
+    CResultWriter oWriter(oConfig.m_sOutput);
+    if (!RunCollisionBenchmark(oConfig, oWriter))
+    {
+        std::cerr << "GetCollisionFreeGrid() failed." << std::endl;
+        return 1;
+    }
+    if (!RunPlatformFileBenchmark(oConfig, oWriter))
+    {
+        std::cerr << "Writing or opening the platform file failed." << std::endl;
+        return 1;
+    }
+
+    const std::vector<size_t> vecCounts = oConfig.m_bQuick ? std::vector<size_t>{ 1000000 } : std::vector<size_t>{ 10000000, 100000000 };
+    for (size_t nPoints : vecCounts)
+    {
+        const std::vector<SPoint3D> vecPoints = MakeTerrain(nPoints);
+        const int nRepetitions = nPoints > 10000000 ? 1 : 3;
+
+        struct SMode
+        {
+            const char* m_pcName;
+            unsigned int m_nPoses;
+            unsigned int m_nFlags;
+        };
+        const SMode aoModes[] =
+        {
+            { "single", 1, 0 },
+            { "mosaic", 16, 0 },
+            { "single-depth-test", 1, PROJECTION_DEPTH_TEST },
+        };
+        for (const SMode& roMode : aoModes)
+        {
+            // the mosaic writes only counts, a full mask would need 16 bytes per point
+            std::vector<unsigned char> vecVisible(roMode.m_nPoses == 1 ? nPoints : 0);
+            std::vector<unsigned int> vecVisibleCounts(roMode.m_nPoses);
+            int nResult = 0;
+            const double dSeconds = MeasureSeconds(nRepetitions, [&]()
+            {
+                nResult = ProjectPoints(&oIntrinsics, roMode.m_nPoses, vecMosaic.data(), static_cast<unsigned int>(nPoints), vecPoints.data(),
+                    roMode.m_nFlags, 0.05, nullptr, vecVisible.empty() ? nullptr : vecVisible.data(), vecVisibleCounts.data(), oConfig.m_nThreads);
+            });
+            if (nResult != 0)
+            {
+                std::cerr << "ProjectPoints() failed with " << nResult << "." << std::endl;
+                return 1;
+            }
+            unsigned long long nVisible = 0;
+            for (unsigned int nCount : vecVisibleCounts)
+            {
+                nVisible += nCount;
+            }
+            oWriter.Write("ProjectPoints", roMode.m_pcName, nPoints, roMode.m_nPoses, oConfig.m_nThreads, dSeconds, nVisible);
+        }
+    }
+    return 0;
+}
@@ -148,6 +148,419 @@ extern "C"
     };
 
 
+    /**
+     * @brief Create a kinematic chain evaluator for the axes of an instrument.
+     *
+     * The axes of poInstrument are taken as a serial chain: the first axis is mounted on the
+     * platform, every further axis is carried by the axes before it. Axes and extrinsics
+     * are given in ground reference frame for the current axis angles (m_dCurrentAngle);
+     * this is the reference pose of the chain. The rotation of every axis (start point,
+     * direction from start to end point) is precomputed once, the instrument and its axes
+     * are not referenced after the call.
+     * @param[in]   poInstrument    Instrument with at least one axis.
+     * @param[out]  pnChainId       Id of the new chain
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Instrument has no axes or an axis is NULL
+     * -3   Start and end point of an axis are identical or its minimum angle is larger than its maximum angle
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int CreateKinematicChain(const SInstrument* poInstrument, int* pnChainId);
+
+    /**
+     * @brief Release a kinematic chain created by CreateKinematicChain().
+     *
+     * @param[in]   nChainId    Id of the chain.
+     * @return
+     *  0   Success
+     * -2   Unknown chain id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int DestroyKinematicChain(int nChainId);
+
+    /**
+     * @brief Number of axes of a kinematic chain.
+     *
+     * @param[in]   nChainId    Id of the chain.
+     * @param[out]  pnAxes      Number of axes
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown chain id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int GetKinematicChainAxisCount(int nChainId, unsigned int* pnAxes);
+
+    /**
+     * @brief Instrument poses for a batch of axis configurations, e.g. all positions of a mosaic.
+     *
+     * Configuration i is given by the nAxes angles pdAngles[i * nAxes + j] (unit: gon) in the
+     * order of the axes of the instrument. Angles outside [m_dMinAngle, m_dMaxAngle] of their
+     * axis are clamped. Position, look-at and up vector and the bounding box of the instrument
+     * extrinsics are transformed into the pose of every configuration. m_pcReferenceFrame points to
+     * a copy of the reference frame name owned by the chain (valid until DestroyKinematicChain()).
+     * Configurations are evaluated in blocks on up to nThreads threads.
+     * Per-configuration states:
+     * 0: All angles within their limits
+     * 1: At least one angle was clamped
+     * 2: At least one angle is NaN; position, vectors and bounding box of the pose are NaN
+     * @param[in]   nChainId        Id of the chain.
+     * @param[in]   nCount          Number of configurations.
+     * @param[in]   pdAngles        nCount * nAxes axis angles [gon]
+     * @param[out]  poExtrinsics    nCount instrument extrinsics
+     * @param[out]  pnStatus        Optional array of nCount per-configuration states. Can be NULL.
+     * @param[in]   nThreads        Maximum number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. pdAngles and poExtrinsics must not be NULL.
+     * -2   Unknown chain id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int EvaluateKinematicChain(
+        int nChainId,
+        unsigned int nCount,
+        const double* pdAngles,
+        SInstrumentExtrinsics* poExtrinsics,
+        int* pnStatus,
+        unsigned int nThreads);
+
+
+    /** Flags of ProjectPoints(). **/
+    enum EProjectionFlags
+    {
+        PROJECTION_DEPTH_TEST = 1   /* points hidden behind nearer points of the same pixel are not visible */
+    };
+
+    /**
+     * @brief Project surface points into the images of one or more instrument poses.
+     *
+     * The instrument is a pinhole camera at m_oPosition looking along m_oLookAt, with m_oUp
+     * pointing to the top of the image (m_oUp is orthogonalized against m_oLookAt). Pixel
+     * coordinates: u to the right, v downwards, pixel (0, 0) covers [0, 1) x [0, 1).
+     * m_dPrinciplePointH/V are given in pixels; if m_dFocalLengthInPxH/V is not positive, the
+     * focal length is derived from m_dFieldOfViewH/V [deg].
+     * A point is visible if it lies in front of the camera and inside the image. With
+     * PROJECTION_DEPTH_TEST, a depth buffer with the resolution of the image is filled first;
+     * a point is then only visible if its depth (distance along the look-at vector) exceeds
+     * the nearest depth of its pixel by at most dDepthTolerance.
+     * Points are processed in tiles on up to nThreads threads. Without depth test, each tile
+     * is projected for all poses while it is in cache; with depth test, poses are processed
+     * one after the other.
+     * Output arrays are pose-major: entry i of pose p is at index p * nCount + i.
+     * @param[in]   poIntrinsics        Instrument intrinsics.
+     * @param[in]   nPoses              Number of instrument poses.
+     * @param[in]   poExtrinsics        nPoses instrument poses, e.g. from EvaluateKinematicChain().
+     * @param[in]   nCount              Number of points.
+     * @param[in]   poPoints            nCount points, same reference frame as the poses.
+     * @param[in]   nFlags              Combination of EProjectionFlags.
+     * @param[in]   dDepthTolerance     Depth tolerance of PROJECTION_DEPTH_TEST, same unit as the points.
+     * @param[out]  pfPixels            Optional nPoses * nCount pixel coordinates (u, v), NaN for points at or behind the camera. Can be NULL.
+     * @param[out]  pnVisible           Optional nPoses * nCount visibility mask (1 visible, 0 not visible). Can be NULL.
+     * @param[out]  pnVisibleCounts     Optional number of visible points per pose. Can be NULL.
+     * @param[in]   nThreads            Maximum number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. poIntrinsics, poExtrinsics and poPoints must not be NULL.
+     * -2   Invalid intrinsics (zero resolution, neither focal length nor field of view given)
+     * -3   Invalid extrinsics (zero look-at vector or up vector parallel to it)
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int ProjectPoints(
+        const SInstrumentIntrinsics* poIntrinsics,
+        unsigned int nPoses,
+        const SInstrumentExtrinsics* poExtrinsics,
+        unsigned int nCount,
+        const SPoint3D* poPoints,
+        unsigned int nFlags,
+        double dDepthTolerance,
+        float* pfPixels,
+        unsigned char* pnVisible,
+        unsigned int* pnVisibleCounts,
+        unsigned int nThreads);
+
+
+    /**
+     * @brief Check axis configurations of an instrument for collisions with platform boxes.
+     *
+     * The bounding box of the instrument is moved with its kinematic chain (see
+     * EvaluateKinematicChain()) and tested against poBoxes, e.g. the platform body and other
+     * instruments. Boxes are treated as parallelepipeds (origin plus three edges) and tested
+     * with the separating axis theorem; boxes that only touch collide. A bounding volume
+     * hierarchy over poBoxes is built once per call. Configurations are evaluated in blocks on
+     * up to nThreads threads.
+     * @param[in]   nChainId        Id of the kinematic chain of the moving instrument.
+     * @param[in]   nBoxes          Number of fixed boxes.
+     * @param[in]   poBoxes         nBoxes fixed boxes in ground reference frame. Can be NULL if nBoxes is 0.
+     * @param[in]   nCount          Number of configurations.
+     * @param[in]   pdAngles        nCount * nAxes axis angles [gon], clamped like in EvaluateKinematicChain()
+     * @param[out]  pnCollidingBox  nCount indices: smallest index of a colliding box, -1 for no collision or -2 for a NaN angle
+     * @param[in]   nThreads        Maximum number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. pdAngles, pnCollidingBox and poBoxes (if nBoxes > 0) must not be NULL.
+     * -2   Unknown chain id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int CheckKinematicChainCollisions(
+        int nChainId,
+        unsigned int nBoxes,
+        const SBoundingBox* poBoxes,
+        unsigned int nCount,
+        const double* pdAngles,
+        int* pnCollidingBox,
+        unsigned int nThreads);
+
+    /**
+     * @brief Collision-free configurations of an instrument on a regular grid of axis angles.
+     *
+     * Same test as CheckKinematicChainCollisions() for all configurations of a grid: axis j is
+     * sampled at pnSteps[j] angles evenly spaced from m_dMinAngle to m_dMaxAngle (one step: the
+     * current angle). Grid configurations are numbered with the last axis running fastest, e.g.
+     * for pan/tilt index = nPan * pnSteps[1] + nTilt.
+     * pdFeasibleRanges receives per axis the smallest and largest angle of all collision-free
+     * configurations (NaN if there are none).
+     * @param[in]   nChainId            Id of the kinematic chain of the moving instrument.
+     * @param[in]   nBoxes              Number of fixed boxes.
+     * @param[in]   poBoxes             nBoxes fixed boxes in ground reference frame. Can be NULL if nBoxes is 0.
+     * @param[in]   pnSteps             nAxes grid steps
+     * @param[out]  pnFeasible          Optional mask over the grid (1 collision-free, 0 collision). Can be NULL.
+     * @param[out]  pdFeasibleRanges    Optional 2 * nAxes angles [gon] (minimum, maximum per axis). Can be NULL.
+     * @param[out]  pnFeasibleCount     Optional number of collision-free configurations. Can be NULL.
+     * @param[in]   nThreads            Maximum number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. pnSteps and poBoxes (if nBoxes > 0) must not be NULL.
+     * -2   Unknown chain id
+     * -3   A step count is 0 or the grid has more than 2^32 - 1 configurations
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int GetCollisionFreeGrid(
+        int nChainId,
+        unsigned int nBoxes,
+        const SBoundingBox* poBoxes,
+        const unsigned int* pnSteps,
+        unsigned char* pnFeasible,
+        double* pdFeasibleRanges,
+        unsigned int* pnFeasibleCount,
+        unsigned int nThreads);
+
+
+    /**
+     * @brief Create an empty frame graph.
+     *
+     * A frame graph connects reference frames (e.g. platform, ground, surface) by
+     * STransformations and composes the transformation between any two connected frames along
+     * the path with the fewest transformations. Composed transformations are memoized: after
+     * SetFrameTransformation() changed the matrix of a registered transformation, only the
+     * products from that transformation on are recomputed for dependent composites. Registering
+     * a new pair of frames drops all memoized composites.
+     * All functions of a frame graph can be called from multiple threads.
+     * @param[out]  pnGraphId   Id of the new graph
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int CreateFrameGraph(int* pnGraphId);
+
+    /**
+     * @brief Release a frame graph created by CreateFrameGraph().
+     *
+     * @param[in]   nGraphId    Id of the graph.
+     * @return
+     *  0   Success
+     * -2   Unknown graph id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int DestroyFrameGraph(int nGraphId);
+
+    /**
+     * @brief Register a transformation or change the matrix of a registered one.
+     *
+     * m_oHelmertTransfMatrix maps coordinates of m_pcSourceFrame to m_pcTargetFrame (column
+     * vectors, last row 0 0 0 1). A transformation between the same two frames replaces the
+     * registered one, also if source and target are swapped. m_pcTransfName is not used.
+     * @param[in]   nGraphId            Id of the graph.
+     * @param[in]   poTransformation    Transformation.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. poTransformation and its frame names must not be NULL.
+     * -2   Unknown graph id
+     * -4   Source and target frame are identical or the matrix is not an invertible affine transformation
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int SetFrameTransformation(int nGraphId, const STransformation* poTransformation);
+
+    /**
+     * @brief Composed transformation from one frame to another.
+     *
+     * @param[in]   nGraphId    Id of the graph.
+     * @param[in]   pcFrom      Source frame.
+     * @param[in]   pcTo        Target frame.
+     * @param[out]  poMatrix    Matrix mapping coordinates of pcFrom to pcTo.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown graph id
+     * -3   Unknown frame or frames not connected
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int GetFrameTransformation(int nGraphId, const char* pcFrom, const char* pcTo, STransformationMatrix* poMatrix);
+
+    /**
+     * @brief Transform points from one frame to another.
+     *
+     * The composed transformation (see GetFrameTransformation()) is applied to blocks of points
+     * on up to nThreads threads. poPointsOut can be the same array as poPointsIn.
+     * @param[in]   nGraphId        Id of the graph.
+     * @param[in]   pcFrom          Source frame.
+     * @param[in]   pcTo            Target frame.
+     * @param[in]   nCount          Number of points.
+     * @param[in]   poPointsIn      nCount points in pcFrom.
+     * @param[out]  poPointsOut     nCount points in pcTo.
+     * @param[in]   nThreads        Maximum number of threads, 0 uses all hardware threads.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown graph id
+     * -3   Unknown frame or frames not connected
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int TransformPoints(
+        int nGraphId,
+        const char* pcFrom,
+        const char* pcTo,
+        unsigned int nCount,
+        const SPoint3D* poPointsIn,
+        SPoint3D* poPointsOut,
+        unsigned int nThreads);
+
+    /**
+     * @brief Memoization statistics of a frame graph since its creation or the last reset.
+     *
+     * @param[in]   nGraphId        Id of the graph.
+     * @param[out]  pnHits          Queries answered by a valid composite
+     * @param[out]  pnMisses        Queries that searched a path and composed it completely
+     * @param[out]  pnUpdates       Queries that recomposed a composite from a changed transformation on
+     * @param[out]  pnProducts      Matrix products computed for compositions
+     * @param[in]   bReset          Reset the statistics after reading them.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown graph id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int GetFrameGraphStats(
+        int nGraphId,
+        unsigned long long* pnHits,
+        unsigned long long* pnMisses,
+        unsigned long long* pnUpdates,
+        unsigned long long* pnProducts,
+        bool bReset);
+
+
+    /**
+     * @brief Write instruments and transformations of a platform to a flat platform file.
+     *
+     * All pointers are replaced by indices and string offsets: instruments, axes, calibrated
+     * focal lengths and transformations are stored as arrays of fixed-size records followed by
+     * a single string table. Axes referenced by several instruments are stored once. The file
+     * is written to a temporary file first and renamed, readers never see a partial file.
+     * Values are stored in native byte order.
+     * @param[in]   pcPath              File path.
+     * @param[in]   pcPlatformName      Platform name. Can be NULL.
+     * @param[in]   nInstruments        Number of instruments.
+     * @param[in]   poInstruments       nInstruments instruments. Can be NULL if nInstruments is 0.
+     * @param[in]   nTransformations    Number of transformations.
+     * @param[in]   poTransformations   nTransformations transformations. Can be NULL if nTransformations is 0.
+     * @return
+     *  0   Success
+     * -1   Failed to run function. pcPath and the arrays (if their count is > 0) must not be NULL.
+     * -2   File could not be written
+     * -3   An instrument has NULL axes or focal lengths although their count is > 0
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int WritePlatformFile(
+        const char* pcPath,
+        const char* pcPlatformName,
+        unsigned int nInstruments,
+        const SInstrument* poInstruments,
+        unsigned int nTransformations,
+        const STransformation* poTransformations);
+
+    /**
+     * @brief Open a platform file written by WritePlatformFile().
+     *
+     * The file is memory-mapped (copy-on-write, changes never reach the file). The platform
+     * structs are created in a single allocation when the file is opened; names and calibrated
+     * focal lengths point into the mapping. Opening does not parse or copy strings, so large
+     * catalogues are available after touching only the pages that are used.
+     * @param[in]   pcPath          File path.
+     * @param[out]  pnPlatformId    Id of the opened platform
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   File could not be opened
+     * -3   Not a platform file, unsupported version or byte order, or corrupt content
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int OpenPlatformFile(const char* pcPath, int* pnPlatformId);
+
+    /**
+     * @brief Close a platform file opened by OpenPlatformFile().
+     *
+     * All pointers returned for the platform become invalid.
+     * @param[in]   nPlatformId     Id of the platform.
+     * @return
+     *  0   Success
+     * -2   Unknown platform id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int ClosePlatformFile(int nPlatformId);
+
+    /**
+     * @brief Name of an opened platform.
+     *
+     * @param[in]   nPlatformId     Id of the platform.
+     * @param[out]  ppcName         Platform name (NULL if none was written), valid until ClosePlatformFile()
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown platform id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int GetPlatformName(int nPlatformId, const char** ppcName);
+
+    /**
+     * @brief Instruments of an opened platform.
+     *
+     * @param[in]   nPlatformId     Id of the platform.
+     * @param[out]  ppoInstruments  Array of instruments, valid until ClosePlatformFile()
+     * @param[out]  pnCount         Number of instruments
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown platform id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int GetPlatformInstruments(int nPlatformId, const SInstrument** ppoInstruments, unsigned int* pnCount);
+
+    /**
+     * @brief Transformations of an opened platform.
+     *
+     * @param[in]   nPlatformId         Id of the platform.
+     * @param[out]  ppoTransformations  Array of transformations, valid until ClosePlatformFile()
+     * @param[out]  pnCount             Number of transformations
+     * @return
+     *  0   Success
+     * -1   Failed to run function. Argument(s) must not be NULL.
+     * -2   Unknown platform id
+     */
+    JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+    int GetPlatformTransformations(int nPlatformId, const STransformation** ppoTransformations, unsigned int* pnCount);
+
+
 } // extern "C"
 
 #endif // JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_HPP
@@ -0,0 +1,202 @@
+#include "Collision.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+static constexpr uint32_t BVH_LEAF_SIZE = 2;
+
+
+SObb MakeObb(const SBoundingBox& roBox)
+{
+    const SVector3D* apoEdges[3] = { &roBox.m_oEdge1, &roBox.m_oEdge2, &roBox.m_oEdge3 };
+    SObb oObb;
+    for (int e = 0; e < 3; ++e)
+    {
+        oObb.m_adHalfEdges[e][0] = 0.5 * apoEdges[e]->m_dX;
+        oObb.m_adHalfEdges[e][1] = 0.5 * apoEdges[e]->m_dY;
+        oObb.m_adHalfEdges[e][2] = 0.5 * apoEdges[e]->m_dZ;
+    }
+    const double adOrigin[3] = { roBox.m_oOriginBB.m_dX, roBox.m_oOriginBB.m_dY, roBox.m_oOriginBB.m_dZ };
+    for (int c = 0; c < 3; ++c)
+    {
+        double dExtent = 0.0;
+        oObb.m_adCenter[c] = adOrigin[c];
+        for (int e = 0; e < 3; ++e)
+        {
+            oObb.m_adCenter[c] += oObb.m_adHalfEdges[e][c];
+            dExtent += std::abs(oObb.m_adHalfEdges[e][c]);
+        }
+        oObb.m_adMin[c] = oObb.m_adCenter[c] - dExtent;
+        oObb.m_adMax[c] = oObb.m_adCenter[c] + dExtent;
+    }
+    return oObb;
+}
+
+
+static void Cross(const double* pdA, const double* pdB, double* pdOut)
+{
+    pdOut[0] = pdA[1] * pdB[2] - pdA[2] * pdB[1];
+    pdOut[1] = pdA[2] * pdB[0] - pdA[0] * pdB[2];
+    pdOut[2] = pdA[0] * pdB[1] - pdA[1] * pdB[0];
+}
+
+
+static double Dot(const double* pdA, const double* pdB)
+{
+    return pdA[0] * pdB[0] + pdA[1] * pdB[1] + pdA[2] * pdB[2];
+}
+
+
+// Half extent of a parallelepiped projected onto pdAxis.
+static double ProjectedRadius(const SObb& roBox, const double* pdAxis)
+{
+    return std::abs(Dot(roBox.m_adHalfEdges[0], pdAxis)) + std::abs(Dot(roBox.m_adHalfEdges[1], pdAxis))
+        + std::abs(Dot(roBox.m_adHalfEdges[2], pdAxis));
+}
+
+
+static bool Separates(const SObb& roA, const SObb& roB, const double* pdD, const double* pdAxis)
+{
+    // Axes from parallel edges are (almost) zero; they cannot separate anything and are skipped.
+    const double dLength = Dot(pdAxis, pdAxis);
+    if (dLength < 1.0e-24)
+    {
+        return false;
+    }
+    return std::abs(Dot(pdD, pdAxis)) > ProjectedRadius(roA, pdAxis) + ProjectedRadius(roB, pdAxis);
+}
+
+
+bool ObbIntersect(const SObb& roA, const SObb& roB)
+{
+    for (int c = 0; c < 3; ++c)
+    {
+        if (roA.m_adMax[c] < roB.m_adMin[c] || roB.m_adMax[c] < roA.m_adMin[c])
+        {
+            return false;
+        }
+    }
+
+    const double adD[3] = { roB.m_adCenter[0] - roA.m_adCenter[0], roB.m_adCenter[1] - roA.m_adCenter[1], roB.m_adCenter[2] - roA.m_adCenter[2] };
+    double adAxis[3];
+    for (const SObb* poBox : { &roA, &roB })
+    {
+        for (int e = 0; e < 3; ++e)
+        {
+            Cross(poBox->m_adHalfEdges[(e + 1) % 3], poBox->m_adHalfEdges[(e + 2) % 3], adAxis);
+            if (Separates(roA, roB, adD, adAxis))
+            {
+                return false;
+            }
+        }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            Cross(roA.m_adHalfEdges[i], roB.m_adHalfEdges[j], adAxis);
+            if (Separates(roA, roB, adD, adAxis))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+CBoxBvh::CBoxBvh(const std::vector<SObb>& rvecBoxes)
+    : m_vecBoxes(rvecBoxes)
+{
+    m_vecOrder.resize(m_vecBoxes.size());
+    for (uint32_t i = 0; i < m_vecOrder.size(); ++i)
+    {
+        m_vecOrder[i] = i;
+    }
+    if (!m_vecBoxes.empty())
+    {
+        m_vecNodes.reserve(2 * m_vecBoxes.size());
+        Build(0, static_cast<uint32_t>(m_vecBoxes.size()));
+    }
+}
+
+
+uint32_t CBoxBvh::Build(uint32_t nBegin, uint32_t nEnd)
+{
+    const uint32_t nNode = static_cast<uint32_t>(m_vecNodes.size());
+    m_vecNodes.push_back({});
+    SNode oNode{ { HUGE_VAL, HUGE_VAL, HUGE_VAL }, { -HUGE_VAL, -HUGE_VAL, -HUGE_VAL }, nBegin, nEnd - nBegin };
+    for (uint32_t i = nBegin; i < nEnd; ++i)
+    {
+        const SObb& roBox = m_vecBoxes[m_vecOrder[i]];
+        for (int c = 0; c < 3; ++c)
+        {
+            oNode.m_adMin[c] = std::min(oNode.m_adMin[c], roBox.m_adMin[c]);
+            oNode.m_adMax[c] = std::max(oNode.m_adMax[c], roBox.m_adMax[c]);
+        }
+    }
+
+    if (nEnd - nBegin > BVH_LEAF_SIZE)
+    {
+        int nAxis = 0;
+        for (int c = 1; c < 3; ++c)
+        {
+            if (oNode.m_adMax[c] - oNode.m_adMin[c] > oNode.m_adMax[nAxis] - oNode.m_adMin[nAxis])
+            {
+                nAxis = c;
+            }
+        }
+        const uint32_t nMid = nBegin + (nEnd - nBegin) / 2;
+        std::nth_element(m_vecOrder.begin() + nBegin, m_vecOrder.begin() + nMid, m_vecOrder.begin() + nEnd,
+            [&](uint32_t nA, uint32_t nB) { return m_vecBoxes[nA].m_adCenter[nAxis] < m_vecBoxes[nB].m_adCenter[nAxis]; });
+        Build(nBegin, nMid);
+        oNode.m_nFirst = Build(nMid, nEnd);
+        oNode.m_nCount = 0;
+    }
+    m_vecNodes[nNode] = oNode;
+    return nNode;
+}
+
+
+int CBoxBvh::FirstIntersection(const SObb& roBox) const
+{
+    if (m_vecNodes.empty())
+    {
+        return -1;
+    }
+
+    int nFirst = -1;
+    uint32_t anStack[64];
+    int nStack = 0;
+    anStack[nStack++] = 0;
+    while (nStack > 0)
+    {
+        const uint32_t nNode = anStack[--nStack];
+        const SNode& roNode = m_vecNodes[nNode];
+        bool bOverlap = true;
+        for (int c = 0; c < 3; ++c)
+        {
+            bOverlap &= roNode.m_adMin[c] <= roBox.m_adMax[c] && roBox.m_adMin[c] <= roNode.m_adMax[c];
+        }
+        if (!bOverlap)
+        {
+            continue;
+        }
+        if (roNode.m_nCount == 0)
+        {
+            anStack[nStack++] = roNode.m_nFirst;
+            anStack[nStack++] = nNode + 1;
+            continue;
+        }
+        for (uint32_t i = roNode.m_nFirst; i < roNode.m_nFirst + roNode.m_nCount; ++i)
+        {
+            const int nIndex = static_cast<int>(m_vecOrder[i]);
+            if ((nFirst < 0 || nIndex < nFirst) && ObbIntersect(m_vecBoxes[nIndex], roBox))
+            {
+                nFirst = nIndex;
+            }
+        }
+    }
+    return nFirst;
+}
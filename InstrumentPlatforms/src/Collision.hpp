@@ -0,0 +1,53 @@
+#ifndef JR_PRO3D_EXTENSIONS_COLLISION_HPP
+#define JR_PRO3D_EXTENSIONS_COLLISION_HPP
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/** Bounding box (parallelepiped) prepared for separating axis tests. **/
+struct SObb
+{
+    double m_adCenter[3];
+    double m_adHalfEdges[3][3];     // half edge vectors
+    double m_adMin[3];              // axis-aligned bounds
+    double m_adMax[3];
+};
+
+SObb MakeObb(const SBoundingBox& roBox);
+
+/** Separating axis test of two parallelepipeds: face normals of both boxes and cross products of
+  * their edges. Boxes that only touch intersect.
+  **/
+bool ObbIntersect(const SObb& roA, const SObb& roB);
+
+
+/** Bounding volume hierarchy (axis-aligned bounds, median split) over a fixed set of boxes. **/
+class CBoxBvh
+{
+public:
+    explicit CBoxBvh(const std::vector<SObb>& rvecBoxes);
+
+    /** Smallest index of a box intersecting roBox or -1. **/
+    int FirstIntersection(const SObb& roBox) const;
+
+private:
+    struct SNode
+    {
+        double m_adMin[3];
+        double m_adMax[3];
+        uint32_t m_nFirst;          // leaf: first index into m_vecOrder; inner node: right child (left child follows)
+        uint32_t m_nCount;          // leaf: number of boxes, inner node: 0
+    };
+
+    uint32_t Build(uint32_t nBegin, uint32_t nEnd);
+
+    std::vector<SObb> m_vecBoxes;
+    std::vector<uint32_t> m_vecOrder;
+    std::vector<SNode> m_vecNodes;
+};
+
+#endif // JR_PRO3D_EXTENSIONS_COLLISION_HPP
@@ -0,0 +1,259 @@
+#include "FrameGraph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+
+STransformationMatrix MultiplyTransformations(const STransformationMatrix& roA, const STransformationMatrix& roB)
+{
+    STransformationMatrix oResult;
+    for (int r = 0; r < 4; ++r)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            oResult.m_adElement[r][c] = roA.m_adElement[r][0] * roB.m_adElement[0][c] + roA.m_adElement[r][1] * roB.m_adElement[1][c]
+                + roA.m_adElement[r][2] * roB.m_adElement[2][c] + roA.m_adElement[r][3] * roB.m_adElement[3][c];
+        }
+    }
+    return oResult;
+}
+
+
+bool InvertTransformation(const STransformationMatrix& roMatrix, STransformationMatrix& roInverse)
+{
+    const auto& m = roMatrix.m_adElement;
+    if (m[3][0] != 0.0 || m[3][1] != 0.0 || m[3][2] != 0.0 || m[3][3] != 1.0)
+    {
+        return false;
+    }
+
+    // adjugate of the 3x3 part
+    double adAdj[3][3];
+    adAdj[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    adAdj[0][1] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+    adAdj[0][2] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+    adAdj[1][0] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    adAdj[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+    adAdj[1][2] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+    adAdj[2][0] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    adAdj[2][1] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+    adAdj[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+    const double dDet = m[0][0] * adAdj[0][0] + m[0][1] * adAdj[1][0] + m[0][2] * adAdj[2][0];
+    double dScale = 0.0;
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            dScale = std::max(dScale, std::abs(m[r][c]));
+        }
+    }
+    if (!(std::abs(dDet) > 1.0e-12 * dScale * dScale * dScale))
+    {
+        return false;
+    }
+
+    auto& rInv = roInverse.m_adElement;
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            rInv[r][c] = adAdj[r][c] / dDet;
+        }
+        rInv[r][3] = -(rInv[r][0] * m[0][3] + rInv[r][1] * m[1][3] + rInv[r][2] * m[2][3]);
+    }
+    rInv[3][0] = 0.0;
+    rInv[3][1] = 0.0;
+    rInv[3][2] = 0.0;
+    rInv[3][3] = 1.0;
+    return true;
+}
+
+
+int CFrameGraph::FrameIndex(const std::string& rsFrame, bool bCreate)
+{
+    auto it = m_mapFrames.find(rsFrame);
+    if (it != m_mapFrames.end())
+    {
+        return it->second;
+    }
+    if (!bCreate)
+    {
+        return -1;
+    }
+    const int nIndex = static_cast<int>(m_vecAdjacentEdges.size());
+    m_mapFrames.emplace(rsFrame, nIndex);
+    m_vecAdjacentEdges.emplace_back();
+    return nIndex;
+}
+
+
+void CFrameGraph::DropComposites()
+{
+    m_mapComposites.clear();
+    for (SEdge& roEdge : m_vecEdges)
+    {
+        roEdge.m_vecDependents.clear();
+    }
+}
+
+
+int CFrameGraph::SetTransformation(const std::string& rsSource, const std::string& rsTarget, const STransformationMatrix& roMatrix)
+{
+    STransformationMatrix oInverse;
+    if (rsSource == rsTarget || !InvertTransformation(roMatrix, oInverse))
+    {
+        return -4;
+    }
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    const int nSource = FrameIndex(rsSource, true);
+    const int nTarget = FrameIndex(rsTarget, true);
+    const auto oKey = std::minmax(nSource, nTarget);
+    auto it = m_mapEdgeIndex.find(oKey);
+    if (it == m_mapEdgeIndex.end())
+    {
+        // new edge: shortest paths may change
+        DropComposites();
+        const size_t nEdge = m_vecEdges.size();
+        m_vecEdges.push_back({ nSource, nTarget, roMatrix, oInverse, {} });
+        m_mapEdgeIndex.emplace(oKey, nEdge);
+        m_vecAdjacentEdges[nSource].push_back(nEdge);
+        m_vecAdjacentEdges[nTarget].push_back(nEdge);
+        return 0;
+    }
+
+    // the edge keeps its direction, memoized paths refer to it
+    SEdge& roEdge = m_vecEdges[it->second];
+    const bool bSameDirection = roEdge.m_nSource == nSource;
+    roEdge.m_oMatrix = bSameDirection ? roMatrix : oInverse;
+    roEdge.m_oInverse = bSameDirection ? oInverse : roMatrix;
+    for (const auto& roDependent : roEdge.m_vecDependents)
+    {
+        SComposite& roComposite = m_mapComposites.at(roDependent);
+        for (size_t k = 0; k < roComposite.m_vecPath.size(); ++k)
+        {
+            if (roComposite.m_vecPath[k].m_nEdge == it->second)
+            {
+                roComposite.m_nValid = std::min(roComposite.m_nValid, k);
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+
+bool CFrameGraph::FindPath(int nFrom, int nTo, std::vector<SStep>& rvecPath) const
+{
+    // breadth-first search: fewest edges
+    std::vector<size_t> vecReachedBy(m_vecAdjacentEdges.size(), SIZE_MAX);
+    std::queue<int> oQueue;
+    oQueue.push(nFrom);
+    vecReachedBy[nFrom] = m_vecEdges.size();
+    while (!oQueue.empty() && vecReachedBy[nTo] == SIZE_MAX)
+    {
+        const int nFrame = oQueue.front();
+        oQueue.pop();
+        for (size_t nEdge : m_vecAdjacentEdges[nFrame])
+        {
+            const SEdge& roEdge = m_vecEdges[nEdge];
+            const int nNext = roEdge.m_nSource == nFrame ? roEdge.m_nTarget : roEdge.m_nSource;
+            if (vecReachedBy[nNext] == SIZE_MAX)
+            {
+                vecReachedBy[nNext] = nEdge;
+                oQueue.push(nNext);
+            }
+        }
+    }
+    if (vecReachedBy[nTo] == SIZE_MAX)
+    {
+        return false;
+    }
+
+    rvecPath.clear();
+    for (int nFrame = nTo; nFrame != nFrom;)
+    {
+        const SEdge& roEdge = m_vecEdges[vecReachedBy[nFrame]];
+        const bool bForward = roEdge.m_nTarget == nFrame;
+        rvecPath.push_back({ vecReachedBy[nFrame], bForward });
+        nFrame = bForward ? roEdge.m_nSource : roEdge.m_nTarget;
+    }
+    std::reverse(rvecPath.begin(), rvecPath.end());
+    return true;
+}
+
+
+int CFrameGraph::GetTransformation(const std::string& rsFrom, const std::string& rsTo, STransformationMatrix& roMatrix)
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    const int nFrom = FrameIndex(rsFrom, false);
+    const int nTo = FrameIndex(rsTo, false);
+    if (nFrom < 0 || nTo < 0)
+    {
+        return -3;
+    }
+    if (nFrom == nTo)
+    {
+        roMatrix = { { { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0, 0.0 }, { 0.0, 0.0, 0.0, 1.0 } } };
+        return 0;
+    }
+
+    const std::pair<int, int> oKey(nFrom, nTo);
+    auto it = m_mapComposites.find(oKey);
+    if (it == m_mapComposites.end())
+    {
+        SComposite oComposite;
+        if (!FindPath(nFrom, nTo, oComposite.m_vecPath))
+        {
+            return -3;
+        }
+        oComposite.m_vecPrefix.resize(oComposite.m_vecPath.size());
+        oComposite.m_nValid = 0;
+        for (const SStep& roStep : oComposite.m_vecPath)
+        {
+            m_vecEdges[roStep.m_nEdge].m_vecDependents.push_back(oKey);
+        }
+        it = m_mapComposites.emplace(oKey, std::move(oComposite)).first;
+        ++m_oStats.m_nMisses;
+    }
+    else if (it->second.m_nValid == it->second.m_vecPath.size())
+    {
+        ++m_oStats.m_nHits;
+    }
+    else
+    {
+        ++m_oStats.m_nUpdates;
+    }
+
+    SComposite& roComposite = it->second;
+    for (size_t k = roComposite.m_nValid; k < roComposite.m_vecPath.size(); ++k)
+    {
+        const SEdge& roEdge = m_vecEdges[roComposite.m_vecPath[k].m_nEdge];
+        const STransformationMatrix& roStep = roComposite.m_vecPath[k].m_bForward ? roEdge.m_oMatrix : roEdge.m_oInverse;
+        if (k == 0)
+        {
+            roComposite.m_vecPrefix[0] = roStep;
+        }
+        else
+        {
+            roComposite.m_vecPrefix[k] = MultiplyTransformations(roStep, roComposite.m_vecPrefix[k - 1]);
+            ++m_oStats.m_nProducts;
+        }
+    }
+    roComposite.m_nValid = roComposite.m_vecPath.size();
+    roMatrix = roComposite.m_vecPrefix.back();
+    return 0;
+}
+
+
+CFrameGraph::SStats CFrameGraph::GetStats(bool bReset)
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    const SStats oStats = m_oStats;
+    if (bReset)
+    {
+        m_oStats = {};
+    }
+    return oStats;
+}
@@ -0,0 +1,86 @@
+#ifndef JR_PRO3D_EXTENSIONS_FRAMEGRAPH_HPP
+#define JR_PRO3D_EXTENSIONS_FRAMEGRAPH_HPP
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+/** Helmert matrices as affine maps p' = M * p (column vectors, last row 0 0 0 1). **/
+STransformationMatrix MultiplyTransformations(const STransformationMatrix& roA, const STransformationMatrix& roB);
+
+/** Returns false if the matrix is not affine or its 3x3 part is singular. **/
+bool InvertTransformation(const STransformationMatrix& roMatrix, STransformationMatrix& roInverse);
+
+
+/** Frames connected by STransformations. Transformations between any two connected frames are
+  * composed along the path with the fewest edges and memoized.
+  *
+  * A memoized composite keeps the partial products along its path (prefix products). Changing the
+  * matrix of an edge marks the dependent composites from the position of the edge on; the next
+  * query only recomputes the products from there. Adding an edge changes the topology and drops
+  * all composites.
+  **/
+class CFrameGraph
+{
+public:
+    struct SStats
+    {
+        uint64_t m_nHits;               // composite valid
+        uint64_t m_nMisses;             // path search and full composition
+        uint64_t m_nUpdates;            // partial recomposition after edge changes
+        uint64_t m_nProducts;           // matrix products for compositions
+    };
+
+    /** Returns 0 or -4 like SetFrameTransformation(). **/
+    int SetTransformation(const std::string& rsSource, const std::string& rsTarget, const STransformationMatrix& roMatrix);
+
+    /** Returns 0 or -3 like GetFrameTransformation(). **/
+    int GetTransformation(const std::string& rsFrom, const std::string& rsTo, STransformationMatrix& roMatrix);
+
+    SStats GetStats(bool bReset);
+
+private:
+    struct SEdge
+    {
+        int m_nSource;
+        int m_nTarget;
+        STransformationMatrix m_oMatrix;    // source -> target
+        STransformationMatrix m_oInverse;   // target -> source
+        std::vector<std::pair<int, int>> m_vecDependents;   // composites (from, to) using this edge
+    };
+
+    struct SStep
+    {
+        size_t m_nEdge;
+        bool m_bForward;
+    };
+
+    struct SComposite
+    {
+        std::vector<SStep> m_vecPath;
+        std::vector<STransformationMatrix> m_vecPrefix;     // m_vecPrefix[k]: frame "from" -> frame after step k
+        size_t m_nValid;                                    // number of valid prefix products
+    };
+
+    int FrameIndex(const std::string& rsFrame, bool bCreate);
+    bool FindPath(int nFrom, int nTo, std::vector<SStep>& rvecPath) const;
+    void DropComposites();
+
+    std::mutex m_oMutex;
+    std::unordered_map<std::string, int> m_mapFrames;
+    std::vector<std::vector<size_t>> m_vecAdjacentEdges;   // per frame
+    std::vector<SEdge> m_vecEdges;
+    std::map<std::pair<int, int>, size_t> m_mapEdgeIndex;   // (min frame, max frame) -> edge
+    std::map<std::pair<int, int>, SComposite> m_mapComposites;
+    SStats m_oStats{};
+};
+
+#endif // JR_PRO3D_EXTENSIONS_FRAMEGRAPH_HPP
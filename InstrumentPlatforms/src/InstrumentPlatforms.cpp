@@ -0,0 +1,734 @@
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include "Collision.hpp"
+#include "FrameGraph.hpp"
+#include "KinematicChain.hpp"
+#include "ParallelFor.hpp"
+#include "PlatformFile.hpp"
+#include "Projection.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+// Chains are shared with running evaluations, so DestroyKinematicChain() does not wait for them.
+struct SKinematicChainEntry
+{
+    int m_nId;
+    std::shared_ptr<const CKinematicChain> m_poChain;
+};
+
+static std::mutex s_oChainMutex;
+static std::vector<SKinematicChainEntry> s_vecKinematicChains;
+static int s_nNextKinematicChainId = 1;
+
+
+static std::shared_ptr<const CKinematicChain> FindKinematicChain(int nChainId)
+{
+    std::lock_guard<std::mutex> oLock(s_oChainMutex);
+    auto it = std::find_if(s_vecKinematicChains.begin(), s_vecKinematicChains.end(),
+        [nChainId](const SKinematicChainEntry& roEntry) { return roEntry.m_nId == nChainId; });
+    return it == s_vecKinematicChains.end() ? nullptr : it->m_poChain;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int CreateKinematicChain(const SInstrument* poInstrument, int* pnChainId)
+{
+    if (!poInstrument || !pnChainId)
+    {
+        return -1;
+    }
+    const int nValid = CKinematicChain::Validate(*poInstrument);
+    if (nValid != 0)
+    {
+        return nValid;
+    }
+
+    auto poChain = std::make_shared<const CKinematicChain>(*poInstrument);
+
+    std::lock_guard<std::mutex> oLock(s_oChainMutex);
+    *pnChainId = s_nNextKinematicChainId++;
+    s_vecKinematicChains.push_back({ *pnChainId, std::move(poChain) });
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int DestroyKinematicChain(int nChainId)
+{
+    std::lock_guard<std::mutex> oLock(s_oChainMutex);
+    auto it = std::find_if(s_vecKinematicChains.begin(), s_vecKinematicChains.end(),
+        [nChainId](const SKinematicChainEntry& roEntry) { return roEntry.m_nId == nChainId; });
+    if (it == s_vecKinematicChains.end())
+    {
+        return -2;
+    }
+    s_vecKinematicChains.erase(it);
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int GetKinematicChainAxisCount(int nChainId, unsigned int* pnAxes)
+{
+    if (!pnAxes)
+    {
+        return -1;
+    }
+    auto poChain = FindKinematicChain(nChainId);
+    if (!poChain)
+    {
+        return -2;
+    }
+    *pnAxes = static_cast<unsigned int>(poChain->AxisCount());
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int EvaluateKinematicChain(
+    int nChainId,
+    unsigned int nCount,
+    const double* pdAngles,
+    SInstrumentExtrinsics* poExtrinsics,
+    int* pnStatus,
+    unsigned int nThreads)
+{
+    if (!pdAngles || !poExtrinsics)
+    {
+        return -1;
+    }
+    auto poChain = FindKinematicChain(nChainId);
+    if (!poChain)
+    {
+        return -2;
+    }
+
+    const size_t nAxes = poChain->AxisCount();
+    // a few blocks per thread keep all threads busy without splitting small batches
+    ParallelFor(nCount, 16 * CKinematicChain::BLOCK_SIZE, nThreads, [&](size_t nBegin, size_t nEnd)
+    {
+        auto poTransforms = std::make_unique<CKinematicChain::SBlockTransforms>();
+        for (size_t nBlock = nBegin; nBlock < nEnd; nBlock += CKinematicChain::BLOCK_SIZE)
+        {
+            const size_t nBlockCount = std::min(CKinematicChain::BLOCK_SIZE, nEnd - nBlock);
+            poChain->EvaluateBlock(pdAngles + nBlock * nAxes, nBlockCount, *poTransforms, pnStatus ? pnStatus + nBlock : nullptr);
+            for (size_t i = 0; i < nBlockCount; ++i)
+            {
+                poChain->TransformExtrinsics(*poTransforms, i, poExtrinsics[nBlock + i]);
+            }
+        }
+    });
+    return 0;
+}
+
+
+// Projection buffers of one tile.
+struct SProjectionTile
+{
+    float m_afU[PROJECTION_TILE_SIZE];
+    float m_afV[PROJECTION_TILE_SIZE];
+    float m_afDepth[PROJECTION_TILE_SIZE];
+    uint32_t m_anPixel[PROJECTION_TILE_SIZE];
+};
+
+
+static void WriteProjection(const SProjectionTile& roTile, size_t nCount, float* pfPixels)
+{
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        pfPixels[2 * i] = roTile.m_afU[i];
+        pfPixels[2 * i + 1] = roTile.m_afV[i];
+    }
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int ProjectPoints(
+    const SInstrumentIntrinsics* poIntrinsics,
+    unsigned int nPoses,
+    const SInstrumentExtrinsics* poExtrinsics,
+    unsigned int nCount,
+    const SPoint3D* poPoints,
+    unsigned int nFlags,
+    double dDepthTolerance,
+    float* pfPixels,
+    unsigned char* pnVisible,
+    unsigned int* pnVisibleCounts,
+    unsigned int nThreads)
+{
+    if (!poIntrinsics || !poExtrinsics || !poPoints)
+    {
+        return -1;
+    }
+
+    std::vector<SCamera> vecCameras(nPoses);
+    for (unsigned int p = 0; p < nPoses; ++p)
+    {
+        const int nValid = MakeCamera(*poIntrinsics, poExtrinsics[p], vecCameras[p]);
+        if (nValid != 0)
+        {
+            return nValid;
+        }
+    }
+
+    std::vector<std::atomic<unsigned int>> vecVisibleCounts(nPoses);
+    auto fnWriteTile = [&](const SProjectionTile& roTile, size_t nPose, size_t nBegin, size_t nTileCount, auto fnVisible)
+    {
+        const size_t nOffset = nPose * nCount + nBegin;
+        if (pfPixels)
+        {
+            WriteProjection(roTile, nTileCount, pfPixels + 2 * nOffset);
+        }
+        unsigned int nVisible = 0;
+        for (size_t i = 0; i < nTileCount; ++i)
+        {
+            const bool bVisible = fnVisible(i);
+            nVisible += bVisible;
+            if (pnVisible)
+            {
+                pnVisible[nOffset + i] = bVisible;
+            }
+        }
+        vecVisibleCounts[nPose] += nVisible;
+    };
+
+    // Blocks of several tiles per thread; the tile buffers are allocated once per block.
+    const size_t nBlockSize = 16 * PROJECTION_TILE_SIZE;
+    auto fnForEachTile = [&](size_t nBegin, size_t nEnd, auto fnTile)
+    {
+        auto poTile = std::make_unique<SProjectionTile>();
+        for (size_t nTile = nBegin; nTile < nEnd; nTile += PROJECTION_TILE_SIZE)
+        {
+            fnTile(*poTile, nTile, std::min(PROJECTION_TILE_SIZE, nEnd - nTile));
+        }
+    };
+
+    if (!(nFlags & PROJECTION_DEPTH_TEST))
+    {
+        // tile-major: the points of a tile are read from memory once for all poses
+        ParallelFor(nCount, nBlockSize, nThreads, [&](size_t nBegin, size_t nEnd)
+        {
+            fnForEachTile(nBegin, nEnd, [&](SProjectionTile& roTile, size_t nTile, size_t nTileCount)
+            {
+                for (unsigned int p = 0; p < nPoses; ++p)
+                {
+                    ProjectTile(vecCameras[p], poPoints + nTile, nTileCount, roTile.m_afU, roTile.m_afV, roTile.m_afDepth, roTile.m_anPixel);
+                    fnWriteTile(roTile, p, nTile, nTileCount, [&](size_t i) { return roTile.m_anPixel[i] != UINT32_MAX; });
+                }
+            });
+        });
+    }
+    else if (nPoses > 0)
+    {
+        // Depths are positive, so their IEEE bit patterns sort like the values and the depth
+        // buffer can be updated with integer compare-and-swap.
+        std::vector<uint32_t> vecDepthBuffer(static_cast<size_t>(poIntrinsics->m_nResolutionH) * poIntrinsics->m_nResolutionV);
+        const float fTolerance = static_cast<float>(std::max(dDepthTolerance, 0.0));
+        for (unsigned int p = 0; p < nPoses; ++p)
+        {
+            const SCamera& roCamera = vecCameras[p];
+            std::fill(vecDepthBuffer.begin(), vecDepthBuffer.end(), std::bit_cast<uint32_t>(std::numeric_limits<float>::infinity()));
+
+            ParallelFor(nCount, nBlockSize, nThreads, [&](size_t nBegin, size_t nEnd)
+            {
+                fnForEachTile(nBegin, nEnd, [&](SProjectionTile& roTile, size_t nTile, size_t nTileCount)
+                {
+                    ProjectTile(roCamera, poPoints + nTile, nTileCount, roTile.m_afU, roTile.m_afV, roTile.m_afDepth, roTile.m_anPixel);
+                    for (size_t i = 0; i < nTileCount; ++i)
+                    {
+                        if (roTile.m_anPixel[i] == UINT32_MAX)
+                        {
+                            continue;
+                        }
+                        const uint32_t nDepth = std::bit_cast<uint32_t>(roTile.m_afDepth[i]);
+                        std::atomic_ref<uint32_t> oNearest(vecDepthBuffer[roTile.m_anPixel[i]]);
+                        uint32_t nNearest = oNearest.load(std::memory_order_relaxed);
+                        while (nDepth < nNearest && !oNearest.compare_exchange_weak(nNearest, nDepth, std::memory_order_relaxed))
+                        {
+                        }
+                    }
+                });
+            });
+
+            ParallelFor(nCount, nBlockSize, nThreads, [&](size_t nBegin, size_t nEnd)
+            {
+                fnForEachTile(nBegin, nEnd, [&](SProjectionTile& roTile, size_t nTile, size_t nTileCount)
+                {
+                    ProjectTile(roCamera, poPoints + nTile, nTileCount, roTile.m_afU, roTile.m_afV, roTile.m_afDepth, roTile.m_anPixel);
+                    fnWriteTile(roTile, p, nTile, nTileCount, [&](size_t i)
+                    {
+                        const uint32_t nPixel = roTile.m_anPixel[i];
+                        return nPixel != UINT32_MAX && roTile.m_afDepth[i] <= std::bit_cast<float>(vecDepthBuffer[nPixel]) + fTolerance;
+                    });
+                });
+            });
+        }
+    }
+
+    if (pnVisibleCounts)
+    {
+        for (unsigned int p = 0; p < nPoses; ++p)
+        {
+            pnVisibleCounts[p] = vecVisibleCounts[p];
+        }
+    }
+    return 0;
+}
+
+
+// Index of the smallest colliding box, -1 or -2 (NaN angle) for a block of configurations.
+static void CheckCollisionBlock(const CKinematicChain& roChain, const CBoxBvh& roBvh, const double* pdAngles, size_t nCount,
+    CKinematicChain::SBlockTransforms& roTransforms, int* pnCollidingBox)
+{
+    int anStatus[CKinematicChain::BLOCK_SIZE];
+    roChain.EvaluateBlock(pdAngles, nCount, roTransforms, anStatus);
+    SInstrumentExtrinsics oExtrinsics;
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        if (anStatus[i] == 2)
+        {
+            // a NaN box overlaps nothing, which would pass as collision-free
+            pnCollidingBox[i] = -2;
+            continue;
+        }
+        roChain.TransformExtrinsics(roTransforms, i, oExtrinsics);
+        pnCollidingBox[i] = roBvh.FirstIntersection(MakeObb(oExtrinsics.m_oBoundingBox));
+    }
+}
+
+
+static CBoxBvh MakeBoxBvh(unsigned int nBoxes, const SBoundingBox* poBoxes)
+{
+    std::vector<SObb> vecBoxes(nBoxes);
+    std::transform(poBoxes, poBoxes + nBoxes, vecBoxes.begin(), MakeObb);
+    return CBoxBvh(vecBoxes);
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int CheckKinematicChainCollisions(
+    int nChainId,
+    unsigned int nBoxes,
+    const SBoundingBox* poBoxes,
+    unsigned int nCount,
+    const double* pdAngles,
+    int* pnCollidingBox,
+    unsigned int nThreads)
+{
+    if (!pdAngles || !pnCollidingBox || (nBoxes > 0 && !poBoxes))
+    {
+        return -1;
+    }
+    auto poChain = FindKinematicChain(nChainId);
+    if (!poChain)
+    {
+        return -2;
+    }
+
+    const CBoxBvh oBvh = MakeBoxBvh(nBoxes, poBoxes);
+    const size_t nAxes = poChain->AxisCount();
+    ParallelFor(nCount, 16 * CKinematicChain::BLOCK_SIZE, nThreads, [&](size_t nBegin, size_t nEnd)
+    {
+        auto poTransforms = std::make_unique<CKinematicChain::SBlockTransforms>();
+        for (size_t nBlock = nBegin; nBlock < nEnd; nBlock += CKinematicChain::BLOCK_SIZE)
+        {
+            const size_t nBlockCount = std::min(CKinematicChain::BLOCK_SIZE, nEnd - nBlock);
+            CheckCollisionBlock(*poChain, oBvh, pdAngles + nBlock * nAxes, nBlockCount, *poTransforms, pnCollidingBox + nBlock);
+        }
+    });
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int GetCollisionFreeGrid(
+    int nChainId,
+    unsigned int nBoxes,
+    const SBoundingBox* poBoxes,
+    const unsigned int* pnSteps,
+    unsigned char* pnFeasible,
+    double* pdFeasibleRanges,
+    unsigned int* pnFeasibleCount,
+    unsigned int nThreads)
+{
+    if (!pnSteps || (nBoxes > 0 && !poBoxes))
+    {
+        return -1;
+    }
+    auto poChain = FindKinematicChain(nChainId);
+    if (!poChain)
+    {
+        return -2;
+    }
+
+    const size_t nAxes = poChain->AxisCount();
+    uint64_t nGrid = 1;
+    std::vector<double> vecStart(nAxes);
+    std::vector<double> vecStep(nAxes);
+    for (size_t j = 0; j < nAxes; ++j)
+    {
+        nGrid *= pnSteps[j];
+        if (pnSteps[j] == 0 || nGrid > UINT32_MAX)
+        {
+            return -3;
+        }
+        double dMin = 0.0;
+        double dMax = 0.0;
+        poChain->GetAxisLimits(j, dMin, dMax);
+        vecStart[j] = pnSteps[j] == 1 ? poChain->GetCurrentAngle(j) : dMin;
+        vecStep[j] = pnSteps[j] == 1 ? 0.0 : (dMax - dMin) / (pnSteps[j] - 1);
+    }
+
+    const CBoxBvh oBvh = MakeBoxBvh(nBoxes, poBoxes);
+    std::mutex oResultMutex;
+    unsigned int nFeasibleCount = 0;
+    std::vector<double> vecMin(nAxes, HUGE_VAL);
+    std::vector<double> vecMax(nAxes, -HUGE_VAL);
+    ParallelFor(nGrid, 16 * CKinematicChain::BLOCK_SIZE, nThreads, [&](size_t nBegin, size_t nEnd)
+    {
+        auto poTransforms = std::make_unique<CKinematicChain::SBlockTransforms>();
+        std::vector<double> vecAngles(CKinematicChain::BLOCK_SIZE * nAxes);
+        int anCollidingBox[CKinematicChain::BLOCK_SIZE];
+        unsigned int nBlockFeasible = 0;
+        std::vector<double> vecBlockMin(nAxes, HUGE_VAL);
+        std::vector<double> vecBlockMax(nAxes, -HUGE_VAL);
+        for (size_t nBlock = nBegin; nBlock < nEnd; nBlock += CKinematicChain::BLOCK_SIZE)
+        {
+            const size_t nBlockCount = std::min(CKinematicChain::BLOCK_SIZE, nEnd - nBlock);
+            for (size_t i = 0; i < nBlockCount; ++i)
+            {
+                size_t nIndex = nBlock + i;
+                for (size_t j = nAxes; j-- > 0;)
+                {
+                    vecAngles[i * nAxes + j] = vecStart[j] + vecStep[j] * static_cast<double>(nIndex % pnSteps[j]);
+                    nIndex /= pnSteps[j];
+                }
+            }
+            CheckCollisionBlock(*poChain, oBvh, vecAngles.data(), nBlockCount, *poTransforms, anCollidingBox);
+            for (size_t i = 0; i < nBlockCount; ++i)
+            {
+                const bool bFeasible = anCollidingBox[i] == -1;
+                if (pnFeasible)
+                {
+                    pnFeasible[nBlock + i] = bFeasible;
+                }
+                if (bFeasible)
+                {
+                    ++nBlockFeasible;
+                    for (size_t j = 0; j < nAxes; ++j)
+                    {
+                        vecBlockMin[j] = std::min(vecBlockMin[j], vecAngles[i * nAxes + j]);
+                        vecBlockMax[j] = std::max(vecBlockMax[j], vecAngles[i * nAxes + j]);
+                    }
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> oLock(oResultMutex);
+        nFeasibleCount += nBlockFeasible;
+        for (size_t j = 0; j < nAxes; ++j)
+        {
+            vecMin[j] = std::min(vecMin[j], vecBlockMin[j]);
+            vecMax[j] = std::max(vecMax[j], vecBlockMax[j]);
+        }
+    });
+
+    if (pdFeasibleRanges)
+    {
+        for (size_t j = 0; j < nAxes; ++j)
+        {
+            pdFeasibleRanges[2 * j] = nFeasibleCount > 0 ? vecMin[j] : std::numeric_limits<double>::quiet_NaN();
+            pdFeasibleRanges[2 * j + 1] = nFeasibleCount > 0 ? vecMax[j] : std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    if (pnFeasibleCount)
+    {
+        *pnFeasibleCount = nFeasibleCount;
+    }
+    return 0;
+}
+
+
+struct SFrameGraphEntry
+{
+    int m_nId;
+    std::shared_ptr<CFrameGraph> m_poGraph;
+};
+
+static std::mutex s_oGraphMutex;
+static std::vector<SFrameGraphEntry> s_vecFrameGraphs;
+static int s_nNextFrameGraphId = 1;
+
+
+static std::shared_ptr<CFrameGraph> FindFrameGraph(int nGraphId)
+{
+    std::lock_guard<std::mutex> oLock(s_oGraphMutex);
+    auto it = std::find_if(s_vecFrameGraphs.begin(), s_vecFrameGraphs.end(),
+        [nGraphId](const SFrameGraphEntry& roEntry) { return roEntry.m_nId == nGraphId; });
+    return it == s_vecFrameGraphs.end() ? nullptr : it->m_poGraph;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int CreateFrameGraph(int* pnGraphId)
+{
+    if (!pnGraphId)
+    {
+        return -1;
+    }
+    std::lock_guard<std::mutex> oLock(s_oGraphMutex);
+    *pnGraphId = s_nNextFrameGraphId++;
+    s_vecFrameGraphs.push_back({ *pnGraphId, std::make_shared<CFrameGraph>() });
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int DestroyFrameGraph(int nGraphId)
+{
+    std::lock_guard<std::mutex> oLock(s_oGraphMutex);
+    auto it = std::find_if(s_vecFrameGraphs.begin(), s_vecFrameGraphs.end(),
+        [nGraphId](const SFrameGraphEntry& roEntry) { return roEntry.m_nId == nGraphId; });
+    if (it == s_vecFrameGraphs.end())
+    {
+        return -2;
+    }
+    s_vecFrameGraphs.erase(it);
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int SetFrameTransformation(int nGraphId, const STransformation* poTransformation)
+{
+    if (!poTransformation || !poTransformation->m_pcSourceFrame || !poTransformation->m_pcTargetFrame)
+    {
+        return -1;
+    }
+    auto poGraph = FindFrameGraph(nGraphId);
+    if (!poGraph)
+    {
+        return -2;
+    }
+    return poGraph->SetTransformation(poTransformation->m_pcSourceFrame, poTransformation->m_pcTargetFrame, poTransformation->m_oHelmertTransfMatrix);
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int GetFrameTransformation(int nGraphId, const char* pcFrom, const char* pcTo, STransformationMatrix* poMatrix)
+{
+    if (!pcFrom || !pcTo || !poMatrix)
+    {
+        return -1;
+    }
+    auto poGraph = FindFrameGraph(nGraphId);
+    if (!poGraph)
+    {
+        return -2;
+    }
+    return poGraph->GetTransformation(pcFrom, pcTo, *poMatrix);
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int TransformPoints(
+    int nGraphId,
+    const char* pcFrom,
+    const char* pcTo,
+    unsigned int nCount,
+    const SPoint3D* poPointsIn,
+    SPoint3D* poPointsOut,
+    unsigned int nThreads)
+{
+    if (!pcFrom || !pcTo || !poPointsIn || !poPointsOut)
+    {
+        return -1;
+    }
+    auto poGraph = FindFrameGraph(nGraphId);
+    if (!poGraph)
+    {
+        return -2;
+    }
+    STransformationMatrix oMatrix;
+    const int nResult = poGraph->GetTransformation(pcFrom, pcTo, oMatrix);
+    if (nResult != 0)
+    {
+        return nResult;
+    }
+
+    const auto& m = oMatrix.m_adElement;
+    ParallelFor(nCount, 1 << 16, nThreads, [&](size_t nBegin, size_t nEnd)
+    {
+        for (size_t i = nBegin; i < nEnd; ++i)
+        {
+            const double dX = poPointsIn[i].m_dX;
+            const double dY = poPointsIn[i].m_dY;
+            const double dZ = poPointsIn[i].m_dZ;
+            poPointsOut[i].m_dX = m[0][0] * dX + m[0][1] * dY + m[0][2] * dZ + m[0][3];
+            poPointsOut[i].m_dY = m[1][0] * dX + m[1][1] * dY + m[1][2] * dZ + m[1][3];
+            poPointsOut[i].m_dZ = m[2][0] * dX + m[2][1] * dY + m[2][2] * dZ + m[2][3];
+        }
+    });
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int GetFrameGraphStats(
+    int nGraphId,
+    unsigned long long* pnHits,
+    unsigned long long* pnMisses,
+    unsigned long long* pnUpdates,
+    unsigned long long* pnProducts,
+    bool bReset)
+{
+    if (!pnHits || !pnMisses || !pnUpdates || !pnProducts)
+    {
+        return -1;
+    }
+    auto poGraph = FindFrameGraph(nGraphId);
+    if (!poGraph)
+    {
+        return -2;
+    }
+    const CFrameGraph::SStats oStats = poGraph->GetStats(bReset);
+    *pnHits = oStats.m_nHits;
+    *pnMisses = oStats.m_nMisses;
+    *pnUpdates = oStats.m_nUpdates;
+    *pnProducts = oStats.m_nProducts;
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int WritePlatformFile(
+    const char* pcPath,
+    const char* pcPlatformName,
+    unsigned int nInstruments,
+    const SInstrument* poInstruments,
+    unsigned int nTransformations,
+    const STransformation* poTransformations)
+{
+    if (!pcPath || (nInstruments > 0 && !poInstruments) || (nTransformations > 0 && !poTransformations))
+    {
+        return -1;
+    }
+    return WritePlatform(pcPath, pcPlatformName, nInstruments, poInstruments, nTransformations, poTransformations);
+}
+
+
+struct SPlatformFileEntry
+{
+    int m_nId;
+    std::shared_ptr<const CPlatformFile> m_poPlatform;
+};
+
+static std::mutex s_oPlatformMutex;
+static std::vector<SPlatformFileEntry> s_vecPlatformFiles;
+static int s_nNextPlatformFileId = 1;
+
+
+static std::shared_ptr<const CPlatformFile> FindPlatformFile(int nPlatformId)
+{
+    std::lock_guard<std::mutex> oLock(s_oPlatformMutex);
+    auto it = std::find_if(s_vecPlatformFiles.begin(), s_vecPlatformFiles.end(),
+        [nPlatformId](const SPlatformFileEntry& roEntry) { return roEntry.m_nId == nPlatformId; });
+    return it == s_vecPlatformFiles.end() ? nullptr : it->m_poPlatform;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int OpenPlatformFile(const char* pcPath, int* pnPlatformId)
+{
+    if (!pcPath || !pnPlatformId)
+    {
+        return -1;
+    }
+    auto poPlatform = std::make_shared<CPlatformFile>();
+    const int nResult = poPlatform->Open(pcPath);
+    if (nResult != 0)
+    {
+        return nResult;
+    }
+
+    std::lock_guard<std::mutex> oLock(s_oPlatformMutex);
+    *pnPlatformId = s_nNextPlatformFileId++;
+    s_vecPlatformFiles.push_back({ *pnPlatformId, std::move(poPlatform) });
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int ClosePlatformFile(int nPlatformId)
+{
+    std::lock_guard<std::mutex> oLock(s_oPlatformMutex);
+    auto it = std::find_if(s_vecPlatformFiles.begin(), s_vecPlatformFiles.end(),
+        [nPlatformId](const SPlatformFileEntry& roEntry) { return roEntry.m_nId == nPlatformId; });
+    if (it == s_vecPlatformFiles.end())
+    {
+        return -2;
+    }
+    s_vecPlatformFiles.erase(it);
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int GetPlatformName(int nPlatformId, const char** ppcName)
+{
+    if (!ppcName)
+    {
+        return -1;
+    }
+    auto poPlatform = FindPlatformFile(nPlatformId);
+    if (!poPlatform)
+    {
+        return -2;
+    }
+    *ppcName = poPlatform->Name();
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int GetPlatformInstruments(int nPlatformId, const SInstrument** ppoInstruments, unsigned int* pnCount)
+{
+    if (!ppoInstruments || !pnCount)
+    {
+        return -1;
+    }
+    auto poPlatform = FindPlatformFile(nPlatformId);
+    if (!poPlatform)
+    {
+        return -2;
+    }
+    *ppoInstruments = poPlatform->Instruments();
+    *pnCount = poPlatform->InstrumentCount();
+    return 0;
+}
+
+
+JR_PRO3D_EXTENSIONS_INSTRUMENTPLATFORMS_EXPORT
+int GetPlatformTransformations(int nPlatformId, const STransformation** ppoTransformations, unsigned int* pnCount)
+{
+    if (!ppoTransformations || !pnCount)
+    {
+        return -1;
+    }
+    auto poPlatform = FindPlatformFile(nPlatformId);
+    if (!poPlatform)
+    {
+        return -2;
+    }
+    *ppoTransformations = poPlatform->Transformations();
+    *pnCount = poPlatform->TransformationCount();
+    return 0;
+}
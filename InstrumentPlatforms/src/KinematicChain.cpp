@@ -0,0 +1,186 @@
+#include "KinematicChain.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+
+static constexpr double GON_TO_RAD = std::numbers::pi / 200.0;
+
+
+int CKinematicChain::Validate(const SInstrument& roInstrument)
+{
+    if (roInstrument.m_nNrOfInstrumentAxes == 0 || !roInstrument.m_poInstrumentAxes)
+    {
+        return -2;
+    }
+    for (unsigned int j = 0; j < roInstrument.m_nNrOfInstrumentAxes; ++j)
+    {
+        const SAxis* poAxis = roInstrument.m_poInstrumentAxes[j];
+        if (!poAxis)
+        {
+            return -2;
+        }
+        const double dX = poAxis->m_oEndPoint.m_dX - poAxis->m_oStartPoint.m_dX;
+        const double dY = poAxis->m_oEndPoint.m_dY - poAxis->m_oStartPoint.m_dY;
+        const double dZ = poAxis->m_oEndPoint.m_dZ - poAxis->m_oStartPoint.m_dZ;
+        if (dX * dX + dY * dY + dZ * dZ == 0.0 || !(poAxis->m_dMinAngle <= poAxis->m_dMaxAngle))
+        {
+            return -3;
+        }
+    }
+    return 0;
+}
+
+
+CKinematicChain::CKinematicChain(const SInstrument& roInstrument)
+    : m_oReference(roInstrument.m_oInstrumentExtrinsics)
+{
+    if (m_oReference.m_pcReferenceFrame)
+    {
+        m_sReferenceFrame = m_oReference.m_pcReferenceFrame;
+        m_oReference.m_pcReferenceFrame = m_sReferenceFrame.c_str();
+    }
+    m_vecAxes.reserve(roInstrument.m_nNrOfInstrumentAxes);
+    for (unsigned int j = 0; j < roInstrument.m_nNrOfInstrumentAxes; ++j)
+    {
+        const SAxis& roAxis = *roInstrument.m_poInstrumentAxes[j];
+        const double adQ[3] = { roAxis.m_oStartPoint.m_dX, roAxis.m_oStartPoint.m_dY, roAxis.m_oStartPoint.m_dZ };
+        double adW[3] = { roAxis.m_oEndPoint.m_dX - adQ[0], roAxis.m_oEndPoint.m_dY - adQ[1], roAxis.m_oEndPoint.m_dZ - adQ[2] };
+        const double dLength = std::sqrt(adW[0] * adW[0] + adW[1] * adW[1] + adW[2] * adW[2]);
+        for (double& rdW : adW)
+        {
+            rdW /= dLength;
+        }
+
+        SAxisTerms oTerms;
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                oTerms.m_adP[3 * r + c] = adW[r] * adW[c];
+                oTerms.m_adQ[3 * r + c] = (r == c ? 1.0 : 0.0) - adW[r] * adW[c];
+            }
+        }
+        const double adK[9] = {
+            0.0, -adW[2], adW[1],
+            adW[2], 0.0, -adW[0],
+            -adW[1], adW[0], 0.0 };
+        std::copy(adK, adK + 9, oTerms.m_adK);
+        for (int r = 0; r < 3; ++r)
+        {
+            oTerms.m_adQq[r] = oTerms.m_adQ[3 * r] * adQ[0] + oTerms.m_adQ[3 * r + 1] * adQ[1] + oTerms.m_adQ[3 * r + 2] * adQ[2];
+            oTerms.m_adKq[r] = adK[3 * r] * adQ[0] + adK[3 * r + 1] * adQ[1] + adK[3 * r + 2] * adQ[2];
+        }
+        oTerms.m_dCurrentAngle = roAxis.m_dCurrentAngle;
+        oTerms.m_dMinAngle = roAxis.m_dMinAngle;
+        oTerms.m_dMaxAngle = roAxis.m_dMaxAngle;
+        m_vecAxes.push_back(oTerms);
+    }
+}
+
+
+void CKinematicChain::EvaluateBlock(const double* pdAngles, size_t nCount, SBlockTransforms& roTransforms, int* pnStatus) const
+{
+    const size_t nAxes = m_vecAxes.size();
+    alignas(64) double adCos[BLOCK_SIZE];
+    alignas(64) double adSin[BLOCK_SIZE];
+    alignas(64) int anStatus[BLOCK_SIZE] = {};
+
+    double (&adR)[9][BLOCK_SIZE] = roTransforms.m_adR;
+    double (&adT)[3][BLOCK_SIZE] = roTransforms.m_adT;
+    for (int e = 0; e < 9; ++e)
+    {
+        std::fill(adR[e], adR[e] + nCount, (e % 4 == 0) ? 1.0 : 0.0);
+    }
+    for (int e = 0; e < 3; ++e)
+    {
+        std::fill(adT[e], adT[e] + nCount, 0.0);
+    }
+
+    for (size_t j = 0; j < nAxes; ++j)
+    {
+        const SAxisTerms& roAxis = m_vecAxes[j];
+        for (size_t k = 0; k < nCount; ++k)
+        {
+            const double dAngle = pdAngles[k * nAxes + j];
+            // NaN passes std::clamp() unchanged and makes the whole pose NaN
+            const double dClamped = std::clamp(dAngle, roAxis.m_dMinAngle, roAxis.m_dMaxAngle);
+            anStatus[k] = std::max(anStatus[k], std::isnan(dAngle) ? 2 : static_cast<int>(dClamped != dAngle));
+            const double dDelta = (dClamped - roAxis.m_dCurrentAngle) * GON_TO_RAD;
+            adCos[k] = std::cos(dDelta);
+            adSin[k] = std::sin(dDelta);
+        }
+
+        // (R, t) = (R, t) * (R_j, t_j) = (R * R_j, R * t_j + t)
+        const double* pdP = roAxis.m_adP;
+        const double* pdQ = roAxis.m_adQ;
+        const double* pdK = roAxis.m_adK;
+        for (size_t k = 0; k < nCount; ++k)
+        {
+            const double dC = adCos[k];
+            const double dS = adSin[k];
+            double adRj[9];
+            for (int e = 0; e < 9; ++e)
+            {
+                adRj[e] = pdP[e] + dC * pdQ[e] + dS * pdK[e];
+            }
+            double adTj[3];
+            for (int e = 0; e < 3; ++e)
+            {
+                adTj[e] = (1.0 - dC) * roAxis.m_adQq[e] - dS * roAxis.m_adKq[e];
+            }
+
+            double adRow[3];
+            for (int r = 0; r < 3; ++r)
+            {
+                adRow[0] = adR[3 * r][k];
+                adRow[1] = adR[3 * r + 1][k];
+                adRow[2] = adR[3 * r + 2][k];
+                adT[r][k] += adRow[0] * adTj[0] + adRow[1] * adTj[1] + adRow[2] * adTj[2];
+                for (int c = 0; c < 3; ++c)
+                {
+                    adR[3 * r + c][k] = adRow[0] * adRj[c] + adRow[1] * adRj[3 + c] + adRow[2] * adRj[6 + c];
+                }
+            }
+        }
+    }
+
+    if (pnStatus)
+    {
+        std::copy(anStatus, anStatus + nCount, pnStatus);
+    }
+}
+
+
+void CKinematicChain::TransformExtrinsics(const SBlockTransforms& roTransforms, size_t i, SInstrumentExtrinsics& roExtrinsics) const
+{
+    const auto& adR = roTransforms.m_adR;
+    const auto& adT = roTransforms.m_adT;
+    auto fnRotate = [&](double dX, double dY, double dZ, double& rdX, double& rdY, double& rdZ)
+    {
+        rdX = adR[0][i] * dX + adR[1][i] * dY + adR[2][i] * dZ;
+        rdY = adR[3][i] * dX + adR[4][i] * dY + adR[5][i] * dZ;
+        rdZ = adR[6][i] * dX + adR[7][i] * dY + adR[8][i] * dZ;
+    };
+    auto fnPoint = [&](const SPoint3D& roIn, SPoint3D& roOut)
+    {
+        fnRotate(roIn.m_dX, roIn.m_dY, roIn.m_dZ, roOut.m_dX, roOut.m_dY, roOut.m_dZ);
+        roOut.m_dX += adT[0][i];
+        roOut.m_dY += adT[1][i];
+        roOut.m_dZ += adT[2][i];
+    };
+    auto fnVector = [&](const SVector3D& roIn, SVector3D& roOut)
+    {
+        fnRotate(roIn.m_dX, roIn.m_dY, roIn.m_dZ, roOut.m_dX, roOut.m_dY, roOut.m_dZ);
+    };
+
+    roExtrinsics.m_pcReferenceFrame = m_oReference.m_pcReferenceFrame;
+    fnPoint(m_oReference.m_oPosition, roExtrinsics.m_oPosition);
+    fnVector(m_oReference.m_oLookAt, roExtrinsics.m_oLookAt);
+    fnVector(m_oReference.m_oUp, roExtrinsics.m_oUp);
+    fnPoint(m_oReference.m_oBoundingBox.m_oOriginBB, roExtrinsics.m_oBoundingBox.m_oOriginBB);
+    fnVector(m_oReference.m_oBoundingBox.m_oEdge1, roExtrinsics.m_oBoundingBox.m_oEdge1);
+    fnVector(m_oReference.m_oBoundingBox.m_oEdge2, roExtrinsics.m_oBoundingBox.m_oEdge2);
+    fnVector(m_oReference.m_oBoundingBox.m_oEdge3, roExtrinsics.m_oBoundingBox.m_oEdge3);
+}
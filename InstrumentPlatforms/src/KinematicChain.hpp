@@ -0,0 +1,76 @@
+#ifndef JR_PRO3D_EXTENSIONS_KINEMATICCHAIN_HPP
+#define JR_PRO3D_EXTENSIONS_KINEMATICCHAIN_HPP
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/** Serial chain of rotation axes, evaluated as product of exponentials:
+  *
+  *     T(a) = T_0(a_0 - c_0) * T_1(a_1 - c_1) * ... * T_n-1(a_n-1 - c_n-1)
+  *
+  * T_j(d) rotates by d around axis j as given in the reference pose (current angles c_j), so
+  * axis j is moved by all axes before it. With the unit direction w and start point q of an
+  * axis, the rotation is R = w*w^T + cos(d) * (I - w*w^T) + sin(d) * [w]x and the translation
+  * t = (I - R) * q; these terms are precomputed per axis.
+  *
+  * Configurations are evaluated in blocks of BLOCK_SIZE, stored as structure of arrays so the
+  * loops over the configurations of a block vectorize.
+  **/
+
+class CKinematicChain
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    /** Rigid transformations of a block of configurations: p' = R * p + t, R row-major. **/
+    struct SBlockTransforms
+    {
+        alignas(64) double m_adR[9][BLOCK_SIZE];
+        alignas(64) double m_adT[3][BLOCK_SIZE];
+    };
+
+    /** Returns 0, -2 or -3 like CreateKinematicChain(). **/
+    static int Validate(const SInstrument& roInstrument);
+
+    /** roInstrument must have passed Validate(). **/
+    explicit CKinematicChain(const SInstrument& roInstrument);
+
+    CKinematicChain(const CKinematicChain&) = delete;
+    CKinematicChain& operator=(const CKinematicChain&) = delete;
+
+    size_t AxisCount() const { return m_vecAxes.size(); }
+    double GetCurrentAngle(size_t j) const { return m_vecAxes[j].m_dCurrentAngle; }
+    void GetAxisLimits(size_t j, double& rdMin, double& rdMax) const { rdMin = m_vecAxes[j].m_dMinAngle; rdMax = m_vecAxes[j].m_dMaxAngle; }
+    const SInstrumentExtrinsics& Reference() const { return m_oReference; }
+
+    /** Transformations of nCount <= BLOCK_SIZE configurations (AxisCount() angles each, gon).
+      * pnStatus (can be nullptr) receives the per-configuration states of EvaluateKinematicChain().
+      **/
+    void EvaluateBlock(const double* pdAngles, size_t nCount, SBlockTransforms& roTransforms, int* pnStatus) const;
+
+    /** The reference extrinsics moved by transformation i of a block. **/
+    void TransformExtrinsics(const SBlockTransforms& roTransforms, size_t i, SInstrumentExtrinsics& roExtrinsics) const;
+
+private:
+    struct SAxisTerms
+    {
+        double m_adP[9];            // w*w^T
+        double m_adQ[9];            // I - w*w^T
+        double m_adK[9];            // [w]x
+        double m_adQq[3];           // (I - w*w^T) * q
+        double m_adKq[3];           // w x q
+        double m_dCurrentAngle;     // [gon]
+        double m_dMinAngle;         // [gon]
+        double m_dMaxAngle;         // [gon]
+    };
+
+    std::vector<SAxisTerms> m_vecAxes;
+    std::string m_sReferenceFrame;
+    SInstrumentExtrinsics m_oReference;     // m_pcReferenceFrame points to m_sReferenceFrame
+};
+
+#endif // JR_PRO3D_EXTENSIONS_KINEMATICCHAIN_HPP
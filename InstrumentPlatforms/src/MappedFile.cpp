@@ -0,0 +1,117 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+CMappedFile::~CMappedFile()
+{
+    Close();
+}
+
+
+#ifdef _WIN32
+
+bool CMappedFile::Open(const std::string& rsPath)
+{
+    Close();
+    HANDLE hFile = CreateFileA(rsPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER oSize;
+    if (!GetFileSizeEx(hFile, &oSize))
+    {
+        CloseHandle(hFile);
+        return false;
+    }
+    m_hFile = hFile;
+    m_nSize = static_cast<size_t>(oSize.QuadPart);
+    if (m_nSize == 0)
+    {
+        return true;
+    }
+    m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    m_pData = m_hMapping ? static_cast<std::byte*>(MapViewOfFile(m_hMapping, FILE_MAP_COPY, 0, 0, 0)) : nullptr;
+    if (!m_pData)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+
+void CMappedFile::Close()
+{
+    if (m_pData)
+    {
+        UnmapViewOfFile(m_pData);
+    }
+    if (m_hMapping)
+    {
+        CloseHandle(m_hMapping);
+    }
+    if (m_hFile)
+    {
+        CloseHandle(m_hFile);
+    }
+    m_pData = nullptr;
+    m_hMapping = nullptr;
+    m_hFile = nullptr;
+    m_nSize = 0;
+}
+
+#else
+
+bool CMappedFile::Open(const std::string& rsPath)
+{
+    Close();
+    const int nFile = open(rsPath.c_str(), O_RDONLY);
+    if (nFile < 0)
+    {
+        return false;
+    }
+    struct stat oStat;
+    if (fstat(nFile, &oStat) != 0)
+    {
+        close(nFile);
+        return false;
+    }
+    m_nSize = static_cast<size_t>(oStat.st_size);
+    if (m_nSize > 0)
+    {
+        void* pData = mmap(nullptr, m_nSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, nFile, 0);
+        m_pData = pData == MAP_FAILED ? nullptr : static_cast<std::byte*>(pData);
+    }
+    // the mapping stays valid after closing the descriptor
+    close(nFile);
+    if (m_nSize > 0 && !m_pData)
+    {
+        m_nSize = 0;
+        return false;
+    }
+    return true;
+}
+
+
+void CMappedFile::Close()
+{
+    if (m_pData)
+    {
+        munmap(m_pData, m_nSize);
+    }
+    m_pData = nullptr;
+    m_nSize = 0;
+}
+
+#endif
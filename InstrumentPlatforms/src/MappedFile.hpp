@@ -0,0 +1,36 @@
+#ifndef JR_PRO3D_EXTENSIONS_MAPPEDFILE_HPP
+#define JR_PRO3D_EXTENSIONS_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+
+/** Copy-on-write memory mapping of a whole file (mmap / MapViewOfFile). Writes to the mapped
+  * pages are private to the process and never reach the file.
+  **/
+class CMappedFile
+{
+public:
+    CMappedFile() = default;
+    ~CMappedFile();
+
+    CMappedFile(const CMappedFile&) = delete;
+    CMappedFile& operator=(const CMappedFile&) = delete;
+
+    /** Returns false if the file cannot be opened or mapped. Empty files map to Size() == 0. **/
+    bool Open(const std::string& rsPath);
+    void Close();
+
+    std::byte* Data() const { return m_pData; }
+    size_t Size() const { return m_nSize; }
+
+private:
+    std::byte* m_pData = nullptr;
+    size_t m_nSize = 0;
+#ifdef _WIN32
+    void* m_hFile = nullptr;
+    void* m_hMapping = nullptr;
+#endif
+};
+
+#endif // JR_PRO3D_EXTENSIONS_MAPPEDFILE_HPP
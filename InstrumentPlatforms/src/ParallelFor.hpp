@@ -0,0 +1,55 @@
+#ifndef JR_PRO3D_EXTENSIONS_PARALLELFOR_HPP
+#define JR_PRO3D_EXTENSIONS_PARALLELFOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+/** Number of threads for nBlocks blocks of work, nThreads = 0 uses all hardware threads. **/
+inline unsigned int ThreadCount(size_t nBlocks, unsigned int nThreads)
+{
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return static_cast<unsigned int>(std::min<size_t>(nThreads, std::max<size_t>(nBlocks, 1)));
+}
+
+
+/** Calls fnBlock(nBegin, nEnd) for consecutive blocks of nBlockSize items of [0, nCount).
+  * Blocks are handed out to up to nThreads threads (see ThreadCount()) in ascending order; the
+  * calling thread is one of them.
+  **/
+template <typename F>
+void ParallelFor(size_t nCount, size_t nBlockSize, unsigned int nThreads, F&& fnBlock)
+{
+    const size_t nBlocks = (nCount + nBlockSize - 1) / nBlockSize;
+    nThreads = ThreadCount(nBlocks, nThreads);
+
+    std::atomic<size_t> nNextBlock{0};
+    auto fnWorker = [&]()
+    {
+        for (size_t nBlock = nNextBlock++; nBlock < nBlocks; nBlock = nNextBlock++)
+        {
+            const size_t nBegin = nBlock * nBlockSize;
+            fnBlock(nBegin, std::min(nBegin + nBlockSize, nCount));
+        }
+    };
+
+    std::vector<std::thread> vecThreads;
+    vecThreads.reserve(nThreads - 1);
+    for (unsigned int i = 1; i < nThreads; ++i)
+    {
+        vecThreads.emplace_back(fnWorker);
+    }
+    fnWorker();
+    for (auto& roThread : vecThreads)
+    {
+        roThread.join();
+    }
+}
+
+#endif // JR_PRO3D_EXTENSIONS_PARALLELFOR_HPP
@@ -0,0 +1,365 @@
+#include "PlatformFile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+
+static const char s_acMagic[8] = { 'I', 'P', 'L', 'A', 'T', 'F', '\0', '\0' };
+static constexpr uint32_t PLATFORM_FILE_VERSION = 1;
+static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+static_assert(sizeof(SPlatformFileHeader) == 112 && sizeof(SPlatformFileInstrument) == 264
+    && sizeof(SPlatformFileAxis) == 88 && sizeof(SPlatformFileTransformation) == 152,
+    "platform file records must not contain padding");
+
+
+// Name of the file written before it replaces rsPath (pid and random suffix).
+static std::string TempPathFor(const std::string& rsPath)
+{
+#ifdef _WIN32
+    const unsigned long nPid = GetCurrentProcessId();
+#else
+    const unsigned long nPid = static_cast<unsigned long>(getpid());
+#endif
+    return rsPath + ".tmp." + std::to_string(nPid) + "." + std::to_string(std::random_device()());
+}
+
+
+// rename() replaces atomically on POSIX, Windows needs MoveFileEx() for that.
+static bool ReplaceFileWith(const std::string& rsTempPath, const std::string& rsPath)
+{
+#ifdef _WIN32
+    return MoveFileExA(rsTempPath.c_str(), rsPath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(rsTempPath.c_str(), rsPath.c_str()) == 0;
+#endif
+}
+
+
+static size_t Align8(size_t nOffset)
+{
+    return (nOffset + 7) & ~static_cast<size_t>(7);
+}
+
+
+namespace
+{
+    // String table with deduplication; instrument catalogues repeat frame names a lot.
+    class CStringTable
+    {
+    public:
+        uint64_t Add(const char* pcString)
+        {
+            if (!pcString)
+            {
+                return NO_STRING;
+            }
+            auto it = m_mapOffsets.find(pcString);
+            if (it != m_mapOffsets.end())
+            {
+                return it->second;
+            }
+            const uint64_t nOffset = m_vecData.size();
+            m_vecData.insert(m_vecData.end(), pcString, pcString + std::strlen(pcString) + 1);
+            m_mapOffsets.emplace(pcString, nOffset);
+            return nOffset;
+        }
+
+        const std::vector<char>& Data() const { return m_vecData; }
+
+    private:
+        std::vector<char> m_vecData;
+        std::unordered_map<std::string, uint64_t> m_mapOffsets;
+    };
+
+
+    template <typename T>
+    void AppendSection(std::vector<char>& rvecFile, uint64_t& rnOffset, const std::vector<T>& rvecRecords)
+    {
+        rvecFile.resize(Align8(rvecFile.size()));
+        rnOffset = rvecFile.size();
+        const char* pcData = reinterpret_cast<const char*>(rvecRecords.data());
+        rvecFile.insert(rvecFile.end(), pcData, pcData + rvecRecords.size() * sizeof(T));
+    }
+}
+
+
+int WritePlatform(const std::string& rsPath, const char* pcName, unsigned int nInstruments, const SInstrument* poInstruments,
+    unsigned int nTransformations, const STransformation* poTransformations)
+{
+    CStringTable oStrings;
+    std::vector<SPlatformFileInstrument> vecInstruments;
+    std::vector<SPlatformFileAxis> vecAxes;
+    std::vector<uint32_t> vecAxisRefs;
+    std::vector<double> vecFocalLengths;
+    std::vector<SPlatformFileTransformation> vecTransformations;
+    std::unordered_map<const SAxis*, uint32_t> mapAxisIndex;   // axes are shared between instruments
+
+    for (unsigned int i = 0; i < nInstruments; ++i)
+    {
+        const SInstrument& roInstrument = poInstruments[i];
+        if ((roInstrument.m_nNrOfCalibratedFocalLengths > 0 && !roInstrument.m_pdCalibratedFocalLengths)
+            || (roInstrument.m_nNrOfInstrumentAxes > 0 && !roInstrument.m_poInstrumentAxes))
+        {
+            return -3;
+        }
+
+        SPlatformFileInstrument oRecord{};
+        oRecord.m_nName = oStrings.Add(roInstrument.m_pcInstrumentName);
+        oRecord.m_nReferenceFrame = oStrings.Add(roInstrument.m_oInstrumentExtrinsics.m_pcReferenceFrame);
+        const SInstrumentIntrinsics& roIntrinsics = roInstrument.m_oCurrentInstrumentIntrinsics;
+        oRecord.m_nResolutionH = roIntrinsics.m_nResolutionH;
+        oRecord.m_nResolutionV = roIntrinsics.m_nResolutionV;
+        const double adIntrinsics[6] = { roIntrinsics.m_dFieldOfViewH, roIntrinsics.m_dFieldOfViewV, roIntrinsics.m_dPrinciplePointH,
+            roIntrinsics.m_dPrinciplePointV, roIntrinsics.m_dFocalLengthInPxH, roIntrinsics.m_dFocalLengthInPxV };
+        std::copy(adIntrinsics, adIntrinsics + 6, oRecord.m_adIntrinsics);
+        const SInstrumentExtrinsics& roExtrinsics = roInstrument.m_oInstrumentExtrinsics;
+        const SBoundingBox& roBox = roExtrinsics.m_oBoundingBox;
+        const double adExtrinsics[21] = {
+            roExtrinsics.m_oPosition.m_dX, roExtrinsics.m_oPosition.m_dY, roExtrinsics.m_oPosition.m_dZ,
+            roExtrinsics.m_oLookAt.m_dX, roExtrinsics.m_oLookAt.m_dY, roExtrinsics.m_oLookAt.m_dZ,
+            roExtrinsics.m_oUp.m_dX, roExtrinsics.m_oUp.m_dY, roExtrinsics.m_oUp.m_dZ,
+            roBox.m_oOriginBB.m_dX, roBox.m_oOriginBB.m_dY, roBox.m_oOriginBB.m_dZ,
+            roBox.m_oEdge1.m_dX, roBox.m_oEdge1.m_dY, roBox.m_oEdge1.m_dZ,
+            roBox.m_oEdge2.m_dX, roBox.m_oEdge2.m_dY, roBox.m_oEdge2.m_dZ,
+            roBox.m_oEdge3.m_dX, roBox.m_oEdge3.m_dY, roBox.m_oEdge3.m_dZ };
+        std::copy(adExtrinsics, adExtrinsics + 21, oRecord.m_adExtrinsics);
+        oRecord.m_dCurrentFocalLengthInMm = roInstrument.m_dCurrentFocalLengthInMm;
+
+        oRecord.m_nFirstFocalLength = static_cast<uint32_t>(vecFocalLengths.size());
+        oRecord.m_nFocalLengths = roInstrument.m_nNrOfCalibratedFocalLengths;
+        vecFocalLengths.insert(vecFocalLengths.end(), roInstrument.m_pdCalibratedFocalLengths,
+            roInstrument.m_pdCalibratedFocalLengths + roInstrument.m_nNrOfCalibratedFocalLengths);
+
+        oRecord.m_nFirstAxisRef = static_cast<uint32_t>(vecAxisRefs.size());
+        oRecord.m_nAxisRefs = roInstrument.m_nNrOfInstrumentAxes;
+        for (unsigned int j = 0; j < roInstrument.m_nNrOfInstrumentAxes; ++j)
+        {
+            const SAxis* poAxis = roInstrument.m_poInstrumentAxes[j];
+            if (!poAxis)
+            {
+                return -3;
+            }
+            auto it = mapAxisIndex.find(poAxis);
+            if (it == mapAxisIndex.end())
+            {
+                SPlatformFileAxis oAxis{};
+                oAxis.m_nAxisId = oStrings.Add(poAxis->m_pcAxisId);
+                oAxis.m_nAxisDescription = oStrings.Add(poAxis->m_pcAxisDescription);
+                const double adStart[3] = { poAxis->m_oStartPoint.m_dX, poAxis->m_oStartPoint.m_dY, poAxis->m_oStartPoint.m_dZ };
+                const double adEnd[3] = { poAxis->m_oEndPoint.m_dX, poAxis->m_oEndPoint.m_dY, poAxis->m_oEndPoint.m_dZ };
+                std::copy(adStart, adStart + 3, oAxis.m_adStartPoint);
+                std::copy(adEnd, adEnd + 3, oAxis.m_adEndPoint);
+                oAxis.m_dMinAngle = poAxis->m_dMinAngle;
+                oAxis.m_dMaxAngle = poAxis->m_dMaxAngle;
+                oAxis.m_dCurrentAngle = poAxis->m_dCurrentAngle;
+                it = mapAxisIndex.emplace(poAxis, static_cast<uint32_t>(vecAxes.size())).first;
+                vecAxes.push_back(oAxis);
+            }
+            vecAxisRefs.push_back(it->second);
+        }
+        vecInstruments.push_back(oRecord);
+    }
+
+    for (unsigned int i = 0; i < nTransformations; ++i)
+    {
+        const STransformation& roTransformation = poTransformations[i];
+        SPlatformFileTransformation oRecord{};
+        oRecord.m_nName = oStrings.Add(roTransformation.m_pcTransfName);
+        oRecord.m_nSourceFrame = oStrings.Add(roTransformation.m_pcSourceFrame);
+        oRecord.m_nTargetFrame = oStrings.Add(roTransformation.m_pcTargetFrame);
+        std::memcpy(oRecord.m_adMatrix, roTransformation.m_oHelmertTransfMatrix.m_adElement, sizeof(oRecord.m_adMatrix));
+        vecTransformations.push_back(oRecord);
+    }
+
+    SPlatformFileHeader oHeader{};
+    std::memcpy(oHeader.m_acMagic, s_acMagic, sizeof(s_acMagic));
+    oHeader.m_nVersion = PLATFORM_FILE_VERSION;
+    oHeader.m_nByteOrder = BYTE_ORDER_MARK;
+    oHeader.m_nName = oStrings.Add(pcName);
+    oHeader.m_nInstruments = static_cast<uint32_t>(vecInstruments.size());
+    oHeader.m_nAxes = static_cast<uint32_t>(vecAxes.size());
+    oHeader.m_nAxisRefs = static_cast<uint32_t>(vecAxisRefs.size());
+    oHeader.m_nTransformations = static_cast<uint32_t>(vecTransformations.size());
+    oHeader.m_nFocalLengths = static_cast<uint32_t>(vecFocalLengths.size());
+
+    std::vector<char> vecFile(sizeof(SPlatformFileHeader));
+    AppendSection(vecFile, oHeader.m_nInstrumentsOffset, vecInstruments);
+    AppendSection(vecFile, oHeader.m_nAxesOffset, vecAxes);
+    AppendSection(vecFile, oHeader.m_nAxisRefsOffset, vecAxisRefs);
+    AppendSection(vecFile, oHeader.m_nTransformationsOffset, vecTransformations);
+    AppendSection(vecFile, oHeader.m_nFocalLengthsOffset, vecFocalLengths);
+    AppendSection(vecFile, oHeader.m_nStringsOffset, oStrings.Data());
+    oHeader.m_nStringsSize = oStrings.Data().size();
+    oHeader.m_nFileSize = vecFile.size();
+    std::memcpy(vecFile.data(), &oHeader, sizeof(oHeader));
+
+    // readers map either the old or the new file, never a partially written one
+    const std::string sTempPath = TempPathFor(rsPath);
+    {
+        std::ofstream oFile(sTempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        oFile.write(vecFile.data(), static_cast<std::streamsize>(vecFile.size()));
+        if (!oFile.flush())
+        {
+            oFile.close();
+            std::remove(sTempPath.c_str());
+            return -2;
+        }
+    }
+    if (!ReplaceFileWith(sTempPath, rsPath))
+    {
+        std::remove(sTempPath.c_str());
+        return -2;
+    }
+    return 0;
+}
+
+
+namespace
+{
+    // Bounds-checked access to the sections of a mapped file.
+    class CPlatformFileView
+    {
+    public:
+        CPlatformFileView(std::byte* pData, size_t nSize) : m_pData(pData), m_nSize(nSize) {}
+
+        template <typename T>
+        T* Section(uint64_t nOffset, uint64_t nCount) const
+        {
+            if (nOffset % alignof(T) != 0 || nOffset > m_nSize || nCount > (m_nSize - nOffset) / sizeof(T))
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<T*>(m_pData + nOffset);
+        }
+
+    private:
+        std::byte* m_pData;
+        size_t m_nSize;
+    };
+}
+
+
+int CPlatformFile::Open(const std::string& rsPath)
+{
+    if (!m_oFile.Open(rsPath))
+    {
+        return -2;
+    }
+
+    SPlatformFileHeader oHeader;
+    if (m_oFile.Size() < sizeof(oHeader))
+    {
+        return -3;
+    }
+    std::memcpy(&oHeader, m_oFile.Data(), sizeof(oHeader));
+    if (std::memcmp(oHeader.m_acMagic, s_acMagic, sizeof(s_acMagic)) != 0 || oHeader.m_nVersion != PLATFORM_FILE_VERSION
+        || oHeader.m_nByteOrder != BYTE_ORDER_MARK || oHeader.m_nFileSize != m_oFile.Size())
+    {
+        return -3;
+    }
+
+    const CPlatformFileView oView(m_oFile.Data(), m_oFile.Size());
+    const auto* poInstruments = oView.Section<const SPlatformFileInstrument>(oHeader.m_nInstrumentsOffset, oHeader.m_nInstruments);
+    const auto* poAxes = oView.Section<const SPlatformFileAxis>(oHeader.m_nAxesOffset, oHeader.m_nAxes);
+    const auto* pnAxisRefs = oView.Section<const uint32_t>(oHeader.m_nAxisRefsOffset, oHeader.m_nAxisRefs);
+    const auto* poTransformations = oView.Section<const SPlatformFileTransformation>(oHeader.m_nTransformationsOffset, oHeader.m_nTransformations);
+    auto* pdFocalLengths = oView.Section<double>(oHeader.m_nFocalLengthsOffset, oHeader.m_nFocalLengths);
+    const auto* pcStrings = oView.Section<const char>(oHeader.m_nStringsOffset, oHeader.m_nStringsSize);
+    if (!poInstruments || !poAxes || !pnAxisRefs || !poTransformations || !pdFocalLengths || !pcStrings
+        || (oHeader.m_nStringsSize > 0 && pcStrings[oHeader.m_nStringsSize - 1] != '\0'))
+    {
+        return -3;
+    }
+
+    bool bValid = true;
+    auto fnString = [&](uint64_t nOffset) -> const char*
+    {
+        if (nOffset == NO_STRING)
+        {
+            return nullptr;
+        }
+        bValid &= nOffset < oHeader.m_nStringsSize;
+        return bValid ? pcStrings + nOffset : nullptr;
+    };
+
+    // One arena block for all C structs: instruments, axes, axis pointer lists, transformations.
+    const size_t nInstrumentsOffset = 0;
+    const size_t nAxesOffset = Align8(nInstrumentsOffset + oHeader.m_nInstruments * sizeof(SInstrument));
+    const size_t nAxisRefsOffset = Align8(nAxesOffset + oHeader.m_nAxes * sizeof(SAxis));
+    const size_t nTransformationsOffset = Align8(nAxisRefsOffset + oHeader.m_nAxisRefs * sizeof(SAxis*));
+    const size_t nArenaSize = nTransformationsOffset + oHeader.m_nTransformations * sizeof(STransformation);
+    m_pArena = std::make_unique_for_overwrite<std::byte[]>(std::max<size_t>(nArenaSize, 1));
+    m_poInstruments = reinterpret_cast<SInstrument*>(m_pArena.get() + nInstrumentsOffset);
+    SAxis* poArenaAxes = reinterpret_cast<SAxis*>(m_pArena.get() + nAxesOffset);
+    SAxis** ppoArenaAxisRefs = reinterpret_cast<SAxis**>(m_pArena.get() + nAxisRefsOffset);
+    m_poTransformations = reinterpret_cast<STransformation*>(m_pArena.get() + nTransformationsOffset);
+
+    for (uint32_t i = 0; i < oHeader.m_nAxes; ++i)
+    {
+        const SPlatformFileAxis& roRecord = poAxes[i];
+        const double* pdS = roRecord.m_adStartPoint;
+        const double* pdE = roRecord.m_adEndPoint;
+        new (poArenaAxes + i) SAxis{ fnString(roRecord.m_nAxisId), fnString(roRecord.m_nAxisDescription),
+            { pdS[0], pdS[1], pdS[2] }, { pdE[0], pdE[1], pdE[2] }, roRecord.m_dMinAngle, roRecord.m_dMaxAngle, roRecord.m_dCurrentAngle };
+    }
+    for (uint32_t i = 0; i < oHeader.m_nAxisRefs; ++i)
+    {
+        bValid &= pnAxisRefs[i] < oHeader.m_nAxes;
+        ppoArenaAxisRefs[i] = bValid ? poArenaAxes + pnAxisRefs[i] : nullptr;
+    }
+    for (uint32_t i = 0; i < oHeader.m_nInstruments; ++i)
+    {
+        const SPlatformFileInstrument& roRecord = poInstruments[i];
+        bValid &= roRecord.m_nFirstFocalLength <= oHeader.m_nFocalLengths
+            && roRecord.m_nFocalLengths <= oHeader.m_nFocalLengths - roRecord.m_nFirstFocalLength
+            && roRecord.m_nFirstAxisRef <= oHeader.m_nAxisRefs
+            && roRecord.m_nAxisRefs <= oHeader.m_nAxisRefs - roRecord.m_nFirstAxisRef;
+        if (!bValid)
+        {
+            break;
+        }
+        const double* pdI = roRecord.m_adIntrinsics;
+        const double* pdX = roRecord.m_adExtrinsics;
+        new (m_poInstruments + i) SInstrument{
+            fnString(roRecord.m_nName),
+            roRecord.m_nFocalLengths,
+            roRecord.m_nFocalLengths > 0 ? pdFocalLengths + roRecord.m_nFirstFocalLength : nullptr,
+            roRecord.m_dCurrentFocalLengthInMm,
+            { roRecord.m_nResolutionH, roRecord.m_nResolutionV, pdI[0], pdI[1], pdI[2], pdI[3], pdI[4], pdI[5] },
+            { fnString(roRecord.m_nReferenceFrame), { pdX[0], pdX[1], pdX[2] }, { pdX[3], pdX[4], pdX[5] }, { pdX[6], pdX[7], pdX[8] },
+                { { pdX[9], pdX[10], pdX[11] }, { pdX[12], pdX[13], pdX[14] }, { pdX[15], pdX[16], pdX[17] }, { pdX[18], pdX[19], pdX[20] } } },
+            roRecord.m_nAxisRefs,
+            roRecord.m_nAxisRefs > 0 ? ppoArenaAxisRefs + roRecord.m_nFirstAxisRef : nullptr };
+    }
+    for (uint32_t i = 0; i < oHeader.m_nTransformations && bValid; ++i)
+    {
+        const SPlatformFileTransformation& roRecord = poTransformations[i];
+        STransformation* poTransformation = new (m_poTransformations + i) STransformation{
+            fnString(roRecord.m_nName), fnString(roRecord.m_nSourceFrame), fnString(roRecord.m_nTargetFrame), {} };
+        std::memcpy(poTransformation->m_oHelmertTransfMatrix.m_adElement, roRecord.m_adMatrix, sizeof(roRecord.m_adMatrix));
+    }
+    m_pcName = fnString(oHeader.m_nName);
+    if (!bValid)
+    {
+        return -3;
+    }
+
+    m_nInstruments = oHeader.m_nInstruments;
+    m_nTransformations = oHeader.m_nTransformations;
+    return 0;
+}
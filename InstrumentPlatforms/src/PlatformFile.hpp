@@ -0,0 +1,112 @@
+#ifndef JR_PRO3D_EXTENSIONS_PLATFORMFILE_HPP
+#define JR_PRO3D_EXTENSIONS_PLATFORMFILE_HPP
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+/** Flat platform description, see WritePlatformFile().
+  *
+  * Layout: SPlatformFileHeader followed by 8 byte aligned sections of fixed-size records
+  * (instruments, axes, axis references, transformations, focal lengths) and a string table.
+  * References are indices or byte offsets into the string table instead of pointers; a string
+  * offset of NO_STRING stands for a NULL pointer. All values are in native byte order, files
+  * written on a machine with another byte order are rejected.
+  **/
+
+static constexpr uint64_t NO_STRING = UINT64_MAX;
+
+struct SPlatformFileHeader
+{
+    char m_acMagic[8];                  // "IPLATF\0\0"
+    uint32_t m_nVersion;
+    uint32_t m_nByteOrder;              // 0x01020304 in native byte order
+    uint64_t m_nFileSize;
+    uint64_t m_nName;                   // string offset of the platform name
+    uint32_t m_nInstruments;
+    uint32_t m_nAxes;
+    uint32_t m_nAxisRefs;
+    uint32_t m_nTransformations;
+    uint32_t m_nFocalLengths;
+    uint32_t m_nReserved;
+    uint64_t m_nInstrumentsOffset;      // byte offsets from the start of the file
+    uint64_t m_nAxesOffset;
+    uint64_t m_nAxisRefsOffset;
+    uint64_t m_nTransformationsOffset;
+    uint64_t m_nFocalLengthsOffset;
+    uint64_t m_nStringsOffset;
+    uint64_t m_nStringsSize;
+};
+
+struct SPlatformFileInstrument
+{
+    uint64_t m_nName;
+    uint64_t m_nReferenceFrame;
+    uint32_t m_nResolutionH;
+    uint32_t m_nResolutionV;
+    uint32_t m_nFirstFocalLength;       // index into the focal lengths
+    uint32_t m_nFocalLengths;
+    uint32_t m_nFirstAxisRef;           // index into the axis references
+    uint32_t m_nAxisRefs;
+    double m_dCurrentFocalLengthInMm;
+    double m_adIntrinsics[6];           // FoV H/V, principal point H/V, focal length in px H/V
+    double m_adExtrinsics[21];          // position, look-at, up, bounding box origin and edges
+};
+
+struct SPlatformFileAxis
+{
+    uint64_t m_nAxisId;
+    uint64_t m_nAxisDescription;
+    double m_adStartPoint[3];
+    double m_adEndPoint[3];
+    double m_dMinAngle;
+    double m_dMaxAngle;
+    double m_dCurrentAngle;
+};
+
+struct SPlatformFileTransformation
+{
+    uint64_t m_nName;
+    uint64_t m_nSourceFrame;
+    uint64_t m_nTargetFrame;
+    double m_adMatrix[16];
+};
+
+
+/** Returns 0, -1, -2 or -3 like WritePlatformFile(). **/
+int WritePlatform(const std::string& rsPath, const char* pcName, unsigned int nInstruments, const SInstrument* poInstruments,
+    unsigned int nTransformations, const STransformation* poTransformations);
+
+
+/** Mapped platform file. The C structs of the platform are created once in a single arena
+  * block; names and focal lengths point into the mapping.
+  **/
+class CPlatformFile
+{
+public:
+    /** Returns 0, -2 or -3 like OpenPlatformFile(). **/
+    int Open(const std::string& rsPath);
+
+    const char* Name() const { return m_pcName; }
+    unsigned int InstrumentCount() const { return m_nInstruments; }
+    const SInstrument* Instruments() const { return m_poInstruments; }
+    unsigned int TransformationCount() const { return m_nTransformations; }
+    const STransformation* Transformations() const { return m_poTransformations; }
+
+private:
+    CMappedFile m_oFile;
+    std::unique_ptr<std::byte[]> m_pArena;
+    const char* m_pcName = nullptr;
+    unsigned int m_nInstruments = 0;
+    SInstrument* m_poInstruments = nullptr;
+    unsigned int m_nTransformations = 0;
+    STransformation* m_poTransformations = nullptr;
+};
+
+#endif // JR_PRO3D_EXTENSIONS_PLATFORMFILE_HPP
@@ -0,0 +1,117 @@
+#include "Projection.hpp"
+
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+
+static void Normalize(double* pdVector)
+{
+    const double dLength = std::sqrt(pdVector[0] * pdVector[0] + pdVector[1] * pdVector[1] + pdVector[2] * pdVector[2]);
+    for (int i = 0; i < 3; ++i)
+    {
+        pdVector[i] /= dLength;
+    }
+}
+
+
+// Focal length in pixels, derived from the field of view [deg] if it is not given.
+static double FocalLength(double dFocalLengthInPx, double dFieldOfView, unsigned int nResolution)
+{
+    if (dFocalLengthInPx > 0.0)
+    {
+        return dFocalLengthInPx;
+    }
+    if (dFieldOfView > 0.0 && dFieldOfView < 180.0)
+    {
+        return 0.5 * nResolution / std::tan(0.5 * dFieldOfView * std::numbers::pi / 180.0);
+    }
+    return 0.0;
+}
+
+
+int MakeCamera(const SInstrumentIntrinsics& roIntrinsics, const SInstrumentExtrinsics& roExtrinsics, SCamera& roCamera)
+{
+    roCamera.m_nWidth = roIntrinsics.m_nResolutionH;
+    roCamera.m_nHeight = roIntrinsics.m_nResolutionV;
+    roCamera.m_dFocalLengthH = FocalLength(roIntrinsics.m_dFocalLengthInPxH, roIntrinsics.m_dFieldOfViewH, roCamera.m_nWidth);
+    roCamera.m_dFocalLengthV = FocalLength(roIntrinsics.m_dFocalLengthInPxV, roIntrinsics.m_dFieldOfViewV, roCamera.m_nHeight);
+    roCamera.m_dPrinciplePointH = roIntrinsics.m_dPrinciplePointH;
+    roCamera.m_dPrinciplePointV = roIntrinsics.m_dPrinciplePointV;
+    if (roCamera.m_nWidth == 0 || roCamera.m_nHeight == 0 || roCamera.m_dFocalLengthH <= 0.0 || roCamera.m_dFocalLengthV <= 0.0
+        || static_cast<uint64_t>(roCamera.m_nWidth) * roCamera.m_nHeight >= UINT32_MAX)
+    {
+        return -2;
+    }
+
+    const SPoint3D& roPosition = roExtrinsics.m_oPosition;
+    const SVector3D& roLookAt = roExtrinsics.m_oLookAt;
+    const SVector3D& roUp = roExtrinsics.m_oUp;
+    double* pdL = roCamera.m_adLookAt;
+    double* pdU = roCamera.m_adUp;
+    double* pdR = roCamera.m_adRight;
+    roCamera.m_adPosition[0] = roPosition.m_dX;
+    roCamera.m_adPosition[1] = roPosition.m_dY;
+    roCamera.m_adPosition[2] = roPosition.m_dZ;
+    pdL[0] = roLookAt.m_dX;
+    pdL[1] = roLookAt.m_dY;
+    pdL[2] = roLookAt.m_dZ;
+    pdU[0] = roUp.m_dX;
+    pdU[1] = roUp.m_dY;
+    pdU[2] = roUp.m_dZ;
+
+    // right = look-at x up; up = right x look-at
+    pdR[0] = pdL[1] * pdU[2] - pdL[2] * pdU[1];
+    pdR[1] = pdL[2] * pdU[0] - pdL[0] * pdU[2];
+    pdR[2] = pdL[0] * pdU[1] - pdL[1] * pdU[0];
+    const double dLookAt = pdL[0] * pdL[0] + pdL[1] * pdL[1] + pdL[2] * pdL[2];
+    const double dRight = pdR[0] * pdR[0] + pdR[1] * pdR[1] + pdR[2] * pdR[2];
+    if (!(dLookAt > 0.0) || !(dRight > 1.0e-24 * dLookAt))
+    {
+        return -3;
+    }
+    Normalize(pdL);
+    Normalize(pdR);
+    pdU[0] = pdR[1] * pdL[2] - pdR[2] * pdL[1];
+    pdU[1] = pdR[2] * pdL[0] - pdR[0] * pdL[2];
+    pdU[2] = pdR[0] * pdL[1] - pdR[1] * pdL[0];
+    return 0;
+}
+
+
+void ProjectTile(const SCamera& roCamera, const SPoint3D* poPoints, size_t nCount,
+    float* pfU, float* pfV, float* pfDepth, uint32_t* pnPixel)
+{
+    const double dPx = roCamera.m_adPosition[0];
+    const double dPy = roCamera.m_adPosition[1];
+    const double dPz = roCamera.m_adPosition[2];
+    const double* pdL = roCamera.m_adLookAt;
+    const double* pdR = roCamera.m_adRight;
+    const double* pdU = roCamera.m_adUp;
+    const double dFh = roCamera.m_dFocalLengthH;
+    const double dFv = roCamera.m_dFocalLengthV;
+    const double dCh = roCamera.m_dPrinciplePointH;
+    const double dCv = roCamera.m_dPrinciplePointV;
+    const double dWidth = roCamera.m_nWidth;
+    const double dHeight = roCamera.m_nHeight;
+    const double dNaN = std::numeric_limits<double>::quiet_NaN();
+
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        const double dX = poPoints[i].m_dX - dPx;
+        const double dY = poPoints[i].m_dY - dPy;
+        const double dZ = poPoints[i].m_dZ - dPz;
+        const double dDepth = pdL[0] * dX + pdL[1] * dY + pdL[2] * dZ;
+        const double dRight = pdR[0] * dX + pdR[1] * dY + pdR[2] * dZ;
+        const double dUp = pdU[0] * dX + pdU[1] * dY + pdU[2] * dZ;
+        const double dInvDepth = dDepth > 0.0 ? 1.0 / dDepth : dNaN;
+        const double dU = dCh + dFh * dRight * dInvDepth;
+        const double dV = dCv - dFv * dUp * dInvDepth;
+        pfU[i] = static_cast<float>(dU);
+        pfV[i] = static_cast<float>(dV);
+        pfDepth[i] = static_cast<float>(dDepth);
+        // NaN fails all comparisons
+        const bool bInside = dU >= 0.0 && dU < dWidth && dV >= 0.0 && dV < dHeight;
+        pnPixel[i] = bInside ? static_cast<uint32_t>(dV) * roCamera.m_nWidth + static_cast<uint32_t>(dU) : UINT32_MAX;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef JR_PRO3D_EXTENSIONS_PROJECTION_HPP
+#define JR_PRO3D_EXTENSIONS_PROJECTION_HPP
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+
+/** Pinhole camera of an instrument pose. Camera axes: +x = look-at, +z = up, right = look-at x up.
+  * Pixel coordinates: u to the right, v downwards, pixel (0, 0) covers [0, 1) x [0, 1).
+  **/
+struct SCamera
+{
+    double m_adPosition[3];
+    double m_adLookAt[3];       // unit vectors, orthogonalized
+    double m_adRight[3];
+    double m_adUp[3];
+    double m_dFocalLengthH;     // [px]
+    double m_dFocalLengthV;     // [px]
+    double m_dPrinciplePointH;  // [px]
+    double m_dPrinciplePointV;  // [px]
+    unsigned int m_nWidth;
+    unsigned int m_nHeight;
+};
+
+/** Returns 0, -2 or -3 like ProjectPoints(). **/
+int MakeCamera(const SInstrumentIntrinsics& roIntrinsics, const SInstrumentExtrinsics& roExtrinsics, SCamera& roCamera);
+
+
+/** Number of points projected at once; the per-tile buffers stay in L1/L2. **/
+static constexpr size_t PROJECTION_TILE_SIZE = 2048;
+
+/** Projects nCount <= PROJECTION_TILE_SIZE points. Depth is the distance along the look-at
+  * vector; points at or behind the camera get u = v = NaN. Returns for each point the index of its
+  * pixel or UINT32_MAX if it is outside the image.
+  **/
+void ProjectTile(const SCamera& roCamera, const SPoint3D* poPoints, size_t nCount,
+    float* pfU, float* pfV, float* pfDepth, uint32_t* pnPixel);
+
+#endif // JR_PRO3D_EXTENSIONS_PROJECTION_HPP
@@ -0,0 +1,167 @@
+/** CollisionTest
+* =============
+*
+* CheckKinematicChainCollisions() and GetCollisionFreeGrid() for a pan/tilt camera whose
+* bounding box (0.5 m cube around (1, 0, 2)) is swept around the mast by the pan axis.
+**/
+
+#include "TestCheck.hpp"
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <cmath>
+#include <vector>
+
+
+static int CreateChain()
+{
+    SAxis oPan{ "pan", "pan", { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }, -200.0, 200.0, 0.0 };
+    SAxis oTilt{ "tilt", "tilt", { 0.0, 0.0, 2.0 }, { 0.0, -1.0, 2.0 }, -100.0, 100.0, 0.0 };
+    SAxis* apoAxes[] = { &oPan, &oTilt };
+    SInstrument oInstrument{};
+    oInstrument.m_pcInstrumentName = "camera";
+    oInstrument.m_nNrOfInstrumentAxes = 2;
+    oInstrument.m_poInstrumentAxes = apoAxes;
+    oInstrument.m_oInstrumentExtrinsics = { "GRF", { 1.0, 0.0, 2.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 },
+        { { 0.75, -0.25, 1.75 }, { 0.5, 0.0, 0.0 }, { 0.0, 0.5, 0.0 }, { 0.0, 0.0, 0.5 } } };
+    int nChainId = 0;
+    CHECK(CreateKinematicChain(&oInstrument, &nChainId) == 0);
+    return nChainId;
+}
+
+
+static SBoundingBox Cube(double dX, double dY, double dZ, double dEdge)
+{
+    return { { dX, dY, dZ }, { dEdge, 0.0, 0.0 }, { 0.0, dEdge, 0.0 }, { 0.0, 0.0, dEdge } };
+}
+
+
+// Box on the +y side of the mast, where the camera box is at pan 100 gon.
+static const SBoundingBox s_oSideBox = Cube(-0.25, 0.6, 1.6, 0.5);
+
+
+static void TestSweptBox()
+{
+    const int nChainId = CreateChain();
+    const double adAngles[] = { 0.0, 0.0, 100.0, 0.0, -100.0, 0.0, 100.0, 100.0 };
+    int anColliding[4] = { 7, 7, 7, 7 };
+    CHECK(CheckKinematicChainCollisions(nChainId, 1, &s_oSideBox, 4, adAngles, anColliding, 1) == 0);
+    CHECK(anColliding[0] == -1);
+    CHECK(anColliding[1] == 0);
+    CHECK(anColliding[2] == -1);
+    CHECK(anColliding[3] == -1);    // tilted up above the box
+
+    // a box rotated by 50 gon about z, so the separating axis tests use non-aligned axes
+    const double dC = std::sqrt(0.5) * 0.4;
+    const SBoundingBox oRotated{ { 0.0, 0.5, 1.8 }, { dC, dC, 0.0 }, { -dC, dC, 0.0 }, { 0.0, 0.0, 0.4 } };
+    CHECK(CheckKinematicChainCollisions(nChainId, 1, &oRotated, 4, adAngles, anColliding, 1) == 0);
+    CHECK(anColliding[0] == -1 && anColliding[1] == 0 && anColliding[2] == -1);
+    DestroyKinematicChain(nChainId);
+}
+
+
+static void TestTouching()
+{
+    const int nChainId = CreateChain();
+    const double adAngles[] = { 0.0, 0.0 };
+    // the camera box spans x = [0.75, 1.25] at pan 0
+    const SBoundingBox aoBoxes[] = {
+        Cube(1.25, -0.25, 1.75, 0.25),      // shares the face x = 1.25
+        Cube(1.25, 0.25, 2.25, 0.25),       // shares only the corner (1.25, 0.25, 2.25)
+        Cube(1.2500001, -0.25, 1.75, 0.25) };
+    int nColliding = 7;
+    for (int i = 0; i < 3; ++i)
+    {
+        CHECK(CheckKinematicChainCollisions(nChainId, 1, &aoBoxes[i], 1, adAngles, &nColliding, 1) == 0);
+        CHECK(nColliding == (i < 2 ? 0 : -1));
+    }
+    DestroyKinematicChain(nChainId);
+}
+
+
+static void TestSmallestIndex()
+{
+    const int nChainId = CreateChain();
+    // enough boxes for a deep hierarchy; boxes 12 and 37 collide at pan 100 gon
+    std::vector<SBoundingBox> vecBoxes;
+    for (int i = 0; i < 64; ++i)
+    {
+        vecBoxes.push_back(Cube(10.0 + i, -10.0 - 0.5 * i, 0.1 * i, 0.3));
+    }
+    vecBoxes[37] = s_oSideBox;
+    vecBoxes[12] = Cube(-0.1, 0.9, 1.9, 0.2);
+    const double adAngles[] = { 100.0, 0.0, 0.0, 0.0 };
+    int anColliding[2] = { 7, 7 };
+    CHECK(CheckKinematicChainCollisions(nChainId, static_cast<unsigned int>(vecBoxes.size()), vecBoxes.data(), 2, adAngles, anColliding, 1) == 0);
+    CHECK(anColliding[0] == 12);
+    CHECK(anColliding[1] == -1);
+    DestroyKinematicChain(nChainId);
+}
+
+
+static void TestGrid()
+{
+    const int nChainId = CreateChain();
+    // pan -200, -100, 0, 100, 200 gon; tilt -100, 0, 100 gon
+    const unsigned int anSteps[] = { 5, 3 };
+    unsigned char anFeasible[15] = {};
+    double adRanges[4] = {};
+    unsigned int nFeasible = 0;
+    CHECK(GetCollisionFreeGrid(nChainId, 1, &s_oSideBox, anSteps, anFeasible, adRanges, &nFeasible, 2) == 0);
+
+    // last axis fastest: index = nPan * 3 + nTilt
+    unsigned int nExpected = 0;
+    for (unsigned int nPan = 0; nPan < 5; ++nPan)
+    {
+        for (unsigned int nTilt = 0; nTilt < 3; ++nTilt)
+        {
+            const double adAngles[] = { -200.0 + 100.0 * nPan, -100.0 + 100.0 * nTilt };
+            int nColliding = 7;
+            CHECK(CheckKinematicChainCollisions(nChainId, 1, &s_oSideBox, 1, adAngles, &nColliding, 1) == 0);
+            CHECK(anFeasible[nPan * 3 + nTilt] == (nColliding < 0 ? 1 : 0));
+            nExpected += nColliding < 0;
+        }
+    }
+    CHECK(anFeasible[3 * 3 + 1] == 0);     // pan 100, tilt 0
+    CHECK(anFeasible[1 * 3 + 1] == 1);     // pan -100, tilt 0
+    CHECK(nFeasible == nExpected && nFeasible == 14);
+    CHECK(adRanges[0] == -200.0 && adRanges[1] == 200.0);
+    CHECK(adRanges[2] == -100.0 && adRanges[3] == 100.0);
+
+    // one step samples the current angle
+    const unsigned int anCurrent[] = { 1, 1 };
+    CHECK(GetCollisionFreeGrid(nChainId, 1, &s_oSideBox, anCurrent, anFeasible, adRanges, &nFeasible, 1) == 0);
+    CHECK(nFeasible == 1 && anFeasible[0] == 1 && adRanges[0] == 0.0 && adRanges[2] == 0.0);
+
+    // nothing is free inside a box enclosing the whole workspace
+    const SBoundingBox oEnclosing = Cube(-10.0, -10.0, -10.0, 20.0);
+    CHECK(GetCollisionFreeGrid(nChainId, 1, &oEnclosing, anSteps, anFeasible, adRanges, &nFeasible, 1) == 0);
+    CHECK(nFeasible == 0);
+    for (int j = 0; j < 4; ++j)
+    {
+        CHECK(std::isnan(adRanges[j]));
+    }
+    for (unsigned char nFeasibleEntry : anFeasible)
+    {
+        CHECK(nFeasibleEntry == 0);
+    }
+
+    // no boxes: everything is free
+    CHECK(GetCollisionFreeGrid(nChainId, 0, nullptr, anSteps, nullptr, nullptr, &nFeasible, 1) == 0);
+    CHECK(nFeasible == 15);
+
+    const unsigned int anEmpty[] = { 5, 0 };
+    CHECK(GetCollisionFreeGrid(nChainId, 1, &s_oSideBox, anEmpty, nullptr, nullptr, nullptr, 1) == -3);
+    CHECK(GetCollisionFreeGrid(-1, 1, &s_oSideBox, anSteps, nullptr, nullptr, nullptr, 1) == -2);
+    DestroyKinematicChain(nChainId);
+}
+
+
+int main()
+{
+    TestSweptBox();
+    TestTouching();
+    TestSmallestIndex();
+    TestGrid();
+    return TestResult();
+}
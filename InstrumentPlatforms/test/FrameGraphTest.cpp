@@ -0,0 +1,141 @@
+/** FrameGraphTest
+* ==============
+*
+* Composition, incremental invalidation and memoization statistics of the frame graph for the
+* chain A -> B -> C -> D.
+**/
+
+#include "TestCheck.hpp"
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+
+static const double TOLERANCE = 1.0e-12;
+
+
+static STransformationMatrix Translation(double dX, double dY, double dZ)
+{
+    return { { { 1.0, 0.0, 0.0, dX }, { 0.0, 1.0, 0.0, dY }, { 0.0, 0.0, 1.0, dZ }, { 0.0, 0.0, 0.0, 1.0 } } };
+}
+
+
+/** 100 gon about +z: (x, y, z) -> (-y, x, z). **/
+static STransformationMatrix QuarterTurn()
+{
+    return { { { 0.0, -1.0, 0.0, 0.0 }, { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0, 0.0 }, { 0.0, 0.0, 0.0, 1.0 } } };
+}
+
+
+static int Set(int nGraphId, const char* pcSource, const char* pcTarget, const STransformationMatrix& roMatrix)
+{
+    const STransformation oTransformation{ "test", pcSource, pcTarget, roMatrix };
+    return SetFrameTransformation(nGraphId, &oTransformation);
+}
+
+
+static SPoint3D Apply(const STransformationMatrix& roMatrix, const SPoint3D& roPoint)
+{
+    const auto& m = roMatrix.m_adElement;
+    return { m[0][0] * roPoint.m_dX + m[0][1] * roPoint.m_dY + m[0][2] * roPoint.m_dZ + m[0][3],
+             m[1][0] * roPoint.m_dX + m[1][1] * roPoint.m_dY + m[1][2] * roPoint.m_dZ + m[1][3],
+             m[2][0] * roPoint.m_dX + m[2][1] * roPoint.m_dY + m[2][2] * roPoint.m_dZ + m[2][3] };
+}
+
+
+static void CheckPoint(const SPoint3D& roActual, double dX, double dY, double dZ)
+{
+    CHECK_NEAR(roActual.m_dX, dX, TOLERANCE);
+    CHECK_NEAR(roActual.m_dY, dY, TOLERANCE);
+    CHECK_NEAR(roActual.m_dZ, dZ, TOLERANCE);
+}
+
+
+static void CheckStats(int nGraphId, unsigned long long nHits, unsigned long long nMisses, unsigned long long nUpdates, unsigned long long nProducts)
+{
+    unsigned long long nActualHits = 0, nActualMisses = 0, nActualUpdates = 0, nActualProducts = 0;
+    CHECK(GetFrameGraphStats(nGraphId, &nActualHits, &nActualMisses, &nActualUpdates, &nActualProducts, true) == 0);
+    CHECK(nActualHits == nHits);
+    CHECK(nActualMisses == nMisses);
+    CHECK(nActualUpdates == nUpdates);
+    CHECK(nActualProducts == nProducts);
+}
+
+
+static void TestIncrementalInvalidation()
+{
+    int nGraphId = -1;
+    CHECK(CreateFrameGraph(&nGraphId) == 0);
+    CHECK(Set(nGraphId, "A", "B", Translation(1.0, 0.0, 0.0)) == 0);
+    CHECK(Set(nGraphId, "B", "C", QuarterTurn()) == 0);
+    CHECK(Set(nGraphId, "C", "D", Translation(0.0, 0.0, 5.0)) == 0);
+    const SPoint3D oOrigin{ 0.0, 0.0, 0.0 };
+
+    // three edges: full composition with two products, then a memoized hit
+    STransformationMatrix oAD;
+    CHECK(GetFrameTransformation(nGraphId, "A", "D", &oAD) == 0);
+    CheckPoint(Apply(oAD, oOrigin), 0.0, 1.0, 5.0);
+    CheckStats(nGraphId, 0, 1, 0, 2);
+    CHECK(GetFrameTransformation(nGraphId, "A", "D", &oAD) == 0);
+    CheckStats(nGraphId, 1, 0, 0, 0);
+
+    // the middle edge registered as C -> B replaces B -> C; A -> D is recomposed from that edge on
+    CHECK(Set(nGraphId, "C", "B", Translation(0.0, -2.0, 0.0)) == 0);
+    CHECK(GetFrameTransformation(nGraphId, "A", "D", &oAD) == 0);
+    CheckPoint(Apply(oAD, oOrigin), 1.0, 2.0, 5.0);
+    CheckStats(nGraphId, 0, 0, 1, 2);
+
+    // changing the last edge only recomputes the last product
+    CHECK(Set(nGraphId, "C", "D", Translation(0.0, 0.0, 7.0)) == 0);
+    CHECK(GetFrameTransformation(nGraphId, "A", "D", &oAD) == 0);
+    CheckPoint(Apply(oAD, oOrigin), 1.0, 2.0, 7.0);
+    CheckStats(nGraphId, 0, 0, 1, 1);
+
+    // inverse path
+    STransformationMatrix oDA;
+    CHECK(GetFrameTransformation(nGraphId, "D", "A", &oDA) == 0);
+    CheckPoint(Apply(oDA, { 1.0, 2.0, 7.0 }), 0.0, 0.0, 0.0);
+    CheckPoint(Apply(oDA, Apply(oAD, { 0.3, -4.0, 2.5 })), 0.3, -4.0, 2.5);
+    CheckStats(nGraphId, 0, 1, 0, 2);
+
+    SPoint3D aoPoints[2] = { { 1.0, 2.0, 7.0 }, { 1.0, 3.0, 7.0 } };
+    CHECK(TransformPoints(nGraphId, "D", "A", 2, aoPoints, aoPoints, 1) == 0);
+    CheckPoint(aoPoints[0], 0.0, 0.0, 0.0);
+    CheckPoint(aoPoints[1], 0.0, 1.0, 0.0);
+    CheckStats(nGraphId, 1, 0, 0, 0);
+
+    // a new pair of frames drops all composites
+    CHECK(Set(nGraphId, "E", "F", Translation(1.0, 1.0, 1.0)) == 0);
+    CHECK(GetFrameTransformation(nGraphId, "A", "D", &oAD) == 0);
+    CheckPoint(Apply(oAD, oOrigin), 1.0, 2.0, 7.0);
+    CheckStats(nGraphId, 0, 1, 0, 2);
+
+    CHECK(DestroyFrameGraph(nGraphId) == 0);
+}
+
+
+static void TestInvalidArguments()
+{
+    int nGraphId = -1;
+    CHECK(CreateFrameGraph(&nGraphId) == 0);
+    CHECK(Set(nGraphId, "A", "B", Translation(1.0, 0.0, 0.0)) == 0);
+    CHECK(Set(nGraphId, "C", "D", Translation(1.0, 0.0, 0.0)) == 0);
+    CHECK(Set(nGraphId, "A", "A", Translation(1.0, 0.0, 0.0)) == -4);
+    STransformationMatrix oSingular = Translation(0.0, 0.0, 0.0);
+    oSingular.m_adElement[2][2] = 0.0;
+    CHECK(Set(nGraphId, "A", "B", oSingular) == -4);
+
+    STransformationMatrix oMatrix;
+    CHECK(GetFrameTransformation(nGraphId, "A", "X", &oMatrix) == -3);
+    CHECK(GetFrameTransformation(nGraphId, "A", "D", &oMatrix) == -3);     // not connected
+    CHECK(GetFrameTransformation(nGraphId, "A", nullptr, &oMatrix) == -1);
+    CHECK(DestroyFrameGraph(nGraphId) == 0);
+    CHECK(GetFrameTransformation(nGraphId, "A", "B", &oMatrix) == -2);
+}
+
+
+int main()
+{
+    TestIncrementalInvalidation();
+    TestInvalidArguments();
+    return TestResult();
+}
@@ -0,0 +1,169 @@
+/** KinematicChainTest
+* ==================
+*
+* Pose math and per-configuration states of CreateKinematicChain() and EvaluateKinematicChain()
+* for a single pan axis and a pan/tilt chain.
+**/
+
+#include "TestCheck.hpp"
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+static const double TOLERANCE = 1.0e-12;
+
+
+static void CheckPoint(const SPoint3D& roActual, double dX, double dY, double dZ)
+{
+    CHECK_NEAR(roActual.m_dX, dX, TOLERANCE);
+    CHECK_NEAR(roActual.m_dY, dY, TOLERANCE);
+    CHECK_NEAR(roActual.m_dZ, dZ, TOLERANCE);
+}
+
+static void CheckVector(const SVector3D& roActual, double dX, double dY, double dZ)
+{
+    CHECK_NEAR(roActual.m_dX, dX, TOLERANCE);
+    CHECK_NEAR(roActual.m_dY, dY, TOLERANCE);
+    CHECK_NEAR(roActual.m_dZ, dZ, TOLERANCE);
+}
+
+
+/** Camera at (1, 0, 2) looking along +x; pan about +z through the origin, optionally tilt about -y at height 2. **/
+static int CreateChain(bool bTilt)
+{
+    SAxis oPan{ "pan", "pan", { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }, -200.0, 200.0, 0.0 };
+    SAxis oTilt{ "tilt", "tilt", { 0.0, 0.0, 2.0 }, { 0.0, -1.0, 2.0 }, -100.0, 100.0, 0.0 };
+    SAxis* apoAxes[] = { &oPan, &oTilt };
+    SInstrument oInstrument{};
+    oInstrument.m_pcInstrumentName = "camera";
+    oInstrument.m_nNrOfInstrumentAxes = bTilt ? 2 : 1;
+    oInstrument.m_poInstrumentAxes = apoAxes;
+    oInstrument.m_oInstrumentExtrinsics = { "GRF", { 1.0, 0.0, 2.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 },
+        { { 0.9, -0.1, 1.9 }, { 0.2, 0.0, 0.0 }, { 0.0, 0.2, 0.0 }, { 0.0, 0.0, 0.2 } } };
+    int nChainId = 0;
+    CHECK(CreateKinematicChain(&oInstrument, &nChainId) == 0);
+    return nChainId;
+}
+
+
+static void TestPan()
+{
+    const int nChainId = CreateChain(false);
+    unsigned int nAxes = 0;
+    CHECK(GetKinematicChainAxisCount(nChainId, &nAxes) == 0 && nAxes == 1);
+
+    const double dAngle = 100.0;
+    SInstrumentExtrinsics oPose{};
+    int nStatus = -1;
+    CHECK(EvaluateKinematicChain(nChainId, 1, &dAngle, &oPose, &nStatus, 1) == 0);
+    CHECK(nStatus == 0);
+    CheckPoint(oPose.m_oPosition, 0.0, 1.0, 2.0);
+    CheckVector(oPose.m_oLookAt, 0.0, 1.0, 0.0);
+    CheckVector(oPose.m_oUp, 0.0, 0.0, 1.0);
+    CheckPoint(oPose.m_oBoundingBox.m_oOriginBB, 0.1, 0.9, 1.9);
+    CheckVector(oPose.m_oBoundingBox.m_oEdge1, 0.0, 0.2, 0.0);
+    CheckVector(oPose.m_oBoundingBox.m_oEdge2, -0.2, 0.0, 0.0);
+    CHECK(oPose.m_pcReferenceFrame != nullptr);
+    CHECK(DestroyKinematicChain(nChainId) == 0);
+    CHECK(DestroyKinematicChain(nChainId) == -2);
+}
+
+
+static void TestPanTilt()
+{
+    const int nChainId = CreateChain(true);
+    // tilt 50 gon about -y raises the look-at vector by 45 deg, pan 100 gon then turns it to +y
+    const double adAngles[] = { 100.0, 50.0 };
+    SInstrumentExtrinsics oPose{};
+    int nStatus = -1;
+    CHECK(EvaluateKinematicChain(nChainId, 1, adAngles, &oPose, &nStatus, 1) == 0);
+    CHECK(nStatus == 0);
+    const double dHalf = std::sqrt(0.5);
+    CheckPoint(oPose.m_oPosition, 0.0, dHalf, 2.0 + dHalf);
+    CheckVector(oPose.m_oLookAt, 0.0, dHalf, dHalf);
+    CheckVector(oPose.m_oUp, 0.0, -dHalf, dHalf);
+
+    // a batch over several blocks and threads gives the same poses as single evaluations
+    const unsigned int nCount = 1000;
+    std::vector<double> vecAngles(2 * nCount);
+    for (unsigned int i = 0; i < nCount; ++i)
+    {
+        vecAngles[2 * i] = -200.0 + 0.4 * i;
+        vecAngles[2 * i + 1] = -100.0 + 0.2 * i;
+    }
+    std::vector<SInstrumentExtrinsics> vecPoses(nCount);
+    CHECK(EvaluateKinematicChain(nChainId, nCount, vecAngles.data(), vecPoses.data(), nullptr, 4) == 0);
+    for (unsigned int i = 0; i < nCount; i += 97)
+    {
+        SInstrumentExtrinsics oSingle{};
+        CHECK(EvaluateKinematicChain(nChainId, 1, &vecAngles[2 * i], &oSingle, nullptr, 1) == 0);
+        CheckPoint(vecPoses[i].m_oPosition, oSingle.m_oPosition.m_dX, oSingle.m_oPosition.m_dY, oSingle.m_oPosition.m_dZ);
+        CheckVector(vecPoses[i].m_oLookAt, oSingle.m_oLookAt.m_dX, oSingle.m_oLookAt.m_dY, oSingle.m_oLookAt.m_dZ);
+    }
+    DestroyKinematicChain(nChainId);
+}
+
+
+static void TestStates()
+{
+    const int nChainId = CreateChain(true);
+    const double dNaN = std::numeric_limits<double>::quiet_NaN();
+    const double adAngles[] = {
+        0.0, 0.0,
+        250.0, 0.0,         // pan clamped to 200
+        200.0, 0.0,
+        0.0, dNaN,
+        300.0, dNaN };
+    SInstrumentExtrinsics aoPoses[5] = {};
+    int anStatus[5] = { -1, -1, -1, -1, -1 };
+    CHECK(EvaluateKinematicChain(nChainId, 5, adAngles, aoPoses, anStatus, 1) == 0);
+    CHECK(anStatus[0] == 0);
+    CHECK(anStatus[1] == 1);
+    CHECK(anStatus[2] == 0);
+    CHECK(anStatus[3] == 2);
+    CHECK(anStatus[4] == 2);
+    CheckPoint(aoPoses[1].m_oPosition, aoPoses[2].m_oPosition.m_dX, aoPoses[2].m_oPosition.m_dY, aoPoses[2].m_oPosition.m_dZ);
+    CheckPoint(aoPoses[1].m_oPosition, -1.0, 0.0, 2.0);
+    CHECK(std::isnan(aoPoses[3].m_oPosition.m_dX) && std::isnan(aoPoses[3].m_oLookAt.m_dZ));
+
+    // a NaN configuration is reported as such instead of as collision-free
+    const SBoundingBox oFarBox{ { 100.0, 100.0, 100.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+    int anColliding[5] = {};
+    CHECK(CheckKinematicChainCollisions(nChainId, 1, &oFarBox, 5, adAngles, anColliding, 1) == 0);
+    CHECK(anColliding[0] == -1 && anColliding[1] == -1 && anColliding[2] == -1);
+    CHECK(anColliding[3] == -2 && anColliding[4] == -2);
+    DestroyKinematicChain(nChainId);
+}
+
+
+static void TestInvalidArguments()
+{
+    SAxis oDegenerate{ "pan", "pan", { 0.0, 0.0, 1.0 }, { 0.0, 0.0, 1.0 }, -200.0, 200.0, 0.0 };
+    SAxis* apoAxes[] = { &oDegenerate };
+    SInstrument oInstrument{};
+    oInstrument.m_nNrOfInstrumentAxes = 1;
+    oInstrument.m_poInstrumentAxes = apoAxes;
+    int nChainId = 0;
+    CHECK(CreateKinematicChain(&oInstrument, &nChainId) == -3);
+    oInstrument.m_nNrOfInstrumentAxes = 0;
+    CHECK(CreateKinematicChain(&oInstrument, &nChainId) == -2);
+    CHECK(CreateKinematicChain(nullptr, &nChainId) == -1);
+
+    const double dAngle = 0.0;
+    SInstrumentExtrinsics oPose{};
+    CHECK(EvaluateKinematicChain(-1, 1, &dAngle, &oPose, nullptr, 1) == -2);
+}
+
+
+int main()
+{
+    TestPan();
+    TestPanTilt();
+    TestStates();
+    TestInvalidArguments();
+    return TestResult();
+}
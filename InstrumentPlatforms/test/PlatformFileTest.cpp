@@ -0,0 +1,281 @@
+/** PlatformFileTest
+* ================
+*
+* Round trip of WritePlatformFile() and OpenPlatformFile(), and rejection of truncated and
+* corrupted files. The byte-flip sweep opens every single-byte corruption of a written file;
+* it must only ever return 0 or -3 (run it with -fsanitize=address,undefined to catch reads
+* outside the mapping or arena).
+**/
+
+#include "TestCheck.hpp"
+
+#include "../src/PlatformFile.hpp"
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+static const char* const PATH = "PlatformFileTest.iplat";
+
+
+static std::vector<char> ReadBytes(const char* pcPath)
+{
+    std::ifstream oFile(pcPath, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(oFile), std::istreambuf_iterator<char>());
+}
+
+static void WriteBytes(const char* pcPath, const std::vector<char>& rvecBytes)
+{
+    std::ofstream oFile(pcPath, std::ios::binary | std::ios::trunc);
+    oFile.write(rvecBytes.data(), static_cast<std::streamsize>(rvecBytes.size()));
+}
+
+
+template<typename T>
+static void Patch(std::vector<char>& rvecBytes, size_t nOffset, T value)
+{
+    std::memcpy(rvecBytes.data() + nOffset, &value, sizeof(value));
+}
+
+template<typename T>
+static T Peek(const std::vector<char>& rvecBytes, size_t nOffset)
+{
+    T value;
+    std::memcpy(&value, rvecBytes.data() + nOffset, sizeof(value));
+    return value;
+}
+
+
+/** Writes and opens rvecBytes; returns the result of OpenPlatformFile() and closes the platform again. **/
+static int OpenBytes(const std::vector<char>& rvecBytes)
+{
+    WriteBytes(PATH, rvecBytes);
+    int nPlatformId = -1;
+    const int nResult = OpenPlatformFile(PATH, &nPlatformId);
+    if (nResult == 0)
+    {
+        const SInstrument* poInstruments = nullptr;
+        unsigned int nCount = 0;
+        CHECK(GetPlatformInstruments(nPlatformId, &poInstruments, &nCount) == 0);
+        for (unsigned int i = 0; i < nCount; ++i)
+        {
+            // every pointer of an accepted file must be usable
+            if (poInstruments[i].m_pcInstrumentName)
+            {
+                (void)std::strlen(poInstruments[i].m_pcInstrumentName);
+            }
+            for (unsigned int j = 0; j < poInstruments[i].m_nNrOfInstrumentAxes; ++j)
+            {
+                (void)poInstruments[i].m_poInstrumentAxes[j]->m_dCurrentAngle;
+            }
+        }
+        CHECK(ClosePlatformFile(nPlatformId) == 0);
+    }
+    return nResult;
+}
+
+
+static STransformationMatrix Translation(double dX, double dY, double dZ)
+{
+    return { { { 1.0, 0.0, 0.0, dX }, { 0.0, 1.0, 0.0, dY }, { 0.0, 0.0, 1.0, dZ }, { 0.0, 0.0, 0.0, 1.0 } } };
+}
+
+
+/** Two instruments sharing the pan axis, and two transformations. **/
+static void WritePlatform()
+{
+    SAxis oPan{ "pan", "mast pan", { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }, -200.0, 200.0, 10.0 };
+    SAxis oTilt{ "tilt", nullptr, { 0.0, 0.0, 2.0 }, { 0.0, -1.0, 2.0 }, -100.0, 100.0, -5.0 };
+    SAxis* apoWideAxes[] = { &oPan, &oTilt };
+    SAxis* apoHighAxes[] = { &oPan };
+    double adWideFocalLengths[] = { 12.5, 25.0, 50.0 };
+    double adHighFocalLengths[] = { 100.0 };
+
+    SInstrument aoInstruments[2] = {};
+    aoInstruments[0].m_pcInstrumentName = "WAC";
+    aoInstruments[0].m_nNrOfCalibratedFocalLengths = 3;
+    aoInstruments[0].m_pdCalibratedFocalLengths = adWideFocalLengths;
+    aoInstruments[0].m_dCurrentFocalLengthInMm = 25.0;
+    aoInstruments[0].m_oCurrentInstrumentIntrinsics = { 1024, 768, 60.0, 45.0, 511.5, 383.5, 900.0, 900.0 };
+    aoInstruments[0].m_oInstrumentExtrinsics = { "GRF", { 1.0, 0.0, 2.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 },
+        { { 0.9, -0.1, 1.9 }, { 0.2, 0.0, 0.0 }, { 0.0, 0.2, 0.0 }, { 0.0, 0.0, 0.2 } } };
+    aoInstruments[0].m_nNrOfInstrumentAxes = 2;
+    aoInstruments[0].m_poInstrumentAxes = apoWideAxes;
+    aoInstruments[1] = aoInstruments[0];
+    aoInstruments[1].m_pcInstrumentName = "HRC";
+    aoInstruments[1].m_nNrOfCalibratedFocalLengths = 1;
+    aoInstruments[1].m_pdCalibratedFocalLengths = adHighFocalLengths;
+    aoInstruments[1].m_dCurrentFocalLengthInMm = 100.0;
+    aoInstruments[1].m_nNrOfInstrumentAxes = 1;
+    aoInstruments[1].m_poInstrumentAxes = apoHighAxes;
+
+    const STransformation aoTransformations[] = {
+        { "Platform2Ground", "PRF", "GRF", Translation(1.0, 2.0, 3.0) },
+        { "Ground2Surface", "GRF", "SRF", Translation(-4.0, 5.0, -6.0) } };
+    CHECK(WritePlatformFile(PATH, "rover", 2, aoInstruments, 2, aoTransformations) == 0);
+}
+
+
+static void TestRoundTrip()
+{
+    WritePlatform();
+    int nPlatformId = -1;
+    CHECK(OpenPlatformFile(PATH, &nPlatformId) == 0);
+
+    const char* pcName = nullptr;
+    CHECK(GetPlatformName(nPlatformId, &pcName) == 0);
+    CHECK(pcName && std::string(pcName) == "rover");
+
+    const SInstrument* poInstruments = nullptr;
+    unsigned int nInstruments = 0;
+    CHECK(GetPlatformInstruments(nPlatformId, &poInstruments, &nInstruments) == 0);
+    if (CHECK(nInstruments == 2))
+    {
+        const SInstrument& roWide = poInstruments[0];
+        const SInstrument& roHigh = poInstruments[1];
+        CHECK(std::string(roWide.m_pcInstrumentName) == "WAC");
+        CHECK(std::string(roHigh.m_pcInstrumentName) == "HRC");
+        CHECK(std::string(roWide.m_oInstrumentExtrinsics.m_pcReferenceFrame) == "GRF");
+
+        CHECK(roWide.m_nNrOfCalibratedFocalLengths == 3 && roHigh.m_nNrOfCalibratedFocalLengths == 1);
+        CHECK(roWide.m_pdCalibratedFocalLengths[0] == 12.5 && roWide.m_pdCalibratedFocalLengths[1] == 25.0
+            && roWide.m_pdCalibratedFocalLengths[2] == 50.0);
+        CHECK(roHigh.m_pdCalibratedFocalLengths[0] == 100.0);
+        CHECK(roWide.m_dCurrentFocalLengthInMm == 25.0 && roHigh.m_dCurrentFocalLengthInMm == 100.0);
+        CHECK(roWide.m_oCurrentInstrumentIntrinsics.m_nResolutionH == 1024 && roWide.m_oCurrentInstrumentIntrinsics.m_dPrinciplePointV == 383.5);
+        CHECK(roWide.m_oInstrumentExtrinsics.m_oBoundingBox.m_oEdge3.m_dZ == 0.2);
+
+        // the pan axis is stored once and shared by both instruments
+        CHECK(roWide.m_nNrOfInstrumentAxes == 2 && roHigh.m_nNrOfInstrumentAxes == 1);
+        const SAxis* poPan = roWide.m_poInstrumentAxes[0];
+        const SAxis* poTilt = roWide.m_poInstrumentAxes[1];
+        CHECK(roHigh.m_poInstrumentAxes[0] == poPan);
+        CHECK(poPan != poTilt);
+        CHECK(std::string(poPan->m_pcAxisId) == "pan" && std::string(poPan->m_pcAxisDescription) == "mast pan");
+        CHECK(poTilt->m_pcAxisDescription == nullptr);
+        CHECK(poPan->m_dCurrentAngle == 10.0 && poTilt->m_oEndPoint.m_dY == -1.0 && poTilt->m_dMinAngle == -100.0);
+    }
+
+    const STransformation* poTransformations = nullptr;
+    unsigned int nTransformations = 0;
+    CHECK(GetPlatformTransformations(nPlatformId, &poTransformations, &nTransformations) == 0);
+    if (CHECK(nTransformations == 2))
+    {
+        CHECK(std::string(poTransformations[0].m_pcTransfName) == "Platform2Ground");
+        CHECK(std::string(poTransformations[0].m_pcSourceFrame) == "PRF");
+        CHECK(std::string(poTransformations[1].m_pcTargetFrame) == "SRF");
+        const STransformationMatrix oExpected[] = { Translation(1.0, 2.0, 3.0), Translation(-4.0, 5.0, -6.0) };
+        for (int i = 0; i < 2; ++i)
+        {
+            CHECK(std::memcmp(&poTransformations[i].m_oHelmertTransfMatrix, &oExpected[i], sizeof(STransformationMatrix)) == 0);
+        }
+    }
+    CHECK(ClosePlatformFile(nPlatformId) == 0);
+    CHECK(ClosePlatformFile(nPlatformId) == -2);
+
+    // no name, no instruments, no transformations
+    CHECK(WritePlatformFile(PATH, nullptr, 0, nullptr, 0, nullptr) == 0);
+    CHECK(OpenPlatformFile(PATH, &nPlatformId) == 0);
+    CHECK(GetPlatformName(nPlatformId, &pcName) == 0 && pcName == nullptr);
+    CHECK(GetPlatformInstruments(nPlatformId, &poInstruments, &nInstruments) == 0 && nInstruments == 0);
+    CHECK(ClosePlatformFile(nPlatformId) == 0);
+}
+
+
+static void TestCorrupt()
+{
+    WritePlatform();
+    const std::vector<char> vecValid = ReadBytes(PATH);
+    CHECK(vecValid.size() > sizeof(SPlatformFileHeader));
+    CHECK(OpenBytes(vecValid) == 0);
+
+    // truncated
+    for (size_t nSize : { size_t(0), size_t(7), sizeof(SPlatformFileHeader) - 1, sizeof(SPlatformFileHeader), vecValid.size() - 1 })
+    {
+        CHECK(OpenBytes(std::vector<char>(vecValid.begin(), vecValid.begin() + nSize)) == -3);
+    }
+    // truncated with a matching file size: the string table is cut off
+    std::vector<char> vecBytes(vecValid.begin(), vecValid.end() - 8);
+    Patch<uint64_t>(vecBytes, offsetof(SPlatformFileHeader, m_nFileSize), vecBytes.size());
+    CHECK(OpenBytes(vecBytes) == -3);
+
+    vecBytes = vecValid;
+    vecBytes[0] = 'X';
+    CHECK(OpenBytes(vecBytes) == -3);
+
+    vecBytes = vecValid;
+    Patch<uint32_t>(vecBytes, offsetof(SPlatformFileHeader, m_nVersion), 2);
+    CHECK(OpenBytes(vecBytes) == -3);
+
+    // section offsets outside the file or misaligned
+    vecBytes = vecValid;
+    Patch<uint64_t>(vecBytes, offsetof(SPlatformFileHeader, m_nAxesOffset), vecValid.size() + 8);
+    CHECK(OpenBytes(vecBytes) == -3);
+    vecBytes = vecValid;
+    Patch<uint64_t>(vecBytes, offsetof(SPlatformFileHeader, m_nTransformationsOffset),
+        Peek<uint64_t>(vecValid, offsetof(SPlatformFileHeader, m_nTransformationsOffset)) + 1);
+    CHECK(OpenBytes(vecBytes) == -3);
+    vecBytes = vecValid;
+    Patch<uint64_t>(vecBytes, offsetof(SPlatformFileHeader, m_nInstrumentsOffset), UINT64_MAX - 7);
+    CHECK(OpenBytes(vecBytes) == -3);
+
+    // section counts beyond the file
+    vecBytes = vecValid;
+    Patch<uint32_t>(vecBytes, offsetof(SPlatformFileHeader, m_nInstruments), UINT32_MAX);
+    CHECK(OpenBytes(vecBytes) == -3);
+    vecBytes = vecValid;
+    Patch<uint64_t>(vecBytes, offsetof(SPlatformFileHeader, m_nStringsSize),
+        Peek<uint64_t>(vecValid, offsetof(SPlatformFileHeader, m_nStringsSize)) + 1);
+    CHECK(OpenBytes(vecBytes) == -3);
+
+    // references: axis index and string offset out of range
+    vecBytes = vecValid;
+    Patch<uint32_t>(vecBytes, Peek<uint64_t>(vecValid, offsetof(SPlatformFileHeader, m_nAxisRefsOffset)), 2);
+    CHECK(OpenBytes(vecBytes) == -3);
+    vecBytes = vecValid;
+    Patch<uint64_t>(vecBytes, offsetof(SPlatformFileHeader, m_nName), Peek<uint64_t>(vecValid, offsetof(SPlatformFileHeader, m_nStringsSize)));
+    CHECK(OpenBytes(vecBytes) == -3);
+}
+
+
+static void TestByteFlipSweep()
+{
+    WritePlatform();
+    const std::vector<char> vecValid = ReadBytes(PATH);
+    std::vector<char> vecBytes = vecValid;
+    unsigned int nRejected = 0;
+    for (size_t i = 0; i < vecValid.size(); ++i)
+    {
+        for (unsigned char nMask : { 0x01, 0x80, 0xFF })
+        {
+            vecBytes[i] = static_cast<char>(vecValid[i] ^ nMask);
+            const int nResult = OpenBytes(vecBytes);
+            if (!CHECK(nResult == 0 || nResult == -3))
+            {
+                std::fprintf(stderr, "byte %zu, mask 0x%02x\n", i, nMask);
+            }
+            nRejected += nResult == -3;
+        }
+        vecBytes[i] = vecValid[i];
+    }
+    // every flip in the magic, version, byte order and file size is rejected
+    CHECK(nRejected >= 3 * offsetof(SPlatformFileHeader, m_nName));
+}
+
+
+int main()
+{
+    TestRoundTrip();
+    TestCorrupt();
+    TestByteFlipSweep();
+    std::remove(PATH);
+    return TestResult();
+}
@@ -0,0 +1,147 @@
+/** ProjectionTest
+* ==============
+*
+* Pixel coordinates, visibility and depth test of ProjectPoints() for a camera at the origin
+* looking along +x with +z up (right = look-at x up = -y).
+**/
+
+#include "TestCheck.hpp"
+
+#include <InstrumentPlatforms/InstrumentPlatforms.hpp>
+
+#include <cmath>
+#include <vector>
+
+
+static const double TOLERANCE = 1.0e-4;    // pixels are floats
+
+
+static SInstrumentIntrinsics MakeIntrinsics()
+{
+    SInstrumentIntrinsics oIntrinsics{};
+    oIntrinsics.m_nResolutionH = 101;
+    oIntrinsics.m_nResolutionV = 81;
+    oIntrinsics.m_dPrinciplePointH = 50.5;
+    oIntrinsics.m_dPrinciplePointV = 40.5;
+    oIntrinsics.m_dFocalLengthInPxH = 100.0;
+    oIntrinsics.m_dFocalLengthInPxV = 100.0;
+    return oIntrinsics;
+}
+
+
+static SInstrumentExtrinsics MakePose()
+{
+    SInstrumentExtrinsics oPose{};
+    oPose.m_pcReferenceFrame = "GRF";
+    oPose.m_oPosition = { 0.0, 0.0, 0.0 };
+    oPose.m_oLookAt = { 2.0, 0.0, 0.0 };       // need not be normalized
+    oPose.m_oUp = { 0.5, 0.0, 1.0 };           // orthogonalized against the look-at vector
+    return oPose;
+}
+
+
+static void TestPixels()
+{
+    const SInstrumentIntrinsics oIntrinsics = MakeIntrinsics();
+    const SInstrumentExtrinsics oPose = MakePose();
+    const SPoint3D aoPoints[] = {
+        { 10.0, 0.0, 0.0 },         // on the optical axis
+        { 10.0, 1.0, 0.0 },         // left
+        { 10.0, -1.0, 0.0 },        // right
+        { 10.0, 0.0, 1.0 },         // up
+        { -10.0, 0.0, 0.0 },        // behind
+        { 0.0, 1.0, 0.0 },          // at depth 0
+        { 10.0, -100.0, 0.0 } };    // in front, outside the image
+    const unsigned int nCount = sizeof(aoPoints) / sizeof(aoPoints[0]);
+    std::vector<float> vecPixels(2 * nCount);
+    std::vector<unsigned char> vecVisible(nCount, 2);
+    unsigned int nVisibleCount = 0;
+    CHECK(ProjectPoints(&oIntrinsics, 1, &oPose, nCount, aoPoints, 0, 0.0, vecPixels.data(), vecVisible.data(), &nVisibleCount, 1) == 0);
+
+    CHECK_NEAR(vecPixels[0], 50.5, TOLERANCE);
+    CHECK_NEAR(vecPixels[1], 40.5, TOLERANCE);
+    CHECK(vecVisible[0] == 1);
+    // u decreases to the left, increases to the right
+    CHECK_NEAR(vecPixels[2], 40.5, TOLERANCE);
+    CHECK_NEAR(vecPixels[3], 40.5, TOLERANCE);
+    CHECK_NEAR(vecPixels[4], 60.5, TOLERANCE);
+    // v decreases upwards
+    CHECK_NEAR(vecPixels[6], 50.5, TOLERANCE);
+    CHECK_NEAR(vecPixels[7], 30.5, TOLERANCE);
+    for (unsigned int i = 4; i <= 5; ++i)
+    {
+        CHECK(std::isnan(vecPixels[2 * i]) && std::isnan(vecPixels[2 * i + 1]));
+        CHECK(vecVisible[i] == 0);
+    }
+    CHECK_NEAR(vecPixels[12], 1050.5, 1.0e-3);
+    CHECK(vecVisible[6] == 0);
+    CHECK(nVisibleCount == 4);
+}
+
+
+static void TestFieldOfView()
+{
+    // 90 deg horizontal field of view over 100 pixels: focal length 50 px
+    SInstrumentIntrinsics oIntrinsics = MakeIntrinsics();
+    oIntrinsics.m_nResolutionH = 100;
+    oIntrinsics.m_dPrinciplePointH = 50.0;
+    oIntrinsics.m_dFocalLengthInPxH = 0.0;
+    oIntrinsics.m_dFieldOfViewH = 90.0;
+    const SInstrumentExtrinsics oPose = MakePose();
+    const SPoint3D oPoint{ 10.0, -5.0, 0.0 };
+    float afPixel[2] = {};
+    CHECK(ProjectPoints(&oIntrinsics, 1, &oPose, 1, &oPoint, 0, 0.0, afPixel, nullptr, nullptr, 1) == 0);
+    CHECK_NEAR(afPixel[0], 75.0, TOLERANCE);
+}
+
+
+static void TestDepth()
+{
+    const SInstrumentIntrinsics oIntrinsics = MakeIntrinsics();
+    // second pose looks from the other side, so the order of the points is reversed
+    SInstrumentExtrinsics aoPoses[2] = { MakePose(), MakePose() };
+    aoPoses[1].m_oPosition = { 30.0, 0.0, 0.0 };
+    aoPoses[1].m_oLookAt = { -1.0, 0.0, 0.0 };
+    const SPoint3D aoPoints[] = { { 10.0, 0.0, 0.0 }, { 20.0, 0.0, 0.0 }, { 15.0, 0.0, 0.0 } };
+    unsigned char anVisible[6] = {};
+    unsigned int anVisibleCounts[2] = {};
+
+    CHECK(ProjectPoints(&oIntrinsics, 1, aoPoses, 2, aoPoints, 0, 0.0, nullptr, anVisible, anVisibleCounts, 1) == 0);
+    CHECK(anVisible[0] == 1 && anVisible[1] == 1);
+
+    CHECK(ProjectPoints(&oIntrinsics, 2, aoPoses, 3, aoPoints, PROJECTION_DEPTH_TEST, 0.5, nullptr, anVisible, anVisibleCounts, 1) == 0);
+    CHECK(anVisible[0] == 1 && anVisible[1] == 0 && anVisible[2] == 0);
+    CHECK(anVisible[3] == 0 && anVisible[4] == 1 && anVisible[5] == 0);
+    CHECK(anVisibleCounts[0] == 1 && anVisibleCounts[1] == 1);
+
+    // the far point reappears once the tolerance exceeds the depth gap of 10
+    CHECK(ProjectPoints(&oIntrinsics, 1, aoPoses, 2, aoPoints, PROJECTION_DEPTH_TEST, 9.5, nullptr, anVisible, anVisibleCounts, 1) == 0);
+    CHECK(anVisible[0] == 1 && anVisible[1] == 0);
+    CHECK(ProjectPoints(&oIntrinsics, 1, aoPoses, 2, aoPoints, PROJECTION_DEPTH_TEST, 10.5, nullptr, anVisible, anVisibleCounts, 1) == 0);
+    CHECK(anVisible[0] == 1 && anVisible[1] == 1);
+    CHECK(anVisibleCounts[0] == 2);
+}
+
+
+static void TestInvalidArguments()
+{
+    SInstrumentIntrinsics oIntrinsics = MakeIntrinsics();
+    SInstrumentExtrinsics oPose = MakePose();
+    const SPoint3D oPoint{ 10.0, 0.0, 0.0 };
+    CHECK(ProjectPoints(nullptr, 1, &oPose, 1, &oPoint, 0, 0.0, nullptr, nullptr, nullptr, 1) == -1);
+    oPose.m_oUp = { -3.0, 0.0, 0.0 };
+    CHECK(ProjectPoints(&oIntrinsics, 1, &oPose, 1, &oPoint, 0, 0.0, nullptr, nullptr, nullptr, 1) == -3);
+    oPose = MakePose();
+    oIntrinsics.m_dFocalLengthInPxV = 0.0;
+    CHECK(ProjectPoints(&oIntrinsics, 1, &oPose, 1, &oPoint, 0, 0.0, nullptr, nullptr, nullptr, 1) == -2);
+}
+
+
+int main()
+{
+    TestPixels();
+    TestFieldOfView();
+    TestDepth();
+    TestInvalidArguments();
+    return TestResult();
+}
@@ -0,0 +1,52 @@
+#ifndef JR_PRO3D_EXTENSIONS_TESTCHECK_HPP
+#define JR_PRO3D_EXTENSIONS_TESTCHECK_HPP
+
+#include <cmath>
+#include <cstdio>
+
+
+/** Minimal checks for the InstrumentPlatforms tests: failures are printed with their location
+  * and counted, main() returns TestResult() so ctest sees a non-zero exit code.
+  **/
+
+inline int& TestFailures()
+{
+    static int s_nFailures = 0;
+    return s_nFailures;
+}
+
+inline bool TestCheck(bool bCondition, const char* pcExpression, const char* pcFile, int nLine)
+{
+    if (!bCondition)
+    {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", pcFile, nLine, pcExpression);
+        ++TestFailures();
+    }
+    return bCondition;
+}
+
+inline bool TestCheckNear(double dActual, double dExpected, double dTolerance, const char* pcExpression, const char* pcFile, int nLine)
+{
+    if (!(std::abs(dActual - dExpected) <= dTolerance))
+    {
+        std::fprintf(stderr, "%s:%d: check failed: %s = %.17g, expected %.17g +- %g\n", pcFile, nLine, pcExpression, dActual, dExpected, dTolerance);
+        ++TestFailures();
+        return false;
+    }
+    return true;
+}
+
+inline int TestResult()
+{
+    if (TestFailures() > 0)
+    {
+        std::fprintf(stderr, "%d check(s) failed\n", TestFailures());
+        return 1;
+    }
+    return 0;
+}
+
+#define CHECK(bCondition) TestCheck((bCondition), #bCondition, __FILE__, __LINE__)
+#define CHECK_NEAR(dActual, dExpected, dTolerance) TestCheckNear((dActual), (dExpected), (dTolerance), #dActual, __FILE__, __LINE__)
+
+#endif // JR_PRO3D_EXTENSIONS_TESTCHECK_HPP